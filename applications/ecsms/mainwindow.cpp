@@ -898,6 +898,8 @@ void MainWindow::constructAndStartPipeline() {
     for (auto&& stage : stages)
       _pipeline->addStage(stage);
 
+    // connections are created with one task per consumer, let them grow
+    _pipeline->setCapacityTuning(CapacityTuningSettings{});
     _pipeline->run();
   } catch (const std::exception& e) {
     QMessageBox::warning(this, "Ошибка", e.what());
@@ -0,0 +1,110 @@
+#include "RunSummary.h"
+
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+double toSeconds(chrono::nanoseconds t) {
+  return chrono::duration<double>(t).count();
+}
+
+double toMicroseconds(chrono::nanoseconds t) {
+  return chrono::duration<double, micro>(t).count();
+}
+
+double throughput(const StageStatistics& statistics,
+                  chrono::nanoseconds elapsed) {
+  auto seconds = toSeconds(elapsed);
+  return seconds > 0 ? statistics.processedCount / seconds : 0;
+}
+
+string escapeJson(const string& s) {
+  ostringstream out;
+  for (char c : s) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+          out << "\\u" << hex << setw(4) << setfill('0') << int(c) << dec;
+        else
+          out << c;
+    }
+  }
+
+  return out.str();
+}
+}  // namespace
+
+RunSummary RunSummary::collect(Pipeline& pipeline,
+                               chrono::nanoseconds elapsed) {
+  RunSummary summary;
+  summary.elapsed = elapsed;
+  for (const auto& stage : pipeline.getStages()) {
+    summary.stages.push_back({stage->getId().value_or(""), stage->getName(),
+                              stage->getStatistics()});
+  }
+
+  return summary;
+}
+
+string RunSummary::toText() const {
+  ostringstream out;
+  out << fixed << setprecision(3);
+  out << "pipeline ran for " << toSeconds(elapsed) << " s\n";
+
+  out << left << setw(24) << "stage" << right << setw(12) << "processed"
+      << setw(8) << "failed" << setw(14) << "tasks/s" << setw(11) << "avg us"
+      << setw(11) << "p50 us" << setw(11) << "p99 us" << setw(11) << "max us"
+      << '\n';
+  for (const auto& stage : stages) {
+    const auto& s = stage.statistics;
+    out << left << setw(24) << (stage.id.empty() ? stage.name : stage.id)
+        << right << setw(12) << s.processedCount << setw(8) << s.failedCount
+        << setw(14) << setprecision(1) << throughput(s, elapsed)
+        << setprecision(3) << setw(11) << toMicroseconds(s.averageLatency())
+        << setw(11) << toMicroseconds(s.latencyPercentile(0.5)) << setw(11)
+        << toMicroseconds(s.latencyPercentile(0.99)) << setw(11)
+        << toMicroseconds(s.maxLatency) << '\n';
+  }
+
+  return out.str();
+}
+
+string RunSummary::toJson() const {
+  ostringstream out;
+  out << "{\n";
+  out << "  \"elapsedSeconds\": " << toSeconds(elapsed) << ",\n";
+  out << "  \"stages\": [";
+  for (size_t i = 0; i < stages.size(); ++i) {
+    const auto& s = stages[i].statistics;
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\n";
+    out << "      \"id\": \"" << escapeJson(stages[i].id) << "\",\n";
+    out << "      \"name\": \"" << escapeJson(stages[i].name) << "\",\n";
+    out << "      \"processed\": " << s.processedCount << ",\n";
+    out << "      \"failed\": " << s.failedCount << ",\n";
+    out << "      \"tasksPerSecond\": " << throughput(s, elapsed) << ",\n";
+    out << "      \"latencyNs\": {\"avg\": " << s.averageLatency().count()
+        << ", \"p50\": " << s.latencyPercentile(0.5).count()
+        << ", \"p99\": " << s.latencyPercentile(0.99).count()
+        << ", \"max\": " << s.maxLatency.count() << "}\n";
+    out << "    }";
+  }
+  out << (stages.empty() ? "]\n" : "\n  ]\n");
+  out << "}\n";
+
+  return out.str();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Pipeline.h"
+#include "StageStatistics.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+struct StageSummary {
+  std::string id;
+  std::string name;
+  StageStatistics statistics;
+};
+
+struct RunSummary {
+  std::chrono::nanoseconds elapsed{0};
+  std::vector<StageSummary> stages;
+
+  static RunSummary collect(Pipeline& pipeline,
+                            std::chrono::nanoseconds elapsed);
+
+  std::string toText() const;
+
+  std::string toJson() const;
+};
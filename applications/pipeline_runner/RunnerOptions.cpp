@@ -0,0 +1,97 @@
+#include "RunnerOptions.h"
+
+#include <stdexcept>
+
+using namespace std;
+using namespace string_literals;
+
+namespace {
+size_t toNumber(const string& option, const string& value) {
+  size_t pos = 0;
+  unsigned long long number = 0;
+  try {
+    number = stoull(value, &pos);
+  } catch (std::exception&) {
+    pos = 0;
+  }
+
+  if (pos == 0 || pos != value.size())
+    throw invalid_argument("option "s + option + " expects a number, got " +
+                           value);
+
+  return size_t(number);
+}
+
+ExecutorType executorFromString(const string& value) {
+  if (value == "threads")
+    return ExecutorType::threadPerStage;
+  if (value == "pool")
+    return ExecutorType::threadPool;
+
+  throw invalid_argument("unknown executor "s + value);
+}
+}  // namespace
+
+RunnerOptions RunnerOptionsParser::parse(int argc, char* argv[]) {
+  RunnerOptions options;
+  optional<string> pipelineFile;
+
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    auto value = [&]() -> string {
+      if (i + 1 >= argc)
+        throw invalid_argument("option "s + arg + " expects a value");
+      return argv[++i];
+    };
+
+    if (arg == "--duration") {
+      options.duration = chrono::milliseconds(toNumber(arg, value()));
+    } else if (arg == "--drain") {
+      options.drainTime = chrono::milliseconds(toNumber(arg, value()));
+    } else if (arg == "--executor") {
+      options.executor = executorFromString(value());
+    } else if (arg == "--threads") {
+      options.threadsCount = toNumber(arg, value());
+      if (options.threadsCount == 0u)
+        throw invalid_argument("option --threads expects a positive number");
+    } else if (arg == "--pin") {
+      auto pin = value();
+      auto separator = pin.rfind('=');
+      if (separator == string::npos || separator == 0)
+        throw invalid_argument("option --pin expects <stageId>=<cpu>, got "s +
+                               pin);
+      options.stageCpus[pin.substr(0, separator)] =
+          toNumber(arg, pin.substr(separator + 1));
+    } else if (arg == "--pin-all") {
+      options.pinAllStages = true;
+    } else if (arg == "--json") {
+      options.jsonOutput = value();
+    } else if (!arg.empty() && arg[0] == '-') {
+      throw invalid_argument("unknown option "s + arg);
+    } else if (pipelineFile.has_value()) {
+      throw invalid_argument("only one pipeline file is expected");
+    } else {
+      pipelineFile = arg;
+    }
+  }
+
+  if (!pipelineFile.has_value())
+    throw invalid_argument("pipeline file is not specified");
+
+  options.pipelineFile = pipelineFile.value();
+  return options;
+}
+
+string RunnerOptionsParser::usage() {
+  return "usage: pipeline_runner <pipeline.yaml> [options]\n"
+         "  --duration <ms>        stop after given time, by default runs\n"
+         "                         until all producers finish\n"
+         "  --drain <ms>           time given to consumers after producers\n"
+         "                         finish, 100 by default\n"
+         "  --executor <name>      threads (thread per stage) or pool\n"
+         "  --threads <n>          threads of the pool executor\n"
+         "  --pin <stageId>=<cpu>  pin stage thread to cpu, can be repeated\n"
+         "  --pin-all              pin stage threads to cpus in order of\n"
+         "                         declaration\n"
+         "  --json <file>          write summary as json, '-' for stdout\n";
+}
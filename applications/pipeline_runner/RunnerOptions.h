@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+enum class ExecutorType { threadPerStage, threadPool };
+
+struct RunnerOptions {
+  std::filesystem::path pipelineFile;
+  // run until producers finish if not set
+  std::optional<std::chrono::milliseconds> duration;
+  // time given to consumers to drain connections after producers finish
+  std::chrono::milliseconds drainTime{100};
+  ExecutorType executor = ExecutorType::threadPerStage;
+  // threads of the pool executor, hardware concurrency if not set
+  std::optional<size_t> threadsCount;
+  std::map<std::string, size_t> stageCpus;
+  bool pinAllStages = false;
+  // "-" means stdout
+  std::optional<std::string> jsonOutput;
+};
+
+namespace RunnerOptionsParser {
+// throws std::invalid_argument on malformed command line
+RunnerOptions parse(int argc, char* argv[]);
+
+std::string usage();
+}  // namespace RunnerOptionsParser
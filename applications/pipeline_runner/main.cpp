@@ -0,0 +1,118 @@
+#include "Pipeline.h"
+#include "RunSummary.h"
+#include "RunnerOptions.h"
+#include "SteadyClock.h"
+#include "ThreadPoolExecutor.h"
+#include "YamlToPipeline.h"
+
+#include <atomic>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+namespace {
+atomic_bool interrupted{false};
+
+void onInterrupt(int) {
+  interrupted = true;
+}
+
+void applyAffinity(Pipeline& pipeline, const RunnerOptions& options) {
+  if (options.pinAllStages) {
+    auto cpusCount = max(1u, thread::hardware_concurrency());
+    const auto& stages = pipeline.getStages();
+    for (size_t i = 0; i < stages.size(); ++i)
+      stages[i]->setCpuAffinity(i % cpusCount);
+  }
+
+  for (const auto& [stageId, cpu] : options.stageCpus)
+    pipeline.getStageById(stageId)->setCpuAffinity(cpu);
+}
+
+void applyExecutor(Pipeline& pipeline, const RunnerOptions& options) {
+  if (options.executor != ExecutorType::threadPool)
+    return;
+
+  ThreadPoolSettings settings;
+  if (options.threadsCount.has_value())
+    settings.threadsCount = options.threadsCount.value();
+  pipeline.setExecutor(make_shared<ThreadPoolExecutor>(settings));
+}
+
+void waitForCompletion(Pipeline& pipeline, const RunnerOptions& options) {
+  using Clock = chrono::steady_clock;
+
+  optional<Clock::time_point> deadline;
+  if (options.duration.has_value())
+    deadline = Clock::now() + options.duration.value();
+
+  bool draining = false;
+  while (!interrupted) {
+    auto now = Clock::now();
+    if (deadline.has_value() && now >= deadline.value())
+      break;
+
+    if (!draining && pipeline.producersFinished()) {
+      draining = true;
+      if (!deadline.has_value() || now + options.drainTime < deadline.value())
+        deadline = now + options.drainTime;
+    }
+
+    SteadyClock::waitForMs(10);
+  }
+}
+
+void writeJson(const RunSummary& summary, const string& output) {
+  if (output == "-") {
+    cout << summary.toJson();
+    return;
+  }
+
+  ofstream file(output);
+  if (!file.is_open())
+    throw runtime_error("cannot open " + output);
+  file << summary.toJson();
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  RunnerOptions options;
+  try {
+    options = RunnerOptionsParser::parse(argc, argv);
+  } catch (std::exception& ex) {
+    cerr << ex.what() << endl << RunnerOptionsParser::usage();
+    return 2;
+  }
+
+  try {
+    auto pipeline = YamlToPipeline::parseFromFile(options.pipelineFile);
+    applyAffinity(*pipeline, options);
+    applyExecutor(*pipeline, options);
+
+    signal(SIGINT, onInterrupt);
+    signal(SIGTERM, onInterrupt);
+
+    auto started = chrono::steady_clock::now();
+    pipeline->run();
+    waitForCompletion(*pipeline, options);
+    pipeline->shutdown();
+    auto elapsed = chrono::steady_clock::now() - started;
+
+    auto summary = RunSummary::collect(*pipeline, elapsed);
+    if (options.jsonOutput != "-")
+      cout << summary.toText();
+    if (options.jsonOutput.has_value())
+      writeJson(summary, options.jsonOutput.value());
+  } catch (std::exception& ex) {
+    cerr << ex.what() << endl;
+    return 1;
+  } catch (...) {
+    cerr << "unhandled exception in main thread" << endl;
+    return 1;
+  }
+
+  return 0;
+}
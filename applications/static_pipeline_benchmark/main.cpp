@@ -0,0 +1,211 @@
+// Compares throughput of the same graph built at runtime from YAML and at
+// compile time with StaticPipeline:
+//   counter -> halving -> counting sink
+// Both variants run the same node code and use SPMC connections of the same
+// capacity, so the difference is the cost of the runtime machinery: registry
+// factories, virtual stage hooks and weak_ptr connections.
+//
+// usage: static_pipeline_benchmark [--duration <seconds>]
+//                                  [--capacity <tasks>]
+
+#include "ConsumerStage.h"
+#include "PipelineRegistry.h"
+#include "ProducerAndConsumerStage.h"
+#include "ProducerStage.h"
+#include "StaticPipeline.h"
+#include "SteadyClock.h"
+#include "YamlToPipeline.h"
+
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace {
+struct BenchmarkOptions {
+  size_t durationSeconds = 3;
+  size_t capacity = 1024;
+};
+
+// nodes of the static graph, the runtime stages below call them too
+struct CounterNode : StaticNode<void, int64_t> {
+  bool produce(int64_t& out) {
+    out = m_next++;
+    return true;
+  }
+
+  int64_t m_next = 0;
+};
+
+struct HalvingNode : StaticNode<int64_t, double> {
+  bool consumeAndProduce(const int64_t& in, double& out) {
+    out = double(in) / 2;
+    return true;
+  }
+};
+
+struct SinkNode : StaticNode<double, void> {
+  void consume(const double& in) { m_sum += in; }
+
+  double m_sum = 0;
+};
+
+class CounterStage : public ProducerStage<int64_t> {
+ public:
+  CounterStage(std::shared_ptr<OutStageConnection<int64_t>> connection)
+      : ProducerStage<int64_t>(stageName, connection) {}
+
+  void produce(std::shared_ptr<int64_t> outData) override {
+    dataProduced(outData, m_node.produce(*outData));
+  }
+
+  static constexpr auto stageName = "benchmarkCounter";
+  using consumptionT = void;
+  using productionT = int64_t;
+
+ private:
+  CounterNode m_node;
+};
+
+class HalvingStage : public ConsumerAndProducerStage<int64_t, double> {
+ public:
+  HalvingStage(ConsumptionStrategy strategy,
+               std::shared_ptr<InStageConnection<int64_t>> inConnection,
+               std::shared_ptr<OutStageConnection<double>> outConnection)
+      : ConsumerAndProducerStage<int64_t, double>(stageName,
+                                                  strategy,
+                                                  inConnection,
+                                                  outConnection) {}
+
+  void consumeAndProduce(std::shared_ptr<int64_t> inData,
+                         std::shared_ptr<double> outData) override {
+    auto produced = m_node.consumeAndProduce(*inData, *outData);
+    dataConsumed(inData);
+    dataProduced(outData, produced);
+  }
+
+  static constexpr auto stageName = "benchmarkHalving";
+  using consumptionT = int64_t;
+  using productionT = double;
+
+ private:
+  HalvingNode m_node;
+};
+
+class SinkStage : public ConsumerStage<double> {
+ public:
+  SinkStage(ConsumptionStrategy strategy,
+            std::shared_ptr<InStageConnection<double>> connection)
+      : ConsumerStage<double>(stageName, strategy, connection) {}
+
+  void consume(std::shared_ptr<double> inData) override {
+    m_node.consume(*inData);
+    dataConsumed(inData);
+  }
+
+  static constexpr auto stageName = "benchmarkSink";
+  using consumptionT = double;
+  using productionT = void;
+
+ private:
+  SinkNode m_node;
+};
+
+string yamlGraph(const BenchmarkOptions& options) {
+  auto size = to_string(options.capacity);
+  return "benchmarkCounter:\n"
+         "  id: counter\n"
+         "  type: producer\n"
+         "  connectionSize: " + size + "\n"
+         "\n"
+         "benchmarkHalving:\n"
+         "  id: halving\n"
+         "  type: producerConsumer\n"
+         "  strategy: fifo\n"
+         "  parentId: counter\n"
+         "  connectionSize: " + size + "\n"
+         "\n"
+         "benchmarkSink:\n"
+         "  id: sink\n"
+         "  type: consumer\n"
+         "  strategy: fifo\n"
+         "  parentId: halving\n";
+}
+
+void report(const string& name,
+            const IPipelineStage& sink,
+            const BenchmarkOptions& options) {
+  auto statistics = sink.getStatistics();
+  auto rate = double(statistics.processedCount) / options.durationSeconds;
+  cout << left << setw(10) << name << right << setw(14) << fixed
+       << setprecision(0) << rate << " tasks/s" << setw(10)
+       << statistics.averageLatency().count() << " ns/task in sink"
+       << endl;
+}
+
+void measure(const string& name,
+             Pipeline& pipeline,
+             const IPipelineStage& sink,
+             const BenchmarkOptions& options) {
+  pipeline.run();
+  SteadyClock::waitForMs(options.durationSeconds * 1000);
+  pipeline.shutdown();
+
+  report(name, sink, options);
+}
+
+void runYaml(const BenchmarkOptions& options) {
+  auto& registry = PipelineRegistry::Instance();
+  registry.registerProducer<CounterStage>(CounterStage::stageName);
+  registry.registerConsumerAndProducer<HalvingStage>(HalvingStage::stageName);
+  registry.registerConsumer<SinkStage>(SinkStage::stageName);
+
+  auto pipeline = YamlToPipeline::parseFromString(yamlGraph(options));
+  measure("yaml", *pipeline, *pipeline->getStageById("sink"), options);
+}
+
+void runStatic(const BenchmarkOptions& options) {
+  auto pipeline = makeStaticPipeline(
+      CounterNode{} | HalvingNode{} | SinkNode{}, options.capacity);
+  measure("static", *pipeline, *pipeline->getStaticStage<2>(), options);
+}
+
+BenchmarkOptions parseOptions(int argc, char** argv) {
+  BenchmarkOptions options;
+  for (int i = 1; i < argc; ++i) {
+    string flag = argv[i];
+    if (i + 1 == argc)
+      throw invalid_argument("value is expected after " + flag);
+
+    string value = argv[++i];
+    if (flag == "--duration")
+      options.durationSeconds = stoul(value);
+    else if (flag == "--capacity")
+      options.capacity = stoul(value);
+    else
+      throw invalid_argument("unknown option " + flag);
+  }
+
+  if (options.durationSeconds == 0)
+    throw invalid_argument("duration must be positive");
+  if (options.capacity == 0)
+    throw invalid_argument("capacity must be positive");
+  return options;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    auto options = parseOptions(argc, argv);
+
+    runYaml(options);
+    runStatic(options);
+  } catch (const exception& ex) {
+    cerr << "static_pipeline_benchmark: " << ex.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
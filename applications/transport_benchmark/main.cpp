@@ -0,0 +1,182 @@
+// Compares throughput of the in-process connection with the socket bridge
+// stages. Every configuration runs a counting producer and a counting
+// consumer for the given duration:
+//   in-process: producer -> connection -> consumer
+//   socket:     producer -> connection -> SocketWriteStage ==>
+//               SocketReadStage -> connection -> consumer
+//
+// usage: transport_benchmark [--duration <seconds>] [--batch <tasks>]
+//                            [--window <tasks>] [--capacity <tasks>]
+
+#include "ConsumerStage.h"
+#include "Pipeline.h"
+#include "ProducerStage.h"
+#include "SPMCStageConnection.h"
+#include "SocketReadStage.h"
+#include "SocketWriteStage.h"
+#include "SteadyClock.h"
+
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace {
+struct BenchmarkOptions {
+  size_t durationSeconds = 3;
+  string batchSize = "64";
+  string window = "1024";
+  size_t capacity = 1024;
+};
+
+class CounterProducer : public ProducerStage<int64_t> {
+ public:
+  CounterProducer(std::shared_ptr<OutStageConnection<int64_t>> connection)
+      : ProducerStage<int64_t>("CounterProducer", connection) {}
+
+  void produce(std::shared_ptr<int64_t> outData) override {
+    *outData = m_next++;
+    dataProduced(outData);
+  }
+
+ private:
+  int64_t m_next = 0;
+};
+
+class CountingConsumer : public ConsumerStage<int64_t> {
+ public:
+  CountingConsumer(std::shared_ptr<InStageConnection<int64_t>> connection)
+      : ConsumerStage<int64_t>("CountingConsumer",
+                               ConsumptionStrategy::fifo,
+                               connection) {}
+
+  void consume(std::shared_ptr<int64_t> inData) override {
+    // producer overwrites tasks which were not consumed in time
+    if (*inData != m_last + 1)
+      ++m_gaps;
+    m_last = *inData;
+    ++m_count;
+    dataConsumed(inData);
+  }
+
+  size_t getCount() const { return m_count; }
+  size_t getGaps() const { return m_gaps; }
+
+ private:
+  std::atomic_size_t m_count{0};
+  std::atomic_size_t m_gaps{0};
+  int64_t m_last = -1;
+};
+
+template <typename Stage>
+void parameterize(Stage& stage,
+                  const vector<pair<string, string>>& parameters) {
+  for (const auto& [name, value] : parameters) {
+    if (!stage.SetParameterValue(name, value))
+      throw invalid_argument("unknown parameter " + name);
+  }
+  stage.ApplyParameterValues();
+}
+
+void report(const string& name,
+            const CountingConsumer& consumer,
+            const BenchmarkOptions& options) {
+  auto rate = double(consumer.getCount()) / options.durationSeconds;
+  cout << left << setw(12) << name << right << setw(14) << fixed
+       << setprecision(0) << rate << " tasks/s" << setw(14)
+       << setprecision(1) << rate * sizeof(int64_t) / (1024 * 1024)
+       << " MiB/s" << setw(10) << consumer.getGaps() << " gaps" << endl;
+}
+
+void runInProcess(const BenchmarkOptions& options) {
+  auto connection = make_shared<SPMCStageConnection<int64_t>>(options.capacity);
+  auto consumer = make_shared<CountingConsumer>(connection);
+
+  Pipeline pipeline;
+  pipeline.addConnection(connection);
+  pipeline.addStage(make_shared<CounterProducer>(connection));
+  pipeline.addStage(consumer);
+
+  pipeline.run();
+  SteadyClock::waitForMs(options.durationSeconds * 1000);
+  pipeline.shutdown();
+
+  report("in-process", *consumer, options);
+}
+
+void runSocket(const string& name,
+               const string& address,
+               const BenchmarkOptions& options) {
+  auto received = make_shared<SPMCStageConnection<int64_t>>(options.capacity);
+  auto reader = make_shared<SocketReadStage<int64_t>>(received);
+  parameterize(*reader, {{"address", address}, {"window", options.window}});
+  auto consumer = make_shared<CountingConsumer>(received);
+
+  Pipeline receiving;
+  receiving.addConnection(received);
+  receiving.addStage(reader);
+  receiving.addStage(consumer);
+
+  auto produced = make_shared<SPMCStageConnection<int64_t>>(options.capacity);
+  auto writer = make_shared<SocketWriteStage<int64_t>>(
+      ConsumptionStrategy::fifo, produced);
+  parameterize(*writer, {{"address", reader->GetListenAddress()},
+                         {"batchSize", options.batchSize}});
+
+  Pipeline sending;
+  sending.addConnection(produced);
+  sending.addStage(make_shared<CounterProducer>(produced));
+  sending.addStage(writer);
+
+  receiving.run();
+  sending.run();
+  SteadyClock::waitForMs(options.durationSeconds * 1000);
+  sending.shutdown();
+  receiving.shutdown();
+
+  report(name, *consumer, options);
+}
+
+BenchmarkOptions parseOptions(int argc, char** argv) {
+  BenchmarkOptions options;
+  for (int i = 1; i < argc; ++i) {
+    string flag = argv[i];
+    if (i + 1 == argc)
+      throw invalid_argument("value is expected after " + flag);
+
+    string value = argv[++i];
+    if (flag == "--duration")
+      options.durationSeconds = stoul(value);
+    else if (flag == "--batch")
+      options.batchSize = value;
+    else if (flag == "--window")
+      options.window = value;
+    else if (flag == "--capacity")
+      options.capacity = stoul(value);
+    else
+      throw invalid_argument("unknown option " + flag);
+  }
+
+  if (options.durationSeconds == 0)
+    throw invalid_argument("duration must be positive");
+  return options;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    auto options = parseOptions(argc, argv);
+
+    runInProcess(options);
+    runSocket("unix", "unix:transport_benchmark.sock", options);
+    runSocket("tcp", "tcp:127.0.0.1:0", options);
+  } catch (const exception& ex) {
+    cerr << "transport_benchmark: " << ex.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
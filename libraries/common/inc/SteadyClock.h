@@ -5,6 +5,7 @@
 
 class SteadyClock {
  public:
+  static std::chrono::nanoseconds nowNs();
   static std::chrono::microseconds nowUs();
   static std::chrono::milliseconds nowMs();
 
@@ -12,4 +13,11 @@ class SteadyClock {
   static void waitForMs(unsigned);
   static void waitForUs(const std::chrono::microseconds&);
   static void waitForMs(const std::chrono::milliseconds&);
+
+  // waits until nowNs() reaches the deadline: sleeps while the deadline is
+  // far away and spins for the last spinPeriod, so the wake up is not
+  // delayed by the scheduler
+  static void waitUntilNs(const std::chrono::nanoseconds& deadline);
+
+  static constexpr std::chrono::microseconds spinPeriod{200};
 };
@@ -4,6 +4,11 @@
 
 using namespace std;
 
+chrono::nanoseconds SteadyClock::nowNs() {
+  auto now = chrono::steady_clock::now().time_since_epoch();
+  return chrono::duration_cast<chrono::nanoseconds>(now);
+}
+
 chrono::microseconds SteadyClock::nowUs() {
   auto now = chrono::steady_clock::now().time_since_epoch();
   return chrono::duration_cast<chrono::microseconds>(now);
@@ -29,3 +34,12 @@ void SteadyClock::waitForUs(const chrono::microseconds& t) {
 void SteadyClock::waitForMs(const chrono::milliseconds& t) {
   this_thread::sleep_for(t);
 }
+
+void SteadyClock::waitUntilNs(const chrono::nanoseconds& deadline) {
+  auto now = nowNs();
+  if (deadline - now > spinPeriod)
+    this_thread::sleep_for(deadline - now - spinPeriod);
+
+  while (nowNs() < deadline)
+    this_thread::yield();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <IConnection.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class ConnectionPool;
+/// Указатель на ConnectionPool
+using ConnectionPoolPtr = std::shared_ptr<ConnectionPool>;
+
+//------------------------------------------------------------------------------
+/**
+  \brief Пул соединений с базой данных.
+
+  Ограничивает число одновременно открытых соединений. Полученное из пула
+  соединение возвращается в него, когда уничтожается последняя копия
+  указателя на него, и может быть повторно выдано для той же строки
+  подключения. При возврате незавершенная транзакция отменяется.
+
+  Пул может быть вложенным (см. CreateQuota): вложенный пул ограничивает
+  число соединений, выданных через него (например, одному конвейеру), а сами
+  соединения берет у родительского пула.
+
+  \warning Объекты, полученные через соединение (например, удаленные файлы),
+           не должны использоваться после возврата соединения в пул.
+*/
+//---
+class ConnectionPool : public std::enable_shared_from_this<ConnectionPool> {
+public:
+  /// Функция создания соединения по строке подключения
+  using ConnectionFactory =
+      std::function<IConnectionPtr(const std::string &connectionInfo)>;
+
+private:
+  const size_t m_maxConnections; ///< Максимальное число соединений
+  const ConnectionFactory m_factory; ///< Создание соединений (корневой пул)
+  const ConnectionPoolPtr m_parent;  ///< Родительский пул (вложенный пул)
+
+  size_t m_acquiredCount = 0; ///< Число выданных соединений
+  size_t m_openedCount = 0;   ///< Число открытых соединений (корневой пул)
+  std::multimap<std::string, IConnectionPtr>
+      m_idleConnections; ///< Свободные соединения по строкам подключения
+
+  mutable std::mutex m_mutex; ///< Мьютекс для доступа к состоянию пула
+  std::condition_variable m_released; ///< Сигнал о возврате соединения
+
+public:
+  /// Создать пул соединений
+  /// \param maxConnections Максимальное число одновременно открытых
+  ///        соединений.
+  /// \param factory Функция создания соединения. По умолчанию соединения
+  ///        создаются менеджером базы данных PostgreSQL.
+  static ConnectionPoolPtr Create(size_t maxConnections,
+                                  ConnectionFactory factory = {});
+
+  /// Создать вложенный пул, выдающий не более maxConnections соединений
+  ConnectionPoolPtr CreateQuota(size_t maxConnections);
+
+  /// Получить соединение.
+  /// Если все соединения заняты, ожидает возврата соединения в пул.
+  /// \param connectionInfo Строка подключения.
+  /// \param timeout Максимальное время ожидания.
+  /// \return \c nullptr, если соединение не было получено за время ожидания.
+  IConnectionPtr
+  Acquire(const std::string &connectionInfo,
+          std::chrono::milliseconds timeout = std::chrono::seconds(30));
+
+  /// Получить максимальное число соединений
+  size_t GetMaxConnectionsCount() const;
+  /// Получить число выданных соединений
+  size_t GetAcquiredConnectionsCount() const;
+  /// Получить число открытых соединений (выданных и свободных)
+  size_t GetOpenedConnectionsCount() const;
+
+private:
+  /// Конструктор
+  ConnectionPool(size_t maxConnections, ConnectionFactory factory,
+                 ConnectionPoolPtr parent);
+
+  /// Получить соединение из корневого пула
+  IConnectionPtr acquireOwn(const std::string &connectionInfo,
+                            std::chrono::steady_clock::time_point deadline);
+  /// Получить соединение через вложенный пул
+  IConnectionPtr acquireFromParent(
+      const std::string &connectionInfo,
+      std::chrono::steady_clock::time_point deadline);
+
+  /// Вернуть соединение в корневой пул
+  void release(const std::string &connectionInfo,
+               const IConnectionPtr &connection);
+  /// Освободить место во вложенном пуле
+  void releaseQuota();
+};
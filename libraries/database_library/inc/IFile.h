@@ -47,6 +47,15 @@ public:
   /// \return \c true, если удалось закрыть файл, иначе \c false.
   virtual bool Close() = 0;
 
+  /// Переместить позицию чтения/записи
+  /// \param position Смещение от начала файла в байтах
+  /// \return \c true, если удалось переместить позицию, иначе \c false.
+  virtual bool Seek(size_t position) = 0;
+  /// Получить размер файла. Позиция чтения/записи не меняется.
+  /// \return Размер файла в байтах или std::nullopt, если файл не открыт или
+  ///         произошла ошибка.
+  virtual std::optional<size_t> GetSize() = 0;
+
   /// Попытаться прочесть байты
   /// \param buffer Буфер, в который требуется прочитать байты.
   /// \param bytesCount Количество байт, которое требуется попытаться прочесть.
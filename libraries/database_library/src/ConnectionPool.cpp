@@ -0,0 +1,215 @@
+#include <ConnectionPool.h>
+
+#include <IDatabaseManager.h>
+
+#include <stdexcept>
+
+//------------------------------------------------------------------------------
+/**
+  Конструктор
+*/
+//---
+ConnectionPool::ConnectionPool(size_t maxConnections, ConnectionFactory factory,
+                               ConnectionPoolPtr parent)
+    : m_maxConnections(maxConnections), m_factory(std::move(factory)),
+      m_parent(std::move(parent)) {
+  if (maxConnections == 0)
+    throw std::invalid_argument("maxConnections must be positive");
+}
+
+//------------------------------------------------------------------------------
+/**
+  Создать пул соединений
+*/
+//---
+ConnectionPoolPtr ConnectionPool::Create(size_t maxConnections,
+                                         ConnectionFactory factory) {
+  if (!factory)
+    factory = [](const std::string &connectionInfo) {
+      return GetDatabaseManager().GetConnection(connectionInfo);
+    };
+
+  return ConnectionPoolPtr(
+      new ConnectionPool(maxConnections, std::move(factory), nullptr));
+}
+
+//------------------------------------------------------------------------------
+/**
+  Создать вложенный пул
+*/
+//---
+ConnectionPoolPtr ConnectionPool::CreateQuota(size_t maxConnections) {
+  return ConnectionPoolPtr(
+      new ConnectionPool(maxConnections, nullptr, shared_from_this()));
+}
+
+//------------------------------------------------------------------------------
+/**
+  Получить соединение
+*/
+//---
+IConnectionPtr ConnectionPool::Acquire(const std::string &connectionInfo,
+                                       std::chrono::milliseconds timeout) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  return m_parent ? acquireFromParent(connectionInfo, deadline)
+                  : acquireOwn(connectionInfo, deadline);
+}
+
+//------------------------------------------------------------------------------
+/**
+  Получить соединение из корневого пула
+*/
+//---
+IConnectionPtr
+ConnectionPool::acquireOwn(const std::string &connectionInfo,
+                           std::chrono::steady_clock::time_point deadline) {
+  IConnectionPtr connection;
+  {
+    std::unique_lock lock(m_mutex);
+    while (!connection) {
+      if (auto idle = m_idleConnections.find(connectionInfo);
+          idle != m_idleConnections.end()) {
+        connection = idle->second;
+        m_idleConnections.erase(idle);
+        break;
+      }
+
+      if (m_openedCount < m_maxConnections) {
+        ++m_openedCount;
+        break;
+      }
+
+      if (!m_idleConnections.empty()) {
+        // Свободное соединение к другой базе закрываем, чтобы открыть нужное
+        m_idleConnections.erase(m_idleConnections.begin());
+        --m_openedCount;
+        continue;
+      }
+
+      if (m_released.wait_until(lock, deadline) == std::cv_status::timeout)
+        return nullptr;
+    }
+    ++m_acquiredCount;
+  }
+
+  if (!connection)
+    connection = m_factory(connectionInfo);
+
+  if (!connection) {
+    {
+      std::lock_guard lock(m_mutex);
+      --m_acquiredCount;
+      --m_openedCount;
+    }
+    m_released.notify_one();
+    return nullptr;
+  }
+
+  std::weak_ptr<ConnectionPool> pool = shared_from_this();
+  return IConnectionPtr(connection.get(),
+                        [pool, connectionInfo, connection](IConnection *) {
+                          if (auto p = pool.lock())
+                            p->release(connectionInfo, connection);
+                        });
+}
+
+//------------------------------------------------------------------------------
+/**
+  Получить соединение через вложенный пул
+*/
+//---
+IConnectionPtr ConnectionPool::acquireFromParent(
+    const std::string &connectionInfo,
+    std::chrono::steady_clock::time_point deadline) {
+  {
+    std::unique_lock lock(m_mutex);
+    if (!m_released.wait_until(lock, deadline, [this] {
+          return m_acquiredCount < m_maxConnections;
+        }))
+      return nullptr;
+    ++m_acquiredCount;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+      deadline > now ? deadline - now : std::chrono::milliseconds(0));
+  auto lease = m_parent->Acquire(connectionInfo, timeout);
+  if (!lease) {
+    releaseQuota();
+    return nullptr;
+  }
+
+  std::weak_ptr<ConnectionPool> pool = shared_from_this();
+  return IConnectionPtr(lease.get(), [pool, lease](IConnection *) mutable {
+    lease.reset();
+    if (auto p = pool.lock())
+      p->releaseQuota();
+  });
+}
+
+//------------------------------------------------------------------------------
+/**
+  Вернуть соединение в корневой пул
+*/
+//---
+void ConnectionPool::release(const std::string &connectionInfo,
+                             const IConnectionPtr &connection) {
+  bool reusable = connection->IsValid();
+  if (reusable) {
+    // Соединение не должно попасть к следующему владельцу посреди транзакции
+    auto status = connection->RollbackTransaction();
+    reusable = status && !status->HasError();
+  }
+
+  {
+    std::lock_guard lock(m_mutex);
+    --m_acquiredCount;
+    if (reusable)
+      m_idleConnections.emplace(connectionInfo, connection);
+    else
+      --m_openedCount;
+  }
+  m_released.notify_one();
+}
+
+//------------------------------------------------------------------------------
+/**
+  Освободить место во вложенном пуле
+*/
+//---
+void ConnectionPool::releaseQuota() {
+  {
+    std::lock_guard lock(m_mutex);
+    --m_acquiredCount;
+  }
+  m_released.notify_one();
+}
+
+//------------------------------------------------------------------------------
+/**
+  Получить максимальное число соединений
+*/
+//---
+size_t ConnectionPool::GetMaxConnectionsCount() const {
+  return m_maxConnections;
+}
+
+//------------------------------------------------------------------------------
+/**
+  Получить число выданных соединений
+*/
+//---
+size_t ConnectionPool::GetAcquiredConnectionsCount() const {
+  std::lock_guard lock(m_mutex);
+  return m_acquiredCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+  Получить число открытых соединений
+*/
+//---
+size_t ConnectionPool::GetOpenedConnectionsCount() const {
+  std::lock_guard lock(m_mutex);
+  return m_parent ? m_acquiredCount : m_openedCount;
+}
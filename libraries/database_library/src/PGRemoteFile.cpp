@@ -113,6 +113,50 @@ bool PGRemoteFile::Close() {
   return true;
 }
 
+//------------------------------------------------------------------------------
+/**
+  Переместить позицию чтения/записи
+*/
+//---
+bool PGRemoteFile::Seek(size_t position) {
+  if (!m_fd)
+    // Файл не открыт
+    return false;
+
+  auto connection = m_connection.lock();
+  if (!connection || !connection->IsValid())
+    return false;
+
+  return connection->LoLseek64(*m_fd, static_cast<pg_int64>(position),
+                               SEEK_SET) != -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+  Получить размер файла
+*/
+//---
+std::optional<size_t> PGRemoteFile::GetSize() {
+  if (!m_fd)
+    // Файл не открыт
+    return std::nullopt;
+
+  auto connection = m_connection.lock();
+  if (!connection || !connection->IsValid())
+    return std::nullopt;
+
+  pg_int64 position = connection->LoTell64(*m_fd);
+  if (position < 0)
+    return std::nullopt;
+
+  pg_int64 size = connection->LoLseek64(*m_fd, 0, SEEK_END);
+  // Вернем позицию на место в любом случае
+  if (connection->LoLseek64(*m_fd, position, SEEK_SET) == -1 || size < 0)
+    return std::nullopt;
+
+  return static_cast<size_t>(size);
+}
+
 //------------------------------------------------------------------------------
 /**
   Прочитать байты
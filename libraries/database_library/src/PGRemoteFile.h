@@ -44,6 +44,13 @@ public:
   /// Файл, оставшийся открытым в конце транзакции, будет закрыт автоматически
   /// \return Статус выполнения операции
   virtual bool Close() override;
+  /// Переместить позицию чтения/записи
+  /// \param position Смещение от начала файла в байтах
+  /// \return Статус выполнения операции
+  virtual bool Seek(size_t position) override;
+  /// Получить размер файла
+  /// \return Размер файла в байтах или std::nullopt в случае ошибки
+  virtual std::optional<size_t> GetSize() override;
   /// Попытаться прочесть байты
   /// \param buffer Буфер, в который требуется прочитать байты.
   /// \param bytesCount Количество байт, которое требуется попытаться прочесть.
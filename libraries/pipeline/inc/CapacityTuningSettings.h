@@ -0,0 +1,16 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+struct CapacityTuningSettings {
+  size_t minCapacity = 16;
+  size_t maxCapacity = 1 << 20;
+  // memory available for tasks of all tuned connections
+  size_t memoryBudget = 256u << 20;
+  std::chrono::milliseconds period{500};
+  // share of produced tasks which stalled or were overwritten
+  double growThreshold = 0.001;
+  // number of periods with starving consumers before shrinking
+  size_t shrinkPeriodsCount = 8;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "IPipelineStage.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+// Execution of a stage connected to the pipeline: runs step() on an own
+// thread or on the executor, reports exceptions of the stage function and
+// stops the stage. Stages only take and release their tasks.
+class ConnectablePipelineStage : public IPipelineStage {
+ public:
+  ConnectablePipelineStage(const std::string_view stageName);
+
+  // derived stages must call shutdown() in their destructors, while the
+  // tasks they hold can still be released
+  ~ConnectablePipelineStage() override;
+
+  void run() override;
+
+  void shutdown() override;
+
+  bool step() final;
+
+ protected:
+  // throws if the stage cannot be run, e.g. it has been disconnected
+  virtual void checkRunnable() const {}
+
+  // processes a single task, returns false if there was nothing to process;
+  // after an exception the tasks are released with releaseTasksOnError
+  virtual bool processTask() = 0;
+
+  virtual void releaseTasksOnError() = 0;
+
+  // hands back the task kept until the out connection has room for the
+  // result, called when the stage is stopped
+  virtual void releasePendingTask() = 0;
+
+  virtual bool connectionsAreShutdown() const = 0;
+
+ private:
+  std::atomic_bool m_shutdownSignaled;
+  std::thread m_thread;
+  std::weak_ptr<StageExecutor> m_scheduledExecutor;
+};
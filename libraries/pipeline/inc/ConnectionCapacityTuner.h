@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CapacityTuningSettings.h"
+#include "Pipeline.h"
+#include "StageConnection.h"
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class ConnectionCapacityTuner {
+ public:
+  ConnectionCapacityTuner(CapacityTuningSettings settings = {});
+
+  ~ConnectionCapacityTuner();
+
+  void addConnection(const std::string_view id,
+                     std::shared_ptr<StageConnection> connection);
+
+  // out connections of the stage, tuned as the stage id ("<stageId>.<output>"
+  // for a stage routing to several connections) or the name of a stage
+  // without id
+  void addStage(const IPipelineStage& stage);
+
+  void addPipeline(Pipeline& pipeline);
+
+  void run();
+
+  void shutdown();
+
+  void tune();
+
+  std::map<std::string, size_t> getCapacities() const;
+
+  const CapacityTuningSettings& getSettings() const;
+
+ private:
+  struct TunedConnection {
+    std::weak_ptr<StageConnection> connection;
+    size_t idlePeriodsCount = 0;
+  };
+
+  // key of the out connection of the stage, output is the name of the
+  // connection for a stage routing to several connections
+  std::string stageKey(const IPipelineStage& stage,
+                       const std::shared_ptr<StageConnection>& connection,
+                       const std::string& output = {}) const;
+
+  size_t usedMemory() const;
+
+ private:
+  CapacityTuningSettings m_settings;
+  std::map<std::string, TunedConnection> m_connections;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_shutdownCv;
+  bool m_shutdownSignaled;
+  std::thread m_thread;
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+struct ConnectionStatistics {
+  size_t producedCount = 0;
+  // producer had to wait until a task is released by consumers
+  size_t producerWaitsCount = 0;
+  // produced task was overwritten before all consumers took it
+  size_t overwrittenCount = 0;
+  // consumer had to wait until a task is produced
+  size_t consumerWaitsCount = 0;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "StageConnection.h"
+
+#include <cstddef>
+
+// position of a consumer stage in its input connection
+struct ConsumerCursor {
+  const StageConnection* connection;
+  size_t consumerId;
+  size_t lastConsumedTaskId;
+};
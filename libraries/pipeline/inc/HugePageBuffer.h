@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+
+enum class PageKind {
+  // reserved huge pages (hugetlbfs on Linux, large pages on Windows)
+  explicitHuge,
+  // regular mapping the kernel is asked to back with transparent huge pages
+  transparentHuge,
+  regular
+};
+
+// Memory for large connections which is backed by 2 MB pages when the system
+// allows it, so that walking a ring of millions of tasks doesn't thrash the
+// TLB. Explicit huge pages are tried first, then transparent ones, then the
+// buffer silently falls back to regular pages. All memory is touched in the
+// constructor, so using the buffer never page-faults.
+class HugePageBuffer {
+ public:
+  explicit HugePageBuffer(size_t size);
+
+  ~HugePageBuffer();
+
+  HugePageBuffer(const HugePageBuffer&) = delete;
+  HugePageBuffer& operator=(const HugePageBuffer&) = delete;
+
+  void* data() const;
+
+  // may be greater than requested, rounded up to the page size
+  size_t size() const;
+
+  PageKind getPageKind() const;
+
+  static constexpr size_t hugePageSize = 2u << 20;
+
+ private:
+  void prefault();
+
+ private:
+  void* m_data;
+  size_t m_size;
+  PageKind m_pageKind;
+  // start of the mapping when m_data was aligned inside of it
+  void* m_mapping;
+  size_t m_mappingSize;
+};
@@ -1,15 +1,21 @@
 #pragma once
 
+#include "ConsumerCursor.h"
 #include "PipelineStageType.h"
 #include "StageConnection.h"
+#include "StageExecutor.h"
+#include "StageStatistics.h"
 #include "ConsumptionStrategy.h"
 
 #include <any>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <string>
 #include <thread>
+#include <vector>
 
 class IPipelineStage {
  public:
@@ -21,22 +27,84 @@ class IPipelineStage {
 
   virtual void shutdown() = 0;
 
+  // processes a single task, returns false if there was nothing to process
+  virtual bool step() = 0;
+
   std::string getName() const;
 
   void setId(const std::string_view id);
   std::optional<std::string> getId() const;
 
   void setParentId(const std::string_view parentId);
+  // the first parent of a stage with several inputs
   std::optional<std::string> getParentId() const;
 
+  // parents of a stage with several inputs, in the order of its inputs
+  void setParentIds(const std::vector<std::string>& parentIds);
+  std::vector<std::string> getParentIds() const;
+
+  // names of the outputs of a stage with several outputs, in the order of
+  // getOutConnections(); children refer to an output as "<id>.<name>"
+  void setOutputNames(const std::vector<std::string>& outputNames);
+  std::vector<std::string> getOutputNames() const;
+
   virtual PipelineStageType getStageType() const = 0;
 
   virtual std::optional<ConsumptionStrategy> getConsumptionStrategy() const = 0;
 
+  virtual std::shared_ptr<StageConnection> getInConnection() const = 0;
+
+  // all connections the stage consumes from, in the order of its inputs
+  virtual std::vector<std::shared_ptr<StageConnection>> getInConnections()
+      const;
+
+  virtual std::shared_ptr<StageConnection> getOutConnection() const = 0;
+
+  // all connections the stage produces to, in the order of its outputs
+  virtual std::vector<std::shared_ptr<StageConnection>> getOutConnections()
+      const;
+
+  virtual std::optional<ConsumerCursor> getConsumerCursor() const = 0;
+
+  virtual void attachConsumerCursor(const ConsumerCursor&) = 0;
+
+  virtual void disconnect() = 0;
+
+  // stage has nothing more to produce, e.g. its source is exhausted
+  bool isFinished() const;
+
+  void setCpuAffinity(std::optional<size_t> cpu);
+  std::optional<size_t> getCpuAffinity() const;
+
+  StageStatistics getStatistics() const;
+
+  // stage runs in its own thread if no executor is set
+  void setExecutor(std::shared_ptr<StageExecutor> executor,
+                   std::shared_ptr<ExecutorQuota> quota = nullptr);
+  std::shared_ptr<StageExecutor> getExecutor() const;
+  std::shared_ptr<ExecutorQuota> getExecutorQuota() const;
+
+ protected:
+  void finish();
+
+  void taskProcessed(std::chrono::nanoseconds latency);
+  void taskFailed();
+
  protected:
   std::string m_stageName;
 
  private:
   std::optional<std::string> m_id;
-  std::optional<std::string> m_parentId;
+  std::vector<std::string> m_parentIds;
+  std::vector<std::string> m_outputNames;
+  std::optional<size_t> m_cpu;
+  std::shared_ptr<StageExecutor> m_executor;
+  std::shared_ptr<ExecutorQuota> m_executorQuota;
+
+  std::atomic_bool m_finished;
+  std::atomic<size_t> m_processedCount;
+  std::atomic<size_t> m_failedCount;
+  std::atomic<int64_t> m_totalLatencyNs;
+  std::atomic<int64_t> m_maxLatencyNs;
+  std::array<std::atomic<size_t>, 64> m_latencyHistogram;
 };
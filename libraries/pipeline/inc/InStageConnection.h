@@ -13,11 +13,24 @@ class InStageConnection : public virtual StageConnection {
  public:
   virtual size_t connectConsumer() = 0;
 
+  virtual void disconnectConsumer(size_t consumerId) = 0;
+
+  virtual void transferConsumer(size_t fromConsumerId, size_t toConsumerId) = 0;
+
   virtual std::shared_ptr<StageTask<T>> getConsumerTask(
       size_t consumerId,
       ConsumptionStrategy strategy,
       size_t minTaskId) = 0;
 
+  // like getConsumerTask, but returns immediately if there is no task to
+  // consume, so that a stage can poll several connections
+  virtual std::shared_ptr<StageTask<T>> tryGetConsumerTask(
+      size_t consumerId,
+      ConsumptionStrategy strategy,
+      size_t minTaskId) = 0;
+
+  // a task which is not consumed is handed back to the consumer and can be
+  // taken again
   virtual void taskConsumed(std::shared_ptr<T> taskData,
                             size_t consumerId,
                             bool consumed = true) = 0;
@@ -0,0 +1,359 @@
+#pragma once
+
+#include "ConnectablePipelineStage.h"
+#include "ConsumptionStrategy.h"
+#include "InStageConnection.h"
+#include "OutStageConnection.h"
+#include "PendingTask.h"
+#include "PipelineException.h"
+
+#include <optional>
+#include <vector>
+
+// Stage consuming tasks of the same type from several connections, e.g.
+// streams of different sensors combined into one. Every step takes one task
+// from one of the inputs: inputs are polled in turn starting after the one
+// used last, so a busy input cannot starve the others. If no input has a
+// task, the stage waits on the next input in turn, so while idle a task of
+// another input may wait up to the connection wait period.
+template <typename In, typename Out>
+class MultiInputStage : public ConnectablePipelineStage {
+ public:
+  MultiInputStage(
+      const std::string_view stageName,
+      ConsumptionStrategy consumptionStrategy,
+      const std::vector<std::shared_ptr<InStageConnection<In>>>&
+          inConnections,
+      std::shared_ptr<OutStageConnection<Out>> outConnection);
+
+  ~MultiInputStage() override;
+
+  PipelineStageType getStageType() const override;
+
+  std::optional<ConsumptionStrategy> getConsumptionStrategy() const override;
+
+  // the first input
+  std::shared_ptr<StageConnection> getInConnection() const override;
+
+  std::vector<std::shared_ptr<StageConnection>> getInConnections()
+      const override;
+
+  std::shared_ptr<StageConnection> getOutConnection() const override;
+
+  // consumer cursors belong to a single connection, so they are not
+  // supported and replaced stages start from the newest tasks
+  std::optional<ConsumerCursor> getConsumerCursor() const override;
+
+  void attachConsumerCursor(const ConsumerCursor& cursor) override;
+
+  void disconnect() override;
+
+ protected:
+  // processes a task of the input with the given index, both tasks must be
+  // released with dataConsumed and dataProduced
+  virtual void consumeAndProduce(size_t input,
+                                 std::shared_ptr<In> inData,
+                                 std::shared_ptr<Out> outData) = 0;
+
+  // whether the stage can take a task of the input now; stages buffering
+  // values per input leave tasks in the connection while their buffer is
+  // full
+  virtual bool acceptsInput(size_t) const { return true; }
+
+  // called when no input arrived within the connection wait period
+  virtual void onIdle() {}
+
+  size_t getInputsCount() const;
+
+  void dataConsumed(size_t input,
+                    std::shared_ptr<In> taskData,
+                    bool consumed = true);
+
+  void dataProduced(std::shared_ptr<Out> taskData, bool produced = true);
+
+  void checkRunnable() const override;
+
+  bool processTask() override;
+
+  void releaseTasksOnError() override;
+
+  void releasePendingTask() override;
+
+  bool connectionsAreShutdown() const override;
+
+ private:
+  struct Input {
+    std::weak_ptr<InStageConnection<In>> connection;
+    std::optional<size_t> consumerId;
+    size_t lastConsumedTaskId = 0;
+  };
+
+  std::shared_ptr<In> getConsumptionData(size_t input, bool wait);
+
+  std::shared_ptr<Out> getProductionData();
+
+ private:
+  PendingTask<std::shared_ptr<In>, std::shared_ptr<Out>> m_pending;
+  // input the pending task was taken from
+  size_t m_pendingInput;
+  // input polled first by the next step
+  size_t m_nextInput;
+
+  ConsumptionStrategy m_consumptionStrategy;
+  std::vector<Input> m_inputs;
+  size_t m_lastProducedTaskId;
+
+  std::weak_ptr<OutStageConnection<Out>> m_outConnection;
+};
+
+template <typename In, typename Out>
+MultiInputStage<In, Out>::MultiInputStage(
+    const std::string_view stageName,
+    ConsumptionStrategy consumptionStrategy,
+    const std::vector<std::shared_ptr<InStageConnection<In>>>& inConnections,
+    std::shared_ptr<OutStageConnection<Out>> outConnection)
+    : ConnectablePipelineStage(stageName),
+      m_pendingInput{0},
+      m_nextInput{0},
+      m_consumptionStrategy(consumptionStrategy),
+      m_lastProducedTaskId{0},
+      m_outConnection(outConnection) {
+  if (inConnections.empty())
+    throw std::invalid_argument("inConnections are empty");
+
+  if (!outConnection)
+    throw std::invalid_argument("outConnection is null");
+
+  for (const auto& connection : inConnections) {
+    if (!connection)
+      throw std::invalid_argument("inConnection is null");
+
+    for (const auto& input : m_inputs) {
+      if (input.connection.lock() == connection)
+        throw std::invalid_argument("inConnection is used twice");
+    }
+
+    Input input;
+    input.connection = connection;
+    m_inputs.push_back(input);
+  }
+
+  for (auto& input : m_inputs)
+    input.consumerId = input.connection.lock()->connectConsumer();
+}
+
+template <typename In, typename Out>
+MultiInputStage<In, Out>::~MultiInputStage() {
+  shutdown();
+}
+
+template <typename In, typename Out>
+void MultiInputStage<In, Out>::checkRunnable() const {
+  for (const auto& input : m_inputs) {
+    if (!input.consumerId.has_value())
+      throw PipelineException(std::string("consumerId is null"));
+  }
+}
+
+template <typename In, typename Out>
+bool MultiInputStage<In, Out>::processTask() {
+  if (!m_pending.inData) {
+    for (size_t i = 0; i < m_inputs.size() && !m_pending.inData; ++i) {
+      auto input = (m_nextInput + i) % m_inputs.size();
+      if (!acceptsInput(input))
+        continue;
+
+      m_pending.inData = getConsumptionData(input, false);
+      m_pendingInput = input;
+    }
+
+    // nothing to take right now, wait for the next input in turn
+    for (size_t i = 0; i < m_inputs.size() && !m_pending.inData; ++i) {
+      auto input = m_nextInput;
+      m_nextInput = (m_nextInput + 1) % m_inputs.size();
+      if (!acceptsInput(input))
+        continue;
+
+      m_pending.inData = getConsumptionData(input, true);
+      m_pendingInput = input;
+      break;
+    }
+
+    if (!m_pending.inData) {
+      onIdle();
+      return false;
+    }
+    m_nextInput = (m_pendingInput + 1) % m_inputs.size();
+  }
+
+  m_pending.outData = getProductionData();
+  if (!m_pending.outData)
+    return false;
+
+  auto started = std::chrono::steady_clock::now();
+  consumeAndProduce(m_pendingInput, m_pending.inData, m_pending.outData);
+  taskProcessed(std::chrono::steady_clock::now() - started);
+
+  m_pending.inData = nullptr;
+  m_pending.outData = nullptr;
+  return true;
+}
+
+template <typename In, typename Out>
+void MultiInputStage<In, Out>::releasePendingTask() {
+  if (!m_pending.inData)
+    return;
+
+  auto& in = m_inputs[m_pendingInput];
+  auto inData = m_pending.handBack(in.lastConsumedTaskId);
+  if (!in.connection.expired() && in.consumerId.has_value())
+    dataConsumed(m_pendingInput, inData, false);
+}
+
+template <typename In, typename Out>
+PipelineStageType MultiInputStage<In, Out>::getStageType() const {
+  return PipelineStageType::producerConsumer;
+}
+
+template <typename In, typename Out>
+std::optional<ConsumptionStrategy>
+MultiInputStage<In, Out>::getConsumptionStrategy() const {
+  return m_consumptionStrategy;
+}
+
+template <typename In, typename Out>
+std::shared_ptr<StageConnection> MultiInputStage<In, Out>::getInConnection()
+    const {
+  return m_inputs.front().connection.lock();
+}
+
+template <typename In, typename Out>
+std::vector<std::shared_ptr<StageConnection>>
+MultiInputStage<In, Out>::getInConnections() const {
+  std::vector<std::shared_ptr<StageConnection>> connections;
+  for (const auto& input : m_inputs) {
+    if (auto connection = input.connection.lock(); connection != nullptr)
+      connections.push_back(connection);
+  }
+  return connections;
+}
+
+template <typename In, typename Out>
+std::shared_ptr<StageConnection> MultiInputStage<In, Out>::getOutConnection()
+    const {
+  return m_outConnection.lock();
+}
+
+template <typename In, typename Out>
+std::optional<ConsumerCursor> MultiInputStage<In, Out>::getConsumerCursor()
+    const {
+  return std::nullopt;
+}
+
+template <typename In, typename Out>
+void MultiInputStage<In, Out>::attachConsumerCursor(const ConsumerCursor&) {
+  throw PipelineException("multi-input stage cannot attach consumer cursor");
+}
+
+template <typename In, typename Out>
+void MultiInputStage<In, Out>::disconnect() {
+  for (auto& input : m_inputs) {
+    if (auto in = input.connection.lock();
+        in != nullptr && input.consumerId.has_value()) {
+      in->disconnectConsumer(input.consumerId.value());
+      input.consumerId = std::nullopt;
+    }
+  }
+}
+
+template <typename In, typename Out>
+size_t MultiInputStage<In, Out>::getInputsCount() const {
+  return m_inputs.size();
+}
+
+template <typename In, typename Out>
+std::shared_ptr<In> MultiInputStage<In, Out>::getConsumptionData(size_t input,
+                                                                 bool wait) {
+  auto& in = m_inputs[input];
+  auto connection = in.connection.lock();
+  if (connection == nullptr)
+    return nullptr;
+
+  auto inTask =
+      wait ? connection->getConsumerTask(in.consumerId.value(),
+                                         m_consumptionStrategy,
+                                         in.lastConsumedTaskId)
+           : connection->tryGetConsumerTask(in.consumerId.value(),
+                                            m_consumptionStrategy,
+                                            in.lastConsumedTaskId);
+  if (!inTask)
+    return nullptr;
+
+  m_pending.taken(in.lastConsumedTaskId, inTask->taskId);
+  return inTask->data;
+}
+
+template <typename In, typename Out>
+void MultiInputStage<In, Out>::dataConsumed(size_t input,
+                                            std::shared_ptr<In> taskData,
+                                            bool consumed) {
+  if (!taskData)
+    throw std::invalid_argument("taskData is null");
+
+  auto& in = m_inputs.at(input);
+  if (auto connection = in.connection.lock(); connection != nullptr)
+    connection->taskConsumed(taskData, in.consumerId.value(), consumed);
+  else
+    throw PipelineException("inConnection expired");
+}
+
+template <typename In, typename Out>
+std::shared_ptr<Out> MultiInputStage<In, Out>::getProductionData() {
+  auto out = m_outConnection.lock();
+  if (out == nullptr)
+    throw PipelineException("m_outConnection expired");
+
+  auto outTask = out->getProducerTask();
+  if (!outTask)
+    return nullptr;
+
+  return outTask->data;
+}
+
+template <typename In, typename Out>
+void MultiInputStage<In, Out>::dataProduced(std::shared_ptr<Out> taskData,
+                                            bool produced) {
+  if (!taskData)
+    throw std::invalid_argument("taskData is null");
+
+  if (auto out = m_outConnection.lock(); out != nullptr)
+    out->taskProduced(taskData, ++m_lastProducedTaskId, produced);
+  else
+    throw PipelineException("m_outConnection expired");
+}
+
+template <typename In, typename Out>
+void MultiInputStage<In, Out>::releaseTasksOnError() {
+  auto inData = std::move(m_pending.inData);
+  auto outData = std::move(m_pending.outData);
+
+  if (inData)
+    dataConsumed(m_pendingInput, inData, false);
+
+  if (outData && !m_outConnection.expired())
+    dataProduced(outData, false);
+}
+
+template <typename In, typename Out>
+bool MultiInputStage<In, Out>::connectionsAreShutdown() const {
+  if (auto out = m_outConnection.lock(); out != nullptr && out->isShutdown())
+    return true;
+
+  for (const auto& input : m_inputs) {
+    auto in = input.connection.lock();
+    if (in != nullptr && in->isShutdown())
+      return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,335 @@
+#pragma once
+
+#include "ConnectablePipelineStage.h"
+#include "ConsumptionStrategy.h"
+#include "InStageConnection.h"
+#include "OutStageConnection.h"
+#include "PendingTask.h"
+#include "PipelineException.h"
+
+#include <optional>
+#include <vector>
+
+// Stage routing every task unchanged to one of several connections, so a
+// downstream branch receives (and pays for) only its share of the stream
+// instead of filtering all of it. The output is chosen by route(); while
+// the chosen output is full the task waits and the whole stage stalls, as
+// a single-output stage does.
+template <typename T>
+class MultiOutputStage : public ConnectablePipelineStage {
+ public:
+  MultiOutputStage(
+      const std::string_view stageName,
+      ConsumptionStrategy consumptionStrategy,
+      std::shared_ptr<InStageConnection<T>> inConnection,
+      const std::vector<std::shared_ptr<OutStageConnection<T>>>&
+          outConnections);
+
+  ~MultiOutputStage() override;
+
+  PipelineStageType getStageType() const override;
+
+  std::optional<ConsumptionStrategy> getConsumptionStrategy() const override;
+
+  std::shared_ptr<StageConnection> getInConnection() const override;
+
+  // the first output
+  std::shared_ptr<StageConnection> getOutConnection() const override;
+
+  std::vector<std::shared_ptr<StageConnection>> getOutConnections()
+      const override;
+
+  std::optional<ConsumerCursor> getConsumerCursor() const override;
+
+  void attachConsumerCursor(const ConsumerCursor& cursor) override;
+
+  void disconnect() override;
+
+  // tasks route() sent to no output
+  size_t getDroppedCount() const;
+
+ protected:
+  // index of the output the task goes to, getOutputsCount() or more drops
+  // the task
+  virtual size_t route(const T& data) = 0;
+
+  size_t getOutputsCount() const;
+
+  void checkRunnable() const override;
+
+  bool processTask() override;
+
+  void releaseTasksOnError() override;
+
+  void releasePendingTask() override;
+
+  bool connectionsAreShutdown() const override;
+
+ private:
+  struct Output {
+    std::weak_ptr<OutStageConnection<T>> connection;
+    size_t lastProducedTaskId = 0;
+  };
+
+  std::shared_ptr<T> getConsumptionData();
+
+  void dataConsumed(std::shared_ptr<T> taskData, bool consumed = true);
+
+  std::shared_ptr<T> getProductionData(size_t output);
+
+  void dataProduced(size_t output,
+                    std::shared_ptr<T> taskData,
+                    bool produced = true);
+
+ private:
+  // the consumed task is kept until its output has room for it
+  PendingTask<std::shared_ptr<T>, std::shared_ptr<T>> m_pending;
+  // output route() chose for the pending task
+  size_t m_pendingOutput;
+
+  ConsumptionStrategy m_consumptionStrategy;
+  std::optional<size_t> m_consumerId;
+  size_t m_lastConsumedTaskId;
+  std::atomic<size_t> m_droppedCount;
+
+  std::weak_ptr<InStageConnection<T>> m_inConnection;
+  std::vector<Output> m_outputs;
+};
+
+template <typename T>
+MultiOutputStage<T>::MultiOutputStage(
+    const std::string_view stageName,
+    ConsumptionStrategy consumptionStrategy,
+    std::shared_ptr<InStageConnection<T>> inConnection,
+    const std::vector<std::shared_ptr<OutStageConnection<T>>>&
+        outConnections)
+    : ConnectablePipelineStage(stageName),
+      m_pendingOutput{0},
+      m_consumptionStrategy(consumptionStrategy),
+      m_lastConsumedTaskId{0},
+      m_droppedCount{0},
+      m_inConnection(inConnection) {
+  if (!inConnection)
+    throw std::invalid_argument("inConnection is null");
+
+  if (outConnections.empty())
+    throw std::invalid_argument("outConnections are empty");
+
+  for (const auto& connection : outConnections) {
+    if (!connection)
+      throw std::invalid_argument("outConnection is null");
+
+    for (const auto& output : m_outputs) {
+      if (output.connection.lock() == connection)
+        throw std::invalid_argument("outConnection is used twice");
+    }
+
+    Output output;
+    output.connection = connection;
+    m_outputs.push_back(output);
+  }
+
+  m_consumerId = inConnection->connectConsumer();
+}
+
+template <typename T>
+MultiOutputStage<T>::~MultiOutputStage() {
+  shutdown();
+}
+
+template <typename T>
+void MultiOutputStage<T>::checkRunnable() const {
+  if (!m_consumerId.has_value())
+    throw PipelineException(std::string("consumerId is null"));
+}
+
+template <typename T>
+bool MultiOutputStage<T>::processTask() {
+  auto started = std::chrono::steady_clock::now();
+  if (!m_pending.inData) {
+    m_pending.inData = getConsumptionData();
+    if (!m_pending.inData)
+      return false;
+
+    m_pendingOutput = route(*m_pending.inData);
+    if (m_pendingOutput >= m_outputs.size()) {
+      dataConsumed(m_pending.inData);
+      m_pending.inData = nullptr;
+      ++m_droppedCount;
+      taskProcessed(std::chrono::steady_clock::now() - started);
+      return true;
+    }
+  }
+
+  m_pending.outData = getProductionData(m_pendingOutput);
+  if (!m_pending.outData)
+    return false;
+
+  *m_pending.outData = *m_pending.inData;
+  dataConsumed(m_pending.inData);
+  m_pending.inData = nullptr;
+  dataProduced(m_pendingOutput, m_pending.outData);
+  m_pending.outData = nullptr;
+  taskProcessed(std::chrono::steady_clock::now() - started);
+  return true;
+}
+
+template <typename T>
+void MultiOutputStage<T>::releaseTasksOnError() {
+  auto inData = std::move(m_pending.inData);
+  auto outData = std::move(m_pending.outData);
+
+  if (inData)
+    dataConsumed(inData, false);
+  if (outData)
+    dataProduced(m_pendingOutput, outData, false);
+}
+
+template <typename T>
+void MultiOutputStage<T>::releasePendingTask() {
+  // the task waiting for room in its output is handed back, so that a stage
+  // replacing this one routes it
+  if (!m_pending.inData)
+    return;
+
+  auto inData = m_pending.handBack(m_lastConsumedTaskId);
+  if (!m_inConnection.expired() && m_consumerId.has_value())
+    dataConsumed(inData, false);
+}
+
+template <typename T>
+PipelineStageType MultiOutputStage<T>::getStageType() const {
+  return PipelineStageType::producerConsumer;
+}
+
+template <typename T>
+std::optional<ConsumptionStrategy>
+MultiOutputStage<T>::getConsumptionStrategy() const {
+  return m_consumptionStrategy;
+}
+
+template <typename T>
+std::shared_ptr<StageConnection> MultiOutputStage<T>::getInConnection()
+    const {
+  return m_inConnection.lock();
+}
+
+template <typename T>
+std::shared_ptr<StageConnection> MultiOutputStage<T>::getOutConnection()
+    const {
+  return m_outputs.front().connection.lock();
+}
+
+template <typename T>
+std::vector<std::shared_ptr<StageConnection>>
+MultiOutputStage<T>::getOutConnections() const {
+  std::vector<std::shared_ptr<StageConnection>> connections;
+  for (const auto& output : m_outputs) {
+    if (auto connection = output.connection.lock(); connection != nullptr)
+      connections.push_back(connection);
+  }
+  return connections;
+}
+
+template <typename T>
+std::optional<ConsumerCursor> MultiOutputStage<T>::getConsumerCursor() const {
+  auto in = m_inConnection.lock();
+  if (in == nullptr || !m_consumerId.has_value())
+    return std::nullopt;
+
+  return ConsumerCursor{in.get(), m_consumerId.value(), m_lastConsumedTaskId};
+}
+
+template <typename T>
+void MultiOutputStage<T>::attachConsumerCursor(const ConsumerCursor& cursor) {
+  auto in = m_inConnection.lock();
+  if (in == nullptr)
+    throw PipelineException("m_inConnection expired");
+
+  if (cursor.connection != in.get())
+    throw PipelineException("cursor belongs to another connection");
+
+  in->transferConsumer(cursor.consumerId, m_consumerId.value());
+  m_lastConsumedTaskId = cursor.lastConsumedTaskId;
+}
+
+template <typename T>
+void MultiOutputStage<T>::disconnect() {
+  if (auto in = m_inConnection.lock();
+      in != nullptr && m_consumerId.has_value()) {
+    in->disconnectConsumer(m_consumerId.value());
+    m_consumerId = std::nullopt;
+  }
+}
+
+template <typename T>
+size_t MultiOutputStage<T>::getDroppedCount() const {
+  return m_droppedCount;
+}
+
+template <typename T>
+size_t MultiOutputStage<T>::getOutputsCount() const {
+  return m_outputs.size();
+}
+
+template <typename T>
+std::shared_ptr<T> MultiOutputStage<T>::getConsumptionData() {
+  auto in = m_inConnection.lock();
+  if (in == nullptr)
+    return nullptr;
+
+  auto inTask = in->getConsumerTask(
+      m_consumerId.value(), m_consumptionStrategy, m_lastConsumedTaskId);
+  if (!inTask)
+    return nullptr;
+
+  m_pending.taken(m_lastConsumedTaskId, inTask->taskId);
+  return inTask->data;
+}
+
+template <typename T>
+void MultiOutputStage<T>::dataConsumed(std::shared_ptr<T> taskData,
+                                       bool consumed) {
+  if (auto in = m_inConnection.lock(); in != nullptr)
+    in->taskConsumed(taskData, m_consumerId.value(), consumed);
+  else
+    throw PipelineException("m_inConnection expired");
+}
+
+template <typename T>
+std::shared_ptr<T> MultiOutputStage<T>::getProductionData(size_t output) {
+  auto out = m_outputs[output].connection.lock();
+  if (out == nullptr)
+    throw PipelineException("outConnection expired");
+
+  auto outTask = out->getProducerTask();
+  if (!outTask)
+    return nullptr;
+
+  return outTask->data;
+}
+
+template <typename T>
+void MultiOutputStage<T>::dataProduced(size_t output,
+                                       std::shared_ptr<T> taskData,
+                                       bool produced) {
+  auto& out = m_outputs[output];
+  if (auto connection = out.connection.lock(); connection != nullptr)
+    connection->taskProduced(taskData, ++out.lastProducedTaskId, produced);
+  else
+    throw PipelineException("outConnection expired");
+}
+
+template <typename T>
+bool MultiOutputStage<T>::connectionsAreShutdown() const {
+  if (auto in = m_inConnection.lock(); in != nullptr && in->isShutdown())
+    return true;
+
+  for (const auto& output : m_outputs) {
+    auto out = output.connection.lock();
+    if (out != nullptr && out->isShutdown())
+      return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+// Tasks of the current step of a stage. The consumed task is kept until the
+// out connection has room for the result; when the stage is stopped it is
+// handed back and the consumer cursor is moved before it, so that a stage
+// replacing this one consumes it.
+template <typename InData, typename OutData>
+struct PendingTask {
+  // consumed task which is kept until the out connection has room for result
+  InData inData{};
+  // task being produced by the current step
+  OutData outData{};
+
+  // moves the consumer cursor to the task taken from the connection
+  void taken(size_t& lastConsumedTaskId, size_t taskId) {
+    m_previousConsumedTaskId = lastConsumedTaskId;
+    lastConsumedTaskId = taskId;
+  }
+
+  // forgets the consumed task and moves the cursor back before it, the
+  // returned task must be released as not consumed
+  InData handBack(size_t& lastConsumedTaskId) {
+    lastConsumedTaskId = m_previousConsumedTaskId;
+    return std::exchange(inData, InData{});
+  }
+
+ private:
+  // id of the task consumed before the pending one
+  size_t m_previousConsumedTaskId = 0;
+};
@@ -1,10 +1,17 @@
 #pragma once
 
+#include "CapacityTuningSettings.h"
 #include "IPipelineStage.h"
 #include "StageConnection.h"
+#include "StageExecutor.h"
 
+#include <memory>
+#include <optional>
+#include <string_view>
 #include <vector>
 
+class ConnectionCapacityTuner;
+
 class Pipeline {
  public:
   Pipeline();
@@ -15,8 +22,27 @@ class Pipeline {
 
   void shutdown();
 
+  // all producer stages are finished, so no new data will appear
+  bool producersFinished() const;
+
+  // stages are run by the executor instead of their own threads, applies to
+  // stages started after the call
+  void setExecutor(std::shared_ptr<StageExecutor> executor,
+                   std::shared_ptr<ExecutorQuota> quota = nullptr);
+
+  // out connections of the stages are resized by ConnectionCapacityTuner
+  // while the pipeline runs, nullopt keeps their capacities fixed
+  void setCapacityTuning(std::optional<CapacityTuningSettings> settings);
+
+  std::optional<CapacityTuningSettings> getCapacityTuning() const;
+
   void addStage(std::shared_ptr<IPipelineStage>);
 
+  void replaceStage(std::shared_ptr<IPipelineStage> stage,
+                    std::shared_ptr<IPipelineStage> newStage);
+
+  void removeStage(std::shared_ptr<IPipelineStage>);
+
   void addConnection(std::shared_ptr<StageConnection>);
 
   const std::vector<std::shared_ptr<IPipelineStage>>& getStages();
@@ -25,9 +51,15 @@ class Pipeline {
 
   std::shared_ptr<IPipelineStage> getStage(const std::string_view);
 
-  std::shared_ptr<StageConnection> getConnectionForStage(const std::string_view) { return nullptr; }
+  std::shared_ptr<IPipelineStage> getStageById(const std::string_view);
+
+  std::shared_ptr<StageConnection> getConnectionForStage(const std::string_view);
 
  private:
   std::vector<std::shared_ptr<IPipelineStage>> m_stages;
   std::vector<std::shared_ptr<StageConnection>> m_connections;
+  std::shared_ptr<StageExecutor> m_executor;
+  std::shared_ptr<ExecutorQuota> m_executorQuota;
+  std::unique_ptr<ConnectionCapacityTuner> m_capacityTuner;
+  bool m_running;
 };
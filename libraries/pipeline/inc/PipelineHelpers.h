@@ -3,6 +3,7 @@
 #include "PipelineStageType.h"
 #include "ConsumptionStrategy.h"
 
+#include <cstddef>
 #include <string_view>
 
 namespace PipelineHelpers {
@@ -11,4 +12,7 @@ std::string toString(PipelineStageType);
 
 ConsumptionStrategy strategyFromString(const std::string_view);
 std::string toString(ConsumptionStrategy);
+
+// returns false if the platform doesn't support pinning or cpu is invalid
+bool pinCurrentThread(size_t cpu);
 }  // namespace PipelineHelpers
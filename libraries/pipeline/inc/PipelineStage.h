@@ -1,17 +1,17 @@
 #pragma once
 
+#include "ConnectablePipelineStage.h"
 #include "ConsumptionStrategy.h"
-#include "IPipelineStage.h"
 #include "InStageConnection.h"
 #include "OutStageConnection.h"
+#include "PendingTask.h"
 #include "PipelineException.h"
 #include "SteadyClock.h"
 
-#include <iostream>
 #include <optional>
 
 template <typename In, typename Out>
-class PipelineStage : public IPipelineStage {
+class PipelineStage : public ConnectablePipelineStage {
  public:
   PipelineStage(const std::string_view stageName,
                 std::optional<ConsumptionStrategy>,
@@ -20,18 +20,28 @@ class PipelineStage : public IPipelineStage {
 
   ~PipelineStage() override;
 
-  void run() override;
-
-  void shutdown() override;
-
   PipelineStageType getStageType() const override;
 
   std::optional<ConsumptionStrategy> getConsumptionStrategy() const override;
 
+  std::shared_ptr<StageConnection> getInConnection() const override;
+
+  std::shared_ptr<StageConnection> getOutConnection() const override;
+
+  std::optional<ConsumerCursor> getConsumerCursor() const override;
+
+  void attachConsumerCursor(const ConsumerCursor& cursor) override;
+
+  void disconnect() override;
+
  protected:
   virtual void consumeAndProduce(std::shared_ptr<In> inData,
                                  std::shared_ptr<Out> outData) = 0;
 
+  // called when no input arrived within the connection wait period, lets
+  // stages flush partially accumulated work
+  virtual void onIdle() {}
+
   std::shared_ptr<In> getConsumptionData();
   void dataConsumed(std::shared_ptr<In> taskData, bool consumed = true);
 
@@ -40,21 +50,23 @@ class PipelineStage : public IPipelineStage {
 
   void setConsumerId(size_t consumerId);
 
- private:
-  void releaseTasksOnError(std::shared_ptr<In> inData,
-                           std::shared_ptr<Out> outData);
+  void checkRunnable() const override;
 
-  bool inConnectionIsShutdown() const;
+  bool processTask() override;
 
-  bool outConnectionIsShutdown() const;
+  void releaseTasksOnError() override;
+
+  void releasePendingTask() override;
+
+  bool connectionsAreShutdown() const override;
 
  private:
-  std::atomic_bool m_shutdownSignaled;
-  std::thread m_thread;
+  PendingTask<std::shared_ptr<In>, std::shared_ptr<Out>> m_pending;
 
   std::optional<ConsumptionStrategy> m_consumptionStrategy;
   std::optional<size_t> m_consumerId;
   size_t m_lastConusmedTaskId;
+  size_t m_lastProducedTaskId;
 
   std::weak_ptr<InStageConnection<In>> m_inConnection;
   std::weak_ptr<OutStageConnection<Out>> m_outConnection;
@@ -66,13 +78,13 @@ PipelineStage<In, Out>::PipelineStage(
     std::optional<ConsumptionStrategy> consumptionStrategy,
     std::weak_ptr<InStageConnection<In>> inConnection,
     std::weak_ptr<OutStageConnection<Out>> outConnection)
-    : IPipelineStage(stageName),
-      m_shutdownSignaled{false},
+    : ConnectablePipelineStage(stageName),
       m_consumptionStrategy(consumptionStrategy),
       m_consumerId(std::nullopt),
+      m_lastConusmedTaskId{0},
+      m_lastProducedTaskId{0},
       m_inConnection(inConnection),
-      m_outConnection(outConnection),
-      m_lastConusmedTaskId{0} {
+      m_outConnection(outConnection) {
   if (!inConnection.expired() && !consumptionStrategy.has_value())
     throw std::invalid_argument("consumerStrategy is null");
 
@@ -90,44 +102,44 @@ PipelineStage<In, Out>::~PipelineStage() {
 }
 
 template <typename In, typename Out>
-void PipelineStage<In, Out>::run() {
+void PipelineStage<In, Out>::checkRunnable() const {
   if (!m_inConnection.expired() && !m_consumerId.has_value())
     throw PipelineException(std::string("consumerId is null"));
+}
 
-  m_thread = std::thread([this] {
-    while (!m_shutdownSignaled) {
-      std::shared_ptr<In> inData;
-      std::shared_ptr<Out> outData;
-      try {
-        inData = getConsumptionData();
-        outData = getProductionData();
-
-        if (!inData && inConnectionIsShutdown())
-          break;
-        else if (!outData && outConnectionIsShutdown())
-          break;
-        consumeAndProduce(inData, outData);
-
-        inData = nullptr;
-        outData = nullptr;
-      } catch (std::exception& ex) {
-        std::cerr << "ConnectablePipelineStage: " << ex.what() << std::endl;
-      } catch (...) {
-        std::cerr << "ConnectablePipelineStage: "
-                  << "unhandled exception in stage function" << std::endl;
-      }
-
-      releaseTasksOnError(inData, outData);
+template <typename In, typename Out>
+bool PipelineStage<In, Out>::processTask() {
+  if (!m_pending.inData) {
+    m_pending.inData = getConsumptionData();
+    if (!m_pending.inData && !m_inConnection.expired()) {
+      onIdle();
+      return false;
     }
-  });
+  }
+
+  m_pending.outData = getProductionData();
+  if (!m_pending.outData && !m_outConnection.expired())
+    return false;
+
+  auto started = std::chrono::steady_clock::now();
+  consumeAndProduce(m_pending.inData, m_pending.outData);
+  taskProcessed(std::chrono::steady_clock::now() - started);
+
+  m_pending.inData = nullptr;
+  m_pending.outData = nullptr;
+  return true;
 }
 
 template <typename In, typename Out>
-void PipelineStage<In, Out>::shutdown() {
-  m_shutdownSignaled = true;
-
-  if (m_thread.joinable())
-    m_thread.join();
+void PipelineStage<In, Out>::releasePendingTask() {
+  // the task waiting for room in the out connection is handed back, so that
+  // a stage replacing this one consumes it
+  if (!m_pending.inData)
+    return;
+
+  auto inData = m_pending.handBack(m_lastConusmedTaskId);
+  if (!m_inConnection.expired() && m_consumerId.has_value())
+    dataConsumed(inData, false);
 }
 
 template <typename In, typename Out>
@@ -148,6 +160,51 @@ PipelineStage<In, Out>::getConsumptionStrategy() const {
   return m_consumptionStrategy;
 }
 
+template <typename In, typename Out>
+std::shared_ptr<StageConnection> PipelineStage<In, Out>::getInConnection()
+    const {
+  return m_inConnection.lock();
+}
+
+template <typename In, typename Out>
+std::shared_ptr<StageConnection> PipelineStage<In, Out>::getOutConnection()
+    const {
+  return m_outConnection.lock();
+}
+
+template <typename In, typename Out>
+std::optional<ConsumerCursor> PipelineStage<In, Out>::getConsumerCursor()
+    const {
+  auto in = m_inConnection.lock();
+  if (in == nullptr || !m_consumerId.has_value())
+    return std::nullopt;
+
+  return ConsumerCursor{in.get(), m_consumerId.value(), m_lastConusmedTaskId};
+}
+
+template <typename In, typename Out>
+void PipelineStage<In, Out>::attachConsumerCursor(
+    const ConsumerCursor& cursor) {
+  auto in = m_inConnection.lock();
+  if (in == nullptr)
+    throw PipelineException("m_inConnection expired");
+
+  if (cursor.connection != in.get())
+    throw PipelineException("cursor belongs to another connection");
+
+  in->transferConsumer(cursor.consumerId, m_consumerId.value());
+  m_lastConusmedTaskId = cursor.lastConsumedTaskId;
+}
+
+template <typename In, typename Out>
+void PipelineStage<In, Out>::disconnect() {
+  if (auto in = m_inConnection.lock();
+      in != nullptr && m_consumerId.has_value()) {
+    in->disconnectConsumer(m_consumerId.value());
+    m_consumerId = std::nullopt;
+  }
+}
+
 template <typename In, typename Out>
 void PipelineStage<In, Out>::setConsumerId(size_t consumerId) {
   if (m_inConnection.expired())
@@ -166,7 +223,7 @@ std::shared_ptr<In> PipelineStage<In, Out>::getConsumptionData() {
     if (!inTask)
       return nullptr;
 
-    m_lastConusmedTaskId = inTask->taskId;
+    m_pending.taken(m_lastConusmedTaskId, inTask->taskId);
     inData = inTask->data;
   }
 
@@ -206,17 +263,17 @@ void PipelineStage<In, Out>::dataProduced(
   if (!taskData)
     throw std::invalid_argument("taskData is null");
 
-  static size_t taskId = 1;
-
   if (auto out = m_outConnection.lock(); out != nullptr)
-    out->taskProduced(taskData, taskId++, produced);
+    out->taskProduced(taskData, ++m_lastProducedTaskId, produced);
   else
     throw PipelineException("m_outConnection expired");
 }
 
 template <typename In, typename Out>
-void PipelineStage<In, Out>::releaseTasksOnError(std::shared_ptr<In> inData,
-                                                 std::shared_ptr<Out> outData) {
+void PipelineStage<In, Out>::releaseTasksOnError() {
+  auto inData = std::move(m_pending.inData);
+  auto outData = std::move(m_pending.outData);
+
   if (inData && !m_inConnection.expired())
     dataConsumed(inData, false);
 
@@ -225,16 +282,11 @@ void PipelineStage<In, Out>::releaseTasksOnError(std::shared_ptr<In> inData,
 }
 
 template <typename In, typename Out>
-bool PipelineStage<In, Out>::inConnectionIsShutdown() const {
+bool PipelineStage<In, Out>::connectionsAreShutdown() const {
   auto in = m_inConnection.lock();
   if (in != nullptr && in->isShutdown())
     return true;
 
-  return false;
-}
-
-template <typename In, typename Out>
-bool PipelineStage<In, Out>::outConnectionIsShutdown() const {
   auto out = m_outConnection.lock();
   if (out != nullptr && out->isShutdown())
     return true;
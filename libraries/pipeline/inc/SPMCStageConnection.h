@@ -4,8 +4,11 @@
 #include "OutStageConnection.h"
 #include "PipelineException.h"
 #include "StageTaskState.h"
+#include "TaskArena.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <optional>
@@ -18,6 +21,7 @@ class SPMCStageConnection : public InStageConnection<T>,
  public:
   SPMCStageConnection(std::vector<std::shared_ptr<T>> data);
 
+  // tasks of connections larger than a huge page are placed in a TaskArena
   SPMCStageConnection(size_t connectionSize);
 
   ~SPMCStageConnection() override;
@@ -26,6 +30,18 @@ class SPMCStageConnection : public InStageConnection<T>,
 
   bool isShutdown() const override;
 
+  size_t getCapacity() const override;
+
+  void setCapacity(size_t capacity) override;
+
+  size_t getTaskSize() const override;
+
+  ConnectionStatistics takeStatistics() override;
+
+  void setWaitPeriod(std::chrono::milliseconds period) override;
+
+  std::chrono::milliseconds getWaitPeriod() const override;
+
   std::shared_ptr<StageTask<T>> getProducerTask() override;
 
   void taskProduced(std::shared_ptr<T> taskData,
@@ -36,12 +52,24 @@ class SPMCStageConnection : public InStageConnection<T>,
                                                 ConsumptionStrategy strategy,
                                                 size_t minTaskId) override;
 
+  std::shared_ptr<StageTask<T>> tryGetConsumerTask(
+      size_t consumerId,
+      ConsumptionStrategy strategy,
+      size_t minTaskId) override;
+
   void taskConsumed(std::shared_ptr<T> taskData,
                     size_t consumerId,
                     bool consumed) override;
 
   size_t connectConsumer() override;
 
+  void disconnectConsumer(size_t consumerId) override;
+
+  void transferConsumer(size_t fromConsumerId, size_t toConsumerId) override;
+
+  // pages backing the tasks, regular for connections without an arena
+  PageKind getPageKind() const;
+
  private:
   void setTaskState(size_t taskId, StageTaskState);
 
@@ -52,27 +80,55 @@ class SPMCStageConnection : public InStageConnection<T>,
       std::unique_lock<std::mutex>& lock,
       size_t consumerId,
       ConsumptionStrategy strategy,
-      size_t minTaskId);
+      size_t minTaskId,
+      bool wait);
+
+  std::shared_ptr<StageTask<T>> takeConsumerTask(
+      std::unique_lock<std::mutex>& lock,
+      size_t consumerId,
+      ConsumptionStrategy strategy,
+      size_t minTaskId,
+      bool wait);
 
   bool taskLocked(size_t taskId);
 
-  static std::vector<std::shared_ptr<T>> initData(size_t size);
+  void checkConsumerId(size_t consumerId) const;
+
+  void resetConsumerStates(size_t consumerId);
+
+  bool taskPending(size_t taskId);
+
+  void restoreTaskIndices();
+
+  std::shared_ptr<StageTask<T>> makeTask();
+
+  static std::shared_ptr<TaskArena> createArena(size_t connectionSize);
 
  private:
   static constexpr size_t maxConsumersCount = 32u;
+  static constexpr auto defaultWaitPeriod = std::chrono::milliseconds(100);
+  // two shared_ptr control blocks per task, each holding the arena allocator
+  static constexpr size_t taskOverhead = 64;
+
+  std::shared_ptr<TaskArena> m_arena;
 
   std::vector<std::shared_ptr<StageTask<T>>> m_tasks;
 
   std::shared_ptr<StageTask<T>> m_consumingTasks[maxConsumersCount];
   size_t m_consumingTasksId[maxConsumersCount];
+  bool m_consumersConnected[maxConsumersCount];
   size_t m_consumersCount;
   std::vector<std::vector<StageTaskState>> m_consumersStates;
 
   std::shared_ptr<StageTask<T>> m_producingTask;
   size_t m_producingId;
   std::vector<bool> m_producersStates;
+  size_t m_lastTaskId;
+
+  ConnectionStatistics m_statistics;
+  std::atomic<std::chrono::milliseconds> m_waitPeriod;
 
-  std::mutex m_mutex;
+  mutable std::mutex m_mutex;
   std::condition_variable m_waitConsumerTaskCv;
   std::condition_variable m_waitProducerTaskCv;
   std::atomic_bool m_shutdownSignaled;
@@ -89,14 +145,23 @@ SPMCStageConnection<T>::SPMCStageConnection(
       m_producingTask(nullptr),
       m_producingId(0),
       m_producersStates(data.size(), false),
+      m_lastTaskId(0),
+      m_waitPeriod(defaultWaitPeriod),
       m_shutdownSignaled(false) {
   for (size_t i = 0; i < data.size(); ++i)
     m_tasks[i] = std::make_shared<StageTask<T>>(data[i]);
+
+  std::fill(std::begin(m_consumersConnected), std::end(m_consumersConnected),
+            false);
 }
 
 template <typename T>
 SPMCStageConnection<T>::SPMCStageConnection(size_t connectionSize)
-    : SPMCStageConnection(initData(connectionSize)) {}
+    : SPMCStageConnection(std::vector<std::shared_ptr<T>>()) {
+  m_arena = createArena(connectionSize);
+  if (connectionSize > 0)
+    setCapacity(connectionSize);
+}
 
 template <typename T>
 SPMCStageConnection<T>::~SPMCStageConnection() {
@@ -115,6 +180,75 @@ bool SPMCStageConnection<T>::isShutdown() const {
   return m_shutdownSignaled;
 }
 
+template <typename T>
+size_t SPMCStageConnection<T>::getCapacity() const {
+  std::lock_guard lock{m_mutex};
+  return m_tasks.size();
+}
+
+template <typename T>
+void SPMCStageConnection<T>::setCapacity(size_t capacity) {
+  if (capacity == 0)
+    throw std::invalid_argument("capacity must be positive");
+
+  {
+    std::lock_guard lock{m_mutex};
+
+    while (m_tasks.size() < capacity) {
+      m_tasks.push_back(makeTask());
+      m_consumersStates.emplace_back(maxConsumersCount, StageTaskState::empty);
+      m_producersStates.push_back(false);
+    }
+
+    // only tasks which are neither locked nor waiting for consumers can be
+    // removed, so the capacity may remain greater than requested
+    for (size_t i = m_tasks.size(); i > 0 && m_tasks.size() > capacity; --i) {
+      auto index = i - 1;
+      if (taskLocked(index) || taskPending(index))
+        continue;
+
+      m_tasks.erase(m_tasks.begin() + index);
+      m_consumersStates.erase(m_consumersStates.begin() + index);
+      m_producersStates.erase(m_producersStates.begin() + index);
+    }
+
+    restoreTaskIndices();
+  }
+
+  m_waitProducerTaskCv.notify_all();
+}
+
+template <typename T>
+size_t SPMCStageConnection<T>::getTaskSize() const {
+  return sizeof(T) + sizeof(StageTask<T>);
+}
+
+template <typename T>
+ConnectionStatistics SPMCStageConnection<T>::takeStatistics() {
+  std::lock_guard lock{m_mutex};
+
+  auto statistics = m_statistics;
+  m_statistics = ConnectionStatistics();
+  return statistics;
+}
+
+template <typename T>
+PageKind SPMCStageConnection<T>::getPageKind() const {
+  return m_arena ? m_arena->getPageKind() : PageKind::regular;
+}
+
+template <typename T>
+void SPMCStageConnection<T>::setWaitPeriod(std::chrono::milliseconds period) {
+  m_waitPeriod = period;
+  m_waitConsumerTaskCv.notify_all();
+  m_waitProducerTaskCv.notify_all();
+}
+
+template <typename T>
+std::chrono::milliseconds SPMCStageConnection<T>::getWaitPeriod() const {
+  return m_waitPeriod;
+}
+
 template <typename T>
 std::shared_ptr<StageTask<T>> SPMCStageConnection<T>::getProducerTask() {
   std::unique_lock lock{m_mutex};
@@ -124,6 +258,9 @@ std::shared_ptr<StageTask<T>> SPMCStageConnection<T>::getProducerTask() {
     return nullptr;
   auto index = taskIndex.value();
 
+  if (taskPending(index))
+    m_statistics.overwrittenCount++;
+
   for (size_t i = 0; i < m_consumersCount; ++i)
     m_consumersStates[index][i] = StageTaskState::empty;
 
@@ -154,8 +291,11 @@ void SPMCStageConnection<T>::taskProduced(std::shared_ptr<T> taskData,
   }
 
   if (produced) {
-    m_tasks[taskIndex]->taskId = taskId;
+    // task ids must grow monotonically even if the producer has been replaced
+    m_lastTaskId = std::max(taskId, m_lastTaskId + 1);
+    m_tasks[taskIndex]->taskId = m_lastTaskId;
     setTaskState(taskIndex, StageTaskState::produced);
+    m_statistics.producedCount++;
     m_waitConsumerTaskCv.notify_all();
   } else {
     m_tasks[taskIndex]->taskId = 0;
@@ -171,9 +311,27 @@ std::shared_ptr<StageTask<T>> SPMCStageConnection<T>::getConsumerTask(
     ConsumptionStrategy strategy,
     size_t minTaskId) {
   std::unique_lock lock{m_mutex};
+  return takeConsumerTask(lock, consumerId, strategy, minTaskId, true);
+}
 
+template <typename T>
+std::shared_ptr<StageTask<T>> SPMCStageConnection<T>::tryGetConsumerTask(
+    size_t consumerId,
+    ConsumptionStrategy strategy,
+    size_t minTaskId) {
+  std::unique_lock lock{m_mutex};
+  return takeConsumerTask(lock, consumerId, strategy, minTaskId, false);
+}
+
+template <typename T>
+std::shared_ptr<StageTask<T>> SPMCStageConnection<T>::takeConsumerTask(
+    std::unique_lock<std::mutex>& lock,
+    size_t consumerId,
+    ConsumptionStrategy strategy,
+    size_t minTaskId,
+    bool wait) {
   auto taskIndex =
-      findTaskIndexToConsume(lock, consumerId, strategy, minTaskId);
+      findTaskIndexToConsume(lock, consumerId, strategy, minTaskId, wait);
   if (taskIndex == std::nullopt)
     return nullptr;
   auto index = taskIndex.value();
@@ -190,12 +348,14 @@ template <typename T>
 void SPMCStageConnection<T>::taskConsumed(std::shared_ptr<T> taskData,
                                            size_t consumerId,
                                            bool consumed) {
-  if (consumerId >= m_consumersCount)
-    throw std::invalid_argument(std::string("invalid consumerId:)") +
-                                std::to_string(consumerId));
+  checkConsumerId(consumerId);
   {
     std::lock_guard lock{m_mutex};
 
+    // the consumer has been disconnected while it was processing the task
+    if (!m_consumersConnected[consumerId])
+      return;
+
     int taskId = -1;
 
     if (m_consumingTasks[consumerId] &&
@@ -213,34 +373,92 @@ void SPMCStageConnection<T>::taskConsumed(std::shared_ptr<T> taskData,
     if (taskId < 0)
       throw PipelineException("invalid taskData");
 
-    if (consumed)
-      m_consumersStates[taskId][consumerId] = StageTaskState::empty;
+    m_consumersStates[taskId][consumerId] =
+        consumed ? StageTaskState::empty : StageTaskState::produced;
   }
 
   m_waitProducerTaskCv.notify_one();
+  if (!consumed)
+    m_waitConsumerTaskCv.notify_all();
 }
 
 template <typename T>
 size_t SPMCStageConnection<T>::connectConsumer() {
-  if (m_consumersCount == maxConsumersCount)
+  std::lock_guard lock{m_mutex};
+
+  auto consumerId = m_consumersCount;
+  for (size_t i = 0; i < m_consumersCount; ++i) {
+    if (!m_consumersConnected[i]) {
+      consumerId = i;
+      break;
+    }
+  }
+
+  if (consumerId == maxConsumersCount)
     throw PipelineException(
         "Cannot connect consumer: the consumers' limit has been reached");
 
-  auto consumerId = m_consumersCount;
-  m_consumersCount++;
+  if (consumerId == m_consumersCount)
+    m_consumersCount++;
 
-  m_consumingTasks[consumerId] = nullptr;
-  m_consumingTasksId[consumerId] = 0;
+  m_consumersConnected[consumerId] = true;
+  resetConsumerStates(consumerId);
 
   return consumerId;
 }
 
+template <typename T>
+void SPMCStageConnection<T>::disconnectConsumer(size_t consumerId) {
+  checkConsumerId(consumerId);
+  {
+    std::lock_guard lock{m_mutex};
+
+    m_consumersConnected[consumerId] = false;
+    resetConsumerStates(consumerId);
+  }
+
+  m_waitConsumerTaskCv.notify_all();
+  m_waitProducerTaskCv.notify_all();
+}
+
+template <typename T>
+void SPMCStageConnection<T>::transferConsumer(size_t fromConsumerId,
+                                              size_t toConsumerId) {
+  checkConsumerId(fromConsumerId);
+  checkConsumerId(toConsumerId);
+  {
+    std::lock_guard lock{m_mutex};
+
+    if (!m_consumersConnected[fromConsumerId] ||
+        !m_consumersConnected[toConsumerId])
+      throw PipelineException("cannot transfer disconnected consumer");
+
+    // tasks not yet taken or not finished by the previous consumer are
+    // handed over to the new one
+    for (auto& states : m_consumersStates) {
+      states[toConsumerId] = states[fromConsumerId] == StageTaskState::empty
+                                 ? StageTaskState::empty
+                                 : StageTaskState::produced;
+    }
+
+    m_consumersConnected[fromConsumerId] = false;
+    resetConsumerStates(fromConsumerId);
+  }
+
+  m_waitConsumerTaskCv.notify_all();
+  m_waitProducerTaskCv.notify_all();
+}
+
 template <typename T>
 std::optional<size_t> SPMCStageConnection<T>::findTaskIndexToProduce(
     std::unique_lock<std::mutex>& lock) {
   std::optional<size_t> taskIndex = std::nullopt;
 
   auto taskId = std::numeric_limits<uint64_t>::max();
+  // waiting is limited so that the producer can be stopped or rescheduled even
+  // if consumers don't release tasks
+  auto waitDeadline = std::chrono::steady_clock::now() + m_waitPeriod.load();
+  bool waited = false;
   while (!taskIndex.has_value() && !m_shutdownSignaled) {
     for (size_t i = 0; i < m_tasks.size(); ++i) {
       // find task with min taskIndex
@@ -250,8 +468,14 @@ std::optional<size_t> SPMCStageConnection<T>::findTaskIndexToProduce(
       }
     }
 
-    if (!taskIndex.has_value())
-      m_waitProducerTaskCv.wait_for(lock, std::chrono::milliseconds(100));
+    if (!taskIndex.has_value()) {
+      if (!waited)
+        m_statistics.producerWaitsCount++;
+      waited = true;
+      if (m_waitProducerTaskCv.wait_until(lock, waitDeadline) ==
+          std::cv_status::timeout)
+        break;
+    }
   }
 
   if (m_shutdownSignaled)
@@ -265,7 +489,8 @@ std::optional<size_t> SPMCStageConnection<T>::findTaskIndexToConsume(
     std::unique_lock<std::mutex>& lock,
     size_t consumerId,
     ConsumptionStrategy strategy,
-    size_t minTaskId) {
+    size_t minTaskId,
+    bool wait) {
   uint64_t taskId;
   if (strategy == ConsumptionStrategy::fifo)
     taskId = std::numeric_limits<uint64_t>::max();
@@ -274,7 +499,12 @@ std::optional<size_t> SPMCStageConnection<T>::findTaskIndexToConsume(
 
   std::optional<size_t> taskIndex = std::nullopt;
 
-  while (taskIndex < 0 && !m_shutdownSignaled) {
+  // waiting is limited so that the consumer can be stopped even if nothing is
+  // produced
+  auto waitDeadline = std::chrono::steady_clock::now() + m_waitPeriod.load();
+  bool waited = false;
+  while (!taskIndex.has_value() && !m_shutdownSignaled &&
+         m_consumersConnected[consumerId]) {
     for (size_t i = 0; i < m_tasks.size(); ++i) {
       if (m_consumersStates[i][consumerId] == StageTaskState::produced &&
           m_tasks[i]->taskId > minTaskId) {
@@ -288,20 +518,39 @@ std::optional<size_t> SPMCStageConnection<T>::findTaskIndexToConsume(
       }
     }
 
-    if (taskIndex < 0)
-      m_waitConsumerTaskCv.wait_for(lock, std::chrono::milliseconds(100));
+    if (taskIndex.has_value() || !wait)
+      break;
+
+    if (!waited)
+      m_statistics.consumerWaitsCount++;
+    waited = true;
+    if (m_waitConsumerTaskCv.wait_until(lock, waitDeadline) ==
+        std::cv_status::timeout)
+      break;
   }
 
   return taskIndex;
 }
 
 template <typename T>
-std::vector<std::shared_ptr<T>> SPMCStageConnection<T>::initData(size_t size) {
-  std::vector<std::shared_ptr<T>> data(size);
-  for (auto& el : data)
-    el = std::make_shared<T>();
+std::shared_ptr<StageTask<T>> SPMCStageConnection<T>::makeTask() {
+  if (!m_arena)
+    return std::make_shared<StageTask<T>>(std::make_shared<T>());
+
+  return std::allocate_shared<StageTask<T>>(
+      TaskArenaAllocator<StageTask<T>>(m_arena),
+      std::allocate_shared<T>(TaskArenaAllocator<T>(m_arena)));
+}
+
+template <typename T>
+std::shared_ptr<TaskArena> SPMCStageConnection<T>::createArena(
+    size_t connectionSize) {
+  auto size =
+      connectionSize * (sizeof(T) + sizeof(StageTask<T>) + taskOverhead);
+  if (size < HugePageBuffer::hugePageSize)
+    return nullptr;
 
-  return data;
+  return std::make_shared<TaskArena>(size);
 }
 
 template <typename T>
@@ -319,6 +568,49 @@ bool SPMCStageConnection<T>::taskLocked(size_t taskId) {
   return false;
 }
 
+template <typename T>
+bool SPMCStageConnection<T>::taskPending(size_t taskId) {
+  for (auto i = 0u; i < m_consumersCount; i++) {
+    if (m_consumersConnected[i] &&
+        m_consumersStates[taskId][i] == StageTaskState::produced)
+      return true;
+  }
+
+  return false;
+}
+
+template <typename T>
+void SPMCStageConnection<T>::restoreTaskIndices() {
+  auto indexOf = [this](const std::shared_ptr<StageTask<T>>& task) -> size_t {
+    auto it = std::find(m_tasks.begin(), m_tasks.end(), task);
+    return it != m_tasks.end() ? it - m_tasks.begin() : 0;
+  };
+
+  if (m_producingTask)
+    m_producingId = indexOf(m_producingTask);
+
+  for (size_t i = 0; i < m_consumersCount; ++i) {
+    if (m_consumingTasks[i])
+      m_consumingTasksId[i] = indexOf(m_consumingTasks[i]);
+  }
+}
+
+template <typename T>
+void SPMCStageConnection<T>::checkConsumerId(size_t consumerId) const {
+  if (consumerId >= m_consumersCount)
+    throw std::invalid_argument(std::string("invalid consumerId: ") +
+                                std::to_string(consumerId));
+}
+
+template <typename T>
+void SPMCStageConnection<T>::resetConsumerStates(size_t consumerId) {
+  for (auto& states : m_consumersStates)
+    states[consumerId] = StageTaskState::empty;
+
+  m_consumingTasks[consumerId] = nullptr;
+  m_consumingTasksId[consumerId] = 0;
+}
+
 template <typename T>
 void SPMCStageConnection<T>::setTaskState(size_t taskId,
                                            StageTaskState state) {
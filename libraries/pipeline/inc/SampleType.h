@@ -0,0 +1,61 @@
+#pragma once
+
+#include <complex>
+#include <cstdint>
+
+// Stable, compiler-independent name of a task data type. Stage names (and
+// therefore stage names stored in YAML) are built from it instead of
+// typeid().name(), which is mangled differently by every compiler.
+// Every type passed between registered stages must have a specialization.
+template <typename T>
+struct SampleType;
+
+template <>
+struct SampleType<int16_t> {
+  static constexpr const char* name = "int16";
+};
+
+template <>
+struct SampleType<int32_t> {
+  static constexpr const char* name = "int32";
+};
+
+template <>
+struct SampleType<int64_t> {
+  static constexpr const char* name = "int64";
+};
+
+template <>
+struct SampleType<float> {
+  static constexpr const char* name = "float";
+};
+
+template <>
+struct SampleType<double> {
+  static constexpr const char* name = "double";
+};
+
+template <>
+struct SampleType<std::complex<float>> {
+  static constexpr const char* name = "complex64";
+};
+
+// Type of the values a task consists of: the task type itself for plain
+// samples, the element type for composite payloads such as frames
+template <typename T>
+struct SampleValue {
+  using type = T;
+};
+
+// List of task data types a stage family is instantiated for
+template <typename... T>
+struct SampleTypeList {};
+
+// Real numbers: stages doing arithmetic on samples
+using RealSampleTypes =
+    SampleTypeList<int16_t, int32_t, int64_t, float, double>;
+
+// All sample types: stages moving samples as raw bytes
+using AllSampleTypes =
+    SampleTypeList<int16_t, int32_t, int64_t, float, double,
+                   std::complex<float>>;
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "ConnectionStatistics.h"
+
+#include <chrono>
+#include <cstddef>
+
 class StageConnection {
 public:
   virtual ~StageConnection() = default;
@@ -7,4 +12,18 @@ public:
   virtual void shutdown() = 0;
 
   virtual bool isShutdown() const = 0;
+
+  virtual size_t getCapacity() const = 0;
+
+  virtual void setCapacity(size_t capacity) = 0;
+
+  virtual size_t getTaskSize() const = 0;
+
+  // returns statistics collected since the previous call
+  virtual ConnectionStatistics takeStatistics() = 0;
+
+  // how long producers and consumers wait for a task before giving up
+  virtual void setWaitPeriod(std::chrono::milliseconds period) = 0;
+
+  virtual std::chrono::milliseconds getWaitPeriod() const = 0;
 };
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+class IPipelineStage;
+
+// limits resources available to a group of stages, e.g. to one pipeline
+struct ExecutorQuota {
+  // how many stages of the group may be executed simultaneously
+  size_t maxConcurrency;
+};
+
+// runs stages on threads which are not owned by the stages themselves
+class StageExecutor {
+ public:
+  virtual ~StageExecutor() = default;
+
+  // stage is executed by calling IPipelineStage::step until it is unscheduled
+  virtual void schedule(IPipelineStage& stage,
+                        std::shared_ptr<ExecutorQuota> quota) = 0;
+
+  // blocks until no thread executes the stage
+  virtual void unschedule(IPipelineStage& stage) = 0;
+};
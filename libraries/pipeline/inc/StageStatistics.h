@@ -0,0 +1,20 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+struct StageStatistics {
+  size_t processedCount = 0;
+  // stage function threw an exception
+  size_t failedCount = 0;
+  std::chrono::nanoseconds totalLatency{0};
+  std::chrono::nanoseconds maxLatency{0};
+  // latencyHistogram[i] counts calls which took less than 2^i nanoseconds
+  std::array<size_t, 64> latencyHistogram{};
+
+  std::chrono::nanoseconds averageLatency() const;
+
+  // upper bound of the histogram bucket containing given quantile
+  std::chrono::nanoseconds latencyPercentile(double quantile) const;
+};
@@ -0,0 +1,505 @@
+#pragma once
+
+#include "ConnectablePipelineStage.h"
+#include "ConsumptionStrategy.h"
+#include "PendingTask.h"
+#include "Pipeline.h"
+#include "PipelineException.h"
+#include "SPMCStageConnection.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Pipeline for a graph which is fixed at compile time:
+//
+//   auto pipeline = makeStaticPipeline(Source{} | Transform{} | Sink{});
+//
+// Nodes are plain classes deriving from StaticNode<In, Out> (void In for a
+// source, void Out for a sink) and defining one of
+//   bool produce(Out&)                          // source
+//   bool consumeAndProduce(const In&, Out&)     // transform
+//   void consume(const In&)                     // sink
+// where false means that nothing was produced for this step. A node may
+// name its stage with
+//   static constexpr std::string_view name = "Halving";
+// otherwise the stage is named after its position, e.g. "StaticStage1".
+// Nodes are moved into their stages, so they must be movable. Mismatched
+// edges fail to compile. Every node runs in a final stage holding its
+// concrete SPMCStageConnection, so node and connection calls are resolved
+// statically and inlined instead of going through the virtual hooks and
+// weak_ptr connections of PipelineStage. The result is a Pipeline, so
+// executors, statistics and hosting work as for a pipeline built from YAML.
+
+struct StaticNodeTag {};
+
+template <typename In, typename Out>
+struct StaticNode : StaticNodeTag {
+  using consumptionT = In;
+  using productionT = Out;
+};
+
+template <typename T>
+constexpr bool isStaticNode = std::is_base_of_v<StaticNodeTag, T>;
+
+template <typename T, typename = void>
+struct HasStaticNodeName : std::false_type {};
+
+template <typename T>
+struct HasStaticNodeName<T, std::void_t<decltype(T::name)>>
+    : std::true_type {};
+
+// name of the stage running the node at the given position of the chain
+template <typename Node>
+std::string staticNodeName(size_t index) {
+  if constexpr (HasStaticNodeName<Node>::value)
+    return std::string(std::string_view(Node::name));
+  else
+    return "StaticStage" + std::to_string(index);
+}
+
+template <typename... Nodes>
+class StaticChain {
+  static_assert(sizeof...(Nodes) > 0, "chain must have nodes");
+
+ public:
+  constexpr explicit StaticChain(std::tuple<Nodes...> nodes)
+      : m_nodes(std::move(nodes)) {}
+
+  constexpr const std::tuple<Nodes...>& getNodes() const& { return m_nodes; }
+  constexpr std::tuple<Nodes...>&& getNodes() && { return std::move(m_nodes); }
+
+  using firstT = std::tuple_element_t<0, std::tuple<Nodes...>>;
+  using lastT =
+      std::tuple_element_t<sizeof...(Nodes) - 1, std::tuple<Nodes...>>;
+
+ private:
+  std::tuple<Nodes...> m_nodes;
+};
+
+template <typename T>
+constexpr auto toStaticChain(T&& value) {
+  if constexpr (isStaticNode<std::decay_t<T>>)
+    return StaticChain<std::decay_t<T>>(
+        std::make_tuple(std::forward<T>(value)));
+  else
+    return std::forward<T>(value);
+}
+
+template <typename... Left, typename... Right>
+constexpr auto concatStaticChains(StaticChain<Left...> left,
+                                  StaticChain<Right...> right) {
+  using From = typename StaticChain<Left...>::lastT;
+  using To = typename StaticChain<Right...>::firstT;
+  static_assert(!std::is_void_v<typename From::productionT>,
+                "sink node cannot be followed by another node");
+  static_assert(!std::is_void_v<typename To::consumptionT>,
+                "source node cannot follow another node");
+  static_assert(std::is_same_v<typename From::productionT,
+                               typename To::consumptionT>,
+                "node consumes another type than its parent produces");
+
+  return StaticChain<Left..., Right...>(std::tuple_cat(
+      std::move(left).getNodes(), std::move(right).getNodes()));
+}
+
+template <typename T>
+struct IsStaticChain : std::false_type {};
+
+template <typename... Nodes>
+struct IsStaticChain<StaticChain<Nodes...>> : std::true_type {};
+
+template <typename T>
+constexpr bool isStaticChainPart =
+    isStaticNode<std::decay_t<T>> || IsStaticChain<std::decay_t<T>>::value;
+
+template <typename Left,
+          typename Right,
+          typename = std::enable_if_t<isStaticChainPart<Left> &&
+                                      isStaticChainPart<Right>>>
+constexpr auto operator|(Left&& left, Right&& right) {
+  return concatStaticChains(toStaticChain(std::forward<Left>(left)),
+                            toStaticChain(std::forward<Right>(right)));
+}
+
+// connection of a static stage, none for void
+template <typename T>
+using StaticConnectionPtr =
+    std::conditional_t<std::is_void_v<T>,
+                       std::nullptr_t,
+                       std::shared_ptr<SPMCStageConnection<T>>>;
+
+template <typename Node>
+class StaticStage final : public ConnectablePipelineStage {
+ public:
+  using In = typename Node::consumptionT;
+  using Out = typename Node::productionT;
+
+  StaticStage(const std::string_view stageName,
+              Node node,
+              ConsumptionStrategy consumptionStrategy,
+              StaticConnectionPtr<In> inConnection,
+              StaticConnectionPtr<Out> outConnection);
+
+  ~StaticStage() override;
+
+  PipelineStageType getStageType() const override;
+
+  std::optional<ConsumptionStrategy> getConsumptionStrategy() const override;
+
+  std::shared_ptr<StageConnection> getInConnection() const override;
+
+  std::shared_ptr<StageConnection> getOutConnection() const override;
+
+  std::optional<ConsumerCursor> getConsumerCursor() const override;
+
+  void attachConsumerCursor(const ConsumerCursor& cursor) override;
+
+  void disconnect() override;
+
+  Node& getNode();
+
+ protected:
+  void checkRunnable() const override;
+
+  bool processTask() override;
+
+  void releaseTasksOnError() override;
+
+  void releasePendingTask() override;
+
+  bool connectionsAreShutdown() const override;
+
+ private:
+  static constexpr bool consumes = !std::is_void_v<In>;
+  static constexpr bool produces = !std::is_void_v<Out>;
+
+  using InData = std::conditional_t<consumes, std::shared_ptr<In>, bool>;
+  using OutData = std::conditional_t<produces, std::shared_ptr<Out>, bool>;
+
+  bool process(const InData& inData, const OutData& outData);
+
+  void release(InData& inData,
+               OutData& outData,
+               bool consumed,
+               bool produced);
+
+ private:
+  Node m_node;
+
+  PendingTask<InData, OutData> m_pending;
+
+  ConsumptionStrategy m_consumptionStrategy;
+  std::optional<size_t> m_consumerId;
+  size_t m_lastConsumedTaskId;
+  size_t m_lastProducedTaskId;
+
+  // connections are owned and called by their concrete type: qualified calls
+  // below bypass the virtual dispatch of the connection interfaces
+  StaticConnectionPtr<In> m_inConnection;
+  StaticConnectionPtr<Out> m_outConnection;
+};
+
+template <typename Node>
+StaticStage<Node>::StaticStage(const std::string_view stageName,
+                               Node node,
+                               ConsumptionStrategy consumptionStrategy,
+                               StaticConnectionPtr<In> inConnection,
+                               StaticConnectionPtr<Out> outConnection)
+    : ConnectablePipelineStage(stageName),
+      m_node(std::move(node)),
+      m_consumptionStrategy(consumptionStrategy),
+      m_lastConsumedTaskId{0},
+      m_lastProducedTaskId{0},
+      m_inConnection(inConnection),
+      m_outConnection(outConnection) {
+  static_assert(isStaticNode<Node>, "node must derive from StaticNode");
+  static_assert(consumes || produces, "node must consume or produce");
+
+  if constexpr (consumes) {
+    if (!inConnection)
+      throw std::invalid_argument("inConnection is null");
+    m_consumerId = inConnection->connectConsumer();
+  }
+
+  if constexpr (produces) {
+    if (!outConnection)
+      throw std::invalid_argument("outConnection is null");
+  }
+}
+
+template <typename Node>
+StaticStage<Node>::~StaticStage() {
+  shutdown();
+}
+
+template <typename Node>
+void StaticStage<Node>::checkRunnable() const {
+  if constexpr (consumes) {
+    if (!m_consumerId.has_value())
+      throw PipelineException(std::string("consumerId is null"));
+  }
+}
+
+template <typename Node>
+bool StaticStage<Node>::processTask() {
+  if constexpr (consumes) {
+    if (!m_pending.inData) {
+      auto inTask = m_inConnection->SPMCStageConnection<In>::getConsumerTask(
+          m_consumerId.value(), m_consumptionStrategy, m_lastConsumedTaskId);
+      if (!inTask)
+        return false;
+
+      m_pending.taken(m_lastConsumedTaskId, inTask->taskId);
+      m_pending.inData = inTask->data;
+    }
+  }
+
+  if constexpr (produces) {
+    auto outTask = m_outConnection->SPMCStageConnection<Out>::getProducerTask();
+    if (!outTask)
+      return false;
+
+    m_pending.outData = outTask->data;
+  }
+
+  auto started = std::chrono::steady_clock::now();
+  auto produced = process(m_pending.inData, m_pending.outData);
+  taskProcessed(std::chrono::steady_clock::now() - started);
+  release(m_pending.inData, m_pending.outData, true, produced);
+  return true;
+}
+
+template <typename Node>
+void StaticStage<Node>::releaseTasksOnError() {
+  release(m_pending.inData, m_pending.outData, false, false);
+}
+
+template <typename Node>
+void StaticStage<Node>::releasePendingTask() {
+  if constexpr (consumes) {
+    if (!m_pending.inData)
+      return;
+
+    auto inData = m_pending.handBack(m_lastConsumedTaskId);
+    if (m_consumerId.has_value())
+      m_inConnection->SPMCStageConnection<In>::taskConsumed(
+          inData, m_consumerId.value(), false);
+  }
+}
+
+template <typename Node>
+inline bool StaticStage<Node>::process(const InData& inData,
+                                       const OutData& outData) {
+  if constexpr (consumes && produces)
+    return m_node.consumeAndProduce(std::as_const(*inData), *outData);
+  else if constexpr (produces)
+    return m_node.produce(*outData);
+  else {
+    m_node.consume(std::as_const(*inData));
+    return false;
+  }
+}
+
+template <typename Node>
+inline void StaticStage<Node>::release(InData& inData,
+                                       OutData& outData,
+                                       bool consumed,
+                                       bool produced) {
+  if constexpr (consumes) {
+    if (inData) {
+      m_inConnection->SPMCStageConnection<In>::taskConsumed(
+          inData, m_consumerId.value(), consumed);
+      inData = nullptr;
+    }
+  }
+
+  if constexpr (produces) {
+    if (outData) {
+      m_outConnection->SPMCStageConnection<Out>::taskProduced(
+          outData, ++m_lastProducedTaskId, produced);
+      outData = nullptr;
+    }
+  }
+}
+
+template <typename Node>
+PipelineStageType StaticStage<Node>::getStageType() const {
+  if constexpr (consumes && produces)
+    return PipelineStageType::producerConsumer;
+  else if constexpr (produces)
+    return PipelineStageType::producer;
+  else
+    return PipelineStageType::consumer;
+}
+
+template <typename Node>
+std::optional<ConsumptionStrategy> StaticStage<Node>::getConsumptionStrategy()
+    const {
+  if constexpr (consumes)
+    return m_consumptionStrategy;
+  else
+    return std::nullopt;
+}
+
+template <typename Node>
+std::shared_ptr<StageConnection> StaticStage<Node>::getInConnection() const {
+  if constexpr (consumes)
+    return m_inConnection;
+  else
+    return nullptr;
+}
+
+template <typename Node>
+std::shared_ptr<StageConnection> StaticStage<Node>::getOutConnection() const {
+  if constexpr (produces)
+    return m_outConnection;
+  else
+    return nullptr;
+}
+
+template <typename Node>
+std::optional<ConsumerCursor> StaticStage<Node>::getConsumerCursor() const {
+  if constexpr (consumes) {
+    if (!m_consumerId.has_value())
+      return std::nullopt;
+
+    return ConsumerCursor{m_inConnection.get(), m_consumerId.value(),
+                          m_lastConsumedTaskId};
+  } else {
+    return std::nullopt;
+  }
+}
+
+template <typename Node>
+void StaticStage<Node>::attachConsumerCursor(const ConsumerCursor& cursor) {
+  if constexpr (consumes) {
+    if (cursor.connection != m_inConnection.get())
+      throw PipelineException("cursor belongs to another connection");
+
+    m_inConnection->transferConsumer(cursor.consumerId, m_consumerId.value());
+    m_lastConsumedTaskId = cursor.lastConsumedTaskId;
+  } else {
+    throw PipelineException("source stage has no input");
+  }
+}
+
+template <typename Node>
+void StaticStage<Node>::disconnect() {
+  if constexpr (consumes) {
+    if (m_consumerId.has_value()) {
+      m_inConnection->disconnectConsumer(m_consumerId.value());
+      m_consumerId = std::nullopt;
+    }
+  }
+}
+
+template <typename Node>
+Node& StaticStage<Node>::getNode() {
+  return m_node;
+}
+
+template <typename Node>
+bool StaticStage<Node>::connectionsAreShutdown() const {
+  if constexpr (consumes) {
+    if (m_inConnection->SPMCStageConnection<In>::isShutdown())
+      return true;
+  }
+
+  if constexpr (produces) {
+    if (m_outConnection->SPMCStageConnection<Out>::isShutdown())
+      return true;
+  }
+
+  return false;
+}
+
+template <typename... Nodes>
+class StaticPipeline : public Pipeline {
+  using NodesT = std::tuple<Nodes...>;
+
+  using SourceT = std::tuple_element_t<0, NodesT>;
+  using SinkT = std::tuple_element_t<sizeof...(Nodes) - 1, NodesT>;
+  static_assert(std::is_void_v<typename SourceT::consumptionT>,
+                "first node of a pipeline must be a source");
+  static_assert(std::is_void_v<typename SinkT::productionT>,
+                "last node of a pipeline must be a sink");
+
+ public:
+  StaticPipeline(StaticChain<Nodes...> chain,
+                 size_t connectionSize,
+                 ConsumptionStrategy strategy);
+
+  // stage running the I-th node, its id is std::to_string(I)
+  template <size_t I>
+  std::shared_ptr<StaticStage<std::tuple_element_t<I, NodesT>>> getStaticStage()
+      const;
+
+ private:
+  template <size_t I, typename InConnection>
+  void addStaticStages(NodesT& nodes,
+                       InConnection inConnection,
+                       size_t connectionSize,
+                       ConsumptionStrategy strategy);
+
+ private:
+  std::tuple<std::shared_ptr<StaticStage<Nodes>>...> m_staticStages;
+};
+
+template <typename... Nodes>
+StaticPipeline<Nodes...>::StaticPipeline(StaticChain<Nodes...> chain,
+                                         size_t connectionSize,
+                                         ConsumptionStrategy strategy) {
+  auto nodes = std::move(chain).getNodes();
+  addStaticStages<0>(nodes, nullptr, connectionSize, strategy);
+}
+
+template <typename... Nodes>
+template <size_t I>
+std::shared_ptr<StaticStage<std::tuple_element_t<I, std::tuple<Nodes...>>>>
+StaticPipeline<Nodes...>::getStaticStage() const {
+  return std::get<I>(m_staticStages);
+}
+
+template <typename... Nodes>
+template <size_t I, typename InConnection>
+void StaticPipeline<Nodes...>::addStaticStages(NodesT& nodes,
+                                               InConnection inConnection,
+                                               size_t connectionSize,
+                                               ConsumptionStrategy strategy) {
+  using Node = std::tuple_element_t<I, NodesT>;
+  using Out = typename Node::productionT;
+
+  StaticConnectionPtr<Out> outConnection{};
+  if constexpr (!std::is_void_v<Out>) {
+    outConnection = std::make_shared<SPMCStageConnection<Out>>(connectionSize);
+    addConnection(outConnection);
+  }
+
+  auto stage = std::make_shared<StaticStage<Node>>(
+      staticNodeName<Node>(I), std::move(std::get<I>(nodes)), strategy,
+      inConnection, outConnection);
+  stage->setId(std::to_string(I));
+  if constexpr (I > 0)
+    stage->setParentId(std::to_string(I - 1));
+  std::get<I>(m_staticStages) = stage;
+  addStage(stage);
+
+  if constexpr (I + 1 < sizeof...(Nodes))
+    addStaticStages<I + 1>(nodes, outConnection, connectionSize, strategy);
+}
+
+template <typename... Nodes>
+std::shared_ptr<StaticPipeline<Nodes...>> makeStaticPipeline(
+    StaticChain<Nodes...> chain,
+    size_t connectionSize = 1024,
+    ConsumptionStrategy strategy = ConsumptionStrategy::fifo) {
+  return std::make_shared<StaticPipeline<Nodes...>>(std::move(chain),
+                                                    connectionSize, strategy);
+}
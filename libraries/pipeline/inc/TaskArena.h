@@ -0,0 +1,91 @@
+#pragma once
+
+#include "HugePageBuffer.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+// Bump allocator placing the tasks of a connection next to each other in a
+// HugePageBuffer. Memory is returned only when the arena is destroyed, which
+// suits connection tasks living as long as the connection. Allocations
+// which don't fit any more go to the regular heap. Allocation is not
+// thread-safe, releasing memory is.
+class TaskArena {
+ public:
+  explicit TaskArena(size_t size);
+
+  // nullptr if the arena is full
+  void* allocate(size_t size, size_t alignment);
+
+  bool contains(const void* p) const;
+
+  PageKind getPageKind() const;
+
+ private:
+  HugePageBuffer m_buffer;
+  size_t m_used;
+};
+
+// standard allocator over a TaskArena, for std::allocate_shared: every
+// control block keeps the arena alive until its object is released
+template <typename T>
+class TaskArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit TaskArenaAllocator(std::shared_ptr<TaskArena> arena);
+
+  template <typename U>
+  TaskArenaAllocator(const TaskArenaAllocator<U>& other);
+
+  T* allocate(size_t n);
+
+  void deallocate(T* p, size_t n);
+
+  const std::shared_ptr<TaskArena>& getArena() const;
+
+ private:
+  std::shared_ptr<TaskArena> m_arena;
+};
+
+template <typename T>
+TaskArenaAllocator<T>::TaskArenaAllocator(std::shared_ptr<TaskArena> arena)
+    : m_arena(std::move(arena)) {}
+
+template <typename T>
+template <typename U>
+TaskArenaAllocator<T>::TaskArenaAllocator(const TaskArenaAllocator<U>& other)
+    : m_arena(other.getArena()) {}
+
+template <typename T>
+T* TaskArenaAllocator<T>::allocate(size_t n) {
+  if (auto p = m_arena->allocate(n * sizeof(T), alignof(T)); p != nullptr)
+    return static_cast<T*>(p);
+
+  return static_cast<T*>(
+      ::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+}
+
+template <typename T>
+void TaskArenaAllocator<T>::deallocate(T* p, size_t) {
+  if (!m_arena->contains(p))
+    ::operator delete(p, std::align_val_t{alignof(T)});
+}
+
+template <typename T>
+const std::shared_ptr<TaskArena>& TaskArenaAllocator<T>::getArena() const {
+  return m_arena;
+}
+
+template <typename T, typename U>
+bool operator==(const TaskArenaAllocator<T>& a,
+                const TaskArenaAllocator<U>& b) {
+  return a.getArena() == b.getArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const TaskArenaAllocator<T>& a,
+                const TaskArenaAllocator<U>& b) {
+  return !(a == b);
+}
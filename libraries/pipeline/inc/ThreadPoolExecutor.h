@@ -0,0 +1,83 @@
+#pragma once
+
+#include "StageConnection.h"
+#include "StageExecutor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct ThreadPoolSettings {
+  size_t threadsCount = std::max(1u, std::thread::hardware_concurrency());
+  // pause before a stage which had nothing to process is polled again
+  std::chrono::microseconds idleBackoff{500};
+  // connections of scheduled stages must not block pool threads for long,
+  // their own wait period is restored when no scheduled stage uses them
+  std::chrono::milliseconds connectionWaitPeriod{0};
+};
+
+// executes stages of any number of pipelines on a fixed number of threads
+class ThreadPoolExecutor : public StageExecutor {
+ public:
+  ThreadPoolExecutor(ThreadPoolSettings settings = {});
+
+  ~ThreadPoolExecutor() override;
+
+  void schedule(IPipelineStage& stage,
+                std::shared_ptr<ExecutorQuota> quota) override;
+
+  void unschedule(IPipelineStage& stage) override;
+
+  size_t getThreadsCount() const;
+
+  size_t getScheduledCount() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct ScheduledStage {
+    IPipelineStage* stage;
+    std::shared_ptr<ExecutorQuota> quota;
+    Clock::time_point nextRun;
+    std::vector<const StageConnection*> connections;
+    bool running = false;
+    bool removed = false;
+  };
+
+  // connection whose wait period is shortened while scheduled stages use it
+  struct ShortenedConnection {
+    std::weak_ptr<StageConnection> connection;
+    std::chrono::milliseconds waitPeriod;
+    size_t stagesCount = 0;
+  };
+
+  void work();
+
+  // picks the next stage in round-robin order which may be executed now
+  ScheduledStage* pickStage(Clock::time_point now);
+
+  Clock::time_point nextWakeUp(Clock::time_point now) const;
+
+  std::vector<const StageConnection*> shortenWaitPeriods(
+      const IPipelineStage& stage);
+
+  void restoreWaitPeriods(const std::vector<const StageConnection*>& used);
+
+ private:
+  ThreadPoolSettings m_settings;
+
+  std::list<ScheduledStage> m_stages;
+  std::map<const ExecutorQuota*, size_t> m_runningByQuota;
+  std::map<const StageConnection*, ShortenedConnection> m_connections;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_shutdownSignaled;
+  std::vector<std::thread> m_threads;
+};
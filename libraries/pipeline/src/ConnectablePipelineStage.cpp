@@ -0,0 +1,72 @@
+#include "ConnectablePipelineStage.h"
+
+#include "PipelineHelpers.h"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+ConnectablePipelineStage::ConnectablePipelineStage(const string_view stageName)
+    : IPipelineStage(stageName), m_shutdownSignaled{false} {}
+
+ConnectablePipelineStage::~ConnectablePipelineStage() {
+  // the derived stage is already destroyed, only the thread is stopped
+  m_shutdownSignaled = true;
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+void ConnectablePipelineStage::run() {
+  checkRunnable();
+
+  if (auto executor = getExecutor(); executor != nullptr) {
+    executor->schedule(*this, getExecutorQuota());
+    m_scheduledExecutor = executor;
+    return;
+  }
+
+  m_thread = thread([this] {
+    if (auto cpu = getCpuAffinity(); cpu.has_value() &&
+                                     !PipelineHelpers::pinCurrentThread(*cpu))
+      cerr << "ConnectablePipelineStage: cannot pin " << m_stageName
+           << " to cpu " << *cpu << endl;
+
+    while (!m_shutdownSignaled && !isFinished()) {
+      // nothing was produced yet or there is no room for the result, check
+      // whether the stage is stopped
+      if (!step() && connectionsAreShutdown())
+        break;
+    }
+  });
+}
+
+void ConnectablePipelineStage::shutdown() {
+  m_shutdownSignaled = true;
+
+  if (auto executor = m_scheduledExecutor.lock(); executor != nullptr) {
+    executor->unschedule(*this);
+    m_scheduledExecutor.reset();
+  }
+
+  if (m_thread.joinable())
+    m_thread.join();
+
+  releasePendingTask();
+}
+
+bool ConnectablePipelineStage::step() {
+  try {
+    return processTask();
+  } catch (exception& ex) {
+    taskFailed();
+    cerr << "ConnectablePipelineStage: " << ex.what() << endl;
+  } catch (...) {
+    taskFailed();
+    cerr << "ConnectablePipelineStage: "
+         << "unhandled exception in stage function" << endl;
+  }
+
+  releaseTasksOnError();
+  return true;
+}
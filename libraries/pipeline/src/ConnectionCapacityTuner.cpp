@@ -0,0 +1,160 @@
+#include "ConnectionCapacityTuner.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+ConnectionCapacityTuner::ConnectionCapacityTuner(
+    CapacityTuningSettings settings)
+    : m_settings(settings), m_shutdownSignaled{false} {
+  if (settings.minCapacity == 0 || settings.minCapacity > settings.maxCapacity)
+    throw invalid_argument("invalid capacity bounds");
+}
+
+ConnectionCapacityTuner::~ConnectionCapacityTuner() {
+  shutdown();
+}
+
+void ConnectionCapacityTuner::addConnection(
+    const string_view id,
+    shared_ptr<StageConnection> connection) {
+  if (!connection)
+    throw invalid_argument("connection is null");
+
+  lock_guard lock{m_mutex};
+  m_connections[string(id)] = {connection, 0};
+}
+
+void ConnectionCapacityTuner::addStage(const IPipelineStage& stage) {
+  auto outputNames = stage.getOutputNames();
+  auto connections = stage.getOutConnections();
+  if (outputNames.size() != connections.size()) {
+    if (auto connection = stage.getOutConnection(); connection != nullptr)
+      addConnection(stageKey(stage, connection), connection);
+    return;
+  }
+
+  for (size_t i = 0; i < connections.size(); ++i)
+    addConnection(stageKey(stage, connections[i], outputNames[i]),
+                  connections[i]);
+}
+
+void ConnectionCapacityTuner::addPipeline(Pipeline& pipeline) {
+  for (const auto& stage : pipeline.getStages())
+    addStage(*stage);
+}
+
+void ConnectionCapacityTuner::run() {
+  m_shutdownSignaled = false;
+  m_thread = thread([this] {
+    while (true) {
+      {
+        unique_lock lock{m_mutex};
+        if (m_shutdownCv.wait_for(lock, m_settings.period,
+                                  [this] { return m_shutdownSignaled; }))
+          return;
+      }
+      tune();
+    }
+  });
+}
+
+void ConnectionCapacityTuner::shutdown() {
+  {
+    lock_guard lock{m_mutex};
+    m_shutdownSignaled = true;
+  }
+  m_shutdownCv.notify_all();
+
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+void ConnectionCapacityTuner::tune() {
+  lock_guard lock{m_mutex};
+
+  for (auto& [id, tuned] : m_connections) {
+    auto connection = tuned.connection.lock();
+    if (connection == nullptr || connection->isShutdown())
+      continue;
+
+    auto statistics = connection->takeStatistics();
+    auto capacity = connection->getCapacity();
+    auto stalledCount =
+        statistics.producerWaitsCount + statistics.overwrittenCount;
+
+    if (stalledCount > 0 &&
+        stalledCount >= m_settings.growThreshold * statistics.producedCount) {
+      tuned.idlePeriodsCount = 0;
+
+      auto availableMemory =
+          m_settings.memoryBudget - min(m_settings.memoryBudget, usedMemory());
+      auto maxCapacity =
+          min(m_settings.maxCapacity,
+              capacity + availableMemory / connection->getTaskSize());
+      auto newCapacity = min(capacity * 2, maxCapacity);
+      if (newCapacity > capacity)
+        connection->setCapacity(newCapacity);
+    } else if (statistics.consumerWaitsCount > 0) {
+      if (++tuned.idlePeriodsCount < m_settings.shrinkPeriodsCount)
+        continue;
+
+      tuned.idlePeriodsCount = 0;
+      auto newCapacity = max(capacity / 2, m_settings.minCapacity);
+      if (newCapacity < capacity)
+        connection->setCapacity(newCapacity);
+    } else {
+      tuned.idlePeriodsCount = 0;
+    }
+  }
+}
+
+map<string, size_t> ConnectionCapacityTuner::getCapacities() const {
+  lock_guard lock{m_mutex};
+
+  map<string, size_t> capacities;
+  for (const auto& [id, tuned] : m_connections) {
+    if (auto connection = tuned.connection.lock(); connection != nullptr)
+      capacities[id] = connection->getCapacity();
+  }
+
+  return capacities;
+}
+
+string ConnectionCapacityTuner::stageKey(
+    const IPipelineStage& stage,
+    const shared_ptr<StageConnection>& connection,
+    const string& output) const {
+  auto withOutput = [&output](const string& key) {
+    return output.empty() ? key : key + "." + output;
+  };
+
+  if (auto id = stage.getId(); id.has_value())
+    return withOutput(id.value());
+
+  // stages built without ids, e.g. in the editor, are told apart by number;
+  // outputs of different stages may share names, so the whole key is checked
+  lock_guard lock{m_mutex};
+  auto key = withOutput(stage.getName());
+  for (size_t i = 2;; ++i) {
+    auto it = m_connections.find(key);
+    if (it == m_connections.end() || it->second.connection.lock() == connection)
+      return key;
+    key = withOutput(stage.getName() + " #" + to_string(i));
+  }
+}
+
+const CapacityTuningSettings& ConnectionCapacityTuner::getSettings() const {
+  return m_settings;
+}
+
+size_t ConnectionCapacityTuner::usedMemory() const {
+  size_t memory = 0;
+  for (const auto& [id, tuned] : m_connections) {
+    if (auto connection = tuned.connection.lock(); connection != nullptr)
+      memory += connection->getCapacity() * connection->getTaskSize();
+  }
+
+  return memory;
+}
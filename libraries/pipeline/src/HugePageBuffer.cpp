@@ -0,0 +1,105 @@
+#include "HugePageBuffer.h"
+
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+size_t roundUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+}  // namespace
+
+HugePageBuffer::HugePageBuffer(size_t size)
+    : m_data(nullptr),
+      m_size(roundUp(size, hugePageSize)),
+      m_pageKind(PageKind::regular),
+      m_mapping(nullptr),
+      m_mappingSize(0) {
+  if (size == 0)
+    throw std::invalid_argument("size must be positive");
+
+#if defined(_WIN32)
+  if (auto largePage = GetLargePageMinimum(); largePage != 0) {
+    // requires SeLockMemoryPrivilege, fails without it
+    m_size = roundUp(size, largePage);
+    m_data = VirtualAlloc(nullptr, m_size,
+                          MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                          PAGE_READWRITE);
+    if (m_data != nullptr)
+      m_pageKind = PageKind::explicitHuge;
+  }
+
+  if (m_data == nullptr) {
+    m_size = roundUp(size, hugePageSize);
+    m_data = VirtualAlloc(nullptr, m_size, MEM_RESERVE | MEM_COMMIT,
+                          PAGE_READWRITE);
+    if (m_data == nullptr)
+      throw std::bad_alloc();
+  }
+#elif defined(__linux__)
+  // fails unless huge pages are reserved, e.g. via vm.nr_hugepages
+  m_data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1,
+                0);
+  if (m_data != MAP_FAILED) {
+    m_pageKind = PageKind::explicitHuge;
+    m_mapping = m_data;
+    m_mappingSize = m_size;
+  } else {
+    // transparent huge pages need the range to be aligned to the huge page
+    m_mappingSize = m_size + hugePageSize;
+    m_mapping = mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (m_mapping == MAP_FAILED)
+      throw std::bad_alloc();
+
+    auto address = reinterpret_cast<uintptr_t>(m_mapping);
+    m_data = reinterpret_cast<void*>(roundUp(address, hugePageSize));
+    if (madvise(m_data, m_size, MADV_HUGEPAGE) == 0)
+      m_pageKind = PageKind::transparentHuge;
+  }
+#else
+  m_data = ::operator new(m_size, std::align_val_t{hugePageSize});
+#endif
+
+  prefault();
+}
+
+HugePageBuffer::~HugePageBuffer() {
+#if defined(_WIN32)
+  VirtualFree(m_data, 0, MEM_RELEASE);
+#elif defined(__linux__)
+  munmap(m_mapping, m_mappingSize);
+#else
+  ::operator delete(m_data, std::align_val_t{hugePageSize});
+#endif
+}
+
+void* HugePageBuffer::data() const {
+  return m_data;
+}
+
+size_t HugePageBuffer::size() const {
+  return m_size;
+}
+
+PageKind HugePageBuffer::getPageKind() const {
+  return m_pageKind;
+}
+
+void HugePageBuffer::prefault() {
+  // one write per smallest page commits the whole buffer
+  constexpr size_t pageSize = 4096;
+  auto bytes = static_cast<volatile char*>(m_data);
+  for (size_t offset = 0; offset < m_size; offset += pageSize)
+    bytes[offset] = 0;
+}
@@ -5,7 +5,17 @@
 using namespace std;
 
 IPipelineStage::IPipelineStage(const string_view stageName)
-    : m_stageName(stageName), m_id(nullopt), m_parentId(nullopt) {}
+    : m_stageName(stageName),
+      m_id(nullopt),
+      m_cpu(nullopt),
+      m_finished{false},
+      m_processedCount{0},
+      m_failedCount{0},
+      m_totalLatencyNs{0},
+      m_maxLatencyNs{0} {
+  for (auto& bucket : m_latencyHistogram)
+    bucket = 0;
+}
 
 string IPipelineStage::getName() const {
   return m_stageName;
@@ -20,9 +30,102 @@ optional<string> IPipelineStage::getId() const {
 }
 
 void IPipelineStage::setParentId(const string_view id) {
-  m_parentId = id;
+  m_parentIds = {string(id)};
 }
 
 optional<string> IPipelineStage::getParentId() const {
-  return m_parentId;
+  if (m_parentIds.empty())
+    return nullopt;
+  return m_parentIds.front();
+}
+
+void IPipelineStage::setParentIds(const vector<string>& parentIds) {
+  m_parentIds = parentIds;
+}
+
+vector<string> IPipelineStage::getParentIds() const {
+  return m_parentIds;
+}
+
+void IPipelineStage::setOutputNames(const vector<string>& outputNames) {
+  m_outputNames = outputNames;
+}
+
+vector<string> IPipelineStage::getOutputNames() const {
+  return m_outputNames;
+}
+
+vector<shared_ptr<StageConnection>> IPipelineStage::getInConnections() const {
+  if (auto connection = getInConnection(); connection != nullptr)
+    return {connection};
+  return {};
+}
+
+vector<shared_ptr<StageConnection>> IPipelineStage::getOutConnections() const {
+  if (auto connection = getOutConnection(); connection != nullptr)
+    return {connection};
+  return {};
+}
+
+bool IPipelineStage::isFinished() const {
+  return m_finished;
+}
+
+void IPipelineStage::setCpuAffinity(optional<size_t> cpu) {
+  m_cpu = cpu;
+}
+
+optional<size_t> IPipelineStage::getCpuAffinity() const {
+  return m_cpu;
+}
+
+StageStatistics IPipelineStage::getStatistics() const {
+  StageStatistics statistics;
+  statistics.processedCount = m_processedCount.load(memory_order_relaxed);
+  statistics.failedCount = m_failedCount.load(memory_order_relaxed);
+  statistics.totalLatency =
+      chrono::nanoseconds{m_totalLatencyNs.load(memory_order_relaxed)};
+  statistics.maxLatency =
+      chrono::nanoseconds{m_maxLatencyNs.load(memory_order_relaxed)};
+  for (size_t i = 0; i < m_latencyHistogram.size(); ++i)
+    statistics.latencyHistogram[i] =
+        m_latencyHistogram[i].load(memory_order_relaxed);
+
+  return statistics;
+}
+
+void IPipelineStage::setExecutor(shared_ptr<StageExecutor> executor,
+                                 shared_ptr<ExecutorQuota> quota) {
+  m_executor = executor;
+  m_executorQuota = quota;
+}
+
+shared_ptr<StageExecutor> IPipelineStage::getExecutor() const {
+  return m_executor;
+}
+
+shared_ptr<ExecutorQuota> IPipelineStage::getExecutorQuota() const {
+  return m_executorQuota;
+}
+
+void IPipelineStage::finish() {
+  m_finished = true;
+}
+
+void IPipelineStage::taskProcessed(chrono::nanoseconds latency) {
+  // only the stage thread updates statistics, so relaxed order is enough
+  auto ns = max<int64_t>(latency.count(), 0);
+  m_processedCount.fetch_add(1, memory_order_relaxed);
+  m_totalLatencyNs.fetch_add(ns, memory_order_relaxed);
+  if (ns > m_maxLatencyNs.load(memory_order_relaxed))
+    m_maxLatencyNs.store(ns, memory_order_relaxed);
+
+  size_t bucket = 0;
+  while (bucket + 1 < m_latencyHistogram.size() && (ns >> bucket) != 0)
+    ++bucket;
+  m_latencyHistogram[bucket].fetch_add(1, memory_order_relaxed);
+}
+
+void IPipelineStage::taskFailed() {
+  m_failedCount.fetch_add(1, memory_order_relaxed);
 }
@@ -1,5 +1,8 @@
 #include "Pipeline.h"
+#include "ConnectionCapacityTuner.h"
+#include "PipelineException.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 using namespace std;
@@ -12,7 +15,91 @@ void Pipeline::addStage(std::shared_ptr<IPipelineStage> stage) {
   if (!stage)
     throw std::invalid_argument("stage is null");
 
+  if (m_executor != nullptr)
+    stage->setExecutor(m_executor, m_executorQuota);
+
   m_stages.push_back(stage);
+
+  if (m_running && m_capacityTuner != nullptr)
+    m_capacityTuner->addStage(*stage);
+
+  if (m_running)
+    stage->run();
+}
+
+void Pipeline::replaceStage(std::shared_ptr<IPipelineStage> stage,
+                            std::shared_ptr<IPipelineStage> newStage) {
+  if (!stage)
+    throw std::invalid_argument("stage is null");
+
+  if (!newStage)
+    throw std::invalid_argument("newStage is null");
+
+  auto it = find(m_stages.begin(), m_stages.end(), stage);
+  if (it == m_stages.end())
+    throw std::invalid_argument("stage " + stage->getName() + " not found");
+
+  // stages consuming the output of the replaced stage must not be affected
+  auto outConnections = stage->getOutConnections();
+  if (!outConnections.empty() &&
+      outConnections != newStage->getOutConnections())
+    throw PipelineException("new stage must produce to the same connection");
+
+  stage->shutdown();
+
+  auto cursor = stage->getConsumerCursor();
+  if (cursor.has_value() &&
+      stage->getInConnection() == newStage->getInConnection())
+    newStage->attachConsumerCursor(cursor.value());
+  else
+    stage->disconnect();
+
+  if (!newStage->getId().has_value() && stage->getId().has_value())
+    newStage->setId(stage->getId().value());
+  if (newStage->getParentIds().empty() && !stage->getParentIds().empty() &&
+      stage->getInConnections() == newStage->getInConnections())
+    newStage->setParentIds(stage->getParentIds());
+  if (newStage->getOutputNames().empty())
+    newStage->setOutputNames(stage->getOutputNames());
+
+  if (m_executor != nullptr)
+    newStage->setExecutor(m_executor, m_executorQuota);
+
+  *it = newStage;
+
+  if (m_running)
+    newStage->run();
+}
+
+void Pipeline::removeStage(std::shared_ptr<IPipelineStage> stage) {
+  if (!stage)
+    throw std::invalid_argument("stage is null");
+
+  auto it = find(m_stages.begin(), m_stages.end(), stage);
+  if (it == m_stages.end())
+    throw std::invalid_argument("stage " + stage->getName() + " not found");
+
+  auto outConnections = stage->getOutConnections();
+  for (const auto& outConnection : outConnections) {
+    for (const auto& s : m_stages) {
+      auto inConnections = s->getInConnections();
+      if (find(inConnections.begin(), inConnections.end(), outConnection) !=
+          inConnections.end())
+        throw PipelineException("stage " + stage->getName() +
+                                " has dependent stages");
+    }
+  }
+
+  stage->shutdown();
+  stage->disconnect();
+  m_stages.erase(it);
+
+  for (const auto& outConnection : outConnections) {
+    outConnection->shutdown();
+    m_connections.erase(
+        remove(m_connections.begin(), m_connections.end(), outConnection),
+        m_connections.end());
+  }
 }
 
 void Pipeline::addConnection(std::shared_ptr<StageConnection> connection) {
@@ -42,12 +129,40 @@ std::shared_ptr<IPipelineStage> Pipeline::getStage(
                               " not found");
 }
 
+std::shared_ptr<IPipelineStage> Pipeline::getStageById(
+    const std::string_view id) {
+  for (auto& stage : m_stages) {
+    if (stage->getId() == id)
+      return stage;
+  }
+
+  throw std::invalid_argument(std::string("stage with id ") + id.data() +
+                              " not found");
+}
+
+std::shared_ptr<StageConnection> Pipeline::getConnectionForStage(
+    const std::string_view stageName) {
+  return getStage(stageName)->getOutConnection();
+}
+
 void Pipeline::run() {
+  m_running = true;
+
   for (auto& it : m_stages) 
     it->run();
+
+  if (m_capacityTuner != nullptr) {
+    m_capacityTuner->addPipeline(*this);
+    m_capacityTuner->run();
+  }
 }
 
 void Pipeline::shutdown() {
+  m_running = false;
+
+  if (m_capacityTuner != nullptr)
+    m_capacityTuner->shutdown();
+
   for (auto& it : m_connections)
     it->shutdown();
 
@@ -55,4 +170,45 @@ void Pipeline::shutdown() {
     it->shutdown();
 }
 
-Pipeline::Pipeline() {}
+bool Pipeline::producersFinished() const {
+  bool hasProducers = false;
+  for (auto& stage : m_stages) {
+    if (stage->getStageType() != PipelineStageType::producer)
+      continue;
+
+    hasProducers = true;
+    if (!stage->isFinished())
+      return false;
+  }
+
+  return hasProducers;
+}
+
+void Pipeline::setExecutor(std::shared_ptr<StageExecutor> executor,
+                           std::shared_ptr<ExecutorQuota> quota) {
+  m_executor = executor;
+  m_executorQuota = quota;
+
+  for (auto& stage : m_stages)
+    stage->setExecutor(executor, quota);
+}
+
+void Pipeline::setCapacityTuning(
+    std::optional<CapacityTuningSettings> settings) {
+  if (m_running)
+    throw PipelineException("capacity tuning cannot be changed while running");
+
+  if (settings.has_value())
+    m_capacityTuner = make_unique<ConnectionCapacityTuner>(settings.value());
+  else
+    m_capacityTuner.reset();
+}
+
+std::optional<CapacityTuningSettings> Pipeline::getCapacityTuning() const {
+  if (m_capacityTuner == nullptr)
+    return nullopt;
+
+  return m_capacityTuner->getSettings();
+}
+
+Pipeline::Pipeline() : m_running(false) {}
@@ -3,6 +3,14 @@
 
 #include <string>
 
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 using namespace std;
 using namespace string_literals;
 
@@ -53,3 +61,22 @@ string PipelineHelpers::toString(ConsumptionStrategy t) {
                               to_string(int(t)) + " to corresponding string");
   }
 }
+
+bool PipelineHelpers::pinCurrentThread(size_t cpu) {
+#if defined(_WIN32)
+  if (cpu >= sizeof(DWORD_PTR) * 8)
+    return false;
+
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#elif defined(__linux__)
+  if (cpu >= CPU_SETSIZE)
+    return false;
+
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpu, &cpuSet);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,31 @@
+#include "StageStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+chrono::nanoseconds StageStatistics::averageLatency() const {
+  if (processedCount == 0)
+    return chrono::nanoseconds{0};
+
+  return totalLatency / processedCount;
+}
+
+chrono::nanoseconds StageStatistics::latencyPercentile(double quantile) const {
+  if (processedCount == 0)
+    return chrono::nanoseconds{0};
+
+  quantile = clamp(quantile, 0.0, 1.0);
+  auto rank = max<size_t>(1, size_t(ceil(quantile * processedCount)));
+
+  size_t count = 0;
+  for (size_t i = 0; i < latencyHistogram.size(); ++i) {
+    count += latencyHistogram[i];
+    if (count >= rank)
+      return min(chrono::nanoseconds{int64_t(1) << min<size_t>(i, 62)},
+                 maxLatency);
+  }
+
+  return maxLatency;
+}
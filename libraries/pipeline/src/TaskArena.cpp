@@ -0,0 +1,25 @@
+#include "TaskArena.h"
+
+#include <cstdint>
+
+TaskArena::TaskArena(size_t size) : m_buffer(size), m_used(0) {}
+
+void* TaskArena::allocate(size_t size, size_t alignment) {
+  auto base = reinterpret_cast<uintptr_t>(m_buffer.data());
+  auto offset = (base + m_used + alignment - 1) / alignment * alignment - base;
+  if (offset + size > m_buffer.size())
+    return nullptr;
+
+  m_used = offset + size;
+  return reinterpret_cast<char*>(m_buffer.data()) + offset;
+}
+
+bool TaskArena::contains(const void* p) const {
+  auto begin = reinterpret_cast<uintptr_t>(m_buffer.data());
+  auto address = reinterpret_cast<uintptr_t>(p);
+  return address >= begin && address - begin < m_buffer.size();
+}
+
+PageKind TaskArena::getPageKind() const {
+  return m_buffer.getPageKind();
+}
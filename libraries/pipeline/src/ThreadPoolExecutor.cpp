@@ -0,0 +1,177 @@
+#include "ThreadPoolExecutor.h"
+#include "IPipelineStage.h"
+#include "PipelineException.h"
+
+#include <iostream>
+
+using namespace std;
+
+ThreadPoolExecutor::ThreadPoolExecutor(ThreadPoolSettings settings)
+    : m_settings(settings), m_shutdownSignaled(false) {
+  if (m_settings.threadsCount == 0)
+    throw invalid_argument("threadsCount must be positive");
+
+  for (size_t i = 0; i < m_settings.threadsCount; ++i)
+    m_threads.emplace_back([this] { work(); });
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+  {
+    lock_guard lock{m_mutex};
+    m_shutdownSignaled = true;
+  }
+  m_cv.notify_all();
+
+  for (auto& thread : m_threads)
+    thread.join();
+}
+
+void ThreadPoolExecutor::schedule(IPipelineStage& stage,
+                                  shared_ptr<ExecutorQuota> quota) {
+  if (quota != nullptr && quota->maxConcurrency == 0)
+    throw invalid_argument("quota must allow at least one thread");
+
+  {
+    lock_guard lock{m_mutex};
+    for (const auto& scheduled : m_stages) {
+      if (scheduled.stage == &stage && !scheduled.removed)
+        throw PipelineException("stage " + stage.getName() +
+                                " is already scheduled");
+    }
+
+    m_stages.push_back(
+        {&stage, quota, Clock::now(), shortenWaitPeriods(stage)});
+  }
+  m_cv.notify_one();
+}
+
+void ThreadPoolExecutor::unschedule(IPipelineStage& stage) {
+  unique_lock lock{m_mutex};
+
+  auto it = find_if(m_stages.begin(), m_stages.end(),
+                    [&stage](const ScheduledStage& scheduled) {
+                      return scheduled.stage == &stage && !scheduled.removed;
+                    });
+  if (it == m_stages.end())
+    return;
+
+  it->removed = true;
+  m_cv.wait(lock, [it] { return !it->running; });
+  restoreWaitPeriods(it->connections);
+  m_stages.erase(it);
+}
+
+size_t ThreadPoolExecutor::getThreadsCount() const {
+  return m_threads.size();
+}
+
+size_t ThreadPoolExecutor::getScheduledCount() const {
+  lock_guard lock{m_mutex};
+  return count_if(
+      m_stages.begin(), m_stages.end(),
+      [](const ScheduledStage& scheduled) { return !scheduled.removed; });
+}
+
+void ThreadPoolExecutor::work() {
+  unique_lock lock{m_mutex};
+  while (!m_shutdownSignaled) {
+    auto now = Clock::now();
+    auto scheduled = pickStage(now);
+    if (scheduled == nullptr) {
+      m_cv.wait_until(lock, nextWakeUp(now));
+      continue;
+    }
+
+    scheduled->running = true;
+    if (scheduled->quota != nullptr)
+      m_runningByQuota[scheduled->quota.get()]++;
+    lock.unlock();
+
+    bool processed = false;
+    try {
+      processed = scheduled->stage->step();
+    } catch (std::exception& ex) {
+      cerr << "ThreadPoolExecutor: " << ex.what() << endl;
+    }
+
+    lock.lock();
+    scheduled->running = false;
+    if (scheduled->quota != nullptr &&
+        --m_runningByQuota[scheduled->quota.get()] == 0)
+      m_runningByQuota.erase(scheduled->quota.get());
+    if (!processed)
+      scheduled->nextRun = Clock::now() + m_settings.idleBackoff;
+
+    // wakes up unschedule() and threads waiting for the quota
+    m_cv.notify_all();
+  }
+}
+
+ThreadPoolExecutor::ScheduledStage* ThreadPoolExecutor::pickStage(
+    Clock::time_point now) {
+  for (auto it = m_stages.begin(); it != m_stages.end(); ++it) {
+    if (it->running || it->removed || it->nextRun > now ||
+        it->stage->isFinished())
+      continue;
+
+    if (it->quota != nullptr) {
+      auto running = m_runningByQuota.find(it->quota.get());
+      if (running != m_runningByQuota.end() &&
+          running->second >= it->quota->maxConcurrency)
+        continue;
+    }
+
+    // moving the stage to the end gives other stages a chance to run
+    m_stages.splice(m_stages.end(), m_stages, it);
+    return &m_stages.back();
+  }
+
+  return nullptr;
+}
+
+ThreadPoolExecutor::Clock::time_point ThreadPoolExecutor::nextWakeUp(
+    Clock::time_point now) const {
+  // finished stages and stages blocked by quota are rechecked periodically
+  auto wakeUp = now + max<Clock::duration>(m_settings.idleBackoff,
+                                           chrono::milliseconds(10));
+  for (const auto& scheduled : m_stages) {
+    if (!scheduled.running && !scheduled.removed && scheduled.nextRun > now)
+      wakeUp = min(wakeUp, scheduled.nextRun);
+  }
+
+  return wakeUp;
+}
+
+vector<const StageConnection*> ThreadPoolExecutor::shortenWaitPeriods(
+    const IPipelineStage& stage) {
+  auto connections = stage.getInConnections();
+  for (auto& connection : stage.getOutConnections())
+    connections.push_back(connection);
+
+  vector<const StageConnection*> used;
+  for (const auto& connection : connections) {
+    auto& shortened = m_connections[connection.get()];
+    // the entry may remain from a destroyed connection at the same address
+    if (shortened.connection.lock() != connection)
+      shortened = {connection, connection->getWaitPeriod(), 0};
+
+    if (shortened.stagesCount++ == 0)
+      connection->setWaitPeriod(m_settings.connectionWaitPeriod);
+    used.push_back(connection.get());
+  }
+
+  return used;
+}
+
+void ThreadPoolExecutor::restoreWaitPeriods(
+    const vector<const StageConnection*>& used) {
+  for (auto key : used) {
+    auto it = m_connections.find(key);
+    if (it == m_connections.end() || --it->second.stagesCount > 0)
+      continue;
+
+    if (auto connection = it->second.connection.lock(); connection != nullptr)
+      connection->setWaitPeriod(it->second.waitPeriod);
+    m_connections.erase(it);
+  }
+}
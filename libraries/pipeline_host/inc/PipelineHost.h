@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ConnectionPool.h"
+#include "Pipeline.h"
+#include "ThreadPoolExecutor.h"
+#include "YamlToPipeline.h"
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct PipelineHostSettings {
+  ThreadPoolSettings executor;
+  // database connections shared by all pipelines
+  size_t dbConnectionsCount = 8;
+};
+
+// resources a single pipeline may take from the host, unlimited if not set
+struct PipelineQuota {
+  std::optional<size_t> maxThreads;
+  std::optional<size_t> maxDbConnections;
+};
+
+// runs many pipelines on a shared executor and database connection pool, so
+// the numbers of threads and connections don't grow with pipelines count
+class PipelineHost {
+ public:
+  PipelineHost(PipelineHostSettings settings = {});
+
+  ~PipelineHost();
+
+  std::shared_ptr<Pipeline> loadPipeline(const std::string& name,
+                                         const std::filesystem::path& file,
+                                         PipelineQuota quota = {});
+
+  std::shared_ptr<Pipeline> loadPipelineFromString(const std::string& name,
+                                                   const std::string& input,
+                                                   PipelineQuota quota = {});
+
+  // database stages of an already constructed pipeline keep their connections
+  void addPipeline(const std::string& name,
+                   std::shared_ptr<Pipeline> pipeline,
+                   PipelineQuota quota = {});
+
+  void removePipeline(const std::string& name);
+
+  // pipelines added after the call are started immediately
+  void run();
+
+  void shutdown();
+
+  std::shared_ptr<Pipeline> getPipeline(const std::string& name) const;
+
+  std::vector<std::string> getPipelineNames() const;
+
+  std::shared_ptr<ThreadPoolExecutor> getExecutor() const;
+
+  ConnectionPoolPtr getConnectionPool() const;
+
+ private:
+  YamlToPipeline::StageInitializer stageInitializer(
+      const PipelineQuota& quota) const;
+
+  void host(const std::string& name,
+            std::shared_ptr<Pipeline> pipeline,
+            const PipelineQuota& quota);
+
+ private:
+  std::shared_ptr<ThreadPoolExecutor> m_executor;
+  ConnectionPoolPtr m_connectionPool;
+
+  std::map<std::string, std::shared_ptr<Pipeline>> m_pipelines;
+  bool m_running;
+  mutable std::mutex m_mutex;
+};
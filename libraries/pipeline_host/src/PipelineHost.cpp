@@ -0,0 +1,135 @@
+#include "PipelineHost.h"
+#include "DbParameterizedStage.h"
+
+#include <stdexcept>
+
+using namespace std;
+namespace fs = filesystem;
+
+PipelineHost::PipelineHost(PipelineHostSettings settings)
+    : m_executor(make_shared<ThreadPoolExecutor>(settings.executor)),
+      m_connectionPool(ConnectionPool::Create(settings.dbConnectionsCount)),
+      m_running(false) {}
+
+PipelineHost::~PipelineHost() {
+  shutdown();
+}
+
+shared_ptr<Pipeline> PipelineHost::loadPipeline(const string& name,
+                                                const fs::path& file,
+                                                PipelineQuota quota) {
+  auto pipeline = YamlToPipeline::parseFromFile(file, stageInitializer(quota));
+  host(name, pipeline, quota);
+
+  return pipeline;
+}
+
+shared_ptr<Pipeline> PipelineHost::loadPipelineFromString(const string& name,
+                                                          const string& input,
+                                                          PipelineQuota quota) {
+  auto pipeline =
+      YamlToPipeline::parseFromString(input, stageInitializer(quota));
+  host(name, pipeline, quota);
+
+  return pipeline;
+}
+
+void PipelineHost::addPipeline(const string& name,
+                               shared_ptr<Pipeline> pipeline,
+                               PipelineQuota quota) {
+  if (!pipeline)
+    throw invalid_argument("pipeline is null");
+
+  host(name, pipeline, quota);
+}
+
+void PipelineHost::removePipeline(const string& name) {
+  shared_ptr<Pipeline> pipeline;
+  {
+    lock_guard lock{m_mutex};
+    auto it = m_pipelines.find(name);
+    if (it == m_pipelines.end())
+      throw invalid_argument("pipeline " + name + " not found");
+
+    pipeline = it->second;
+    m_pipelines.erase(it);
+  }
+
+  pipeline->shutdown();
+}
+
+void PipelineHost::run() {
+  lock_guard lock{m_mutex};
+  if (m_running)
+    return;
+
+  m_running = true;
+  for (auto& [name, pipeline] : m_pipelines)
+    pipeline->run();
+}
+
+void PipelineHost::shutdown() {
+  lock_guard lock{m_mutex};
+  m_running = false;
+
+  for (auto& [name, pipeline] : m_pipelines)
+    pipeline->shutdown();
+}
+
+shared_ptr<Pipeline> PipelineHost::getPipeline(const string& name) const {
+  lock_guard lock{m_mutex};
+  auto it = m_pipelines.find(name);
+  if (it == m_pipelines.end())
+    throw invalid_argument("pipeline " + name + " not found");
+
+  return it->second;
+}
+
+vector<string> PipelineHost::getPipelineNames() const {
+  lock_guard lock{m_mutex};
+
+  vector<string> names;
+  for (const auto& [name, pipeline] : m_pipelines)
+    names.push_back(name);
+
+  return names;
+}
+
+shared_ptr<ThreadPoolExecutor> PipelineHost::getExecutor() const {
+  return m_executor;
+}
+
+ConnectionPoolPtr PipelineHost::getConnectionPool() const {
+  return m_connectionPool;
+}
+
+YamlToPipeline::StageInitializer PipelineHost::stageInitializer(
+    const PipelineQuota& quota) const {
+  auto pool = quota.maxDbConnections.has_value()
+                  ? m_connectionPool->CreateQuota(*quota.maxDbConnections)
+                  : m_connectionPool;
+
+  return [pool](IPipelineStage& stage) {
+    if (auto dbStage = dynamic_cast<DbParameterizedStage*>(&stage))
+      dbStage->SetConnectionPool(pool);
+  };
+}
+
+void PipelineHost::host(const string& name,
+                        shared_ptr<Pipeline> pipeline,
+                        const PipelineQuota& quota) {
+  shared_ptr<ExecutorQuota> executorQuota;
+  if (quota.maxThreads.has_value())
+    executorQuota =
+        make_shared<ExecutorQuota>(ExecutorQuota{quota.maxThreads.value()});
+
+  lock_guard lock{m_mutex};
+  if (m_pipelines.count(name) != 0)
+    throw invalid_argument("pipeline " + name + " already exists");
+
+  pipeline->setExecutor(m_executor, executorQuota);
+  m_pipelines[name] = pipeline;
+
+  if (m_running)
+    pipeline->run();
+}
@@ -9,6 +9,7 @@
 #include "PipelineStageType.h"
 #include "ProducerAndConsumerStage.h"
 #include "ProducerStage.h"
+#include "SampleType.h"
 
 #include <functional>
 #include <memory>
@@ -31,6 +32,14 @@ class PipelineRegistry {
           ConsumptionStrategy,
           std::shared_ptr<StageConnection>,
           std::shared_ptr<StageConnection>)>;
+  using MultiInputStageFactory = std::function<std::shared_ptr<IPipelineStage>(
+      ConsumptionStrategy,
+      const std::vector<std::shared_ptr<StageConnection>>&,
+      std::shared_ptr<StageConnection>)>;
+  using MultiOutputStageFactory = std::function<std::shared_ptr<IPipelineStage>(
+      ConsumptionStrategy,
+      std::shared_ptr<StageConnection>,
+      const std::vector<std::shared_ptr<StageConnection>>&)>;
   using ProducerConnectionFactory =
       std::function<std::shared_ptr<StageConnection>(size_t)>;
   using ConsumerConnectionFactory =
@@ -66,8 +75,46 @@ class PipelineRegistry {
       const std::string& key,
       const ConsumerAndProducerStageFactory factory);
 
+  // stages consuming from several connections, see MultiInputStage
+  template <typename MultiInputT>
+  void registerMultiInput(const std::string& key);
+
+  template <typename MultiInputT>
+  void registerMultiInputFactory(const std::string& key,
+                                 const MultiInputStageFactory factory);
+
+  // stages producing to several connections, see MultiOutputStage
+  template <typename MultiOutputT>
+  void registerMultiOutput(const std::string& key);
+
+  template <typename MultiOutputT>
+  void registerMultiOutputFactory(const std::string& key,
+                                  const MultiOutputStageFactory factory);
+
+  // register StageT<T> under StageT<T>::stageName for every T of the list
+  template <template <typename> class StageT, typename... T>
+  void registerProducers(SampleTypeList<T...>);
+
+  template <template <typename> class StageT, typename... T>
+  void registerConsumers(SampleTypeList<T...>);
+
+  template <template <typename> class StageT, typename... T>
+  void registerConsumersAndProducers(SampleTypeList<T...>);
+
+  template <template <typename> class StageT, typename... T>
+  void registerMultiInputs(SampleTypeList<T...>);
+
+  template <template <typename> class StageT, typename... T>
+  void registerMultiOutputs(SampleTypeList<T...>);
+
   PipelineStageType getStageType(const std::string& key) const;
 
+  // whether the stage consumes from several connections
+  bool isMultiInput(const std::string& key) const;
+
+  // whether the stage produces to several connections
+  bool isMultiOutput(const std::string& key) const;
+
   std::shared_ptr<StageConnection> constructProducerConnection(
       const std::string& key,
       size_t connectionSize) const;
@@ -91,11 +138,26 @@ class PipelineRegistry {
       std::shared_ptr<StageConnection> inConnection,
       std::shared_ptr<StageConnection> outConnection) const;
 
+  std::shared_ptr<IPipelineStage> constructMultiInput(
+      const std::string& key,
+      ConsumptionStrategy strategy,
+      const std::vector<std::shared_ptr<StageConnection>>& inConnections,
+      std::shared_ptr<StageConnection> outConnection) const;
+
+  std::shared_ptr<IPipelineStage> constructMultiOutput(
+      const std::string& key,
+      ConsumptionStrategy strategy,
+      std::shared_ptr<StageConnection> inConnection,
+      const std::vector<std::shared_ptr<StageConnection>>& outConnections)
+      const;
+
  private:
   PipelineRegistry();
 
   static void Init();
 
+  bool isRegistered(const std::string& key) const;
+
   template <typename ProducerT>
   void registerProducerConnection(const std::string& key);
 
@@ -107,6 +169,8 @@ class PipelineRegistry {
   std::unordered_map<std::string, ConsumerStageFactory> m_consumers;
   std::unordered_map<std::string, ConsumerAndProducerStageFactory>
       m_consumersProducers;
+  std::unordered_map<std::string, MultiInputStageFactory> m_multiInputs;
+  std::unordered_map<std::string, MultiOutputStageFactory> m_multiOutputs;
 
   std::unordered_map<std::string, ProducerConnectionFactory>
       m_producerConnections;
@@ -134,9 +198,7 @@ template <typename ProducerT>
 void PipelineRegistry::registerProducerFactory(
     const std::string& key,
     const ProducerStageFactory factory) {
-  if (m_producers.find(key) != m_producers.end() ||
-      m_consumers.find(key) != m_consumers.end() ||
-      m_consumersProducers.find(key) != m_consumersProducers.end())
+  if (isRegistered(key))
     throw PipelineRegistryException("stage has already been added");
   m_producers[key] = factory;
   registerProducerConnection<ProducerT>(key);
@@ -157,9 +219,7 @@ template <typename ConsumerT>
 void PipelineRegistry::registerConsumerFactory(
     const std::string& key,
     const ConsumerStageFactory factory) {
-  if (m_producers.find(key) != m_producers.end() ||
-      m_consumers.find(key) != m_consumers.end() ||
-      m_consumersProducers.find(key) != m_consumersProducers.end())
+  if (isRegistered(key))
     throw PipelineRegistryException("stage has already been added");
   m_consumers[key] = factory;
   registerConsumerConnection<ConsumerT>(key);
@@ -185,15 +245,102 @@ template <typename ConsumerAndProducerT>
 void PipelineRegistry::registerConsumerAndProducerFactory(
     const std::string& key,
     const ConsumerAndProducerStageFactory factory) {
-  if (m_producers.find(key) != m_producers.end() ||
-      m_consumers.find(key) != m_consumers.end() ||
-      m_consumersProducers.find(key) != m_consumersProducers.end())
+  if (isRegistered(key))
     throw PipelineRegistryException("stage has already been added");
   m_consumersProducers[key] = factory;
   registerConsumerConnection<ConsumerAndProducerT>(key);
   registerProducerConnection<ConsumerAndProducerT>(key);
 }
 
+template <typename MultiInputT>
+void PipelineRegistry::registerMultiInput(const std::string& key) {
+  registerMultiInputFactory<MultiInputT>(
+      key, [](ConsumptionStrategy strategy,
+              const std::vector<std::shared_ptr<StageConnection>>&
+                  inConnections,
+              std::shared_ptr<StageConnection> outConnection) {
+        std::vector<std::shared_ptr<
+            InStageConnection<typename MultiInputT::consumptionT>>>
+            in;
+        for (const auto& connection : inConnections)
+          in.push_back(std::dynamic_pointer_cast<
+                       InStageConnection<typename MultiInputT::consumptionT>>(
+              connection));
+        auto out = std::dynamic_pointer_cast<
+            OutStageConnection<typename MultiInputT::productionT>>(
+            outConnection);
+        return std::make_shared<MultiInputT>(strategy, in, out);
+      });
+}
+
+template <typename MultiInputT>
+void PipelineRegistry::registerMultiInputFactory(
+    const std::string& key,
+    const MultiInputStageFactory factory) {
+  if (isRegistered(key))
+    throw PipelineRegistryException("stage has already been added");
+  m_multiInputs[key] = factory;
+  registerConsumerConnection<MultiInputT>(key);
+  registerProducerConnection<MultiInputT>(key);
+}
+
+template <typename MultiOutputT>
+void PipelineRegistry::registerMultiOutput(const std::string& key) {
+  registerMultiOutputFactory<MultiOutputT>(
+      key, [](ConsumptionStrategy strategy,
+              std::shared_ptr<StageConnection> inConnection,
+              const std::vector<std::shared_ptr<StageConnection>>&
+                  outConnections) {
+        auto in = std::dynamic_pointer_cast<
+            InStageConnection<typename MultiOutputT::consumptionT>>(
+            inConnection);
+        std::vector<std::shared_ptr<
+            OutStageConnection<typename MultiOutputT::productionT>>>
+            out;
+        for (const auto& connection : outConnections)
+          out.push_back(std::dynamic_pointer_cast<
+                        OutStageConnection<typename MultiOutputT::productionT>>(
+              connection));
+        return std::make_shared<MultiOutputT>(strategy, in, out);
+      });
+}
+
+template <typename MultiOutputT>
+void PipelineRegistry::registerMultiOutputFactory(
+    const std::string& key,
+    const MultiOutputStageFactory factory) {
+  if (isRegistered(key))
+    throw PipelineRegistryException("stage has already been added");
+  m_multiOutputs[key] = factory;
+  registerConsumerConnection<MultiOutputT>(key);
+  registerProducerConnection<MultiOutputT>(key);
+}
+
+template <template <typename> class StageT, typename... T>
+void PipelineRegistry::registerProducers(SampleTypeList<T...>) {
+  (registerProducer<StageT<T>>(StageT<T>::stageName), ...);
+}
+
+template <template <typename> class StageT, typename... T>
+void PipelineRegistry::registerConsumers(SampleTypeList<T...>) {
+  (registerConsumer<StageT<T>>(StageT<T>::stageName), ...);
+}
+
+template <template <typename> class StageT, typename... T>
+void PipelineRegistry::registerConsumersAndProducers(SampleTypeList<T...>) {
+  (registerConsumerAndProducer<StageT<T>>(StageT<T>::stageName), ...);
+}
+
+template <template <typename> class StageT, typename... T>
+void PipelineRegistry::registerMultiInputs(SampleTypeList<T...>) {
+  (registerMultiInput<StageT<T>>(StageT<T>::stageName), ...);
+}
+
+template <template <typename> class StageT, typename... T>
+void PipelineRegistry::registerMultiOutputs(SampleTypeList<T...>) {
+  (registerMultiOutput<StageT<T>>(StageT<T>::stageName), ...);
+}
+
 template <typename ProducerT>
 void PipelineRegistry::registerProducerConnection(const std::string& key) {
   if (m_producerConnections.find(key) != m_producerConnections.end())
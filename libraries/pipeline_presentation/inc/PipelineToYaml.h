@@ -4,6 +4,7 @@
 #include "YamlPipelineStage.h"
 
 #include <filesystem>
+#include <optional>
 
 #include <yaml-cpp/yaml.h>
 
@@ -19,13 +20,20 @@ class PipelineToYaml {
   static YamlPipelineStage toYamlStage(
       const std::shared_ptr<IPipelineStage> stage);
 
-  static void emitToFile(const std::list<YamlPipelineStage>& stages,
-                         const std::filesystem::path& file);
+  static void emitToFile(
+      const std::optional<CapacityTuningSettings>& capacityTuning,
+      const std::list<YamlPipelineStage>& stages,
+      const std::filesystem::path& file);
 
-  static std::string emitToString(const std::list<YamlPipelineStage>& stages);
+  static std::string emitToString(
+      const std::optional<CapacityTuningSettings>& capacityTuning,
+      const std::list<YamlPipelineStage>& stages);
 
   static std::list<YamlPipelineStage> reorderStages(
       const std::list<YamlPipelineStage>&);
 
+  static void emitCapacityTuning(YAML::Emitter& emitter,
+                                 const CapacityTuningSettings& settings);
+
   static void emit(YAML::Emitter& emitter, const std::list<YamlPipelineStage>&);
 };
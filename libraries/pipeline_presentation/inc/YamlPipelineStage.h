@@ -5,11 +5,24 @@
 
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 struct YamlPipelineStage {
+  // capacity of the out connection when connectionSize is not set
+  static constexpr size_t defaultConnectionSize = 512;
+
   std::string stageName;
   std::string stageId;
   PipelineStageType stageType;
-  std::optional<std::string> parentStageId;
+  // empty for producers, several for stages consuming from several stages
+  std::vector<std::string> parentStageIds;
   std::optional<ConsumptionStrategy> consumptionStrategy;
+  std::optional<size_t> connectionSize;
+  // values for stages implementing IParameterized, in declaration order
+  std::vector<std::pair<std::string, std::string>> parameters;
+  // names of the outputs of a stage routing to several connections; their
+  // children use "<stageId>.<output>" as parentId, so neither stage ids nor
+  // output names may contain '.'
+  std::vector<std::string> outputs;
 };
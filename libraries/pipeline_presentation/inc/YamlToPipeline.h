@@ -1,26 +1,44 @@
 #pragma once
 
+#include "CapacityTuningSettings.h"
 #include "Pipeline.h"
 #include "PipelineRegistry.h"
 #include "YamlPipelineStage.h"
 
 #include <filesystem>
+#include <functional>
 #include <optional>
 
 #include <yaml-cpp/yaml.h>
 
 class YamlToPipeline {
  public:
-  static std::shared_ptr<Pipeline> parseFromFile(const std::filesystem::path& path);
+  // top-level key of the settings of ConnectionCapacityTuner, the pipeline
+  // is run with fixed connection sizes without it
+  static constexpr auto capacityTuningKey = "capacityTuning";
 
-  static std::shared_ptr<Pipeline> parseFromString(const std::string& input);
+  // called for every constructed stage before its parameters are applied
+  using StageInitializer = std::function<void(IPipelineStage&)>;
+
+  static std::shared_ptr<Pipeline> parseFromFile(
+      const std::filesystem::path& path,
+      const StageInitializer& initializer = {});
+
+  static std::shared_ptr<Pipeline> parseFromString(
+      const std::string& input,
+      const StageInitializer& initializer = {});
 
  private:
   static std::vector<YamlPipelineStage> parse(const YAML::Node& node);
 
+  static std::optional<CapacityTuningSettings> parseCapacityTuning(
+      const YAML::Node& node);
+
   static YamlPipelineStage parseStage(const YAML::Node& node);
 
-  static std::shared_ptr<Pipeline> toPipeline(const std::vector<YamlPipelineStage>& stages);
+  static std::shared_ptr<Pipeline> toPipeline(
+      const std::vector<YamlPipelineStage>& stages,
+      const StageInitializer& initializer);
 
   static std::shared_ptr<IPipelineStage> constructProducer(
       const PipelineRegistry& registry,
@@ -38,5 +56,10 @@ class YamlToPipeline {
         std::map<std::string, std::shared_ptr<StageConnection>>&
             connectionsMap);
 
-  static constexpr size_t defaultConnectionSize = 512;
+  static std::shared_ptr<StageConnection> constructOutConnection(
+      const PipelineRegistry& registry,
+      const YamlPipelineStage& yamlStage);
+
+  static void applyParameters(std::shared_ptr<IPipelineStage> stage,
+                              const YamlPipelineStage& yamlStage);
 };
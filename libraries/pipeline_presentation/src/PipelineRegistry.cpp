@@ -1,14 +1,74 @@
 #include "PipelineRegistry.h"
 
+#include "AsyncFileRecorderStage.h"
+#include "AsyncFileReplayStage.h"
 #include "DoubleVisualizer.h"
 #include "Int32RandomGenerator.h"
 #include "Int32ToDoubleConverter.h"
 #include "Int32Visualizer.h"
 #include "DbReadStage.h"
 #include "DbWriteStage.h"
+#include "DownsamplingStage.h"
+#include "FileRecorderStage.h"
+#include "FileReplayStage.h"
+#include "FirFilterStage.h"
+#include "FrameMergeStage.h"
+#include "FramePackStage.h"
+#include "FrameSelectStage.h"
+#include "HashRouter.h"
+#include "IirFilterStage.h"
+#include "JoinStage.h"
+#include "MergeStage.h"
+#include "QuantileStage.h"
+#include "RangeRouter.h"
+#include "SignalGenerator.h"
+#include "SocketReadStage.h"
+#include "SocketWriteStage.h"
+#include "TimestampStage.h"
+#include "TriggerStage.h"
+#include "WindowAggregationStage.h"
+#include "ZipStage.h"
 
 using namespace std;
 
+namespace {
+// selection of fewer channels from frames of T values and merging of frames
+// into one with more channels
+template <typename T>
+void registerFrameChannels(PipelineRegistry& registry) {
+  using Frame8 = Frame<T, 8, frameSamples>;
+  using Frame16 = Frame<T, 16, frameSamples>;
+  using Frame32 = Frame<T, 32, frameSamples>;
+  using Frame64 = Frame<T, 64, frameSamples>;
+
+  registry.registerConsumerAndProducer<FrameSelectStage<Frame64, Frame32>>(
+      FrameSelectStage<Frame64, Frame32>::stageName);
+  registry.registerConsumerAndProducer<FrameSelectStage<Frame64, Frame16>>(
+      FrameSelectStage<Frame64, Frame16>::stageName);
+  registry.registerConsumerAndProducer<FrameSelectStage<Frame64, Frame8>>(
+      FrameSelectStage<Frame64, Frame8>::stageName);
+  registry.registerConsumerAndProducer<FrameSelectStage<Frame32, Frame16>>(
+      FrameSelectStage<Frame32, Frame16>::stageName);
+  registry.registerConsumerAndProducer<FrameSelectStage<Frame32, Frame8>>(
+      FrameSelectStage<Frame32, Frame8>::stageName);
+  registry.registerConsumerAndProducer<FrameSelectStage<Frame16, Frame8>>(
+      FrameSelectStage<Frame16, Frame8>::stageName);
+
+  registry.registerMultiInput<FrameMergeStage<Frame8, Frame16>>(
+      FrameMergeStage<Frame8, Frame16>::stageName);
+  registry.registerMultiInput<FrameMergeStage<Frame8, Frame32>>(
+      FrameMergeStage<Frame8, Frame32>::stageName);
+  registry.registerMultiInput<FrameMergeStage<Frame8, Frame64>>(
+      FrameMergeStage<Frame8, Frame64>::stageName);
+  registry.registerMultiInput<FrameMergeStage<Frame16, Frame32>>(
+      FrameMergeStage<Frame16, Frame32>::stageName);
+  registry.registerMultiInput<FrameMergeStage<Frame16, Frame64>>(
+      FrameMergeStage<Frame16, Frame64>::stageName);
+  registry.registerMultiInput<FrameMergeStage<Frame32, Frame64>>(
+      FrameMergeStage<Frame32, Frame64>::stageName);
+}
+}  // namespace
+
 decltype(PipelineRegistry::initialized) PipelineRegistry::initialized = false;
 decltype(PipelineRegistry::globalRegistry) PipelineRegistry::globalRegistry;
 
@@ -25,10 +85,66 @@ void PipelineRegistry::Init() {
   globalRegistry.registerConsumerAndProducer<Int32ToDoubleConverter>(
       Int32ToDoubleConverter::stageName);
 
-  globalRegistry.registerProducer<DbReadStage<int>>(DbReadStage<int>::stageName);
-  globalRegistry.registerProducer<DbReadStage<double>>(DbReadStage<double>::stageName);
-  globalRegistry.registerConsumer<DbWriteStage<int>>(DbWriteStage<int>::stageName);
-  globalRegistry.registerConsumer<DbWriteStage<double>>(DbWriteStage<double>::stageName);
+  globalRegistry.registerProducers<DbReadStage>(AllSampleTypes{});
+  globalRegistry.registerConsumers<DbWriteStage>(AllSampleTypes{});
+
+  globalRegistry.registerProducers<SocketReadStage>(AllSampleTypes{});
+  globalRegistry.registerConsumers<SocketWriteStage>(AllSampleTypes{});
+
+  globalRegistry.registerConsumers<FileRecorderStage>(AllSampleTypes{});
+  globalRegistry.registerProducers<FileReplayStage>(AllSampleTypes{});
+
+  globalRegistry.registerProducers<SignalGenerator>(RealSampleTypes{});
+
+  globalRegistry.registerConsumersAndProducers<WindowAggregationStage>(
+      RealSampleTypes{});
+  globalRegistry.registerConsumers<FileRecorderStage>(
+      SampleTypeList<WindowStatistics>{});
+
+  globalRegistry.registerConsumersAndProducers<DownsamplingStage>(
+      RealSampleTypes{});
+  globalRegistry.registerConsumers<FileRecorderStage>(
+      SampleTypeList<DisplayPoint>{});
+
+  globalRegistry.registerConsumersAndProducers<FirFilterStage>(
+      RealSampleTypes{});
+  globalRegistry.registerConsumersAndProducers<IirFilterStage>(
+      RealSampleTypes{});
+
+  globalRegistry.registerConsumers<QuantileStage>(RealSampleTypes{});
+
+  globalRegistry.registerConsumersAndProducers<TriggerStage>(
+      RealSampleTypes{});
+  globalRegistry.registerConsumers<FileRecorderStage>(
+      SampleTypeList<TriggerEvent>{});
+
+  globalRegistry.registerConsumersAndProducers<FramePackStage>(
+      FrameSampleTypes{});
+  registerFrameChannels<int16_t>(globalRegistry);
+  registerFrameChannels<int32_t>(globalRegistry);
+  globalRegistry.registerProducers<DbReadStage>(FrameSampleTypes{});
+  globalRegistry.registerConsumers<DbWriteStage>(FrameSampleTypes{});
+  globalRegistry.registerProducers<SocketReadStage>(FrameSampleTypes{});
+  globalRegistry.registerConsumers<SocketWriteStage>(FrameSampleTypes{});
+  globalRegistry.registerConsumers<FileRecorderStage>(FrameSampleTypes{});
+  globalRegistry.registerProducers<FileReplayStage>(FrameSampleTypes{});
+
+  globalRegistry.registerMultiInputs<MergeStage>(AllSampleTypes{});
+  globalRegistry.registerMultiInputs<ZipStage>(RealSampleTypes{});
+  globalRegistry.registerConsumersAndProducers<TimestampStage>(
+      RealSampleTypes{});
+  globalRegistry.registerMultiInput<JoinStage>(JoinStage::stageName);
+  globalRegistry.registerConsumers<FileRecorderStage>(
+      SampleTypeList<TimedSample>{});
+
+  globalRegistry.registerMultiOutputs<RangeRouter>(RealSampleTypes{});
+  globalRegistry.registerMultiOutputs<HashRouter>(AllSampleTypes{});
+
+  globalRegistry.registerConsumers<AsyncFileRecorderStage>(AllSampleTypes{});
+  globalRegistry.registerProducers<AsyncFileReplayStage>(AllSampleTypes{});
+  globalRegistry.registerConsumers<AsyncFileRecorderStage>(
+      FrameSampleTypes{});
+  globalRegistry.registerProducers<AsyncFileReplayStage>(FrameSampleTypes{});
 }
 
 PipelineRegistry& PipelineRegistry::Instance() {
@@ -41,6 +157,8 @@ void PipelineRegistry::reset() {
   m_producers.clear();
   m_consumers.clear();
   m_consumersProducers.clear();
+  m_multiInputs.clear();
+  m_multiOutputs.clear();
   m_producerConnections.clear();
   m_consumerConnections.clear();
   m_consumerAndProducerConnections.clear();
@@ -55,6 +173,10 @@ std::vector<std::string> PipelineRegistry::getStageNames() const {
     names.push_back(it.first);
   for (const auto& it : m_consumersProducers)
     names.push_back(it.first);
+  for (const auto& it : m_multiInputs)
+    names.push_back(it.first);
+  for (const auto& it : m_multiOutputs)
+    names.push_back(it.first);
 
   return names;
 }
@@ -64,7 +186,9 @@ PipelineStageType PipelineRegistry::getStageType(const std::string& key) const {
     return PipelineStageType::producer;
   else if (m_consumers.find(key) != m_consumers.end())
     return PipelineStageType::consumer;
-  else if (m_consumersProducers.find(key) != m_consumersProducers.end()) {
+  else if (m_consumersProducers.find(key) != m_consumersProducers.end() ||
+           m_multiInputs.find(key) != m_multiInputs.end() ||
+           m_multiOutputs.find(key) != m_multiOutputs.end()) {
     return PipelineStageType::producerConsumer;
   }
 
@@ -72,6 +196,22 @@ PipelineStageType PipelineRegistry::getStageType(const std::string& key) const {
                                   " was not presented in registry");
 }
 
+bool PipelineRegistry::isMultiInput(const std::string& key) const {
+  return m_multiInputs.find(key) != m_multiInputs.end();
+}
+
+bool PipelineRegistry::isMultiOutput(const std::string& key) const {
+  return m_multiOutputs.find(key) != m_multiOutputs.end();
+}
+
+bool PipelineRegistry::isRegistered(const std::string& key) const {
+  return m_producers.find(key) != m_producers.end() ||
+         m_consumers.find(key) != m_consumers.end() ||
+         m_consumersProducers.find(key) != m_consumersProducers.end() ||
+         m_multiInputs.find(key) != m_multiInputs.end() ||
+         m_multiOutputs.find(key) != m_multiOutputs.end();
+}
+
 std::shared_ptr<StageConnection> PipelineRegistry::constructProducerConnection(
     const std::string& key,
     size_t connectionSize) const {
@@ -134,3 +274,33 @@ std::shared_ptr<IPipelineStage> PipelineRegistry::constructConsumerAndProducer(
   throw PipelineRegistryException(std::string("key ") + key +
                                   " was not presented in producers registry");
 }
+
+std::shared_ptr<IPipelineStage> PipelineRegistry::constructMultiInput(
+    const std::string& key,
+    ConsumptionStrategy strategy,
+    const std::vector<std::shared_ptr<StageConnection>>& inConnections,
+    std::shared_ptr<StageConnection> outConnection) const {
+  auto factory = m_multiInputs.find(key);
+  if (factory != m_multiInputs.end()) {
+    return factory->second(strategy, inConnections, outConnection);
+  }
+
+  throw PipelineRegistryException(std::string("key ") + key +
+                                  " was not presented in multi-input registry");
+}
+
+std::shared_ptr<IPipelineStage> PipelineRegistry::constructMultiOutput(
+    const std::string& key,
+    ConsumptionStrategy strategy,
+    std::shared_ptr<StageConnection> inConnection,
+    const std::vector<std::shared_ptr<StageConnection>>& outConnections)
+    const {
+  auto factory = m_multiOutputs.find(key);
+  if (factory != m_multiOutputs.end()) {
+    return factory->second(strategy, inConnection, outConnections);
+  }
+
+  throw PipelineRegistryException(
+      std::string("key ") + key +
+      " was not presented in multi-output registry");
+}
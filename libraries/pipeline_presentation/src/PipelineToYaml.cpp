@@ -1,5 +1,7 @@
 #include "PipelineToYaml.h"
+#include "IParameterized.h"
 #include "YamlConversionException.h"
+#include "YamlToPipeline.h"
 #include "PipelineHelpers.h"
 
 #include <fstream>
@@ -16,7 +18,7 @@ void PipelineToYaml::serializeToFile(const shared_ptr<Pipeline> pipeline,
   }
 
   auto stagesReordered = reorderStages(yamlStages);
-  emitToFile(stagesReordered, file);
+  emitToFile(pipeline->getCapacityTuning(), stagesReordered, file);
 }
 
 string PipelineToYaml::serializeToString(const shared_ptr<Pipeline> pipeline) {
@@ -27,19 +29,30 @@ string PipelineToYaml::serializeToString(const shared_ptr<Pipeline> pipeline) {
   }
 
   auto stagesReordered = reorderStages(yamlStages);
-  return emitToString(stagesReordered);
+  return emitToString(pipeline->getCapacityTuning(), stagesReordered);
 }
 
 YamlPipelineStage PipelineToYaml::toYamlStage(
     const shared_ptr<IPipelineStage> stage) {
   auto id = stage->getId();
   auto stageType = stage->getStageType();
-  auto parentId = stage->getParentId();
+  auto parentIds = stage->getParentIds();
   auto strategy = stage->getConsumptionStrategy();
 
   if (!id.has_value())
     throw YamlConversionException("serializable pipeline stage must have id");
 
+  // '.' separates the stage id and the output name in parentId
+  if (id.value().find('.') != string::npos)
+    throw YamlConversionException("stage id " + id.value() +
+                                  " must not contain '.'");
+
+  for (const auto& output : stage->getOutputNames()) {
+    if (output.find('.') != string::npos)
+      throw YamlConversionException("output " + output + " of stage " +
+                                    id.value() + " must not contain '.'");
+  }
+
   if ((stageType == PipelineStageType::consumer ||
        stageType == PipelineStageType::producerConsumer) &&
       !strategy.has_value())
@@ -48,35 +61,60 @@ YamlPipelineStage PipelineToYaml::toYamlStage(
 
   if ((stageType == PipelineStageType::consumer ||
        stageType == PipelineStageType::producerConsumer) &&
-      !parentId.has_value())
+      parentIds.empty())
     throw YamlConversionException("consumer stage must have parentId");
 
-  return {stage->getName(), id.value(), stageType, parentId, strategy};
+  optional<size_t> connectionSize;
+  if (auto connection = stage->getOutConnection();
+      connection != nullptr &&
+      connection->getCapacity() != YamlPipelineStage::defaultConnectionSize)
+    connectionSize = connection->getCapacity();
+
+  vector<pair<string, string>> parameters;
+  if (auto parameterized = dynamic_pointer_cast<IParameterized>(stage);
+      parameterized && parameterized->IsFullyParameterized()) {
+    for (const auto& [name, value] : parameterized->GetPatameterValues())
+      parameters.emplace_back(name, value);
+  }
+
+  return {stage->getName(), id.value(), stageType, parentIds,
+          strategy, connectionSize, parameters, stage->getOutputNames()};
 }
 
 list<YamlPipelineStage> PipelineToYaml::reorderStages(
     const list<YamlPipelineStage>& stages) {
   list<YamlPipelineStage> result;
-  auto contains = [&result](const string& id) -> bool {
+  // parentId names the stage itself or one of its outputs
+  auto isParent = [](const YamlPipelineStage& stage, const string& parentId) {
+    if (stage.stageId == parentId)
+      return true;
+    return any_of(stage.outputs.begin(), stage.outputs.end(),
+                  [&](const string& output) {
+                    return stage.stageId + "." + output == parentId;
+                  });
+  };
+  auto contains = [&result, &isParent](const string& id) -> bool {
     return find_if(result.begin(), result.end(),
-                   [&id](const YamlPipelineStage& stage) {
-                     return stage.stageId == id;
+                   [&](const YamlPipelineStage& stage) {
+                     return isParent(stage, id);
                    }) != result.end();
   };
 
   for (auto stage = stages.begin(); stage != stages.end(); ++stage) {
     const auto& id = stage->stageId;
-    const auto& parentId = stage->parentStageId;
     auto stageType = stage->stageType;
 
     if (contains(id))
       continue;
 
-    if ((stageType == PipelineStageType::consumer ||
-         stageType == PipelineStageType::producerConsumer) &&
-        !contains(parentId.value())) {
+    for (const auto& parentId : stage->parentStageIds) {
+      if ((stageType != PipelineStageType::consumer &&
+           stageType != PipelineStageType::producerConsumer) ||
+          contains(parentId))
+        continue;
+
       for (auto s = stage; s != stages.end(); ++s) {
-        if (s->stageId == parentId) {
+        if (isParent(*s, parentId)) {
           if (s->stageType == PipelineStageType::consumer)
             throw YamlConversionException("parent stage is not producer");
 
@@ -92,22 +130,49 @@ list<YamlPipelineStage> PipelineToYaml::reorderStages(
   return result;
 }
 
-void PipelineToYaml::emitToFile(const list<YamlPipelineStage>& stages,
-                                const fs::path& file) {
+void PipelineToYaml::emitToFile(
+    const optional<CapacityTuningSettings>& capacityTuning,
+    const list<YamlPipelineStage>& stages,
+    const fs::path& file) {
   YAML::Emitter emitter;
+  if (capacityTuning.has_value())
+    emitCapacityTuning(emitter, capacityTuning.value());
   emit(emitter, stages);
 
   ofstream f(file);
   f << emitter.c_str();
 }
 
-string PipelineToYaml::emitToString(const list<YamlPipelineStage>& stages) {
+string PipelineToYaml::emitToString(
+    const optional<CapacityTuningSettings>& capacityTuning,
+    const list<YamlPipelineStage>& stages) {
   YAML::Emitter emitter;
+  if (capacityTuning.has_value())
+    emitCapacityTuning(emitter, capacityTuning.value());
   emit(emitter, stages);
 
   return emitter.c_str();
 }
 
+void PipelineToYaml::emitCapacityTuning(
+    YAML::Emitter& emitter, const CapacityTuningSettings& settings) {
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << YamlToPipeline::capacityTuningKey;
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "minCapacity";
+  emitter << YAML::Value << settings.minCapacity;
+  emitter << YAML::Key << "maxCapacity";
+  emitter << YAML::Value << settings.maxCapacity;
+  emitter << YAML::Key << "memoryBudget";
+  emitter << YAML::Value << settings.memoryBudget;
+  emitter << YAML::Key << "period";
+  emitter << YAML::Value << settings.period.count();
+  emitter << YAML::EndMap;
+  emitter << YAML::EndMap;
+  emitter << YAML::Newline;
+  emitter << YAML::Newline;
+}
+
 void PipelineToYaml::emit(
     YAML::Emitter& emitter, const std::list<YamlPipelineStage>& stages) {
   for (const auto& stage : stages) {
@@ -123,9 +188,27 @@ void PipelineToYaml::emit(
       emitter << YAML::Value
               << PipelineHelpers::toString(stage.consumptionStrategy.value());
     }
-    if (stage.parentStageId.has_value()) {
+    if (stage.parentStageIds.size() == 1) {
+      emitter << YAML::Key << "parentId";
+      emitter << YAML::Value << stage.parentStageIds.front();
+    } else if (!stage.parentStageIds.empty()) {
       emitter << YAML::Key << "parentId";
-      emitter << YAML::Value << stage.parentStageId.value();
+      emitter << YAML::Value << YAML::Flow << stage.parentStageIds;
+    }
+    if (!stage.outputs.empty()) {
+      emitter << YAML::Key << "outputs";
+      emitter << YAML::Value << YAML::Flow << stage.outputs;
+    }
+    if (stage.connectionSize.has_value()) {
+      emitter << YAML::Key << "connectionSize";
+      emitter << YAML::Value << stage.connectionSize.value();
+    }
+    if (!stage.parameters.empty()) {
+      emitter << YAML::Key << "parameters";
+      emitter << YAML::Value << YAML::BeginMap;
+      for (const auto& [name, value] : stage.parameters)
+        emitter << YAML::Key << name << YAML::Value << value;
+      emitter << YAML::EndMap;
     }
     emitter << YAML::EndMap;
     emitter << YAML::EndMap;
@@ -1,4 +1,5 @@
 #include "YamlToPipeline.h"
+#include "IParameterized.h"
 #include "PipelineHelpers.h"
 #include "PipelineRegistry.h"
 #include "YamlConversionException.h"
@@ -7,23 +8,34 @@ using namespace std;
 using namespace string_literals;
 namespace fs = filesystem;
 
-shared_ptr<Pipeline> YamlToPipeline::parseFromFile(const fs::path& path) {
+shared_ptr<Pipeline> YamlToPipeline::parseFromFile(
+    const fs::path& path,
+    const StageInitializer& initializer) {
   auto node = YAML::LoadFile(path.string());
   auto stages = parse(node);
 
-  return toPipeline(stages);
+  auto pipeline = toPipeline(stages, initializer);
+  pipeline->setCapacityTuning(parseCapacityTuning(node));
+  return pipeline;
 }
 
-shared_ptr<Pipeline> YamlToPipeline::parseFromString(const string& input) {
+shared_ptr<Pipeline> YamlToPipeline::parseFromString(
+    const string& input,
+    const StageInitializer& initializer) {
   auto node = YAML::Load(input);
   auto stages = parse(node);
 
-  return toPipeline(stages);
+  auto pipeline = toPipeline(stages, initializer);
+  pipeline->setCapacityTuning(parseCapacityTuning(node));
+  return pipeline;
 }
 
 vector<YamlPipelineStage> YamlToPipeline::parse(const YAML::Node& node) {
   vector<YamlPipelineStage> stages;
   for (const auto& stageNode : node) {
+    if (stageNode.first.as<string>() == capacityTuningKey)
+      continue;
+
     auto stage = parseStage(stageNode.second);
     stage.stageName = stageNode.first.as<string>();
     stages.push_back(stage);
@@ -32,22 +44,102 @@ vector<YamlPipelineStage> YamlToPipeline::parse(const YAML::Node& node) {
   return stages;
 }
 
+optional<CapacityTuningSettings> YamlToPipeline::parseCapacityTuning(
+    const YAML::Node& node) {
+  const auto& tuningNode = node[capacityTuningKey];
+  if (!tuningNode)
+    return nullopt;
+
+  if (!tuningNode.IsMap())
+    throw YamlConversionException(capacityTuningKey + " must be a map"s);
+
+  CapacityTuningSettings settings;
+  for (const auto& parameter : tuningNode) {
+    auto key = parameter.first.as<string>();
+    auto value = parameter.second.as<size_t>();
+
+    if (key == "minCapacity")
+      settings.minCapacity = value;
+    else if (key == "maxCapacity")
+      settings.maxCapacity = value;
+    else if (key == "memoryBudget")
+      settings.memoryBudget = value;
+    else if (key == "period")
+      settings.period = chrono::milliseconds(value);
+    else
+      throw YamlConversionException("unknown key "s + key + " of " +
+                                    capacityTuningKey);
+  }
+
+  if (settings.minCapacity == 0 ||
+      settings.minCapacity > settings.maxCapacity)
+    throw YamlConversionException(
+        "minCapacity must be positive and not greater than maxCapacity"s);
+
+  if (settings.period.count() == 0)
+    throw YamlConversionException("period must be positive"s);
+
+  return settings;
+}
+
 YamlPipelineStage YamlToPipeline::parseStage(const YAML::Node& stageNode) {
   optional<string> stageId;
   optional<PipelineStageType> stageType;
-  optional<string> parentStageId;
+  vector<string> parentStageIds;
   optional<ConsumptionStrategy> strategy;
+  optional<size_t> connectionSize;
+  vector<pair<string, string>> parameters;
+  vector<string> outputs;
 
   for (const auto& stageParameter : stageNode) {
     const auto& key = stageParameter.first.Scalar();
+
+    if (key == "parameters") {
+      if (!stageParameter.second.IsMap())
+        throw YamlConversionException("parameters must be a map"s);
+      for (const auto& parameter : stageParameter.second)
+        parameters.emplace_back(parameter.first.as<string>(),
+                                parameter.second.as<string>());
+      continue;
+    }
+
+    if (key == "connectionSize") {
+      connectionSize = stageParameter.second.as<size_t>();
+      if (connectionSize.value() == 0)
+        throw YamlConversionException("connectionSize must be positive"s);
+      continue;
+    }
+
+    // stages with several inputs have a list of parents
+    if (key == "parentId") {
+      const auto& parents = stageParameter.second;
+      if (!parents.IsSequence()) {
+        parentStageIds.push_back(parents.as<string>());
+        continue;
+      }
+      for (const auto& parent : parents)
+        parentStageIds.push_back(parent.as<string>());
+      if (parentStageIds.empty())
+        throw YamlConversionException("parentId list must not be empty"s);
+      continue;
+    }
+
+    if (key == "outputs") {
+      if (!stageParameter.second.IsSequence())
+        throw YamlConversionException("outputs must be a list"s);
+      for (const auto& output : stageParameter.second)
+        outputs.push_back(output.as<string>());
+      if (outputs.empty())
+        throw YamlConversionException("outputs list must not be empty"s);
+      continue;
+    }
+
     auto value = stageParameter.second.as<string>();
 
     if (key == "id")
       stageId = value;
     else if (key == "type")
       stageType = PipelineHelpers::stagetTypeFromString(value);
-    else if (key == "parentId")
-      parentStageId = value;
     else if (key == "strategy")
       strategy = PipelineHelpers::strategyFromString(value);
     else
@@ -58,29 +150,44 @@ YamlPipelineStage YamlToPipeline::parseStage(const YAML::Node& stageNode) {
     throw YamlConversionException(
         "yaml representation of stage doesn't contain 'id' field"s);
 
+  // '.' separates the stage id and the output name in parentId
+  if (stageId.value().find('.') != string::npos)
+    throw YamlConversionException("stage id "s + stageId.value() +
+                                  " must not contain '.'");
+
+  for (const auto& output : outputs) {
+    if (output.find('.') != string::npos)
+      throw YamlConversionException("output "s + output + " of stage " +
+                                    stageId.value() + " must not contain '.'");
+  }
+
   if (!stageType.has_value())
     throw YamlConversionException(
         "yaml representation of stage doesn't contain 'type' field"s);
 
-  return {"", stageId.value(), stageType.value(), parentStageId, strategy};
+  if (stageType.value() == PipelineStageType::consumer &&
+      connectionSize.has_value())
+    throw YamlConversionException(
+        "connectionSize is not supported in consumer stage"s);
+
+  if (stageType.value() == PipelineStageType::consumer && !outputs.empty())
+    throw YamlConversionException(
+        "outputs are not supported in consumer stage"s);
+
+  return {"", stageId.value(), stageType.value(), parentStageIds,
+          strategy, connectionSize, parameters, outputs};
 }
 
 shared_ptr<Pipeline> YamlToPipeline::toPipeline(
-    const vector<YamlPipelineStage>& stages) {
+    const vector<YamlPipelineStage>& stages,
+    const StageInitializer& initializer) {
   auto p = make_shared<Pipeline>();
   const auto& registry = PipelineRegistry::Instance();
   try {
     map<string, shared_ptr<StageConnection>> connections;
     for (const auto& yamlStage : stages) {
       shared_ptr<IPipelineStage> stage;
-
-      const auto& name = yamlStage.stageName;
-      const auto& id = yamlStage.stageId;
-      auto type = yamlStage.stageType;
-      const auto& parentId = yamlStage.parentStageId;
-      auto strategy = yamlStage.consumptionStrategy;
-
-      switch (type) {
+      switch (yamlStage.stageType) {
         case PipelineStageType::producer: {
           stage = constructProducer(registry, yamlStage, connections);
           break;
@@ -96,6 +203,9 @@ shared_ptr<Pipeline> YamlToPipeline::toPipeline(
         }
       }
 
+      if (initializer)
+        initializer(*stage);
+      applyParameters(stage, yamlStage);
       p->addStage(stage);
     }
     for (auto& [key, connection] : connections)
@@ -114,10 +224,10 @@ shared_ptr<IPipelineStage> YamlToPipeline::constructProducer(
   const auto& name = yamlStage.stageName;
   const auto& id = yamlStage.stageId;
   auto type = yamlStage.stageType;
-  const auto& parentId = yamlStage.parentStageId;
+  const auto& parentIds = yamlStage.parentStageIds;
   auto strategy = yamlStage.consumptionStrategy;
 
-  if (parentId.has_value())
+  if (!parentIds.empty())
     throw YamlConversionException(
         "parentId is not supported in producer stage");
 
@@ -125,6 +235,10 @@ shared_ptr<IPipelineStage> YamlToPipeline::constructProducer(
     throw YamlConversionException(
         "strategy is not supported in producer stage");
 
+  if (!yamlStage.outputs.empty())
+    throw YamlConversionException(
+        "outputs are not supported in producer stage");
+
   auto names = registry.getStageNames();
   if (find(names.begin(), names.end(), name) == names.end())
     throw YamlConversionException("stage with name "s + name +
@@ -136,8 +250,7 @@ shared_ptr<IPipelineStage> YamlToPipeline::constructProducer(
         "type of stage in registry differs from stage type in yaml "
         "representation");
 
-  auto connection =
-      registry.constructProducerConnection(name, defaultConnectionSize);
+  auto connection = constructOutConnection(registry, yamlStage);
   auto stage = registry.constructProducer(name, connection);
   stage->setId(id);
 
@@ -153,12 +266,16 @@ shared_ptr<IPipelineStage> YamlToPipeline::constructConsumer(
   const auto& name = yamlStage.stageName;
   const auto& id = yamlStage.stageId;
   auto type = yamlStage.stageType;
-  const auto& parentId = yamlStage.parentStageId;
+  const auto& parentIds = yamlStage.parentStageIds;
   auto strategy = yamlStage.consumptionStrategy;
 
-  if (!parentId.has_value())
+  if (parentIds.empty())
     throw YamlConversionException("consumer stage must have parentId field");
 
+  if (parentIds.size() > 1)
+    throw YamlConversionException("consumer stage "s + id +
+                                  " must have a single parent");
+
   if (!strategy.has_value())
     throw YamlConversionException("consumer stage must have strategy field");
 
@@ -173,7 +290,7 @@ shared_ptr<IPipelineStage> YamlToPipeline::constructConsumer(
         "type of stage in registry differs from stage type in yaml "
         "representation");
 
-  auto& parent = parentId.value();
+  auto& parent = parentIds.front();
   if (connectionsMap.find(parent) == connectionsMap.end())
     throw YamlConversionException(
         "error: parent stage was not declared or declared after "
@@ -194,13 +311,23 @@ shared_ptr<IPipelineStage> YamlToPipeline::constructConsumerAndProducer(
   const auto& name = yamlStage.stageName;
   const auto& id = yamlStage.stageId;
   auto type = yamlStage.stageType;
-  const auto& parentId = yamlStage.parentStageId;
+  const auto& parentIds = yamlStage.parentStageIds;
   auto strategy = yamlStage.consumptionStrategy;
 
-  if (!parentId.has_value())
+  if (parentIds.empty())
     throw YamlConversionException(
         "producerConsumer stage must have parentId field");
 
+  if (parentIds.size() > 1 && !registry.isMultiInput(name))
+    throw YamlConversionException("stage "s + name +
+                                  " does not support several parents");
+
+  if (registry.isMultiOutput(name) != !yamlStage.outputs.empty())
+    throw YamlConversionException(
+        "stage "s + id + (registry.isMultiOutput(name)
+                              ? " must have outputs field"
+                              : " does not support outputs"));
+
   if (!strategy.has_value())
     throw YamlConversionException(
         "producerConsumer stage must have strategy field");
@@ -216,20 +343,78 @@ shared_ptr<IPipelineStage> YamlToPipeline::constructConsumerAndProducer(
         "type of stage in registry differs from stage type in yaml "
         "representation");
 
-  auto& parent = parentId.value();
-  if (connectionsMap.find(parent) == connectionsMap.end())
-    throw YamlConversionException(
-        "error: parent stage was not declared or declared after "
-        "consumer stage");
-  auto inConnection = connectionsMap[parent];
-  auto outConnection =
-      registry.constructProducerConnection(name, defaultConnectionSize);
+  vector<shared_ptr<StageConnection>> inConnections;
+  for (const auto& parent : parentIds) {
+    if (connectionsMap.find(parent) == connectionsMap.end())
+      throw YamlConversionException(
+          "error: parent stage was not declared or declared after "
+          "consumer stage");
+    inConnections.push_back(connectionsMap[parent]);
+  }
+
+  if (registry.isMultiOutput(name)) {
+    vector<shared_ptr<StageConnection>> outConnections;
+    for (const auto& output : yamlStage.outputs) {
+      if (connectionsMap.find(id + "." + output) != connectionsMap.end())
+        throw YamlConversionException("output "s + output + " of stage " + id +
+                                      " is declared twice");
+      outConnections.push_back(constructOutConnection(registry, yamlStage));
+      connectionsMap[id + "." + output] = outConnections.back();
+    }
+
+    auto stage = registry.constructMultiOutput(
+        name, strategy.value(), inConnections.front(), outConnections);
+    stage->setId(id);
+    stage->setParentIds(parentIds);
+    stage->setOutputNames(yamlStage.outputs);
+    return stage;
+  }
+
+  auto outConnection = constructOutConnection(registry, yamlStage);
 
-  auto stage = registry.constructConsumerAndProducer(
-      name, strategy.value(), inConnection, outConnection);
+  shared_ptr<IPipelineStage> stage;
+  if (registry.isMultiInput(name))
+    stage = registry.constructMultiInput(name, strategy.value(),
+                                         inConnections, outConnection);
+  else
+    stage = registry.constructConsumerAndProducer(
+        name, strategy.value(), inConnections.front(), outConnection);
   stage->setId(id);
-  stage->setParentId(parent);
+  stage->setParentIds(parentIds);
   connectionsMap[id] = outConnection;
 
   return stage;
 }
+
+shared_ptr<StageConnection> YamlToPipeline::constructOutConnection(
+    const PipelineRegistry& registry,
+    const YamlPipelineStage& yamlStage) {
+  return registry.constructProducerConnection(
+      yamlStage.stageName,
+      yamlStage.connectionSize.value_or(
+          YamlPipelineStage::defaultConnectionSize));
+}
+
+void YamlToPipeline::applyParameters(shared_ptr<IPipelineStage> stage,
+                                     const YamlPipelineStage& yamlStage) {
+  if (yamlStage.parameters.empty())
+    return;
+
+  auto parameterized = dynamic_pointer_cast<IParameterized>(stage);
+  if (!parameterized)
+    throw YamlConversionException("stage "s + yamlStage.stageId +
+                                  " doesn't support parameters");
+
+  for (const auto& [name, value] : yamlStage.parameters) {
+    if (!parameterized->SetParameterValue(name, value))
+      throw YamlConversionException("unknown parameter "s + name +
+                                    " of stage " + yamlStage.stageId);
+  }
+
+  try {
+    parameterized->ApplyParameterValues();
+  } catch (std::exception& ex) {
+    throw YamlConversionException("cannot apply parameters of stage "s +
+                                  yamlStage.stageId + ": " + ex.what());
+  }
+}
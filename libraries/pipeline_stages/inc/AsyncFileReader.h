@@ -0,0 +1,53 @@
+#pragma once
+
+#include "AsyncFileWriter.h"
+#include "AsyncIoQueue.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/// Чтение файла блоками через AsyncIoQueue с упреждением: в работе постоянно
+/// находятся до queueDepth следующих блоков, поток стадии только копирует
+/// данные из уже прочитанных.
+class AsyncFileReader {
+ public:
+  /// Ошибка возвращается через исключение
+  AsyncFileReader(const std::string& path, const AsyncFileOptions& options);
+  ~AsyncFileReader();
+
+  AsyncFileReader(const AsyncFileReader&) = delete;
+  AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+  /// Прочитать size байт. Если до конца файла осталось меньше, ничего не
+  /// читается и возвращается false.
+  bool Read(void* data, size_t size) noexcept(false);
+
+  /// Начать чтение с начала файла
+  void Rewind() noexcept(false);
+
+  /// Размер файла при открытии, байт
+  uint64_t GetSize() const;
+
+  /// Файл открыт с O_DIRECT
+  bool IsDirect() const;
+  /// Чтение идет через io_uring
+  bool UsesIoUring() const;
+
+ private:
+  /// Отправить блок на чтение следующей части файла, если она есть
+  void SubmitBlock(size_t index);
+
+ private:
+  const std::string m_path;
+  int m_fd = -1;
+  bool m_direct = false;
+  uint64_t m_size = 0;
+  std::unique_ptr<AsyncIoQueue> m_queue;
+
+  size_t m_block = 0;         ///< Блок, из которого идет копирование
+  size_t m_blockUsed = 0;     ///< Скопировано из блока, байт
+  size_t m_blockBytes = 0;    ///< Прочитано в блок, байт
+  uint64_t m_position = 0;    ///< Позиция чтения в файле
+  uint64_t m_nextOffset = 0;  ///< Смещение следующего отправляемого блока
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "AsyncFileWriter.h"
+#include "ConsumerStage.h"
+#include "FileParameterizedStage.h"
+#include "SampleType.h"
+
+#include <memory>
+#include <type_traits>
+
+/// Стадия записи задач в файл в двоичном виде через AsyncFileWriter.
+/// В отличие от FileRecorderStage поток стадии не ждет записи на диск:
+/// блоки по blockSize байт пишутся асинхронно, до queueDepth одновременно,
+/// при direct - в обход кэша ОС. Предназначена для записи потоков с высокой
+/// скоростью, файл перезаписывается и не разбивается на части.
+template <typename T>
+class AsyncFileRecorderStage : public ConsumerStage<T>,
+                               public FileParameterizedStage {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "only trivially copyable tasks can be recorded");
+
+  std::unique_ptr<AsyncFileWriter> m_writer;
+
+ public:
+  AsyncFileRecorderStage(ConsumptionStrategy strategy,
+                         std::shared_ptr<InStageConnection<T>>);
+
+  ~AsyncFileRecorderStage() override;
+
+  void consume(std::shared_ptr<T> inData) override;
+
+  /// Остановить стадию и записать последний блок в файл
+  void shutdown() override;
+
+ public:
+  /// Переоткрыть файл с текущими значениями параметров
+  virtual void ResetFile() override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "ToFileAsync";
+  using consumptionT = T;
+  using productionT = void;
+};
+
+template <typename T>
+AsyncFileRecorderStage<T>::AsyncFileRecorderStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> connection)
+    : ConsumerStage<T>(stageName, strategy, connection) {
+  AddParameter("blockSize", L"Размер блока записи, байт (кратен 4096)",
+               "1048576");
+  AddParameter("queueDepth", L"Число блоков, записываемых одновременно",
+               "8");
+  AddParameter("direct", L"Писать в обход кэша ОС (0/1)", "1");
+}
+
+template <typename T>
+AsyncFileRecorderStage<T>::~AsyncFileRecorderStage() {
+  shutdown();
+}
+
+template <typename T>
+void AsyncFileRecorderStage<T>::consume(std::shared_ptr<T> inData) {
+  if (!m_writer) {
+    // Параметры не были заданы. Не можем писать данные.
+    this->dataConsumed(inData, false);
+    return;
+  }
+
+  m_writer->Write(inData.get(), sizeof(T));
+  this->dataConsumed(inData);
+}
+
+template <typename T>
+void AsyncFileRecorderStage<T>::shutdown() {
+  ConsumerStage<T>::shutdown();
+  // Поток стадии остановлен, записываем последний блок
+  m_writer.reset();
+}
+
+template <typename T>
+inline void AsyncFileRecorderStage<T>::ResetFile() {
+  AsyncFileOptions options;
+  options.blockSize = GetSizeParameter("blockSize", 1);
+  options.queueDepth = GetSizeParameter("queueDepth", 1);
+  options.direct = GetFlagParameter("direct");
+
+  m_writer.reset();
+  m_writer = std::make_unique<AsyncFileWriter>(GetFileName(), options);
+}
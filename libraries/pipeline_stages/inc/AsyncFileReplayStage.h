@@ -0,0 +1,86 @@
+#pragma once
+
+#include "AsyncFileReader.h"
+#include "FileParameterizedStage.h"
+#include "ProducerStage.h"
+#include "SampleType.h"
+
+#include <memory>
+#include <type_traits>
+
+/// Стадия воспроизведения двоичного файла записей T через AsyncFileReader.
+/// В отличие от FileReplayStage файл не отображается в память, а читается
+/// блоками по blockSize байт с упреждением на queueDepth блоков, при direct -
+/// в обход кэша ОС. Записи выдаются без ограничения скорости, при loop
+/// воспроизведение повторяется, иначе стадия завершается.
+template <typename T>
+class AsyncFileReplayStage : public ProducerStage<T>,
+                             public FileParameterizedStage {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "only trivially copyable tasks can be replayed");
+
+  std::unique_ptr<AsyncFileReader> m_reader;
+  bool m_loop = false;
+
+ public:
+  AsyncFileReplayStage(std::shared_ptr<OutStageConnection<T>>);
+
+  void produce(std::shared_ptr<T> outData) override;
+
+ public:
+  /// Открыть файл заново и начать воспроизведение сначала
+  virtual void ResetFile() override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "FromFileAsync";
+  using consumptionT = void;
+  using productionT = T;
+};
+
+template <typename T>
+AsyncFileReplayStage<T>::AsyncFileReplayStage(
+    std::shared_ptr<OutStageConnection<T>> connection)
+    : ProducerStage<T>(stageName, connection) {
+  AddParameter("blockSize", L"Размер блока чтения, байт (кратен 4096)",
+               "1048576");
+  AddParameter("queueDepth", L"Число блоков, читаемых заранее", "8");
+  AddParameter("direct", L"Читать в обход кэша ОС (0/1)", "1");
+  AddParameter("loop", L"Повторять воспроизведение (0/1)", "0");
+}
+
+template <typename T>
+void AsyncFileReplayStage<T>::produce(std::shared_ptr<T> outData) {
+  if (!m_reader) {
+    // Параметры не были заданы. Не можем читать данные.
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  if (!m_reader->Read(outData.get(), sizeof(T))) {
+    // Неполная запись в конце файла не воспроизводится
+    if (!m_loop || m_reader->GetSize() < sizeof(T)) {
+      // Данные кончились, больше производить нечего
+      this->dataProduced(outData, false);
+      this->finish();
+      return;
+    }
+    m_reader->Rewind();
+    m_reader->Read(outData.get(), sizeof(T));
+  }
+
+  this->dataProduced(outData);
+}
+
+template <typename T>
+inline void AsyncFileReplayStage<T>::ResetFile() {
+  AsyncFileOptions options;
+  options.blockSize = GetSizeParameter("blockSize", 1);
+  options.queueDepth = GetSizeParameter("queueDepth", 1);
+  options.direct = GetFlagParameter("direct");
+  auto loop = GetFlagParameter("loop");
+
+  m_reader.reset();
+  m_reader = std::make_unique<AsyncFileReader>(GetFileName(), options);
+  m_loop = loop;
+}
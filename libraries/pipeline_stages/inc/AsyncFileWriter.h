@@ -0,0 +1,64 @@
+#pragma once
+
+#include "AsyncIoQueue.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Параметры асинхронной записи и чтения файла
+struct AsyncFileOptions {
+  /// Размер блока, байт (кратен AsyncIoQueue::alignment)
+  size_t blockSize = 1 << 20;
+  size_t queueDepth = 8;  ///< Число блоков, одновременно находящихся в работе
+  /// Открывать файл с O_DIRECT в обход кэша ОС. Если файловая система его не
+  /// поддерживает, файл открывается обычным образом.
+  bool direct = true;
+};
+
+/// Запись файла блоками через AsyncIoQueue: поток стадии только копирует
+/// данные в блок, заполненный блок отправляется на запись и заполняется
+/// следующий. Поток ждет записи, только когда в работе все блоки.
+/// Файл перезаписывается. При O_DIRECT последний неполный блок дополняется до
+/// выравнивания, а лишнее обрезается при закрытии.
+class AsyncFileWriter {
+ public:
+  /// Ошибка возвращается через исключение
+  AsyncFileWriter(const std::string& path, const AsyncFileOptions& options);
+  /// Записывает последний блок и закрывает файл
+  ~AsyncFileWriter();
+
+  AsyncFileWriter(const AsyncFileWriter&) = delete;
+  AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+  /// Записать блок данных
+  void Write(const void* data, size_t size) noexcept(false);
+
+  /// Записать последний блок, дождаться записи и закрыть файл
+  void Close() noexcept(false);
+
+  /// Файл открыт с O_DIRECT
+  bool IsDirect() const;
+  /// Запись идет через io_uring
+  bool UsesIoUring() const;
+
+ private:
+  /// Отправить текущий блок на запись и перейти к следующему
+  void SubmitBlock(size_t size);
+  /// Дождаться самой старой записи и проверить, что блок записан целиком
+  void WaitWritten() noexcept(false);
+  /// Закрыть очередь и файл
+  void Release();
+
+ private:
+  const std::string m_path;
+  int m_fd = -1;
+  bool m_direct = false;
+  std::unique_ptr<AsyncIoQueue> m_queue;
+
+  std::vector<size_t> m_submittedSizes;  ///< Размер записи каждого блока
+  size_t m_block = 0;     ///< Заполняемый блок
+  size_t m_used = 0;      ///< Занято в заполняемом блоке, байт
+  uint64_t m_offset = 0;  ///< Смещение заполняемого блока в файле
+};
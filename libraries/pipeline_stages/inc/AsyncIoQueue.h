@@ -0,0 +1,104 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Очередь асинхронных операций чтения и записи файла блоками из выровненных
+/// буферов. Одновременно выполняется до depth операций. Если сборка включает
+/// io_uring (ECSMS_USE_IO_URING), операции идут через него с
+/// зарегистрированными буферами, иначе (или если io_uring недоступен в ядре) -
+/// через пул потоков с позиционным чтением и записью. Результаты выдаются в
+/// порядке отправки.
+class AsyncIoQueue {
+ public:
+  /// Выравнивание буферов, смещений и размеров операций для O_DIRECT
+  static constexpr size_t alignment = 4096;
+
+  /// Ошибка возвращается через исключение
+  AsyncIoQueue(int fd, size_t blockSize, size_t depth);
+  /// Дожидается отправленных операций
+  ~AsyncIoQueue();
+
+  AsyncIoQueue(const AsyncIoQueue&) = delete;
+  AsyncIoQueue& operator=(const AsyncIoQueue&) = delete;
+
+  /// Буфер блока с номером index
+  char* GetBlock(size_t index) const;
+  size_t GetBlockSize() const;
+  size_t GetDepth() const;
+
+  /// Записать size байт блока index по смещению offset
+  void SubmitWrite(size_t index, uint64_t offset, size_t size);
+  /// Прочитать в блок index до size байт по смещению offset
+  void SubmitRead(size_t index, uint64_t offset, size_t size);
+
+  /// Дождаться самой старой операции. Возвращает номер ее блока и число
+  /// переданных байт, ошибка возвращается через исключение. Неполная
+  /// передача продолжается с места остановки; запись, которую файл не
+  /// принимает целиком, считается ошибкой, чтение меньше size - концом файла.
+  std::pair<size_t, size_t> WaitOldest() noexcept(false);
+
+  /// Число отправленных и еще не полученных через WaitOldest операций
+  size_t GetPendingCount() const;
+
+  /// Операции выполняются через io_uring
+  bool UsesIoUring() const;
+
+  /// Открыть файл для записи (с перезаписью) или чтения. При direct файл
+  /// открывается с O_DIRECT, если файловая система его не поддерживает,
+  /// direct сбрасывается. Ошибка возвращается через исключение.
+  static int OpenFile(const std::string& path,
+                      bool write,
+                      bool& direct) noexcept(false);
+  static void CloseFile(int fd);
+  static uint64_t GetFileSize(int fd) noexcept(false);
+  static void TruncateFile(int fd, uint64_t size) noexcept(false);
+
+ private:
+  struct Request {
+    bool write = false;
+    size_t index = 0;
+    uint64_t offset = 0;
+    size_t size = 0;
+  };
+
+  /// Результат операции блока: число байт (при io_uring - переданных к
+  /// текущему моменту) или -errno
+  struct Result {
+    bool done = false;
+    int64_t bytes = 0;
+  };
+
+  struct Ring;
+
+  void Submit(const Request& request);
+  /// Поток пула, выполняющий операции
+  void Work();
+
+ private:
+  const int m_fd;
+  const size_t m_blockSize;
+  const size_t m_depth;
+
+  std::unique_ptr<char, void (*)(char*)> m_memory;
+  std::deque<size_t> m_submitted;  ///< Блоки в порядке отправки
+  std::vector<Request> m_inFlight;  ///< Отправленная операция каждого блока
+  std::vector<Result> m_results;
+
+  std::unique_ptr<Ring> m_ring;
+
+  std::mutex m_mutex;
+  std::condition_variable m_requestCv;
+  std::condition_variable m_doneCv;
+  std::deque<Request> m_requests;
+  std::vector<std::thread> m_workers;
+  bool m_stopping = false;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/// Коэффициенты звена второго порядка (a0 нормирован к 1):
+/// H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+struct BiquadCoefficients {
+  double b0;
+  double b1;
+  double b2;
+  double a1;
+  double a2;
+};
+
+/// БИХ-фильтр из последовательно соединенных звеньев второго порядка
+/// (транспонированная прямая форма II).
+/// Рекурсия не позволяет считать соседние значения одновременно, поэтому блок
+/// обрабатывается звено за звеном: коэффициенты и состояние звена остаются в
+/// регистрах на весь блок. Состояние сохраняется между вызовами Process.
+class BiquadCascade {
+ public:
+  /// Неустойчивые звенья (полюса не внутри единичной окружности) запрещены
+  explicit BiquadCascade(std::vector<BiquadCoefficients> sections) noexcept(
+      false);
+
+  /// Отфильтровать count значений in в out (in и out могут совпадать)
+  void Process(const double* in, double* out, size_t count);
+  /// Обнулить состояние звеньев
+  void Reset();
+
+ private:
+  struct State {
+    double s1 = 0;
+    double s2 = 0;
+  };
+
+  std::vector<BiquadCoefficients> m_sections;
+  std::vector<State> m_states;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// Запись в файл через большой буфер в памяти процесса.
+/// Файл открывается один раз и дописывается. Данные периодически
+/// сбрасываются на диск, файл может разбиваться на части по размеру или
+/// времени. Части называются <имя>.<номер><расширение>, запись не разрывает
+/// переданный в Write блок между частями.
+class BufferedFileWriter {
+ public:
+  struct Options {
+    size_t bufferSize = 1 << 20;  ///< Размер буфера, байт
+    /// Период сброса данных на диск, 0 - только при закрытии
+    std::chrono::milliseconds syncInterval{1000};
+    size_t rotateSize = 0;  ///< Максимальный размер части, 0 - не ограничен
+    /// Максимальное время записи одной части, 0 - не ограничено
+    std::chrono::seconds rotateInterval{0};
+  };
+
+ public:
+  /// Открыть файл (первую часть). Ошибка возвращается через исключение.
+  BufferedFileWriter(const std::string& path, const Options& options);
+  /// Записывает буфер и закрывает файл
+  ~BufferedFileWriter();
+
+  BufferedFileWriter(const BufferedFileWriter&) = delete;
+  BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+  /// Записать блок данных
+  void Write(const void* data, size_t size) noexcept(false);
+
+  /// Выполнить периодические действия (сброс на диск, смена части), если
+  /// подошло их время. Вызывается, когда новых данных нет.
+  void Tick() noexcept(false);
+
+  /// Передать буфер в файл и сбросить файл на диск
+  void Sync() noexcept(false);
+
+  /// Путь к текущей части
+  std::string GetCurrentPath() const;
+
+ private:
+  /// Открыть очередную часть
+  void Open();
+  /// Записать буфер и закрыть текущую часть
+  void Close();
+  /// Передать буфер в файл
+  void FlushBuffer();
+  /// Проверить, не пора ли сбросить данные или сменить часть
+  void CheckTime(std::chrono::steady_clock::time_point now);
+  /// Путь к части с заданным номером
+  std::string MakePath(size_t index) const;
+  bool IsRotating() const;
+
+ private:
+  const std::string m_path;
+  const Options m_options;
+
+  std::FILE* m_file = nullptr;
+  std::vector<char> m_buffer;
+  size_t m_used = 0;      ///< Занято в буфере, байт
+  size_t m_fileSize = 0;  ///< Размер текущей части, включая буфер
+  size_t m_fileIndex = 0;
+  std::chrono::steady_clock::time_point m_lastSync;
+  std::chrono::steady_clock::time_point m_fileOpened;
+};
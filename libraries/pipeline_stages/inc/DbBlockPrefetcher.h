@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Упреждающее чтение блоков из БД в одном фоновом потоке.
+/// Пока потребитель обрабатывает текущий блок, поток читает следующий.
+/// Вперед читается не более одного блока. Поток запускается при первом
+/// запросе и живет до удаления объекта.
+class DbBlockPrefetcher {
+ public:
+  /// Прочитать очередной блок, вызывается в потоке чтения
+  using ReadFunction = std::function<std::vector<char>()>;
+
+ public:
+  explicit DbBlockPrefetcher(ReadFunction read);
+  /// Дожидается начатого чтения и останавливает поток
+  ~DbBlockPrefetcher();
+
+  DbBlockPrefetcher(const DbBlockPrefetcher&) = delete;
+  DbBlockPrefetcher& operator=(const DbBlockPrefetcher&) = delete;
+
+  /// Начать чтение следующего блока. Ничего не делает, если блок уже
+  /// запрошен и не забран.
+  void Request();
+
+  /// Блок запрошен и еще не забран
+  bool IsRequested() const;
+
+  /// Забрать запрошенный блок, дождавшись окончания чтения. Ошибка чтения
+  /// возвращается через исключение.
+  std::vector<char> Take() noexcept(false);
+
+  /// Дождаться окончания начатого чтения и забыть его результат
+  void Cancel();
+
+ private:
+  /// Поток чтения: читает блок по каждому запросу
+  void ReadBlocks();
+
+ private:
+  const ReadFunction m_read;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_blockRequested;  ///< Запрошен блок или остановка
+  std::condition_variable m_blockRead;       ///< Чтение блока закончено
+  bool m_requested = false;  ///< Блок запрошен и не забран
+  bool m_reading = false;    ///< Поток читает блок
+  std::vector<char> m_block;   ///< Прочитанный блок
+  std::exception_ptr m_error;  ///< Ошибка чтения блока
+  bool m_stopped = false;
+
+  std::thread m_reader;
+};
@@ -1,31 +1,21 @@
 #pragma once
 
-#include <IParameterized.h>
+#include <ConnectionPool.h>
+#include <KeyValueParameterized.h>
 #include <IExecutorEAV.h>
-#include <map>
 
 /// Параметризация общей части стадий чтения и записи в БД
-class DbParameterizedStage : public IParameterized {
-  mutable std::map<std::string, std::string> m_keyValues;
-  const std::vector<std::string> m_keys;
-  const std::map<std::string, std::wstring> m_keysToObviousParamName;
+class DbParameterizedStage : public KeyValueParameterized {
   bool m_isApliedParams = false;  ///< Параметры заданы
+  ConnectionPoolPtr m_connectionPool;  ///< Пул, из которого берется соединение
+  ConnectionPoolPtr m_ownConnectionPool;  ///< Свой пул, если пул не задан
+  std::string m_connectionInfo;  ///< Строка подключения примененных параметров
 
 protected:
-  IConnectionPtr m_connection;    ///< Соединение с БД
-  IExecutorEAVPtr m_executorEAV;  ///< Исполнитель EAV-запросов
-  IFilePtr m_file;  ///< Большой бинарный объект, из которого читаем
+  std::string m_fileName;  ///< Имя большого бинарного объекта
 
  public:
   DbParameterizedStage();
-  /// Получить параметры и их значения
-  virtual std::vector<PatameterValue> GetPatameterValues() const override;
-  /// Установить значение параметра
-  virtual bool SetParameterValue(const std::string& paramName,
-                                 const std::string& paramValue) override;
-  /// Получить понятное название параметра
-  virtual std::optional<std::wstring> GetObviousParamName(
-      const std::string& paramName) const override;
 
   /// Применить значения параметров
   virtual void ApplyParameterValues() noexcept(false) override;
@@ -36,8 +26,10 @@ protected:
   virtual std::wstring GetHelpString() const;
 
 public:
-  /// Установить переменную с большим бинарным объектом
-  virtual void ResetFile() = 0;
+  /// Установить большой бинарный объект, с которым работает стадия.
+  /// Соединение и исполнитель EAV-запросов действуют только во время вызова.
+  virtual void ResetFile(const IConnectionPtr& connection,
+                         IExecutorEAV& executorEAV) = 0;
 
  public:
   /// Получить строку подключения
@@ -46,4 +38,19 @@ public:
   std::string GetEntityName() const;
   /// Получить название атрибута
   std::string GetAttributeName() const;
+  /// Получить название текстового атрибута со способом сжатия объекта
+  std::string GetCompressionAttributeName() const;
+
+  /// Получить соединение из пула на время одной транзакции. Если пул не
+  /// задан, используется свой пул на GetConnectionsCount() соединений.
+  /// Возвращает ошибку через исключение.
+  IConnectionPtr LeaseConnection() const noexcept(false);
+
+  /// Брать соединения из общего пула вместо своего.
+  /// Применяется при следующем вызове ApplyParameterValues.
+  void SetConnectionPool(ConnectionPoolPtr pool);
+
+ protected:
+  /// Сколько соединений стадия использует одновременно (размер своего пула)
+  virtual size_t GetConnectionsCount() const { return 1; }
 };
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <IConnection.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Параллельное чтение большого бинарного объекта диапазонами.
+/// Объект делится на диапазоны по chunkSize байт, которые читаются
+/// несколькими потоками. Каждый диапазон читается в своей транзакции через
+/// соединение, полученное только на время его чтения, поэтому одновременно
+/// используется не больше readersCount соединений. Диапазоны выдаются строго
+/// по порядку, вперед читается не более 2 * readersCount диапазонов.
+class DbRangeReader {
+ public:
+  /// Получить соединение для чтения диапазона (вызывается из потоков чтения)
+  using ConnectionFactory = std::function<IConnectionPtr()>;
+
+ public:
+  /// \param factory Функция получения соединения, вызывается для каждого
+  ///        диапазона.
+  /// \param fileName Имя большого бинарного объекта.
+  /// \param chunkSize Размер диапазона, байт.
+  /// \param readersCount Число потоков чтения.
+  DbRangeReader(ConnectionFactory factory,
+                const std::string& fileName,
+                size_t chunkSize,
+                size_t readersCount);
+  ~DbRangeReader();
+
+  DbRangeReader(const DbRangeReader&) = delete;
+  DbRangeReader& operator=(const DbRangeReader&) = delete;
+
+  /// Размер объекта, байт
+  size_t GetFileSize() const;
+
+  /// Получить следующий по порядку диапазон. Пустой вектор означает, что
+  /// данные кончились. Ошибка чтения возвращается через исключение один
+  /// раз, когда очередь доходит до непрочитанного диапазона; после нее
+  /// чтение останавливается и данные считаются кончившимися.
+  std::vector<char> NextChunk() noexcept(false);
+
+ private:
+  /// Поток чтения: берет очередной диапазон и читает его
+  void ReadRanges();
+
+ private:
+  const ConnectionFactory m_factory;
+  const std::string m_fileName;
+  const size_t m_chunkSize;
+  size_t m_fileSize = 0;
+  size_t m_chunksCount = 0;
+  size_t m_readAheadLimit = 0;  ///< Сколько диапазонов читается вперед
+
+  std::mutex m_mutex;
+  std::condition_variable m_chunkReady;  ///< Прочитан очередной диапазон
+  std::condition_variable m_chunkTaken;  ///< Диапазон выдан потребителю
+  size_t m_nextToRead = 0;    ///< Диапазон, который возьмет следующий поток
+  size_t m_nextToReturn = 0;  ///< Диапазон, который будет выдан следующим
+  std::map<size_t, std::vector<char>> m_readyChunks;  ///< Прочитанные
+  std::exception_ptr m_error;  ///< Ошибка потока чтения
+  size_t m_failedChunk = 0;    ///< Диапазон, при чтении которого она возникла
+  bool m_stopped = false;
+
+  std::vector<std::thread> m_readers;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Отложенная запись в БД с несколькими буферами.
+/// Данные копируются в текущий буфер, заполненный буфер передается потоку
+/// записи, а вызывающий продолжает работу со свободным буфером. Память
+/// ограничена buffersCount буферами по bufferSize байт. Если записи ожидает
+/// больше highWaterMark буферов, добавление данных блокируется, пока запись
+/// не продвинется (обратное давление на источник).
+class DbWriteBehind {
+ public:
+  /// Записать буфер в БД, вызывается в потоке записи
+  using WriteFunction = std::function<bool(const std::vector<char>&)>;
+
+ public:
+  /// \param write Функция записи буфера.
+  /// \param bufferSize Размер буфера, байт.
+  /// \param buffersCount Число буферов, не меньше 2.
+  /// \param highWaterMark Число ожидающих записи буферов, превышение
+  ///        которого блокирует добавление данных, от 1 до buffersCount - 1.
+  DbWriteBehind(WriteFunction write,
+                size_t bufferSize,
+                size_t buffersCount,
+                size_t highWaterMark);
+  /// Записывает оставшиеся данные и останавливает поток записи
+  ~DbWriteBehind();
+
+  DbWriteBehind(const DbWriteBehind&) = delete;
+  DbWriteBehind& operator=(const DbWriteBehind&) = delete;
+
+  /// Скопировать данные в текущий буфер. Если буфер заполнен, он передается
+  /// на запись. Ошибка записи предыдущих буферов возвращается через
+  /// исключение (один раз), данные при этом не добавляются.
+  void Append(const void* data, size_t size) noexcept(false);
+
+  /// Передать текущий буфер на запись, не дожидаясь ее
+  void Submit();
+
+  /// Передать текущий буфер на запись и дождаться записи всех буферов
+  /// \return \c false, если какой-либо буфер записать не удалось.
+  bool Flush();
+
+  /// Есть ли данные в текущем буфере
+  bool HasBufferedData() const;
+
+ private:
+  /// Поток записи: записывает заполненные буферы по порядку
+  void WriteBuffers();
+  /// Передать текущий буфер на запись (мьютекс захвачен)
+  void SubmitLocked();
+
+ private:
+  const WriteFunction m_write;
+  const size_t m_bufferSize;
+  const size_t m_highWaterMark;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_bufferFull;  ///< Появился буфер для записи
+  std::condition_variable m_bufferFree;  ///< Буфер записан
+  std::vector<char> m_current;               ///< Заполняемый буфер
+  std::deque<std::vector<char>> m_full;      ///< Ожидающие записи
+  std::vector<std::vector<char>> m_free;     ///< Свободные буферы
+  bool m_writing = false;  ///< Поток записи пишет буфер
+  bool m_failed = false;   ///< Запись буфера не удалась
+  bool m_stopped = false;
+
+  std::thread m_writer;
+};
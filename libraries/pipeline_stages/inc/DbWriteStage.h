@@ -2,26 +2,82 @@
 
 #include "ConsumerStage.h"
 #include "DbParameterizedStage.h"
+#include "DbWriteBehind.h"
+#include "SampleCodec.h"
+#include "SampleType.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+/// Стадия записи задач в БД.
+/// Задачи накапливаются и записываются одной транзакцией, когда их число
+/// достигает batchSize или с момента поступления первой из них проходит
+/// flushInterval. Задачи освобождаются только после фиксации транзакции,
+/// пакет, который записать не удалось, записывается повторно.
+/// В режиме writeBehind задачи копируются в один из buffers буферов и
+/// освобождаются сразу, а пакеты записывает отдельный поток (DbWriteBehind).
+/// Если задан способ сжатия compression, каждый пакет записывается сжатым
+/// блоком (см. SampleCodec). Способ сжатия записывается в атрибут сущности
+/// (см. GetCompressionAttributeName), по нему DbReadStage раскодирует блоки.
+/// Соединение берется из пула на время записи одного пакета.
 template <typename T>
 class DbWriteStage : public ConsumerStage<T>, public DbParameterizedStage {
   IExecutorEAV::EntityId m_entityId = -1; ///< Идентификатор сущности, в которую пишем
+  size_t m_batchSize = 1;  ///< Число задач, при котором пакет записывается
+  std::chrono::microseconds m_flushInterval{0};  ///< Время накопления пакета
+  std::chrono::steady_clock::time_point m_batchStarted;  ///< Начало пакета
+  std::vector<std::shared_ptr<T>> m_pending;  ///< Задачи, ожидающие записи
+  std::vector<T> m_buffer;  ///< Данные пакета для записи одним вызовом
+  std::unique_ptr<DbWriteBehind> m_writeBehind;  ///< Отложенная запись
+  SampleCompression m_compression = SampleCompression::none;  ///< Сжатие
+  std::vector<char> m_encoded;  ///< Сжатый пакет
 
  public:
   DbWriteStage(ConsumptionStrategy strategy,
                std::shared_ptr<InStageConnection<T>>);
 
+  ~DbWriteStage() override;
+
   void consume(std::shared_ptr<T> inData) override;
 
+  /// Остановить стадию и записать накопленные задачи
+  void shutdown() override;
+
+ public:
   /// Применить значения параметров
   virtual void ApplyParameterValues() noexcept(false) override;
 
  public:
-  virtual void ResetFile() override;
+  virtual void ResetFile(const IConnectionPtr& connection,
+                         IExecutorEAV& executorEAV) override;
+
+ protected:
+  void onIdle() override;
+
+ private:
+  /// Записать накопленные задачи одной транзакцией и освободить их
+  /// (в режиме writeBehind - дождаться записи всех буферов). Если запись не
+  /// удалась, задачи остаются накопленными и записываются при следующей
+  /// попытке. Возвращает false, если запись не удалась.
+  bool Flush();
+  /// Освободить накопленные задачи без записи
+  void DropPending();
+  /// Пора ли записать накопленное
+  bool IsFlushDue(std::chrono::steady_clock::time_point now) const;
+  /// Записать данные в большой бинарный объект одной транзакцией
+  bool WriteBuffer(const char* data, size_t size);
+  /// Сжать отсчеты пакета (если задано сжатие) и записать их
+  bool WriteSamples(const char* data, size_t size);
+  /// Максимальное число накапливаемых задач. Накопленные задачи занимают
+  /// места в соединении, поэтому хотя бы одно место остается производителю.
+  size_t GetBatchLimit() const;
 
  public:
   static inline std::string stageName =
-      std::string(typeid(T).name()) + "ToDatabase";
+      std::string(SampleType<T>::name) + "ToDatabase";
   using consumptionT = T;
   using productionT = void;
 };
@@ -29,7 +85,28 @@ class DbWriteStage : public ConsumerStage<T>, public DbParameterizedStage {
 template <typename T>
 DbWriteStage<T>::DbWriteStage(ConsumptionStrategy strategy,
                               std::shared_ptr<InStageConnection<T>> connection)
-    : ConsumerStage(stageName, strategy, connection) {}
+    : ConsumerStage(stageName, strategy, connection) {
+  AddParameter("batchSize", L"Число задач, записываемых одной транзакцией",
+               "256");
+  AddParameter("flushInterval", L"Максимальное время накопления задач, мкс",
+               "50000");
+  AddParameter("writeBehind", L"Отложенная запись в отдельном потоке (0/1)",
+               "0");
+  AddParameter("buffers", L"Число буферов отложенной записи", "2");
+  AddParameter("highWaterMark",
+               L"Число ожидающих записи буферов, после которого прием задач "
+               L"приостанавливается",
+               "1");
+  AddParameter("compression",
+               L"Сжатие (none, delta, deltaOfDelta, bitPacked - для int32, "
+               L"gorilla - для double)",
+               "none");
+}
+
+template <typename T>
+DbWriteStage<T>::~DbWriteStage() {
+  shutdown();
+}
 
 template <typename T>
 void DbWriteStage<T>::consume(std::shared_ptr<T> inData) {
@@ -39,56 +116,224 @@ void DbWriteStage<T>::consume(std::shared_ptr<T> inData) {
     return;
   }
 
-  if (auto status = m_connection->BeginTransaction(); status->HasError()) {
-    dataConsumed(inData, false);
-    return;
-  }
+  auto now = std::chrono::steady_clock::now();
+  if (m_writeBehind) {
+    // Задача копируется в буфер и освобождается, не дожидаясь записи
+    if (!m_writeBehind->HasBufferedData())
+      m_batchStarted = now;
+    m_writeBehind->Append(inData.get(), sizeof(T));
+    dataConsumed(inData);
 
-  if (!m_file->Open(FileOpenMode::Append)) {
-    dataConsumed(inData, false);
+    if (IsFlushDue(now))
+      m_writeBehind->Submit();
     return;
   }
 
-  if (!m_file->WriteBytes(reinterpret_cast<char*>(inData.get()), sizeof(T))) {
-    m_connection->RollbackTransaction();
-    dataConsumed(inData, false);
-    return;
-  }
+  if (m_pending.empty())
+    m_batchStarted = now;
+  m_pending.push_back(inData);
 
-  if (auto status = m_connection->CommitTransaction(); status->HasError()) {
-    dataConsumed(inData, false);
-    return;
-  }
+  if (m_pending.size() >= GetBatchLimit() || IsFlushDue(now))
+    Flush();
+}
 
-  dataConsumed(inData, true);
+template <typename T>
+void DbWriteStage<T>::shutdown() {
+  ConsumerStage<T>::shutdown();
+  // Поток стадии остановлен, дописываем то, что он успел накопить.
+  // Повторить запись уже некому, поэтому ошибка только сообщается.
+  if (!Flush()) {
+    std::cerr << "DbWriteStage: can't write buffered tasks to database"
+              << std::endl;
+    DropPending();
+  }
 }
 
 template <typename T>
 inline void DbWriteStage<T>::ApplyParameterValues() noexcept(false)
 {
+  // Накопленное относится к прежним параметрам
+  if (!Flush())
+    throw std::runtime_error("Can't write buffered tasks to database");
+  m_writeBehind.reset();
+
+  auto batchSize = GetSizeParameter("batchSize", 1);
+  auto flushInterval = GetSizeParameter("flushInterval");
+  auto writeBehind = GetFlagParameter("writeBehind");
+  auto buffers = GetSizeParameter("buffers");
+  auto highWaterMark = GetSizeParameter("highWaterMark");
+  auto compressionName = GetParameter("compression");
+  auto compression = SampleCodec::ParseCompression(compressionName);
+  if (writeBehind && buffers < 2)
+    throw std::invalid_argument("at least 2 buffers are required");
+  if (writeBehind && (highWaterMark == 0 || highWaterMark >= buffers))
+    throw std::invalid_argument(
+        "highWaterMark must be between 1 and buffers - 1");
+  if (!SampleCodec::Supports<T>(compression))
+    throw std::invalid_argument("compression " + compressionName +
+                                " is not supported for this type");
+
+  // Способ сжатия записывается вместе с объектом в ResetFile
+  m_compression = compression;
   DbParameterizedStage::ApplyParameterValues();
+  m_batchSize = batchSize;
+  m_flushInterval = std::chrono::microseconds(flushInterval);
+  if (writeBehind) {
+    // Пакеты дальше записывает только поток записи
+    m_writeBehind = std::make_unique<DbWriteBehind>(
+        [this](const std::vector<char>& data) {
+          return WriteSamples(data.data(), data.size());
+        },
+        m_batchSize * sizeof(T), buffers, highWaterMark);
+  } else {
+    m_pending.reserve(m_batchSize);
+    m_buffer.reserve(m_batchSize);
+  }
   // setId("EntityName: " + GetEntityName() + "; EntityId: " + std::to_string(m_entityId));
 }
 
 template <typename T>
-inline void DbWriteStage<T>::ResetFile() {
-  m_file.reset();
-
+inline void DbWriteStage<T>::ResetFile(const IConnectionPtr& connection,
+                                       IExecutorEAV& executorEAV) {
   auto converter = GetDatabaseManager().GetSQLTypeConverter();
 
-  m_file = m_connection->CreateRemoteFile();
+  auto file = connection->CreateRemoteFile();
+  if (!file)
+    throw std::runtime_error("Can't create binary large object");
+  m_fileName = file->GetFileName();
 
   ISQLTypeRemoteFileIdPtr value =
-      converter->GetSQLTypeRemoteFileId(m_file->GetFileName());
+      converter->GetSQLTypeRemoteFileId(m_fileName);
 
   m_entityId = -1;
-  if (auto status = m_executorEAV->CreateNewEntity(GetEntityName(), m_entityId);
+  if (auto status = executorEAV.CreateNewEntity(GetEntityName(), m_entityId);
       status->HasError())
     throw std::runtime_error(status->GetErrorMessage());
 
-  if (auto status = m_executorEAV->Insert(
+  if (auto status = executorEAV.Insert(
           GetEntityName(), m_entityId,
           converter->GetSQLTypeText(GetAttributeName()), value);
       status->HasError())
     throw std::runtime_error(status->GetErrorMessage());
+
+  if (auto status = executorEAV.Insert(
+          GetEntityName(), m_entityId,
+          converter->GetSQLTypeText(GetCompressionAttributeName()),
+          converter->GetSQLTypeText(
+              SampleCodec::GetCompressionName(m_compression)));
+      status->HasError())
+    throw std::runtime_error(status->GetErrorMessage());
+}
+
+template <typename T>
+inline void DbWriteStage<T>::onIdle() {
+  // Новых задач нет, но накопленные не держатся дольше flushInterval.
+  // Пустые опросы идут и без ожидания, поэтому пакет записывается только
+  // по времени.
+  if (!IsFlushDue(std::chrono::steady_clock::now()))
+    return;
+
+  if (m_writeBehind)
+    m_writeBehind->Submit();
+  else
+    Flush();
+}
+
+template <typename T>
+inline bool DbWriteStage<T>::IsFlushDue(
+    std::chrono::steady_clock::time_point now) const {
+  auto hasData =
+      m_writeBehind ? m_writeBehind->HasBufferedData() : !m_pending.empty();
+  return hasData && now - m_batchStarted >= m_flushInterval;
+}
+
+template <typename T>
+inline bool DbWriteStage<T>::Flush() {
+  if (m_writeBehind)
+    // Задачи уже освобождены, ошибка возвращается вызывающему
+    return m_writeBehind->Flush();
+
+  if (m_pending.empty())
+    return true;
+
+  m_buffer.clear();
+  for (auto&& task : m_pending)
+    m_buffer.push_back(*task);
+
+  bool written =
+      IsFullyParameterized() &&
+      WriteSamples(reinterpret_cast<const char*>(m_buffer.data()),
+                   m_buffer.size() * sizeof(T));
+  if (!written) {
+    // Задачи не освобождаются, запись повторяется через flushInterval
+    m_batchStarted = std::chrono::steady_clock::now();
+    return false;
+  }
+
+  // Соединение могло быть удалено раньше стадии
+  if (this->getInConnection() != nullptr) {
+    for (auto&& task : m_pending)
+      this->dataConsumed(task);
+  }
+  m_pending.clear();
+  return true;
+}
+
+template <typename T>
+inline void DbWriteStage<T>::DropPending() {
+  if (this->getInConnection() != nullptr) {
+    for (auto&& task : m_pending)
+      this->dataConsumed(task, false);
+  }
+  m_pending.clear();
+}
+
+template <typename T>
+inline bool DbWriteStage<T>::WriteBuffer(const char* data, size_t size) {
+  IConnectionPtr connection;
+  try {
+    connection = LeaseConnection();
+  } catch (const std::exception&) {
+    return false;
+  }
+
+  if (auto status = connection->BeginTransaction(); status->HasError())
+    return false;
+
+  auto file = connection->GetRemoteFile(m_fileName);
+  if (!file || !file->Open(FileOpenMode::Append)) {
+    connection->RollbackTransaction();
+    return false;
+  }
+
+  size_t written = 0;
+  if (!file->WriteBytes(data, size, &written) || written != size) {
+    connection->RollbackTransaction();
+    return false;
+  }
+
+  if (auto status = connection->CommitTransaction(); status->HasError())
+    return false;
+
+  return true;
+}
+
+template <typename T>
+inline bool DbWriteStage<T>::WriteSamples(const char* data, size_t size) {
+  if (m_compression == SampleCompression::none)
+    return WriteBuffer(data, size);
+
+  // В режиме writeBehind вызывается только из потока записи
+  m_encoded.clear();
+  SampleCodec::Encode(m_compression, data, size, m_encoded);
+  return WriteBuffer(m_encoded.data(), m_encoded.size());
+}
+
+template <typename T>
+inline size_t DbWriteStage<T>::GetBatchLimit() const {
+  auto limit = m_batchSize;
+  if (auto in = this->getInConnection(); in != nullptr)
+    limit = std::min(limit, in->getCapacity() - 1);
+
+  return std::max<size_t>(limit, 1);
 }
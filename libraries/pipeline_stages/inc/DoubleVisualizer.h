@@ -2,7 +2,11 @@
 
 #include "ConsumerStage.h"
 
+#include <fstream>
+
 class DoubleVisualizer : public ConsumerStage<double> {
+  std::ofstream m_file;
+
  public:
   DoubleVisualizer(ConsumptionStrategy strategy,
                    std::shared_ptr<InStageConnection<double>>);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "SampleType.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+/// Точка для отображения: номер значения в потоке и само значение
+struct DisplayPoint {
+  uint64_t index;
+  double value;
+};
+
+template <>
+struct SampleType<DisplayPoint> {
+  static constexpr const char* name = "displayPoint";
+};
+
+/// Прореживание потока значений для отображения.
+/// Поток делится на корзины по bucketSize значений, из каждой остаются:
+/// - minMax: минимум и максимум (в порядке следования, совпавшие - одной
+///   точкой), так что на графике сохраняются все выбросы;
+/// - lttb: одна точка по алгоритму Largest-Triangle-Three-Buckets - та, что
+///   образует наибольший треугольник с предыдущей выбранной точкой и средним
+///   следующей корзины. Поэтому точка корзины выдается, когда заполнится
+///   следующая. Первое значение потока выдается всегда.
+class Downsampler {
+ public:
+  enum class Method { minMax, lttb };
+
+ public:
+  Downsampler(Method method, size_t bucketSize) noexcept(false);
+
+  /// Добавить значение. Выбранные точки становятся в очередь.
+  void Add(double value);
+  /// Извлечь очередную выбранную точку
+  std::optional<DisplayPoint> Next();
+
+ private:
+  void CloseMinMaxBucket();
+  void CloseLttbBucket();
+
+ private:
+  const Method m_method;
+  const size_t m_bucketSize;
+  uint64_t m_count = 0;           ///< Число добавленных значений
+  std::vector<double> m_bucket;   ///< Заполняемая корзина
+  uint64_t m_bucketStart = 0;     ///< Номер первого значения m_bucket
+  std::vector<double> m_pending;  ///< Корзина, ожидающая следующей (lttb)
+  uint64_t m_pendingStart = 0;    ///< Номер первого значения m_pending
+  DisplayPoint m_selected{};      ///< Последняя выбранная точка (lttb)
+  std::deque<DisplayPoint> m_points;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Downsampler.h"
+#include "KeyValueParameterized.h"
+#include "ProducerAndConsumerStage.h"
+#include "SampleType.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+/// Стадия прореживания значений для отображения (см. Downsampler).
+/// Из каждых span значений остается около points точек. Стадия рассчитана на
+/// отдельную ветвь конвейера: она подключается к тому же выходу, что и
+/// основная обработка, и не замедляет ее.
+/// За одно значение выдается не больше одной точки, поэтому точки корзины
+/// выдаются по мере поступления следующих значений.
+template <typename T>
+class DownsamplingStage : public ConsumerAndProducerStage<T, DisplayPoint>,
+                          public KeyValueParameterized {
+  static_assert(std::is_arithmetic_v<T>, "only numbers can be displayed");
+
+  std::unique_ptr<Downsampler> m_downsampler;
+
+ public:
+  DownsamplingStage(
+      ConsumptionStrategy strategy,
+      std::shared_ptr<InStageConnection<T>> inConnection,
+      std::shared_ptr<OutStageConnection<DisplayPoint>> outConnection);
+
+  void consumeAndProduce(std::shared_ptr<T> inData,
+                         std::shared_ptr<DisplayPoint> outData) override;
+
+ public:
+  /// Применить значения параметров. Прореживание начинается заново.
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+ private:
+  /// Создать прореживатель по текущим значениям параметров
+  std::unique_ptr<Downsampler> MakeDownsampler() const noexcept(false);
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "Downsampling";
+  using consumptionT = T;
+  using productionT = DisplayPoint;
+};
+
+template <typename T>
+DownsamplingStage<T>::DownsamplingStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> inConnection,
+    std::shared_ptr<OutStageConnection<DisplayPoint>> outConnection)
+    : ConsumerAndProducerStage<T, DisplayPoint>(stageName,
+                                                strategy,
+                                                inConnection,
+                                                outConnection) {
+  AddParameter("method", L"Способ прореживания (minmax или lttb)", "minmax");
+  AddParameter("span", L"Число значений, на которое выдается points точек",
+               "10000");
+  AddParameter("points", L"Число точек на span значений", "1000");
+  m_downsampler = MakeDownsampler();
+}
+
+template <typename T>
+void DownsamplingStage<T>::consumeAndProduce(
+    std::shared_ptr<T> inData,
+    std::shared_ptr<DisplayPoint> outData) {
+  m_downsampler->Add(double(*inData));
+  this->dataConsumed(inData);
+
+  auto point = m_downsampler->Next();
+  if (!point) {
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  *outData = *point;
+  this->dataProduced(outData);
+}
+
+template <typename T>
+inline void DownsamplingStage<T>::ApplyParameterValues() noexcept(false) {
+  m_downsampler = MakeDownsampler();
+}
+
+template <typename T>
+inline bool DownsamplingStage<T>::IsFullyParameterized() const {
+  return true;
+}
+
+template <typename T>
+inline std::unique_ptr<Downsampler> DownsamplingStage<T>::MakeDownsampler()
+    const noexcept(false) {
+  auto method = GetParameter("method");
+  if (method != "minmax" && method != "lttb")
+    throw std::invalid_argument("Unknown downsampling method " + method);
+
+  auto span = GetSizeParameter("span");
+  auto points = GetSizeParameter("points", 1);
+
+  // Корзина minmax дает две точки, lttb - одну
+  if (method == "minmax")
+    return std::make_unique<Downsampler>(
+        Downsampler::Method::minMax, std::max<size_t>(2, 2 * span / points));
+  return std::make_unique<Downsampler>(Downsampler::Method::lttb,
+                                       std::max<size_t>(1, span / points));
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <KeyValueParameterized.h>
+
+/// Параметризация общей части стадий, работающих с файлами записей
+class FileParameterizedStage : public KeyValueParameterized {
+  bool m_isApliedParams = false;  ///< Параметры заданы
+
+ public:
+  FileParameterizedStage();
+
+  /// Применить значения параметров
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+ public:
+  /// Переоткрыть файл с текущими значениями параметров
+  virtual void ResetFile() = 0;
+
+ public:
+  /// Получить имя файла
+  std::string GetFileName() const;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "BufferedFileWriter.h"
+#include "ConsumerStage.h"
+#include "FileParameterizedStage.h"
+#include "Frame.h"
+#include "SampleType.h"
+
+#include <charconv>
+#include <chrono>
+#include <memory>
+#include <type_traits>
+
+/// Стадия записи задач в файл.
+/// Файл открывается один раз, задачи пишутся через буфер BufferedFileWriter
+/// в двоичном виде (format = binary, как есть) или текстом (format = text,
+/// по значению в строке; для кадров - строка на отсчет со значениями каналов
+/// через табуляцию). Данные сбрасываются на диск каждые syncInterval,
+/// файл разбивается на части по rotateSize байт или rotateInterval секунд.
+template <typename T>
+class FileRecorderStage : public ConsumerStage<T>,
+                          public FileParameterizedStage {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "only trivially copyable tasks can be recorded");
+
+  std::unique_ptr<BufferedFileWriter> m_writer;
+  bool m_text = false;  ///< Текстовый формат записи
+
+ public:
+  FileRecorderStage(ConsumptionStrategy strategy,
+                    std::shared_ptr<InStageConnection<T>>);
+
+  ~FileRecorderStage() override;
+
+  void consume(std::shared_ptr<T> inData) override;
+
+  /// Остановить стадию и записать буфер в файл
+  void shutdown() override;
+
+ public:
+  /// Переоткрыть файл с текущими значениями параметров
+  virtual void ResetFile() override;
+
+ protected:
+  void onIdle() override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "ToFile";
+  using consumptionT = T;
+  using productionT = void;
+};
+
+template <typename T>
+FileRecorderStage<T>::FileRecorderStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> connection)
+    : ConsumerStage<T>(stageName, strategy, connection) {
+  AddParameter("format", L"Формат записи (binary или text)", "binary");
+  AddParameter("bufferSize", L"Размер буфера записи, байт", "1048576");
+  AddParameter("syncInterval",
+               L"Период сброса данных на диск, мс (0 - при закрытии)", "1000");
+  AddParameter("rotateSize",
+               L"Максимальный размер части файла, байт (0 - не ограничен)",
+               "0");
+  AddParameter("rotateInterval",
+               L"Максимальное время записи части файла, с (0 - не ограничено)",
+               "0");
+}
+
+template <typename T>
+FileRecorderStage<T>::~FileRecorderStage() {
+  shutdown();
+}
+
+template <typename T>
+void FileRecorderStage<T>::consume(std::shared_ptr<T> inData) {
+  if (!m_writer) {
+    // Параметры не были заданы. Не можем писать данные.
+    this->dataConsumed(inData, false);
+    return;
+  }
+
+  if constexpr (std::is_arithmetic_v<T>) {
+    if (m_text) {
+      char line[64];
+      auto result = std::to_chars(line, line + sizeof(line) - 1, *inData);
+      *result.ptr++ = '\n';
+      m_writer->Write(line, size_t(result.ptr - line));
+      this->dataConsumed(inData);
+      return;
+    }
+  } else if constexpr (isFrame<T>) {
+    if (m_text) {
+      // Кадр хранится по каналам, в тексте - по отсчетам
+      char line[64 * T::channels];
+      for (size_t sample = 0; sample < T::samples; ++sample) {
+        char* end = line;
+        for (size_t channel = 0; channel < T::channels; ++channel) {
+          end = std::to_chars(end, line + sizeof(line) - 1,
+                              inData->data[channel][sample])
+                    .ptr;
+          *end++ = channel + 1 < T::channels ? '\t' : '\n';
+        }
+        m_writer->Write(line, size_t(end - line));
+      }
+      this->dataConsumed(inData);
+      return;
+    }
+  }
+
+  m_writer->Write(inData.get(), sizeof(T));
+  this->dataConsumed(inData);
+}
+
+template <typename T>
+void FileRecorderStage<T>::shutdown() {
+  ConsumerStage<T>::shutdown();
+  // Поток стадии остановлен, записываем то, что осталось в буфере
+  m_writer.reset();
+}
+
+template <typename T>
+inline void FileRecorderStage<T>::ResetFile() {
+  auto format = GetParameter("format");
+  if (format != "binary" &&
+      (format != "text" || !(std::is_arithmetic_v<T> || isFrame<T>)))
+    throw std::invalid_argument("Unsupported file format " + format);
+
+  BufferedFileWriter::Options options;
+  options.bufferSize = GetSizeParameter("bufferSize", 1);
+  options.syncInterval =
+      std::chrono::milliseconds(GetSizeParameter("syncInterval"));
+  options.rotateSize = GetSizeParameter("rotateSize");
+  options.rotateInterval =
+      std::chrono::seconds(GetSizeParameter("rotateInterval"));
+
+  m_writer.reset();
+  m_text = format == "text";
+  m_writer = std::make_unique<BufferedFileWriter>(GetFileName(), options);
+}
+
+template <typename T>
+inline void FileRecorderStage<T>::onIdle() {
+  if (m_writer)
+    m_writer->Tick();
+}
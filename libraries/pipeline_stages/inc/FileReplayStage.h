@@ -0,0 +1,120 @@
+#pragma once
+
+#include "FileParameterizedStage.h"
+#include "MappedFile.h"
+#include "ProducerStage.h"
+#include "RatePacer.h"
+#include "SampleType.h"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+/// Стадия воспроизведения двоичного файла записей T (например, записанного
+/// FileRecorderStage). Файл отображается в память, записи с startOffset до
+/// endOffset (в записях, 0 - до конца файла) выдаются без ограничения
+/// скорости или с частотой rate записей в секунду. При loop воспроизведение
+/// повторяется, иначе стадия завершается.
+template <typename T>
+class FileReplayStage : public ProducerStage<T>, public FileParameterizedStage {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "only trivially copyable tasks can be replayed");
+
+  MappedFile m_file;
+  size_t m_begin = 0;  ///< Первая воспроизводимая запись
+  size_t m_end = 0;    ///< Запись, следующая за последней воспроизводимой
+  size_t m_next = 0;   ///< Следующая запись
+  bool m_loop = false;
+  RatePacer m_pacer;  ///< Расписание выдачи записей при заданном rate
+
+ public:
+  FileReplayStage(std::shared_ptr<OutStageConnection<T>>);
+
+  void produce(std::shared_ptr<T> outData) override;
+
+ public:
+  /// Отобразить файл заново и начать воспроизведение сначала
+  virtual void ResetFile() override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "FromFile";
+  using consumptionT = void;
+  using productionT = T;
+
+  /// Максимальная пауза стадии в ожидании времени выдачи записи
+  static constexpr std::chrono::milliseconds pacingWaitPeriod{10};
+};
+
+template <typename T>
+FileReplayStage<T>::FileReplayStage(
+    std::shared_ptr<OutStageConnection<T>> connection)
+    : ProducerStage<T>(stageName, connection) {
+  AddParameter("startOffset", L"Номер первой записи", "0");
+  AddParameter("endOffset",
+               L"Номер записи, на которой воспроизведение останавливается "
+               L"(0 - до конца файла)",
+               "0");
+  AddParameter("rate", L"Записей в секунду (0 - без ограничения)", "0");
+  AddParameter("loop", L"Повторять воспроизведение (0/1)", "0");
+  AddParameter("populate", L"Загрузить файл в память при открытии (0/1)",
+               "0");
+}
+
+template <typename T>
+void FileReplayStage<T>::produce(std::shared_ptr<T> outData) {
+  if (!m_file.isOpen()) {
+    // Параметры не были заданы. Не можем читать данные.
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  if (m_next == m_end) {
+    if (!m_loop || m_begin == m_end) {
+      // Данные кончились, больше производить нечего
+      this->dataProduced(outData, false);
+      this->finish();
+      return;
+    }
+    m_next = m_begin;
+  }
+
+  if (!m_pacer.WaitForNext(pacingWaitPeriod)) {
+    // Время следующей записи еще не наступило
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  std::memcpy(outData.get(), m_file.data() + m_next * sizeof(T), sizeof(T));
+  ++m_next;
+  this->dataProduced(outData);
+}
+
+template <typename T>
+inline void FileReplayStage<T>::ResetFile() {
+  auto begin = GetSizeParameter("startOffset");
+  auto end = GetSizeParameter("endOffset");
+  auto rate = GetRealParameter("rate", 0);
+  auto loop = GetFlagParameter("loop");
+  auto populate = GetFlagParameter("populate");
+
+  m_file = MappedFile(GetFileName(), populate);
+
+  // Неполная запись в конце файла не воспроизводится
+  auto records = m_file.size() / sizeof(T);
+  if (end == 0)
+    end = records;
+  if (end > records || begin > end) {
+    m_file.close();
+    throw std::invalid_argument("Offsets " + std::to_string(begin) + ".." +
+                                std::to_string(end) + " are out of file " +
+                                GetFileName() + " with " +
+                                std::to_string(records) + " records");
+  }
+
+  m_begin = m_next = begin;
+  m_end = end;
+  m_loop = loop;
+  m_pacer.Reset(rate);
+}
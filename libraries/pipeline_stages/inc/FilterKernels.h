@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+
+/// Скалярное произведение count значений.
+/// Считается инструкциями AVX2/FMA, если их поддерживает процессор, иначе
+/// SSE2 или без векторных инструкций. Порядок суммирования в этих вариантах
+/// разный, поэтому результаты могут отличаться в последних разрядах.
+double DotProduct(const double* a, const double* b, size_t count);
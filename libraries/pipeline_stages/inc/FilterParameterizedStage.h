@@ -0,0 +1,58 @@
+#pragma once
+
+#include <KeyValueParameterized.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/// Параметризация общей части стадий-фильтров.
+/// Коэффициенты задаются списком чисел через пробел, запятую или точку с
+/// запятой - в параметре coefficients или в текстовом файле coefficientsFile
+/// (если он задан). Коэффициенты по умолчанию не меняют сигнал, поэтому
+/// фильтр работает и без применения параметров.
+class FilterParameterizedStage : public KeyValueParameterized {
+  std::wstring m_coefficientsHelp;    ///< Описание коэффициентов фильтра
+  std::vector<double> m_coefficients;  ///< Примененные коэффициенты
+
+ public:
+  /// defaultCoefficients - коэффициенты фильтра, не меняющего сигнал,
+  /// coefficientsHelp - описание коэффициентов для справки
+  FilterParameterizedStage(const std::string& defaultCoefficients,
+                           const std::wstring& coefficientsHelp);
+
+  /// Применить значения параметров. Состояние фильтра сбрасывается.
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+  /// Получить справочную информацию
+  virtual std::wstring GetHelpString() const override;
+
+ public:
+  /// Создать фильтр с заданными коэффициентами (исключение, если они
+  /// некорректны; прежний фильтр при этом остается)
+  virtual void ResetFilter(const std::vector<double>& coefficients) = 0;
+
+ public:
+  /// Получить примененные коэффициенты
+  const std::vector<double>& GetCoefficients() const;
+
+ private:
+  /// Прочитать коэффициенты из параметра или файла
+  std::vector<double> ReadCoefficients() const noexcept(false);
+};
+
+/// Привести результат фильтра к типу отсчета (целые округляются и
+/// ограничиваются диапазоном типа)
+template <typename T>
+T FilterOutputCast(double value) {
+  if constexpr (std::is_integral_v<T>) {
+    auto low = double(std::numeric_limits<T>::lowest());
+    auto high = double(std::numeric_limits<T>::max());
+    return T(std::llround(std::clamp(value, low, high)));
+  } else {
+    return T(value);
+  }
+}
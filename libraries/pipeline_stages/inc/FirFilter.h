@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/// КИХ-фильтр: y[n] = sum(taps[k] * x[n - k]).
+/// Последние значения хранятся дважды подряд в кольцевом буфере, поэтому
+/// окно фильтра всегда непрерывно и свертка считается векторным
+/// скалярным произведением (DotProduct). Состояние сохраняется между
+/// вызовами Process, так что поток можно обрабатывать блоками любого размера.
+class FirFilter {
+ public:
+  explicit FirFilter(const std::vector<double>& taps) noexcept(false);
+
+  /// Отфильтровать count значений in в out (in и out могут совпадать)
+  void Process(const double* in, double* out, size_t count);
+  /// Забыть предыдущие значения
+  void Reset();
+
+ private:
+  std::vector<double> m_reversedTaps;  ///< Коэффициенты от старых к новым
+  std::vector<double> m_history;       ///< Две копии последних значений
+  size_t m_position = 0;               ///< Позиция следующего значения
+};
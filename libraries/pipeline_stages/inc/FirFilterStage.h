@@ -0,0 +1,68 @@
+#pragma once
+
+#include "FilterParameterizedStage.h"
+#include "FirFilter.h"
+#include "ProducerAndConsumerStage.h"
+#include "SampleType.h"
+
+#include <memory>
+#include <type_traits>
+
+/// Стадия КИХ-фильтра (см. FirFilter). Коэффициенты - отсчеты импульсной
+/// характеристики, начиная с нулевого.
+template <typename T>
+class FirFilterStage : public ConsumerAndProducerStage<T, T>,
+                       public FilterParameterizedStage {
+  static_assert(std::is_arithmetic_v<T>, "only numbers can be filtered");
+
+  std::unique_ptr<FirFilter> m_filter;
+
+ public:
+  FirFilterStage(ConsumptionStrategy strategy,
+                 std::shared_ptr<InStageConnection<T>> inConnection,
+                 std::shared_ptr<OutStageConnection<T>> outConnection);
+
+  void consumeAndProduce(std::shared_ptr<T> inData,
+                         std::shared_ptr<T> outData) override;
+
+ public:
+  /// Создать фильтр с заданными коэффициентами
+  virtual void ResetFilter(const std::vector<double>& coefficients) override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "FirFilter";
+  using consumptionT = T;
+  using productionT = T;
+};
+
+template <typename T>
+FirFilterStage<T>::FirFilterStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> inConnection,
+    std::shared_ptr<OutStageConnection<T>> outConnection)
+    : ConsumerAndProducerStage<T, T>(stageName,
+                                     strategy,
+                                     inConnection,
+                                     outConnection),
+      FilterParameterizedStage("1",
+                               L"КИХ-фильтр, коэффициенты - отсчеты "
+                               L"импульсной характеристики h[0], h[1], ...") {
+  ResetFilter(GetCoefficients());
+}
+
+template <typename T>
+void FirFilterStage<T>::consumeAndProduce(std::shared_ptr<T> inData,
+                                          std::shared_ptr<T> outData) {
+  double value = double(*inData);
+  m_filter->Process(&value, &value, 1);
+  *outData = FilterOutputCast<T>(value);
+  this->dataConsumed(inData);
+  this->dataProduced(outData);
+}
+
+template <typename T>
+inline void FirFilterStage<T>::ResetFilter(
+    const std::vector<double>& coefficients) {
+  m_filter = std::make_unique<FirFilter>(coefficients);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "SampleType.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/// Кадр многоканальных данных: Samples отсчетов каждого из Channels каналов,
+/// снятых синхронно. Значения хранятся по каналам (struct of arrays):
+/// отсчеты канала лежат подряд, так что обработка канала идет по
+/// непрерывной памяти и векторизуется. Кадр выровнен на 64 байта (строку
+/// кэша и регистр AVX-512), строки каналов тоже, если их размер кратен 64.
+/// Кадр тривиально копируемый, поэтому стадии записи в файл, БД и сокет
+/// передают его одной задачей как блок данных.
+template <typename T, size_t Channels, size_t Samples>
+struct alignas(64) Frame {
+  static_assert(std::is_arithmetic_v<T>, "frame values must be numbers");
+  static_assert(Channels > 0 && Samples > 0, "frame must not be empty");
+
+  using valueT = T;
+  static constexpr size_t channels = Channels;
+  static constexpr size_t samples = Samples;
+
+  T data[Channels][Samples];  ///< data[канал][номер отсчета]
+
+  T* Channel(size_t channel) { return data[channel]; }
+  const T* Channel(size_t channel) const { return data[channel]; }
+};
+
+/// Признак кадра
+template <typename T>
+struct IsFrame : std::false_type {};
+
+template <typename T, size_t Channels, size_t Samples>
+struct IsFrame<Frame<T, Channels, Samples>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool isFrame = IsFrame<T>::value;
+
+namespace frame_detail {
+constexpr size_t Digits(size_t value) {
+  return value < 10 ? 1 : 1 + Digits(value / 10);
+}
+
+/// Дописать в name с позиции pos десятичную запись value
+template <size_t N>
+constexpr size_t AppendNumber(std::array<char, N>& name,
+                              size_t pos,
+                              size_t value) {
+  auto digits = Digits(value);
+  for (size_t i = digits; i > 0; --i, value /= 10)
+    name[pos + i - 1] = char('0' + value % 10);
+  return pos + digits;
+}
+
+/// Имя кадра вида int16Frame8x256, собранное при компиляции
+template <typename T, size_t Channels, size_t Samples>
+constexpr auto MakeFrameName() {
+  constexpr std::string_view type = SampleType<T>::name;
+  constexpr std::string_view frame = "Frame";
+  std::array<char, type.size() + frame.size() + Digits(Channels) + 1 +
+                       Digits(Samples) + 1>
+      name{};
+  size_t pos = 0;
+  for (auto c : type)
+    name[pos++] = c;
+  for (auto c : frame)
+    name[pos++] = c;
+  pos = AppendNumber(name, pos, Channels);
+  name[pos++] = 'x';
+  AppendNumber(name, pos, Samples);
+  return name;
+}
+}  // namespace frame_detail
+
+template <typename T, size_t Channels, size_t Samples>
+struct SampleType<Frame<T, Channels, Samples>> {
+ private:
+  static constexpr auto storage =
+      frame_detail::MakeFrameName<T, Channels, Samples>();
+
+ public:
+  static constexpr const char* name = storage.data();
+};
+
+template <typename T, size_t Channels, size_t Samples>
+struct SampleValue<Frame<T, Channels, Samples>> {
+  using type = T;
+};
+
+/// Длина кадров, для которых регистрируются стадии
+inline constexpr size_t frameSamples = 256;
+
+/// Кадры, для которых регистрируются стадии: 16- и 32-битные данные АЦП
+/// на 8, 16, 32 и 64 канала
+using FrameSampleTypes = SampleTypeList<Frame<int16_t, 8, frameSamples>,
+                                        Frame<int16_t, 16, frameSamples>,
+                                        Frame<int16_t, 32, frameSamples>,
+                                        Frame<int16_t, 64, frameSamples>,
+                                        Frame<int32_t, 8, frameSamples>,
+                                        Frame<int32_t, 16, frameSamples>,
+                                        Frame<int32_t, 32, frameSamples>,
+                                        Frame<int32_t, 64, frameSamples>>;
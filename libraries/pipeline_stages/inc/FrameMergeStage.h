@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Frame.h"
+#include "MultiInputStage.h"
+#include "SampleType.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Стадия объединения каналов кадров: каналы очередных кадров всех входов
+/// копируются в выходной кадр подряд, в порядке входов (каналы входа i
+/// занимают номера с i * InFrameT::channels). Из каждого входа берется по
+/// одному кадру, пока не придут кадры остальных: вход, обогнавший другие,
+/// ждет в своем соединении. Стадия обратна разделению кадра стадиями
+/// FrameSelectStage.
+template <typename InFrameT, typename OutFrameT>
+class FrameMergeStage : public MultiInputStage<InFrameT, OutFrameT> {
+  static_assert(std::is_same_v<typename InFrameT::valueT,
+                               typename OutFrameT::valueT> &&
+                    InFrameT::samples == OutFrameT::samples,
+                "frames must differ only in the number of channels");
+  static_assert(OutFrameT::channels % InFrameT::channels == 0,
+                "out frame must hold the channels of a whole number of "
+                "frames");
+
+  OutFrameT m_frame;             ///< Собираемый кадр
+  std::vector<bool> m_received;  ///< Кадр входа получен
+  size_t m_receivedCount = 0;
+
+ public:
+  /// Число входов стадии
+  static constexpr size_t inputsCount =
+      OutFrameT::channels / InFrameT::channels;
+
+  FrameMergeStage(
+      ConsumptionStrategy strategy,
+      const std::vector<std::shared_ptr<InStageConnection<InFrameT>>>&
+          inConnections,
+      std::shared_ptr<OutStageConnection<OutFrameT>> outConnection);
+
+ protected:
+  void consumeAndProduce(size_t input,
+                         std::shared_ptr<InFrameT> inData,
+                         std::shared_ptr<OutFrameT> outData) override;
+
+  bool acceptsInput(size_t input) const override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<InFrameT>::name) + "Merge" +
+      std::to_string(OutFrameT::channels);
+  using consumptionT = InFrameT;
+  using productionT = OutFrameT;
+};
+
+template <typename InFrameT, typename OutFrameT>
+FrameMergeStage<InFrameT, OutFrameT>::FrameMergeStage(
+    ConsumptionStrategy strategy,
+    const std::vector<std::shared_ptr<InStageConnection<InFrameT>>>&
+        inConnections,
+    std::shared_ptr<OutStageConnection<OutFrameT>> outConnection)
+    : MultiInputStage<InFrameT, OutFrameT>(stageName,
+                                           strategy,
+                                           inConnections,
+                                           outConnection),
+      m_received(inConnections.size()) {
+  if (inConnections.size() != inputsCount)
+    throw std::invalid_argument(stageName + " needs " +
+                                std::to_string(inputsCount) + " inputs");
+}
+
+template <typename InFrameT, typename OutFrameT>
+void FrameMergeStage<InFrameT, OutFrameT>::consumeAndProduce(
+    size_t input,
+    std::shared_ptr<InFrameT> inData,
+    std::shared_ptr<OutFrameT> outData) {
+  std::memcpy(m_frame.Channel(input * InFrameT::channels), inData->data,
+              sizeof(inData->data));
+  m_received[input] = true;
+  ++m_receivedCount;
+  this->dataConsumed(input, inData);
+
+  if (m_receivedCount < m_received.size()) {
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  *outData = m_frame;
+  std::fill(m_received.begin(), m_received.end(), false);
+  m_receivedCount = 0;
+  this->dataProduced(outData);
+}
+
+template <typename InFrameT, typename OutFrameT>
+inline bool FrameMergeStage<InFrameT, OutFrameT>::acceptsInput(
+    size_t input) const {
+  return !m_received[input];
+}
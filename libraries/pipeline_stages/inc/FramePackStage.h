@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Frame.h"
+#include "ProducerAndConsumerStage.h"
+#include "SampleType.h"
+
+#include <memory>
+
+/// Стадия сборки кадров из потока отсчетов, в котором каналы чередуются
+/// (как их выдает многоканальный АЦП: отсчет канала 0, канала 1, ...,
+/// канала Channels-1, следующий отсчет канала 0 и т. д.). Отсчеты
+/// раскладываются по каналам, кадр выдается, когда заполнен.
+template <typename FrameT>
+class FramePackStage
+    : public ConsumerAndProducerStage<typename FrameT::valueT, FrameT> {
+  using T = typename FrameT::valueT;
+
+  FrameT m_frame{};      ///< Собираемый кадр
+  size_t m_channel = 0;  ///< Канал следующего отсчета
+  size_t m_sample = 0;   ///< Номер следующего отсчета в кадре
+
+ public:
+  FramePackStage(ConsumptionStrategy strategy,
+                 std::shared_ptr<InStageConnection<T>> inConnection,
+                 std::shared_ptr<OutStageConnection<FrameT>> outConnection);
+
+  void consumeAndProduce(std::shared_ptr<T> inData,
+                         std::shared_ptr<FrameT> outData) override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<FrameT>::name) + "FromSamples";
+  using consumptionT = T;
+  using productionT = FrameT;
+};
+
+template <typename FrameT>
+FramePackStage<FrameT>::FramePackStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> inConnection,
+    std::shared_ptr<OutStageConnection<FrameT>> outConnection)
+    : ConsumerAndProducerStage<T, FrameT>(stageName,
+                                          strategy,
+                                          inConnection,
+                                          outConnection) {}
+
+template <typename FrameT>
+void FramePackStage<FrameT>::consumeAndProduce(
+    std::shared_ptr<T> inData,
+    std::shared_ptr<FrameT> outData) {
+  m_frame.data[m_channel][m_sample] = *inData;
+  this->dataConsumed(inData);
+
+  if (++m_channel == FrameT::channels) {
+    m_channel = 0;
+    ++m_sample;
+  }
+  if (m_sample < FrameT::samples) {
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  m_sample = 0;
+  *outData = m_frame;
+  this->dataProduced(outData);
+}
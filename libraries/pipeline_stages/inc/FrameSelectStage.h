@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Frame.h"
+#include "KeyValueParameterized.h"
+#include "ProducerAndConsumerStage.h"
+#include "SampleType.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Стадия выбора каналов кадра: OutFrameT::channels каналов входного кадра
+/// (параметр channels - их номера через пробел или запятую) копируются в
+/// выходной кадр в заданном порядке. Несколько таких стадий на одном входе
+/// разделяют кадр на группы каналов для разных ветвей конвейера.
+template <typename InFrameT, typename OutFrameT>
+class FrameSelectStage : public ConsumerAndProducerStage<InFrameT, OutFrameT>,
+                         public KeyValueParameterized {
+  static_assert(std::is_same_v<typename InFrameT::valueT,
+                               typename OutFrameT::valueT> &&
+                    InFrameT::samples == OutFrameT::samples,
+                "frames must differ only in the number of channels");
+  static_assert(OutFrameT::channels <= InFrameT::channels,
+                "cannot select more channels than the frame has");
+
+  std::array<size_t, OutFrameT::channels> m_channels;  ///< Номера каналов
+
+ public:
+  FrameSelectStage(
+      ConsumptionStrategy strategy,
+      std::shared_ptr<InStageConnection<InFrameT>> inConnection,
+      std::shared_ptr<OutStageConnection<OutFrameT>> outConnection);
+
+  void consumeAndProduce(std::shared_ptr<InFrameT> inData,
+                         std::shared_ptr<OutFrameT> outData) override;
+
+ public:
+  /// Применить значения параметров
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<InFrameT>::name) + "Select" +
+      std::to_string(OutFrameT::channels);
+  using consumptionT = InFrameT;
+  using productionT = OutFrameT;
+};
+
+template <typename InFrameT, typename OutFrameT>
+FrameSelectStage<InFrameT, OutFrameT>::FrameSelectStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<InFrameT>> inConnection,
+    std::shared_ptr<OutStageConnection<OutFrameT>> outConnection)
+    : ConsumerAndProducerStage<InFrameT, OutFrameT>(stageName,
+                                                    strategy,
+                                                    inConnection,
+                                                    outConnection) {
+  // По умолчанию - первые каналы
+  std::string channels;
+  for (size_t i = 0; i < OutFrameT::channels; ++i)
+    channels += (i == 0 ? "" : " ") + std::to_string(i);
+  AddParameter("channels", L"Номера выбираемых каналов (с нуля)", channels);
+  ApplyParameterValues();
+}
+
+template <typename InFrameT, typename OutFrameT>
+void FrameSelectStage<InFrameT, OutFrameT>::consumeAndProduce(
+    std::shared_ptr<InFrameT> inData,
+    std::shared_ptr<OutFrameT> outData) {
+  for (size_t i = 0; i < OutFrameT::channels; ++i)
+    std::memcpy(outData->Channel(i), inData->Channel(m_channels[i]),
+                sizeof(outData->data[i]));
+  this->dataConsumed(inData);
+  this->dataProduced(outData);
+}
+
+template <typename InFrameT, typename OutFrameT>
+inline void
+FrameSelectStage<InFrameT, OutFrameT>::ApplyParameterValues() noexcept(false) {
+  auto text = GetParameter("channels");
+  std::replace(text.begin(), text.end(), ',', ' ');
+  std::istringstream stream(text);
+
+  std::vector<long long> channels;
+  long long channel = 0;
+  while (stream >> channel)
+    channels.push_back(channel);
+  if (!stream.eof())
+    throw std::invalid_argument("Bad channel list " +
+                                GetParameter("channels"));
+  if (channels.size() != OutFrameT::channels)
+    throw std::invalid_argument(std::to_string(OutFrameT::channels) +
+                                " channels must be selected");
+
+  decltype(m_channels) selected;
+  for (size_t i = 0; i < channels.size(); ++i) {
+    if (channels[i] < 0 || size_t(channels[i]) >= InFrameT::channels)
+      throw std::invalid_argument("No channel " +
+                                  std::to_string(channels[i]) + " in frame");
+    selected[i] = size_t(channels[i]);
+  }
+  m_channels = selected;
+}
+
+template <typename InFrameT, typename OutFrameT>
+inline bool FrameSelectStage<InFrameT, OutFrameT>::IsFullyParameterized()
+    const {
+  return true;
+}
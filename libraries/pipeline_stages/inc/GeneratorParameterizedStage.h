@@ -0,0 +1,51 @@
+#pragma once
+
+#include <KeyValueParameterized.h>
+
+#include <cstdint>
+
+/// Вид генерируемого сигнала
+enum class SignalType { uniform, gaussian, sine, chirp, counter };
+
+/// Параметры генерации сигнала
+struct SignalSettings {
+  SignalType type = SignalType::uniform;
+  double rate = 1000;     ///< Отсчетов в секунду
+  bool throttle = true;   ///< Выдавать отсчеты с частотой rate
+  uint64_t seed = 0;      ///< Начальное значение генератора случайных чисел
+  double amplitude = 100; ///< Амплитуда (для gaussian - СКО)
+  double offset = 0;      ///< Смещение (для gaussian - среднее)
+  double frequency = 1;   ///< Частота синуса, начальная частота chirp, Гц
+  double endFrequency = 100;  ///< Конечная частота chirp, Гц
+  double sweepTime = 1;       ///< Время изменения частоты chirp, с
+};
+
+/// Параметризация общей части стадий-генераторов сигналов.
+/// Параметры по умолчанию корректны, поэтому генератор работает и без
+/// применения параметров.
+class GeneratorParameterizedStage : public KeyValueParameterized {
+  SignalSettings m_settings;  ///< Примененные параметры
+
+ public:
+  GeneratorParameterizedStage();
+
+  /// Применить значения параметров
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+  /// Получить справочную информацию
+  virtual std::wstring GetHelpString() const override;
+
+ public:
+  /// Начать генерацию заново с текущими параметрами
+  virtual void ResetGenerator() = 0;
+
+ public:
+  /// Получить примененные параметры
+  const SignalSettings& GetSettings() const;
+
+ private:
+  /// Разобрать значения параметров
+  SignalSettings ParseSettings() const noexcept(false);
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "MultiOutputStage.h"
+#include "SampleType.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Маршрутизатор по хешу: равные отсчеты всегда идут в один и тот же выход,
+/// а разные распределяются по выходам равномерно. Позволяет разделить поток
+/// между несколькими одинаковыми ветками обработки.
+template <typename T>
+class HashRouter : public MultiOutputStage<T> {
+  static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= 8,
+                "sample must fit into the hash key");
+
+ public:
+  HashRouter(ConsumptionStrategy strategy,
+             std::shared_ptr<InStageConnection<T>> inConnection,
+             const std::vector<std::shared_ptr<OutStageConnection<T>>>&
+                 outConnections);
+
+ protected:
+  size_t route(const T& data) override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "HashRouter";
+  using consumptionT = T;
+  using productionT = T;
+};
+
+template <typename T>
+HashRouter<T>::HashRouter(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> inConnection,
+    const std::vector<std::shared_ptr<OutStageConnection<T>>>& outConnections)
+    : MultiOutputStage<T>(stageName, strategy, inConnection, outConnections) {}
+
+template <typename T>
+inline size_t HashRouter<T>::route(const T& data) {
+  uint64_t key = 0;
+  std::memcpy(&key, &data, sizeof(T));
+
+  // Перемешивание splitmix64: соседние значения попадают в разные выходы
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ull;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebull;
+  key ^= key >> 31;
+
+  // Старшие 32 бита хеша, отображенные на [0, число выходов) без деления
+  return size_t(((key >> 32) * this->getOutputsCount()) >> 32);
+}
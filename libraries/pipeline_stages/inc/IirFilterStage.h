@@ -0,0 +1,79 @@
+#pragma once
+
+#include "BiquadCascade.h"
+#include "FilterParameterizedStage.h"
+#include "ProducerAndConsumerStage.h"
+#include "SampleType.h"
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+/// Стадия БИХ-фильтра из звеньев второго порядка (см. BiquadCascade).
+/// Коэффициенты задаются пятерками b0 b1 b2 a1 a2 на каждое звено.
+template <typename T>
+class IirFilterStage : public ConsumerAndProducerStage<T, T>,
+                       public FilterParameterizedStage {
+  static_assert(std::is_arithmetic_v<T>, "only numbers can be filtered");
+
+  std::unique_ptr<BiquadCascade> m_filter;
+
+ public:
+  IirFilterStage(ConsumptionStrategy strategy,
+                 std::shared_ptr<InStageConnection<T>> inConnection,
+                 std::shared_ptr<OutStageConnection<T>> outConnection);
+
+  void consumeAndProduce(std::shared_ptr<T> inData,
+                         std::shared_ptr<T> outData) override;
+
+ public:
+  /// Создать фильтр с заданными коэффициентами
+  virtual void ResetFilter(const std::vector<double>& coefficients) override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "IirFilter";
+  using consumptionT = T;
+  using productionT = T;
+};
+
+template <typename T>
+IirFilterStage<T>::IirFilterStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> inConnection,
+    std::shared_ptr<OutStageConnection<T>> outConnection)
+    : ConsumerAndProducerStage<T, T>(stageName,
+                                     strategy,
+                                     inConnection,
+                                     outConnection),
+      FilterParameterizedStage("1 0 0 0 0",
+                               L"БИХ-фильтр из звеньев второго порядка, "
+                               L"коэффициенты - пятерки b0 b1 b2 a1 a2 "
+                               L"(a0 = 1) для каждого звена") {
+  ResetFilter(GetCoefficients());
+}
+
+template <typename T>
+void IirFilterStage<T>::consumeAndProduce(std::shared_ptr<T> inData,
+                                          std::shared_ptr<T> outData) {
+  double value = double(*inData);
+  m_filter->Process(&value, &value, 1);
+  *outData = FilterOutputCast<T>(value);
+  this->dataConsumed(inData);
+  this->dataProduced(outData);
+}
+
+template <typename T>
+inline void IirFilterStage<T>::ResetFilter(
+    const std::vector<double>& coefficients) {
+  if (coefficients.size() % 5 != 0)
+    throw std::invalid_argument(
+        "IIR filter coefficients must be groups of b0 b1 b2 a1 a2");
+
+  std::vector<BiquadCoefficients> sections;
+  for (size_t i = 0; i < coefficients.size(); i += 5)
+    sections.push_back({coefficients[i], coefficients[i + 1],
+                        coefficients[i + 2], coefficients[i + 3],
+                        coefficients[i + 4]});
+  m_filter = std::make_unique<BiquadCascade>(std::move(sections));
+}
@@ -3,8 +3,11 @@
 #include "ConsumerStage.h"
 #include "IParameterized.h"
 
+#include <fstream>
+
 class Int32Visualizer : public ConsumerStage<int32_t>, public IParameterized {
   std::string m_filename;
+  std::ofstream m_file;  ///< Открывается при задании имени файла
 
  public:
   Int32Visualizer(ConsumptionStrategy strategy,
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "KeyValueParameterized.h"
+#include "MultiInputStage.h"
+#include "SampleCombiner.h"
+#include "TimedSample.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Стадия сведения по времени: отсчеты входов, метки которых отличаются не
+/// больше чем на tolerance, сводятся операцией operation (см.
+/// CombineOperation) в один с меткой отсчета первого входа. Метки каждого
+/// входа должны возрастать.
+/// Отсчеты копятся в буферах входов по buffer штук, так что вход, опередивший
+/// другие, не задерживает свой источник. Отбрасываются (и считаются)
+/// отсчеты, вытесненные из полного буфера, и отсчеты, которым не нашлось
+/// пары: отсчет старше tolerance относительно первых отсчетов остальных
+/// входов уже не может совпасть ни с чем.
+class JoinStage : public MultiInputStage<TimedSample, TimedSample>,
+                  public KeyValueParameterized {
+  /// Кольцо отсчетов входа
+  struct Buffer {
+    std::vector<TimedSample> samples;
+    size_t head = 0;
+    size_t count = 0;
+  };
+
+  int64_t m_toleranceUs = 0;
+  CombineOperation m_operation = CombineOperation::sum;
+  std::vector<Buffer> m_buffers;
+  std::vector<double> m_values;  ///< Значения сводимых отсчетов
+  uint64_t m_dropped = 0;
+
+ public:
+  JoinStage(ConsumptionStrategy strategy,
+            const std::vector<std::shared_ptr<InStageConnection<TimedSample>>>&
+                inConnections,
+            std::shared_ptr<OutStageConnection<TimedSample>> outConnection);
+
+  /// Число отброшенных отсчетов
+  uint64_t GetDroppedCount() const;
+
+ public:
+  /// Применить значения параметров. Накопленные отсчеты сбрасываются.
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+ protected:
+  void consumeAndProduce(size_t input,
+                         std::shared_ptr<TimedSample> inData,
+                         std::shared_ptr<TimedSample> outData) override;
+
+ private:
+  /// Свести первые отсчеты буферов, если их метки совпадают, отбрасывая
+  /// отсчеты без пары. false - буферы еще не содержат совпадения.
+  bool Match(TimedSample& result);
+
+  void Pop(Buffer& buffer);
+
+ public:
+  static constexpr auto stageName = "timedSampleJoin";
+  using consumptionT = TimedSample;
+  using productionT = TimedSample;
+};
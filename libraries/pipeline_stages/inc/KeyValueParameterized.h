@@ -0,0 +1,45 @@
+#pragma once
+
+#include <IParameterized.h>
+
+#include <limits>
+#include <map>
+
+/// Параметризация списком параметров "ключ-значение" с значениями по
+/// умолчанию. Наследники добавляют свои параметры через AddParameter и
+/// разбирают значения с проверкой через Get*Parameter (исключение
+/// std::invalid_argument, если значение некорректно).
+class KeyValueParameterized : public IParameterized {
+  std::map<std::string, std::string> m_keyValues;
+  std::vector<std::string> m_keys;
+  std::map<std::string, std::wstring> m_keysToObviousParamName;
+
+ public:
+  /// Получить параметры и их значения
+  virtual std::vector<PatameterValue> GetPatameterValues() const override;
+  /// Установить значение параметра
+  virtual bool SetParameterValue(const std::string& paramName,
+                                 const std::string& paramValue) override;
+  /// Получить понятное название параметра
+  virtual std::optional<std::wstring> GetObviousParamName(
+      const std::string& paramName) const override;
+
+ protected:
+  /// Добавить параметр со значением по умолчанию
+  void AddParameter(const std::string& key,
+                    const std::wstring& obviousName,
+                    const std::string& defaultValue);
+  /// Получить строковое значение параметра
+  std::string GetParameter(const std::string& key) const;
+  /// Получить значение параметра, которое должно быть целым числом не меньше
+  /// minValue
+  size_t GetSizeParameter(const std::string& key, size_t minValue = 0) const;
+  /// Получить значение параметра, которое должно быть числом от minValue до
+  /// maxValue (по умолчанию - конечным)
+  double GetRealParameter(
+      const std::string& key,
+      double minValue = std::numeric_limits<double>::lowest(),
+      double maxValue = std::numeric_limits<double>::max()) const;
+  /// Получить значение параметра-флага, которое должно быть 0 или 1
+  bool GetFlagParameter(const std::string& key) const;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+/// Гистограмма с логарифмическими корзинами (как в HDR Histogram).
+/// Каждая степень двойки делится на 2^precisionBits корзин, так что
+/// относительная ширина корзины не больше 2^-precisionBits при любом порядке
+/// значения. Номер корзины берется прямо из битов double: показатель и
+/// старшие биты мантиссы дают монотонный номер без вычисления логарифма.
+/// Модули от 2^-64 до 2^64 различаются, меньшие считаются нулем, большие
+/// попадают в крайние корзины. Отрицательные значения хранятся
+/// симметрично положительным. Веса корзин дробные, чтобы их можно было
+/// уменьшать (Decay).
+class LogHistogram {
+ public:
+  explicit LogHistogram(unsigned precisionBits) noexcept(false);
+
+  /// Добавить значение (NaN пропускается)
+  void Add(double value);
+  /// Умножить веса всех значений на factor (0..1)
+  void Decay(double factor);
+  /// Забыть все значения
+  void Clear();
+
+  /// Суммарный вес значений
+  double GetTotalWeight() const;
+  /// Значение, меньше которого доля quantile (0..1) веса значений
+  double GetQuantile(double quantile) const;
+  double GetMin() const;
+  double GetMax() const;
+  double GetMean() const;
+
+ private:
+  /// Номер корзины значения
+  size_t GetIndex(double value) const;
+  /// Границы значений корзины
+  std::pair<double, double> GetBucketBounds(size_t index) const;
+  /// Значение, биты которого - ключ корзины с нулевыми младшими битами
+  double FromKey(uint64_t key) const;
+
+ private:
+  static constexpr int exponentRange = 64;  ///< Модули от 2^-64 до 2^64
+
+  const unsigned m_precisionBits;
+  const uint64_t m_lowestKey;  ///< Ключ (биты >> сдвиг) модуля 2^-64
+  const size_t m_halfSize;     ///< Корзин для значений одного знака
+  std::vector<double> m_weights;  ///< Отрицательные, ноль, положительные
+  double m_totalWeight = 0;
+  double m_sum = 0;
+  double m_min = 0;
+  double m_max = 0;
+};
+
+inline void LogHistogram::Add(double value) {
+  if (std::isnan(value))
+    return;
+
+  m_weights[GetIndex(value)] += 1;
+  if (m_totalWeight == 0) {
+    m_min = m_max = value;
+  } else {
+    m_min = value < m_min ? value : m_min;
+    m_max = value > m_max ? value : m_max;
+  }
+  m_totalWeight += 1;
+  m_sum += value;
+}
+
+inline size_t LogHistogram::GetIndex(double value) const {
+  uint64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  bool negative = (bits >> 63) != 0;
+  // Показатель и старшие биты мантиссы модуля
+  uint64_t key = (bits & ~(uint64_t(1) << 63)) >> (52 - m_precisionBits);
+
+  size_t offset = 0;
+  if (key >= m_lowestKey)
+    offset = key - m_lowestKey < m_halfSize ? size_t(key - m_lowestKey) + 1
+                                            : m_halfSize;
+  return negative ? m_halfSize - offset : m_halfSize + offset;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Файл, отображенный в память только для чтения.
+/// Система предупреждается о последовательном чтении, при populate страницы
+/// загружаются сразу при отображении.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  /// Отобразить файл. Ошибка возвращается через исключение.
+  MappedFile(const std::string& path, bool populate);
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  /// Начало данных (nullptr для пустого или закрытого файла)
+  const char* data() const;
+  /// Размер файла, байт
+  size_t size() const;
+
+  bool isOpen() const;
+  void close();
+
+ private:
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+  bool m_open = false;
+#ifdef _WIN32
+  void* m_mapping = nullptr;  ///< Объект отображения
+#endif
+};
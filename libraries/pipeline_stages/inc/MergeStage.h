@@ -0,0 +1,50 @@
+#pragma once
+
+#include "MultiInputStage.h"
+#include "SampleType.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Стадия слияния: задачи всех входов выдаются одним потоком в порядке
+/// получения. Входы опрашиваются по очереди, так что поток одного входа не
+/// задерживает остальные.
+template <typename T>
+class MergeStage : public MultiInputStage<T, T> {
+ public:
+  MergeStage(ConsumptionStrategy strategy,
+             const std::vector<std::shared_ptr<InStageConnection<T>>>&
+                 inConnections,
+             std::shared_ptr<OutStageConnection<T>> outConnection);
+
+ protected:
+  void consumeAndProduce(size_t input,
+                         std::shared_ptr<T> inData,
+                         std::shared_ptr<T> outData) override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "Merge";
+  using consumptionT = T;
+  using productionT = T;
+};
+
+template <typename T>
+MergeStage<T>::MergeStage(
+    ConsumptionStrategy strategy,
+    const std::vector<std::shared_ptr<InStageConnection<T>>>& inConnections,
+    std::shared_ptr<OutStageConnection<T>> outConnection)
+    : MultiInputStage<T, T>(stageName,
+                            strategy,
+                            inConnections,
+                            outConnection) {}
+
+template <typename T>
+void MergeStage<T>::consumeAndProduce(size_t input,
+                                      std::shared_ptr<T> inData,
+                                      std::shared_ptr<T> outData) {
+  *outData = *inData;
+  this->dataConsumed(input, inData);
+  this->dataProduced(outData);
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+/// Позиции минимального и максимального значений
+struct MinMaxIndices {
+  size_t minIndex;
+  size_t maxIndex;
+};
+
+/// Найти первые позиции минимального и максимального из count > 0 значений.
+/// Экстремумы ищутся векторными инструкциями (SSE2, если доступны), позиции -
+/// вторым проходом по найденным значениям. Значения не должны быть NaN.
+MinMaxIndices FindMinMax(const double* values, size_t count) noexcept(false);
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "ConsumerStage.h"
+#include "KeyValueParameterized.h"
+#include "LogHistogram.h"
+#include "SampleType.h"
+#include "SeqLockCell.h"
+
+#include <SteadyClock.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+/// Статистика распределения значений
+struct QuantileSnapshot {
+  double count;  ///< Вес значений (с учетом уменьшения весов)
+  double min;
+  double max;
+  double mean;
+  double p50;
+  double p90;
+  double p99;
+  double p999;
+  int64_t windowStartUs;  ///< Начало окна (SteadyClock), мкс
+  int64_t publishedUs;    ///< Время публикации (SteadyClock), мкс
+};
+
+/// Стадия, собирающая распределение значений потока в LogHistogram и
+/// публикующая его статистику (QuantileSnapshot) раз в publishInterval.
+/// Снимок читается из любого потока (GUI, экспорт метрик) без блокировок и
+/// без влияния на стадию (см. SeqLockCell).
+/// window задает окно: cumulative - все значения, reset - гистограмма
+/// очищается раз в windowInterval (перед очисткой публикуется итог окна),
+/// decay - раз в windowInterval веса значений умножаются на decay.
+template <typename T>
+class QuantileStage : public ConsumerStage<T>, public KeyValueParameterized {
+  static_assert(std::is_arithmetic_v<T>, "only numbers have a distribution");
+
+  enum class WindowMode { cumulative, reset, decay };
+
+  std::unique_ptr<LogHistogram> m_histogram;
+  WindowMode m_windowMode = WindowMode::cumulative;
+  std::chrono::microseconds m_publishInterval{0};
+  std::chrono::microseconds m_windowInterval{0};
+  double m_decay = 0.5;
+  std::chrono::microseconds m_windowStart{0};
+  std::chrono::microseconds m_lastPublished{0};
+  size_t m_sinceCheck = 0;  ///< Значений с последней проверки времени
+  SeqLockCell<QuantileSnapshot> m_snapshot;
+
+ public:
+  QuantileStage(ConsumptionStrategy strategy,
+                std::shared_ptr<InStageConnection<T>> connection);
+
+  void consume(std::shared_ptr<T> inData) override;
+
+  /// Последняя опубликованная статистика (из любого потока)
+  QuantileSnapshot GetSnapshot() const;
+
+ public:
+  /// Применить значения параметров. Распределение собирается заново.
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+ protected:
+  void onIdle() override;
+
+ private:
+  /// Сменить окно и опубликовать статистику, если пришло время
+  void Tick(std::chrono::microseconds now);
+  void Publish(std::chrono::microseconds now);
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "Quantiles";
+  using consumptionT = T;
+  using productionT = void;
+
+  /// Время проверяется раз в столько значений
+  static constexpr size_t clockCheckPeriod = 256;
+};
+
+template <typename T>
+QuantileStage<T>::QuantileStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> connection)
+    : ConsumerStage<T>(stageName, strategy, connection) {
+  AddParameter("precision", L"Точность: корзин на степень двойки, 2^precision",
+               "6");
+  AddParameter("publishInterval", L"Период публикации статистики, мс", "100");
+  AddParameter("window", L"Окно (cumulative, reset или decay)", "cumulative");
+  AddParameter("windowInterval", L"Период очистки или уменьшения весов, мс",
+               "10000");
+  AddParameter("decay", L"Множитель весов для окна decay (0..1)", "0.5");
+  ApplyParameterValues();
+}
+
+template <typename T>
+void QuantileStage<T>::consume(std::shared_ptr<T> inData) {
+  m_histogram->Add(double(*inData));
+  this->dataConsumed(inData);
+
+  if (++m_sinceCheck >= clockCheckPeriod) {
+    m_sinceCheck = 0;
+    Tick(SteadyClock::nowUs());
+  }
+}
+
+template <typename T>
+inline QuantileSnapshot QuantileStage<T>::GetSnapshot() const {
+  return m_snapshot.Load();
+}
+
+template <typename T>
+inline void QuantileStage<T>::ApplyParameterValues() noexcept(false) {
+  auto precision = GetSizeParameter("precision");
+  auto publishInterval = GetSizeParameter("publishInterval");
+  auto windowInterval = GetSizeParameter("windowInterval");
+  auto decay = GetRealParameter("decay");
+  auto window = GetParameter("window");
+
+  WindowMode windowMode = WindowMode::cumulative;
+  if (window == "reset")
+    windowMode = WindowMode::reset;
+  else if (window == "decay")
+    windowMode = WindowMode::decay;
+  else if (window != "cumulative")
+    throw std::invalid_argument("Unknown window " + window);
+
+  if (windowMode != WindowMode::cumulative && windowInterval == 0)
+    throw std::invalid_argument("windowInterval must be positive");
+  if (windowMode == WindowMode::decay && !(decay >= 0 && decay < 1))
+    throw std::invalid_argument("decay must be in [0, 1)");
+
+  // Слишком большая точность отвергается LogHistogram, а не усекается
+  m_histogram = std::make_unique<LogHistogram>(unsigned(
+      std::min<size_t>(precision, std::numeric_limits<unsigned>::max())));
+  m_windowMode = windowMode;
+  m_publishInterval = std::chrono::milliseconds(publishInterval);
+  m_windowInterval = std::chrono::milliseconds(windowInterval);
+  m_decay = decay;
+
+  auto now = SteadyClock::nowUs();
+  m_windowStart = now;
+  Publish(now);
+}
+
+template <typename T>
+inline bool QuantileStage<T>::IsFullyParameterized() const {
+  return true;
+}
+
+template <typename T>
+inline void QuantileStage<T>::onIdle() {
+  // Значений нет, но окно и публикация идут по времени
+  Tick(SteadyClock::nowUs());
+}
+
+template <typename T>
+inline void QuantileStage<T>::Tick(std::chrono::microseconds now) {
+  if (m_windowMode != WindowMode::cumulative &&
+      now - m_windowStart >= m_windowInterval) {
+    if (m_windowMode == WindowMode::reset) {
+      // Итог закончившегося окна
+      Publish(now);
+      m_histogram->Clear();
+    } else {
+      m_histogram->Decay(m_decay);
+    }
+    m_windowStart = now;
+  }
+
+  if (now - m_lastPublished >= m_publishInterval)
+    Publish(now);
+}
+
+template <typename T>
+inline void QuantileStage<T>::Publish(std::chrono::microseconds now) {
+  QuantileSnapshot snapshot{};
+  snapshot.count = m_histogram->GetTotalWeight();
+  snapshot.min = m_histogram->GetMin();
+  snapshot.max = m_histogram->GetMax();
+  snapshot.mean = m_histogram->GetMean();
+  snapshot.p50 = m_histogram->GetQuantile(0.5);
+  snapshot.p90 = m_histogram->GetQuantile(0.9);
+  snapshot.p99 = m_histogram->GetQuantile(0.99);
+  snapshot.p999 = m_histogram->GetQuantile(0.999);
+  snapshot.windowStartUs = m_windowStart.count();
+  snapshot.publishedUs = now.count();
+  m_snapshot.Store(snapshot);
+  m_lastPublished = now;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "KeyValueParameterized.h"
+#include "MultiOutputStage.h"
+#include "SampleType.h"
+
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Маршрутизатор по диапазону: отсчеты из [low, high] идут в первый выход,
+/// остальные (и NaN) - во второй. Например, выход за допустимые пределы -
+/// в ветку тревоги, остальное - в хранилище.
+template <typename T>
+class RangeRouter : public MultiOutputStage<T>, public KeyValueParameterized {
+  static_assert(std::is_arithmetic_v<T>, "only numbers can be compared");
+
+  double m_low = 0;
+  double m_high = 0;
+
+ public:
+  RangeRouter(ConsumptionStrategy strategy,
+              std::shared_ptr<InStageConnection<T>> inConnection,
+              const std::vector<std::shared_ptr<OutStageConnection<T>>>&
+                  outConnections);
+
+ public:
+  /// Применить значения параметров
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+ protected:
+  size_t route(const T& data) override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "RangeRouter";
+  using consumptionT = T;
+  using productionT = T;
+};
+
+template <typename T>
+RangeRouter<T>::RangeRouter(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> inConnection,
+    const std::vector<std::shared_ptr<OutStageConnection<T>>>& outConnections)
+    : MultiOutputStage<T>(stageName, strategy, inConnection, outConnections) {
+  if (outConnections.size() != 2)
+    throw std::invalid_argument("range router needs two outputs");
+
+  AddParameter("low", L"Нижняя граница диапазона первого выхода", "-inf");
+  AddParameter("high", L"Верхняя граница диапазона первого выхода", "inf");
+  ApplyParameterValues();
+}
+
+template <typename T>
+inline size_t RangeRouter<T>::route(const T& data) {
+  auto value = double(data);
+  return value >= m_low && value <= m_high ? 0 : 1;
+}
+
+template <typename T>
+inline void RangeRouter<T>::ApplyParameterValues() noexcept(false) {
+  // Границы могут быть бесконечными
+  constexpr auto infinity = std::numeric_limits<double>::infinity();
+  auto low = GetRealParameter("low", -infinity, infinity);
+  auto high = GetRealParameter("high", -infinity, infinity);
+  if (!(low <= high))
+    throw std::invalid_argument("low must not exceed high");
+
+  m_low = low;
+  m_high = high;
+}
+
+template <typename T>
+inline bool RangeRouter<T>::IsFullyParameterized() const {
+  return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+/// Выдача элементов с заданной частотой.
+/// Время выдачи n-го элемента отсчитывается от первого (start + n / rate),
+/// поэтому ошибки отдельных ожиданий не накапливаются, а отставание
+/// догоняется без пауз. Если отставание больше maxLag (конвейер стоял),
+/// отсчет начинается заново, чтобы не выдавать накопившиеся элементы разом.
+class RatePacer {
+ public:
+  /// \param rate Элементов в секунду, 0 - без ограничения.
+  explicit RatePacer(double rate = 0);
+
+  /// Начать отсчет заново с новой частотой
+  void Reset(double rate);
+
+  /// Дождаться времени выдачи очередного элемента, но не дольше maxWait.
+  /// \return \c true, если элемент можно выдать (он учитывается как
+  ///         выданный), иначе \c false.
+  bool WaitForNext(std::chrono::nanoseconds maxWait);
+
+  double GetRate() const;
+
+ public:
+  /// Отставание, после которого отсчет начинается заново
+  static constexpr std::chrono::seconds maxLag{1};
+
+ private:
+  double m_rate = 0;
+  size_t m_count = 0;  ///< Выдано элементов с начала отсчета
+  std::chrono::nanoseconds m_started{0};
+};
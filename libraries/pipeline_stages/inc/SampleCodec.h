@@ -0,0 +1,89 @@
+#pragma once
+
+#include "SampleType.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Способ сжатия отсчетов
+enum class SampleCompression : uint8_t {
+  none = 0,
+  delta = 1,         ///< Разности int32, zigzag + varint
+  deltaOfDelta = 2,  ///< Вторые разности int32, zigzag + varint
+  bitPacked = 3,     ///< Разности int32, упакованные группами по 128
+  gorilla = 4,       ///< XOR соседних double (как в Gorilla)
+};
+
+/// Сжатие блоков отсчетов.
+/// Сжатый блок самоописывающий: он начинается заголовком из headerSize байт
+/// (сигнатура, способ сжатия, размер отсчета, число отсчетов, размер данных),
+/// и каждый блок раскодируется независимо от других. Поэтому поток сжатых
+/// блоков можно читать кусками любого размера (см. SampleStreamDecoder).
+/// Сжаты ли хранимые данные, по самим данным не определяется (несжатые
+/// отсчеты могут начинаться с той же сигнатуры): способ сжатия хранится
+/// отдельно, например, в атрибуте сущности (см. DbWriteStage).
+/// Числа записываются в порядке байтов процессора, как и несжатые отсчеты.
+class SampleCodec {
+ public:
+  /// Размер заголовка блока
+  static constexpr size_t headerSize = 16;
+
+  /// Разобрать название способа сжатия
+  static SampleCompression ParseCompression(const std::string& name) noexcept(
+      false);
+  /// Получить название способа сжатия (обратно ParseCompression)
+  static std::string GetCompressionName(SampleCompression compression);
+  /// Можно ли сжимать отсчеты типа T способом compression. Составные
+  /// отсчеты (кадры) сжимаются как последовательность своих значений.
+  template <typename T>
+  static bool Supports(SampleCompression compression);
+
+  /// Сжать size байт отсчетов (размер кратен размеру отсчета) одним блоком и
+  /// добавить его в out
+  static void Encode(SampleCompression compression,
+                     const char* data,
+                     size_t size,
+                     std::vector<char>& out) noexcept(false);
+  /// Данные начинаются с сигнатуры сжатого блока (проверка заголовка блока,
+  /// о несжатых данных она ничего не говорит)
+  static bool IsEncoded(const char* data, size_t size);
+};
+
+/// Раскодирование потока сжатых блоков, поступающего кусками произвольного
+/// размера. Незавершенный блок хранится до следующего куска.
+class SampleStreamDecoder {
+ public:
+  /// Добавить прочитанные байты и раскодировать все завершенные блоки в out.
+  /// Если блок поврежден, бросает исключение и забывает накопленное.
+  void Decode(const char* data,
+              size_t size,
+              std::vector<char>& out) noexcept(false);
+  /// Есть байты незавершенного блока
+  bool HasIncompleteBlock() const;
+  void Reset();
+
+ private:
+  std::vector<char> m_pending;
+};
+
+template <typename T>
+inline bool SampleCodec::Supports(SampleCompression compression) {
+  using V = typename SampleValue<T>::type;
+  if (sizeof(T) % sizeof(V) != 0)
+    return compression == SampleCompression::none;
+
+  switch (compression) {
+    case SampleCompression::none:
+      return true;
+    case SampleCompression::delta:
+    case SampleCompression::deltaOfDelta:
+    case SampleCompression::bitPacked:
+      return std::is_integral_v<V> && sizeof(V) == sizeof(int32_t);
+    case SampleCompression::gorilla:
+      return std::is_same_v<V, double>;
+  }
+  return false;
+}
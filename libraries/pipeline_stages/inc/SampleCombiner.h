@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/// Операция, которой стадии с несколькими входами сводят значения входов в
+/// одно: например, ток и напряжение - в мощность (product)
+enum class CombineOperation { sum, difference, product, ratio, mean, min, max };
+
+/// Операция по имени (sum, difference, product, ratio, mean, min, max)
+CombineOperation CombineOperationFromString(
+    const std::string& name) noexcept(false);
+
+/// Свести count значений (count > 0). difference и ratio считаются слева
+/// направо в порядке входов: values[0] - values[1] - ...
+double Combine(CombineOperation operation, const double* values, size_t count);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/// Ячейка для передачи значения от одного писателя любому числу читателей
+/// без блокировок (seqlock). Писатель никогда не ждет, читатель повторяет
+/// чтение, если попал на запись. Значение хранится в атомарных словах, так
+/// что одновременные чтение и запись не являются гонкой данных.
+template <typename T>
+class SeqLockCell {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "value is copied word by word");
+
+ public:
+  SeqLockCell() : SeqLockCell(T{}) {}
+  explicit SeqLockCell(const T& value) { Store(value); }
+
+  /// Записать значение (только из одного потока)
+  void Store(const T& value) {
+    Words words{};
+    std::memcpy(words.data(), &value, sizeof(T));
+
+    auto sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < words.size(); ++i)
+      m_words[i].store(words[i], std::memory_order_relaxed);
+    m_sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  /// Прочитать последнее записанное значение (из любого потока)
+  T Load() const {
+    Words words{};
+    uint64_t before = 0;
+    uint64_t after = 0;
+    do {
+      before = m_sequence.load(std::memory_order_acquire);
+      for (size_t i = 0; i < words.size(); ++i)
+        words[i] = m_words[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = m_sequence.load(std::memory_order_relaxed);
+      // Нечетный номер - запись не закончена
+    } while ((before & 1) != 0 || before != after);
+
+    T value;
+    std::memcpy(&value, words.data(), sizeof(T));
+    return value;
+  }
+
+ private:
+  using Words = std::array<uint64_t, (sizeof(T) + 7) / 8>;
+
+  std::atomic<uint64_t> m_sequence{0};
+  std::array<std::atomic<uint64_t>, (sizeof(T) + 7) / 8> m_words{};
+};
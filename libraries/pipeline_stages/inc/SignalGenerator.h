@@ -0,0 +1,170 @@
+#pragma once
+
+#include "GeneratorParameterizedStage.h"
+#include "ProducerStage.h"
+#include "RatePacer.h"
+#include "SampleType.h"
+#include "Xoshiro256.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/// Стадия-генератор сигнала (см. GeneratorParameterizedStage::GetHelpString).
+/// Случайные значения берутся из xoshiro256**, отсчеты выдаются с частотой
+/// rate по расписанию RatePacer без пауз на каждый отсчет, а при
+/// throttle = 0 - без ограничения частоты.
+template <typename T>
+class SignalGenerator : public ProducerStage<T>,
+                        public GeneratorParameterizedStage {
+  static_assert(std::is_arithmetic_v<T>, "signal samples must be numbers");
+
+  Xoshiro256 m_random;
+  RatePacer m_pacer;
+  uint64_t m_sample = 0;   ///< Номер следующего отсчета
+  double m_spare = 0;      ///< Второе значение пары нормальных чисел
+  bool m_hasSpare = false;
+
+ public:
+  SignalGenerator(std::shared_ptr<OutStageConnection<T>>);
+
+  void produce(std::shared_ptr<T> outData) override;
+
+ public:
+  /// Начать генерацию заново с текущими параметрами
+  virtual void ResetGenerator() override;
+
+ private:
+  /// Значение очередного отсчета
+  T nextSample();
+  /// Нормально распределенное число (полярный метод Марсальи)
+  double nextGaussian();
+  /// Привести значение к типу отсчета
+  static T convert(double value);
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "Generator";
+  using consumptionT = void;
+  using productionT = T;
+
+  /// Максимальная пауза стадии в ожидании времени выдачи отсчета
+  static constexpr std::chrono::milliseconds pacingWaitPeriod{10};
+};
+
+template <typename T>
+SignalGenerator<T>::SignalGenerator(
+    std::shared_ptr<OutStageConnection<T>> connection)
+    : ProducerStage<T>(stageName, connection) {
+  ResetGenerator();
+}
+
+template <typename T>
+void SignalGenerator<T>::produce(std::shared_ptr<T> outData) {
+  if (!m_pacer.WaitForNext(pacingWaitPeriod)) {
+    // Время следующего отсчета еще не наступило
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  *outData = nextSample();
+  ++m_sample;
+  this->dataProduced(outData);
+}
+
+template <typename T>
+inline void SignalGenerator<T>::ResetGenerator() {
+  const auto& settings = GetSettings();
+  m_random = Xoshiro256(settings.seed);
+  m_pacer.Reset(settings.throttle ? settings.rate : 0);
+  m_sample = 0;
+  m_hasSpare = false;
+}
+
+template <typename T>
+inline T SignalGenerator<T>::nextSample() {
+  constexpr double twoPi = 6.283185307179586;
+  const auto& settings = GetSettings();
+
+  switch (settings.type) {
+    case SignalType::uniform:
+      if constexpr (std::is_integral_v<T>) {
+        // Каждое целое из offset +- amplitude равновероятно
+        auto low = std::floor(settings.offset - settings.amplitude);
+        auto count = std::floor(2 * settings.amplitude) + 1;
+        return convert(std::floor(low + m_random.nextDouble() * count));
+      } else {
+        return convert(settings.offset +
+                       settings.amplitude * (2 * m_random.nextDouble() - 1));
+      }
+
+    case SignalType::gaussian:
+      return convert(settings.offset + settings.amplitude * nextGaussian());
+
+    case SignalType::sine: {
+      // Фаза берется по модулю периода, чтобы не терять точность со временем
+      auto cycles = std::fmod(settings.frequency * double(m_sample) /
+                                  settings.rate,
+                              1.0);
+      return convert(settings.offset +
+                     settings.amplitude * std::sin(twoPi * cycles));
+    }
+
+    case SignalType::chirp: {
+      auto time = std::fmod(double(m_sample) / settings.rate,
+                            settings.sweepTime);
+      auto slope =
+          (settings.endFrequency - settings.frequency) / settings.sweepTime;
+      auto cycles = settings.frequency * time + slope * time * time / 2;
+      return convert(settings.offset +
+                     settings.amplitude *
+                         std::sin(twoPi * std::fmod(cycles, 1.0)));
+    }
+
+    case SignalType::counter:
+      if constexpr (std::is_integral_v<T>) {
+        // Счетчик переполняется по модулю, как целое без знака
+        auto start = uint64_t(std::llround(settings.offset));
+        return T(std::make_unsigned_t<T>(start + m_sample));
+      } else {
+        return convert(settings.offset + double(m_sample));
+      }
+  }
+
+  return T();
+}
+
+template <typename T>
+inline double SignalGenerator<T>::nextGaussian() {
+  if (m_hasSpare) {
+    m_hasSpare = false;
+    return m_spare;
+  }
+
+  double u = 0;
+  double v = 0;
+  double s = 0;
+  do {
+    u = 2 * m_random.nextDouble() - 1;
+    v = 2 * m_random.nextDouble() - 1;
+    s = u * u + v * v;
+  } while (s >= 1 || s == 0);
+
+  auto factor = std::sqrt(-2 * std::log(s) / s);
+  m_spare = v * factor;
+  m_hasSpare = true;
+  return u * factor;
+}
+
+template <typename T>
+inline T SignalGenerator<T>::convert(double value) {
+  if constexpr (std::is_integral_v<T>) {
+    auto low = double(std::numeric_limits<T>::lowest());
+    auto high = double(std::numeric_limits<T>::max());
+    return T(std::llround(std::clamp(value, low, high)));
+  } else {
+    return T(value);
+  }
+}
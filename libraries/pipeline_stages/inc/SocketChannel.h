@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+/// Ошибка сокетного соединения (в т.ч. закрытие соединения другой стороной)
+class SocketChannelException : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+/// Заголовок пакета задач, передаваемого через сокет.
+/// Протокол:
+///   отправитель -> получатель: SocketFrameHeader, затем
+///                              taskCount * taskSize байт задач;
+///   получатель -> отправитель: uint32_t - число задач, которые отправитель
+///                              может дополнительно передать (кредиты).
+/// Отправитель не передает больше задач, чем получил кредитов.
+struct SocketFrameHeader {
+  uint32_t taskSize;   ///< Размер одной задачи в байтах
+  uint32_t taskCount;  ///< Число задач в пакете
+};
+
+/// Потоковый сокет (Unix domain или TCP) для передачи задач между процессами.
+/// Адрес задается в виде "unix:/path/to/socket" или "tcp:host:port".
+class SocketChannel {
+ public:
+  /// Буфер для векторной записи
+  struct Buffer {
+    const void* data;
+    size_t size;
+  };
+
+ public:
+  SocketChannel() = default;
+  SocketChannel(SocketChannel&& other) noexcept;
+  SocketChannel& operator=(SocketChannel&& other) noexcept;
+  SocketChannel(const SocketChannel&) = delete;
+  SocketChannel& operator=(const SocketChannel&) = delete;
+  ~SocketChannel();
+
+  /// Открыть слушающий сокет. Существующий файл Unix-сокета удаляется.
+  static SocketChannel listen(const std::string& address);
+  /// Подключиться к слушающему сокету
+  static SocketChannel connect(const std::string& address);
+
+  /// Принять подключение. Если за timeout подключений не было, возвращает
+  /// закрытый канал.
+  SocketChannel accept(std::chrono::milliseconds timeout);
+
+  /// Адрес, к которому привязан сокет (для TCP с портом 0 - выбранный порт)
+  std::string localAddress() const;
+
+  /// Ожидать появления данных для чтения
+  bool waitReadable(std::chrono::milliseconds timeout) const;
+
+  /// Записать буферы одним векторным вызовом (при частичной записи вызов
+  /// повторяется для оставшихся данных)
+  void send(const Buffer* buffers, size_t count);
+
+  /// Прочитать ровно size байт. Возвращает false, если за timeout не пришло
+  /// ни одного байта. Начатое сообщение дочитывается с ожиданием не более
+  /// messageTimeout между порциями данных.
+  bool receive(void* data, size_t size, std::chrono::milliseconds timeout);
+
+  bool isOpen() const;
+  void close();
+
+ public:
+  /// Максимальное время ожидания продолжения начатого сообщения
+  static constexpr std::chrono::milliseconds messageTimeout{1000};
+
+ private:
+  explicit SocketChannel(std::intptr_t socket, std::string address);
+
+ private:
+  std::intptr_t m_socket = -1;  ///< Дескриптор сокета, -1 если закрыт
+  std::string m_address;        ///< Адрес, с которым создан сокет
+  bool m_listening = false;     ///< Слушающий сокет
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <KeyValueParameterized.h>
+
+/// Параметризация общей части стадий передачи задач через сокет
+class SocketParameterizedStage : public KeyValueParameterized {
+  bool m_isApliedParams = false;  ///< Параметры заданы
+
+ public:
+  SocketParameterizedStage();
+
+  /// Применить значения параметров
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+  /// Получить справочную информацию
+  virtual std::wstring GetHelpString() const override;
+
+ public:
+  /// Переоткрыть сокет с текущими значениями параметров
+  virtual void ResetChannel() = 0;
+
+ public:
+  /// Получить адрес сокета
+  std::string GetAddress() const;
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "ProducerStage.h"
+#include "SampleType.h"
+#include "SocketChannel.h"
+#include "SocketParameterizedStage.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/// Стадия, получающая задачи от стадии SocketWriteStage другого процесса.
+/// Слушает заданный адрес и обслуживает одного отправителя. Отправителю
+/// выдается window кредитов, которые возвращаются по мере передачи
+/// полученных задач дальше по конвейеру.
+template <typename T>
+class SocketReadStage : public ProducerStage<T>,
+                        public SocketParameterizedStage {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "only trivially copyable tasks can be sent through a socket");
+
+  SocketChannel m_listener;  ///< Сокет, ожидающий подключения отправителя
+  SocketChannel m_channel;   ///< Соединение с отправителем
+  std::vector<T> m_received;  ///< Последний полученный пакет
+  size_t m_next = 0;          ///< Следующая задача пакета для передачи
+  size_t m_window = 0;        ///< Число задач, переданных без подтверждения
+  size_t m_producedSinceCredit = 0;  ///< Задачи, за которые кредит не выдан
+
+ public:
+  SocketReadStage(std::shared_ptr<OutStageConnection<T>>);
+
+  void produce(std::shared_ptr<T> outData) override;
+
+ public:
+  /// Переоткрыть слушающий сокет
+  virtual void ResetChannel() override;
+
+  /// Получить адрес, на котором принимаются подключения (для TCP с портом 0
+  /// содержит выбранный системой порт)
+  std::string GetListenAddress() const;
+
+ private:
+  /// Дождаться следующего пакета (не дольше receiveWaitPeriod)
+  bool receiveFrame();
+  /// Вернуть отправителю кредиты за переданные дальше задачи
+  void returnCredits(size_t count);
+  /// Закрыть соединение с отправителем и отбросить непереданные задачи
+  void dropConnection();
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "FromSocket";
+  using consumptionT = void;
+  using productionT = T;
+
+  /// Время ожидания пакета, после которого стадия сообщает об отсутствии
+  /// данных
+  static constexpr std::chrono::milliseconds receiveWaitPeriod{10};
+};
+
+template <typename T>
+SocketReadStage<T>::SocketReadStage(
+    std::shared_ptr<OutStageConnection<T>> connection)
+    : ProducerStage<T>(stageName, connection) {
+  AddParameter("window",
+               L"Число задач, передаваемых отправителем без подтверждения",
+               "1024");
+}
+
+template <typename T>
+void SocketReadStage<T>::produce(std::shared_ptr<T> outData) {
+  if (!IsFullyParameterized()) {
+    // Параметры не были заданы. Не можем читать данные.
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  if (m_next == m_received.size() && !receiveFrame()) {
+    // Отправитель пока ничего не передал
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  *outData = m_received[m_next++];
+
+  if (++m_producedSinceCredit >= std::max<size_t>(1, m_window / 2)) {
+    returnCredits(m_producedSinceCredit);
+    m_producedSinceCredit = 0;
+  }
+
+  this->dataProduced(outData);
+}
+
+template <typename T>
+inline void SocketReadStage<T>::ResetChannel() {
+  m_window = GetSizeParameter("window", 1);
+  if (m_window > UINT32_MAX)
+    throw std::invalid_argument("Parameter window is too large");
+
+  dropConnection();
+  m_listener.close();
+  m_listener = SocketChannel::listen(GetAddress());
+}
+
+template <typename T>
+inline std::string SocketReadStage<T>::GetListenAddress() const {
+  return m_listener.localAddress();
+}
+
+template <typename T>
+inline bool SocketReadStage<T>::receiveFrame() {
+  if (!m_channel.isOpen()) {
+    m_channel = m_listener.accept(receiveWaitPeriod);
+    if (!m_channel.isOpen())
+      return false;
+
+    m_producedSinceCredit = 0;
+    returnCredits(m_window);
+    if (!m_channel.isOpen())
+      return false;
+  }
+
+  try {
+    SocketFrameHeader header{};
+    if (!m_channel.receive(&header, sizeof(header), receiveWaitPeriod))
+      return false;
+
+    if (header.taskSize != sizeof(T) || header.taskCount == 0 ||
+        header.taskCount > m_window)
+      throw SocketChannelException("unexpected frame received on " +
+                                   GetAddress());
+
+    m_received.resize(header.taskCount);
+    if (!m_channel.receive(m_received.data(), header.taskCount * sizeof(T),
+                           SocketChannel::messageTimeout))
+      throw SocketChannelException("incomplete frame received on " +
+                                   GetAddress());
+  } catch (const SocketChannelException&) {
+    // Отправитель отключился или нарушил протокол, ждем нового подключения
+    dropConnection();
+    throw;
+  }
+
+  m_next = 0;
+  return true;
+}
+
+template <typename T>
+inline void SocketReadStage<T>::returnCredits(size_t count) {
+  auto credits = uint32_t(count);
+  SocketChannel::Buffer buffer{&credits, sizeof(credits)};
+  try {
+    m_channel.send(&buffer, 1);
+  } catch (const SocketChannelException&) {
+    // Отправитель отключился, следующий пакет ждем от нового подключения
+    m_channel.close();
+  }
+}
+
+template <typename T>
+inline void SocketReadStage<T>::dropConnection() {
+  m_channel.close();
+  m_received.clear();
+  m_next = 0;
+  m_producedSinceCredit = 0;
+}
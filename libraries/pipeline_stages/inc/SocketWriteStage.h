@@ -0,0 +1,191 @@
+#pragma once
+
+#include "ConsumerStage.h"
+#include "SampleType.h"
+#include "SocketChannel.h"
+#include "SocketParameterizedStage.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+/// Стадия, передающая задачи стадии SocketReadStage другого процесса.
+/// Задачи накапливаются в пакет, который отправляется одним векторным вызовом
+/// при заполнении или по истечении flushInterval, в том числе при простое
+/// стадии.
+/// Пакет передается только в пределах кредитов, выданных получателем.
+template <typename T>
+class SocketWriteStage : public ConsumerStage<T>,
+                         public SocketParameterizedStage {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "only trivially copyable tasks can be sent through a socket");
+
+  SocketChannel m_channel;  ///< Соединение с получателем
+  std::vector<T> m_batch;   ///< Накопленные, но не отправленные задачи
+  size_t m_batchSize = 0;   ///< Число задач, при котором пакет отправляется
+  std::chrono::microseconds m_flushInterval{0};  ///< Время накопления пакета
+  std::chrono::steady_clock::time_point m_batchStarted;  ///< Начало пакета
+  size_t m_credits = 0;  ///< Сколько задач получатель готов принять
+  std::chrono::steady_clock::time_point m_nextConnectAttempt;
+
+ public:
+  SocketWriteStage(ConsumptionStrategy strategy,
+                   std::shared_ptr<InStageConnection<T>>);
+
+  void consume(std::shared_ptr<T> inData) override;
+
+ public:
+  /// Закрыть соединение и применить параметры пакетирования
+  virtual void ResetChannel() override;
+
+ protected:
+  void onIdle() override;
+
+ private:
+  /// Подключиться к получателю, если соединения еще нет
+  bool connect();
+  /// Отправить накопленные задачи
+  void flush();
+  /// Дождаться кредитов на needed задач (не дольше creditWaitPeriod)
+  void waitForCredits(size_t needed);
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "ToSocket";
+  using consumptionT = T;
+  using productionT = void;
+
+  /// Время ожидания кредитов от получателя
+  static constexpr std::chrono::milliseconds creditWaitPeriod{100};
+  /// Пауза между попытками подключения к получателю
+  static constexpr std::chrono::milliseconds reconnectPeriod{100};
+};
+
+template <typename T>
+SocketWriteStage<T>::SocketWriteStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> connection)
+    : ConsumerStage<T>(stageName, strategy, connection) {
+  AddParameter("batchSize", L"Число задач в пакете", "64");
+  AddParameter("flushInterval",
+               L"Максимальное время накопления пакета, мкс", "1000");
+}
+
+template <typename T>
+void SocketWriteStage<T>::consume(std::shared_ptr<T> inData) {
+  if (!IsFullyParameterized() || !connect()) {
+    // Параметры не заданы или получатель недоступен. Не можем передать данные.
+    this->dataConsumed(inData, false);
+    return;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  if (m_batch.empty())
+    m_batchStarted = now;
+  m_batch.push_back(*inData);
+
+  // Задача уже скопирована в пакет, но при ошибке отправки будет
+  // освобождена как необработанная
+  if (m_batch.size() >= m_batchSize || now - m_batchStarted >= m_flushInterval)
+    flush();
+
+  this->dataConsumed(inData);
+}
+
+template <typename T>
+inline void SocketWriteStage<T>::ResetChannel() {
+  m_batchSize = GetSizeParameter("batchSize", 1);
+  m_flushInterval =
+      std::chrono::microseconds(GetSizeParameter("flushInterval", 1));
+
+  m_channel.close();
+  m_batch.clear();
+  m_batch.reserve(m_batchSize);
+  m_credits = 0;
+  m_nextConnectAttempt = {};
+}
+
+template <typename T>
+inline void SocketWriteStage<T>::onIdle() {
+  // Пакет не отправляется раньше времени, иначе при каждом пустом опросе
+  // уходили бы пакеты из нескольких задач
+  if (!m_batch.empty() &&
+      std::chrono::steady_clock::now() - m_batchStarted >= m_flushInterval)
+    flush();
+}
+
+template <typename T>
+inline bool SocketWriteStage<T>::connect() {
+  if (m_channel.isOpen())
+    return true;
+
+  auto now = std::chrono::steady_clock::now();
+  if (now < m_nextConnectAttempt)
+    return false;
+
+  try {
+    m_channel = SocketChannel::connect(GetAddress());
+    m_credits = 0;
+    return true;
+  } catch (const SocketChannelException&) {
+    // Получатель еще не запущен
+    m_nextConnectAttempt = now + reconnectPeriod;
+    return false;
+  }
+}
+
+template <typename T>
+inline void SocketWriteStage<T>::flush() {
+  if (m_batch.empty())
+    return;
+
+  size_t count = 0;
+  try {
+    waitForCredits(m_batch.size());
+
+    count = std::min(m_batch.size(), m_credits);
+    if (count > 0) {
+      SocketFrameHeader header{uint32_t(sizeof(T)), uint32_t(count)};
+      SocketChannel::Buffer buffers[] = {{&header, sizeof(header)},
+                                         {m_batch.data(), count * sizeof(T)}};
+      m_channel.send(buffers, std::size(buffers));
+    }
+  } catch (const SocketChannelException&) {
+    // Соединение разорвано, переподключимся при следующей задаче
+    m_channel.close();
+    m_batch.clear();
+    throw;
+  }
+
+  if (count == 0) {
+    // Получатель не успевает забирать задачи, пакет теряется
+    m_batch.clear();
+    throw SocketChannelException("receiver at " + GetAddress() +
+                                 " has not granted credits in time");
+  }
+
+  // Задачи, на которые не хватило кредитов, уйдут со следующим пакетом
+  m_credits -= count;
+  m_batch.erase(m_batch.begin(), m_batch.begin() + count);
+  if (!m_batch.empty())
+    m_batchStarted = std::chrono::steady_clock::now();
+}
+
+template <typename T>
+inline void SocketWriteStage<T>::waitForCredits(size_t needed) {
+  if (!m_channel.isOpen())
+    throw SocketChannelException("not connected to " + GetAddress());
+
+  auto deadline = std::chrono::steady_clock::now() + creditWaitPeriod;
+  while (m_credits < needed) {
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    uint32_t credits = 0;
+    if (!m_channel.receive(&credits, sizeof(credits),
+                           std::max(left, std::chrono::milliseconds{0})))
+      break;
+    m_credits += credits;
+  }
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+/// Найти первую позицию значения, не большего low или не меньшего high
+/// (count, если таких нет). Значения сравниваются векторными инструкциями
+/// (SSE2, если доступны) по четыре за шаг. Сравнение с NaN всегда ложно,
+/// так что low или high, равный NaN, отключает свою границу.
+size_t FindFirstOutside(const double* values,
+                        size_t count,
+                        double low,
+                        double high);
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "SampleType.h"
+
+#include <cstdint>
+
+/// Отсчет с меткой времени: по меткам JoinStage сопоставляет отсчеты
+/// разных входов
+struct TimedSample {
+  int64_t timestampUs;  ///< Время отсчета (SteadyClock)
+  double value;
+};
+
+template <>
+struct SampleType<TimedSample> {
+  static constexpr const char* name = "timedSample";
+};
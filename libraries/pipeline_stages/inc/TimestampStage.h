@@ -0,0 +1,90 @@
+#pragma once
+
+#include "KeyValueParameterized.h"
+#include "ProducerAndConsumerStage.h"
+#include "SampleType.h"
+#include "TimedSample.h"
+
+#include <SteadyClock.h>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/// Стадия, ставящая отсчетам метки времени для JoinStage. При period = 0
+/// метка - время получения отсчета, иначе отсчеты считаются равномерными:
+/// метка n-го отсчета - время получения первого плюс n * period, так что
+/// задержки в конвейере не сбивают метки.
+template <typename T>
+class TimestampStage : public ConsumerAndProducerStage<T, TimedSample>,
+                       public KeyValueParameterized {
+  static_assert(std::is_arithmetic_v<T>, "only numbers can be timestamped");
+
+  double m_periodUs = 0;
+  int64_t m_startUs = 0;   ///< Метка первого отсчета
+  uint64_t m_samples = 0;  ///< Получено отсчетов
+
+ public:
+  TimestampStage(ConsumptionStrategy strategy,
+                 std::shared_ptr<InStageConnection<T>> inConnection,
+                 std::shared_ptr<OutStageConnection<TimedSample>>
+                     outConnection);
+
+  void consumeAndProduce(std::shared_ptr<T> inData,
+                         std::shared_ptr<TimedSample> outData) override;
+
+ public:
+  /// Применить значения параметров. Отсчет меток начинается заново.
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "Timestamp";
+  using consumptionT = T;
+  using productionT = TimedSample;
+};
+
+template <typename T>
+TimestampStage<T>::TimestampStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> inConnection,
+    std::shared_ptr<OutStageConnection<TimedSample>> outConnection)
+    : ConsumerAndProducerStage<T, TimedSample>(stageName,
+                                               strategy,
+                                               inConnection,
+                                               outConnection) {
+  AddParameter("period",
+               L"Период отсчетов, мкс (0 - метка по времени получения)", "0");
+  ApplyParameterValues();
+}
+
+template <typename T>
+void TimestampStage<T>::consumeAndProduce(
+    std::shared_ptr<T> inData,
+    std::shared_ptr<TimedSample> outData) {
+  if (m_periodUs == 0 || m_samples == 0)
+    m_startUs = SteadyClock::nowUs().count();
+
+  outData->timestampUs =
+      m_startUs + std::llround(double(m_samples) * m_periodUs);
+  outData->value = double(*inData);
+  ++m_samples;
+
+  this->dataConsumed(inData);
+  this->dataProduced(outData);
+}
+
+template <typename T>
+inline void TimestampStage<T>::ApplyParameterValues() noexcept(false) {
+  m_periodUs = GetRealParameter("period", 0);
+  m_samples = 0;
+}
+
+template <typename T>
+inline bool TimestampStage<T>::IsFullyParameterized() const {
+  return true;
+}
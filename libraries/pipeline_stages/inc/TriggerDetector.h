@@ -0,0 +1,105 @@
+#pragma once
+
+#include "SampleType.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Событие срабатывания триггера: отсчеты до и после срабатывания
+struct TriggerEvent {
+  /// Наибольшее число отсчетов события
+  static constexpr size_t maxSamples = 1024;
+
+  uint64_t index;        ///< Номер отсчета срабатывания в потоке
+  int64_t timestampUs;   ///< Время обнаружения срабатывания (SteadyClock)
+  uint32_t preSamples;   ///< Отсчетов до срабатывания в values
+  uint32_t sampleCount;  ///< Всего отсчетов в values
+  uint32_t rising;       ///< 1 - по фронту, 0 - по спаду
+  double values[maxSamples];
+};
+
+template <>
+struct SampleType<TriggerEvent> {
+  static constexpr const char* name = "triggerEvent";
+};
+
+/// Триггер, как у осциллографа: срабатывает, когда значение пересекает
+/// уровень level по фронту и/или спаду. Гистерезис: для срабатывания по
+/// фронту значение сначала должно опуститься до level - hysteresis (для
+/// спада - подняться до level + hysteresis), так что шум около уровня не
+/// дает ложных срабатываний. После срабатывания следующие holdoff отсчетов
+/// не проверяются.
+/// Событие содержит preSamples отсчетов до срабатывания и postSamples,
+/// начиная с него, и готово, когда получен последний из них. События могут
+/// перекрываться.
+/// Отсчеты ищутся векторным поиском (FindFirstOutside) сразу по пачке.
+/// Вся память выделяется при создании: обработка не выделяет память.
+/// Если событий больше, чем помещается в очередь, лишние отбрасываются.
+class TriggerDetector {
+ public:
+  enum class Edge { rising, falling, both };
+
+  struct Settings {
+    double level = 0;
+    double hysteresis = 0;
+    Edge edge = Edge::rising;
+    size_t preSamples = 0;
+    size_t postSamples = 1;
+    size_t holdoff = 0;
+  };
+
+  explicit TriggerDetector(const Settings& settings) noexcept(false);
+
+  /// Обработать очередные count отсчетов. nowUs записывается в события,
+  /// сработавшие на них.
+  void Process(const double* values, size_t count, int64_t nowUs);
+
+  /// Первое готовое событие (nullptr, если их нет)
+  const TriggerEvent* Front() const;
+  /// Удалить первое готовое событие
+  void Pop();
+  /// Число отброшенных событий
+  uint64_t GetDroppedCount() const;
+
+  /// Наибольшее число ожидающих и готовых событий
+  static constexpr size_t maxEvents = 16;
+
+ private:
+  enum class State { idle, armedRise, armedFall };
+
+  /// Сработавший триггер, ожидающий отсчетов после срабатывания
+  struct Trigger {
+    uint64_t index;
+    int64_t timestampUs;
+    bool rising;
+  };
+
+  void Scan(const double* values, size_t count, int64_t nowUs);
+  void Fire(uint64_t index, bool rising, int64_t nowUs);
+  void CompleteEvents();
+
+ private:
+  /// Отсчетов за один проход (история вмещает проход и окна события)
+  static constexpr size_t chunkSize = 256;
+
+  const Settings m_settings;
+  double m_armRise;  ///< Уровень взвода по фронту (NaN - не взводится)
+  double m_armFall;  ///< Уровень взвода по спаду (NaN - не взводится)
+  State m_state = State::idle;
+  uint64_t m_total = 0;     ///< Получено отсчетов
+  uint64_t m_nextScan = 0;  ///< Номер первого непроверенного отсчета
+
+  std::vector<double> m_history;  ///< Кольцо последних отсчетов
+  size_t m_historyMask;
+
+  std::array<Trigger, maxEvents> m_triggers;
+  size_t m_triggersHead = 0;
+  size_t m_triggersCount = 0;
+
+  std::vector<TriggerEvent> m_events;  ///< Кольцо готовых событий
+  size_t m_eventsHead = 0;
+  size_t m_eventsCount = 0;
+  uint64_t m_dropped = 0;
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "KeyValueParameterized.h"
+#include "ProducerAndConsumerStage.h"
+#include "SampleType.h"
+#include "TriggerDetector.h"
+
+#include <SteadyClock.h>
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/// Стадия захвата событий по триггеру (см. TriggerDetector): на каждое
+/// срабатывание выдается задача TriggerEvent с окнами до и после него.
+/// Отсчеты копятся пачками по batch и проверяются векторным поиском, пачка
+/// проверяется и раньше, если входных данных нет. Задержка обнаружения -
+/// не больше пачки; в событие записывается время обнаружения.
+/// События выдаются по одному на входной отсчет.
+template <typename T>
+class TriggerStage : public ConsumerAndProducerStage<T, TriggerEvent>,
+                     public KeyValueParameterized {
+  static_assert(std::is_arithmetic_v<T>, "only numbers can trigger");
+
+  std::unique_ptr<TriggerDetector> m_detector;
+  std::vector<double> m_batch;  ///< Отсчеты, еще не переданные триггеру
+  size_t m_batchSize = 1;
+
+ public:
+  TriggerStage(ConsumptionStrategy strategy,
+               std::shared_ptr<InStageConnection<T>> inConnection,
+               std::shared_ptr<OutStageConnection<TriggerEvent>> outConnection);
+
+  void consumeAndProduce(std::shared_ptr<T> inData,
+                         std::shared_ptr<TriggerEvent> outData) override;
+
+  /// Число событий, отброшенных из-за переполнения очереди
+  uint64_t GetDroppedCount() const;
+
+ public:
+  /// Применить значения параметров. Ожидающие события сбрасываются.
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+ protected:
+  void onIdle() override;
+
+ private:
+  /// Передать накопленные отсчеты триггеру
+  void Flush();
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "Trigger";
+  using consumptionT = T;
+  using productionT = TriggerEvent;
+};
+
+template <typename T>
+TriggerStage<T>::TriggerStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> inConnection,
+    std::shared_ptr<OutStageConnection<TriggerEvent>> outConnection)
+    : ConsumerAndProducerStage<T, TriggerEvent>(stageName,
+                                                strategy,
+                                                inConnection,
+                                                outConnection) {
+  AddParameter("level", L"Уровень срабатывания", "0");
+  AddParameter("hysteresis", L"Гистерезис (отступ от уровня для взвода)", "0");
+  AddParameter("edge",
+               L"Срабатывание по rising (фронт), falling (спад) или both",
+               "rising");
+  AddParameter("pre", L"Отсчетов до срабатывания в событии", "100");
+  AddParameter("post", L"Отсчетов после срабатывания в событии (с ним самим)",
+               "400");
+  AddParameter("holdoff", L"Отсчетов после срабатывания без проверки триггера",
+               "0");
+  AddParameter("batch", L"Отсчетов в пачке, проверяемой за раз", "64");
+  ApplyParameterValues();
+}
+
+template <typename T>
+void TriggerStage<T>::consumeAndProduce(
+    std::shared_ptr<T> inData,
+    std::shared_ptr<TriggerEvent> outData) {
+  m_batch.push_back(double(*inData));
+  this->dataConsumed(inData);
+  if (m_batch.size() >= m_batchSize)
+    Flush();
+
+  auto event = m_detector->Front();
+  if (!event) {
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  // Копируются только заполненные отсчеты
+  std::memcpy(outData.get(), event, offsetof(TriggerEvent, values));
+  std::memcpy(outData->values, event->values,
+              event->sampleCount * sizeof(double));
+  m_detector->Pop();
+  this->dataProduced(outData);
+}
+
+template <typename T>
+inline uint64_t TriggerStage<T>::GetDroppedCount() const {
+  return m_detector->GetDroppedCount();
+}
+
+template <typename T>
+inline void TriggerStage<T>::ApplyParameterValues() noexcept(false) {
+  TriggerDetector::Settings settings;
+  settings.level = GetRealParameter("level");
+  settings.hysteresis = GetRealParameter("hysteresis", 0);
+  settings.preSamples = GetSizeParameter("pre");
+  settings.postSamples = GetSizeParameter("post");
+  settings.holdoff = GetSizeParameter("holdoff");
+
+  auto edge = GetParameter("edge");
+  if (edge == "rising")
+    settings.edge = TriggerDetector::Edge::rising;
+  else if (edge == "falling")
+    settings.edge = TriggerDetector::Edge::falling;
+  else if (edge == "both")
+    settings.edge = TriggerDetector::Edge::both;
+  else
+    throw std::invalid_argument("Unknown trigger edge " + edge);
+
+  auto batchSize = GetSizeParameter("batch", 1);
+
+  m_detector = std::make_unique<TriggerDetector>(settings);
+  m_batchSize = batchSize;
+  m_batch.clear();
+  // Память пачки выделяется один раз
+  m_batch.reserve(m_batchSize);
+}
+
+template <typename T>
+inline bool TriggerStage<T>::IsFullyParameterized() const {
+  return true;
+}
+
+template <typename T>
+inline void TriggerStage<T>::onIdle() {
+  Flush();
+}
+
+template <typename T>
+inline void TriggerStage<T>::Flush() {
+  if (m_batch.empty())
+    return;
+  m_detector->Process(m_batch.data(), m_batch.size(),
+                      SteadyClock::nowUs().count());
+  m_batch.clear();
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "KeyValueParameterized.h"
+#include "ProducerAndConsumerStage.h"
+#include "SampleType.h"
+#include "WindowAggregator.h"
+
+#include <SteadyClock.h>
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+/// Стадия, вычисляющая статистику (min, max, mean, variance, rms, count)
+/// значений по окнам (см. WindowAggregator). На каждое закрытое окно выдается
+/// одна задача WindowStatistics.
+template <typename T>
+class WindowAggregationStage
+    : public ConsumerAndProducerStage<T, WindowStatistics>,
+      public KeyValueParameterized {
+  static_assert(std::is_arithmetic_v<T>, "only numbers can be aggregated");
+
+  std::unique_ptr<WindowAggregator> m_aggregator;
+
+ public:
+  WindowAggregationStage(
+      ConsumptionStrategy strategy,
+      std::shared_ptr<InStageConnection<T>> inConnection,
+      std::shared_ptr<OutStageConnection<WindowStatistics>> outConnection);
+
+  void consumeAndProduce(std::shared_ptr<T> inData,
+                         std::shared_ptr<WindowStatistics> outData) override;
+
+ public:
+  /// Применить значения параметров. Накопленные окна сбрасываются.
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+ private:
+  /// Создать агрегатор по текущим значениям параметров
+  std::unique_ptr<WindowAggregator> MakeAggregator() const noexcept(false);
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "WindowAggregation";
+  using consumptionT = T;
+  using productionT = WindowStatistics;
+};
+
+template <typename T>
+WindowAggregationStage<T>::WindowAggregationStage(
+    ConsumptionStrategy strategy,
+    std::shared_ptr<InStageConnection<T>> inConnection,
+    std::shared_ptr<OutStageConnection<WindowStatistics>> outConnection)
+    : ConsumerAndProducerStage<T, WindowStatistics>(stageName,
+                                                    strategy,
+                                                    inConnection,
+                                                    outConnection) {
+  AddParameter("mode",
+               L"Размер окна задается числом значений (count) или временем "
+               L"(time)",
+               "count");
+  AddParameter("length", L"Длина окна, значений или мкс", "1000");
+  AddParameter("hop", L"Шаг окна, значений или мкс (0 - равен длине)", "0");
+  m_aggregator = MakeAggregator();
+}
+
+template <typename T>
+void WindowAggregationStage<T>::consumeAndProduce(
+    std::shared_ptr<T> inData,
+    std::shared_ptr<WindowStatistics> outData) {
+  auto time = m_aggregator->IsTimeBased() ? SteadyClock::nowUs().count() : 0;
+  auto statistics = m_aggregator->Add(double(*inData), time);
+  this->dataConsumed(inData);
+
+  if (!statistics) {
+    // Окно еще не закрылось
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  *outData = *statistics;
+  this->dataProduced(outData);
+}
+
+template <typename T>
+inline void WindowAggregationStage<T>::ApplyParameterValues() noexcept(false) {
+  m_aggregator = MakeAggregator();
+}
+
+template <typename T>
+inline bool WindowAggregationStage<T>::IsFullyParameterized() const {
+  return true;
+}
+
+template <typename T>
+inline std::unique_ptr<WindowAggregator>
+WindowAggregationStage<T>::MakeAggregator() const noexcept(false) {
+  auto mode = GetParameter("mode");
+  if (mode != "count" && mode != "time")
+    throw std::invalid_argument("Unknown window mode " + mode);
+
+  return std::make_unique<WindowAggregator>(
+      mode == "count" ? WindowAggregator::Mode::count
+                      : WindowAggregator::Mode::time,
+      GetSizeParameter("length", 1), GetSizeParameter("hop"));
+}
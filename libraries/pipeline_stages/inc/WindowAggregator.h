@@ -0,0 +1,100 @@
+#pragma once
+
+#include "SampleType.h"
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+/// Статистика значений окна
+struct WindowStatistics {
+  double min;
+  double max;
+  double mean;
+  double variance;  ///< Дисперсия (по генеральной совокупности)
+  double rms;       ///< Среднеквадратичное значение
+  uint64_t count;   ///< Число значений в окне
+};
+
+template <>
+struct SampleType<WindowStatistics> {
+  static constexpr const char* name = "windowStatistics";
+};
+
+/// Инкрементальная статистика окна: значения добавляются в конец и удаляются
+/// из начала за амортизированное O(1) независимо от размера окна.
+/// Минимум и максимум поддерживаются монотонными очередями, среднее и
+/// дисперсия - алгоритмом Уэлфорда (с обратным шагом при удалении). Без
+/// keepValues значения не хранятся и удалять их нельзя (окно только
+/// накапливается и очищается целиком).
+class WindowAccumulator {
+ public:
+  explicit WindowAccumulator(bool keepValues = true);
+
+  void Push(double value, int64_t time);
+  /// Удалить самое старое значение
+  void PopFront();
+  void Clear();
+
+  size_t Size() const;
+  /// Время самого старого значения (окно не пусто, значения хранятся)
+  int64_t FrontTime() const;
+
+  WindowStatistics GetStatistics() const;
+
+ private:
+  struct Entry {
+    double value;
+    int64_t time;
+  };
+  /// Элемент монотонной очереди: номер значения и значение
+  struct Extremum {
+    uint64_t index;
+    double value;
+  };
+
+  const bool m_keepValues;
+  std::deque<Entry> m_values;
+  std::deque<Extremum> m_minimums;  ///< Возрастающие значения-кандидаты
+  std::deque<Extremum> m_maximums;  ///< Убывающие значения-кандидаты
+  uint64_t m_pushed = 0;  ///< Номер следующего добавляемого значения
+  uint64_t m_popped = 0;  ///< Номер следующего удаляемого значения
+
+  size_t m_count = 0;
+  double m_mean = 0;
+  double m_m2 = 0;  ///< Сумма квадратов отклонений от среднего
+  double m_min = 0;  ///< Минимум без хранения значений
+  double m_max = 0;  ///< Максимум без хранения значений
+};
+
+/// Разбиение потока значений на окна.
+/// Окно задается длиной length и шагом hop в значениях (count) или в
+/// микросекундах времени поступления (time). При hop = length окна
+/// неперекрывающиеся (tumbling), при hop < length - скользящие (sliding).
+/// Окна по времени полуоткрытые, [начало, начало + length): значение,
+/// пришедшее точно на границе, относится к следующему окну. Окно
+/// закрывается первым значением, пришедшим на границе или после нее.
+class WindowAggregator {
+ public:
+  enum class Mode { count, time };
+
+ public:
+  WindowAggregator(Mode mode, uint64_t length, uint64_t hop);
+
+  /// Добавить значение. Возвращает статистику окна, если оно закрылось.
+  std::optional<WindowStatistics> Add(double value, int64_t timeUs);
+
+  bool IsTimeBased() const;
+
+ private:
+  std::optional<WindowStatistics> AddByCount(double value);
+  std::optional<WindowStatistics> AddByTime(double value, int64_t timeUs);
+
+ private:
+  const Mode m_mode;
+  const uint64_t m_length;
+  const uint64_t m_hop;
+  WindowAccumulator m_window;
+  uint64_t m_sinceEmit;  ///< Значений с последней выдачи (count)
+  std::optional<int64_t> m_nextEmit;  ///< Время следующей выдачи (time)
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+/// Генератор псевдослучайных чисел xoshiro256** (D. Blackman, S. Vigna).
+/// Значительно быстрее rand() и std::mt19937 и выдает одну и ту же
+/// последовательность на всех платформах. Подходит для std::*_distribution.
+class Xoshiro256 {
+ public:
+  using result_type = uint64_t;
+
+  /// Состояние заполняется из seed генератором splitmix64
+  explicit Xoshiro256(uint64_t seed = 0) {
+    for (auto& word : m_state) {
+      seed += 0x9e3779b97f4a7c15ull;
+      auto z = seed;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    auto result = rotl(m_state[1] * 5, 7) * 9;
+    auto t = m_state[1] << 17;
+
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = rotl(m_state[3], 45);
+
+    return result;
+  }
+
+  /// Равномерно распределенное число из [0, 1)
+  double nextDouble() { return double((*this)() >> 11) * 0x1.0p-53; }
+
+ private:
+  static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+ private:
+  uint64_t m_state[4];
+};
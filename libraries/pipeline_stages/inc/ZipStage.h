@@ -0,0 +1,104 @@
+#pragma once
+
+#include "KeyValueParameterized.h"
+#include "MultiInputStage.h"
+#include "SampleCombiner.h"
+#include "SampleType.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Стадия попарного сведения: i-е отсчеты всех входов сводятся операцией
+/// operation (см. CombineOperation) в один. Из каждого входа берется по
+/// одному отсчету, пока не придут отсчеты остальных: вход, обогнавший
+/// другие, ждет в своем соединении.
+template <typename T>
+class ZipStage : public MultiInputStage<T, double>,
+                 public KeyValueParameterized {
+  static_assert(std::is_arithmetic_v<T>, "only numbers can be combined");
+
+  CombineOperation m_operation = CombineOperation::sum;
+  std::vector<double> m_values;  ///< Полученные отсчеты входов
+  std::vector<bool> m_received;  ///< Отсчет входа получен
+  size_t m_receivedCount = 0;
+
+ public:
+  ZipStage(ConsumptionStrategy strategy,
+           const std::vector<std::shared_ptr<InStageConnection<T>>>&
+               inConnections,
+           std::shared_ptr<OutStageConnection<double>> outConnection);
+
+ public:
+  /// Применить значения параметров
+  virtual void ApplyParameterValues() noexcept(false) override;
+  /// Объект полностью (и корректно) параметризован
+  virtual bool IsFullyParameterized() const override;
+
+ protected:
+  void consumeAndProduce(size_t input,
+                         std::shared_ptr<T> inData,
+                         std::shared_ptr<double> outData) override;
+
+  bool acceptsInput(size_t input) const override;
+
+ public:
+  static inline std::string stageName =
+      std::string(SampleType<T>::name) + "Zip";
+  using consumptionT = T;
+  using productionT = double;
+};
+
+template <typename T>
+ZipStage<T>::ZipStage(
+    ConsumptionStrategy strategy,
+    const std::vector<std::shared_ptr<InStageConnection<T>>>& inConnections,
+    std::shared_ptr<OutStageConnection<double>> outConnection)
+    : MultiInputStage<T, double>(stageName,
+                                 strategy,
+                                 inConnections,
+                                 outConnection),
+      m_values(inConnections.size()),
+      m_received(inConnections.size()) {
+  AddParameter("operation",
+               L"Операция: sum, difference, product, ratio, mean, min, max",
+               "sum");
+  ApplyParameterValues();
+}
+
+template <typename T>
+void ZipStage<T>::consumeAndProduce(size_t input,
+                                    std::shared_ptr<T> inData,
+                                    std::shared_ptr<double> outData) {
+  m_values[input] = double(*inData);
+  m_received[input] = true;
+  ++m_receivedCount;
+  this->dataConsumed(input, inData);
+
+  if (m_receivedCount < m_values.size()) {
+    this->dataProduced(outData, false);
+    return;
+  }
+
+  *outData = Combine(m_operation, m_values.data(), m_values.size());
+  std::fill(m_received.begin(), m_received.end(), false);
+  m_receivedCount = 0;
+  this->dataProduced(outData);
+}
+
+template <typename T>
+inline bool ZipStage<T>::acceptsInput(size_t input) const {
+  return !m_received[input];
+}
+
+template <typename T>
+inline void ZipStage<T>::ApplyParameterValues() noexcept(false) {
+  m_operation = CombineOperationFromString(GetParameter("operation"));
+}
+
+template <typename T>
+inline bool ZipStage<T>::IsFullyParameterized() const {
+  return true;
+}
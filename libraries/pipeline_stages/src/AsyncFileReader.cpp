@@ -0,0 +1,88 @@
+#include "AsyncFileReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+AsyncFileReader::AsyncFileReader(const std::string& path,
+                                 const AsyncFileOptions& options)
+    : m_path(path), m_direct(options.direct) {
+  m_fd = AsyncIoQueue::OpenFile(path, false, m_direct);
+  try {
+    m_size = AsyncIoQueue::GetFileSize(m_fd);
+    m_queue = std::make_unique<AsyncIoQueue>(m_fd, options.blockSize,
+                                             options.queueDepth);
+    Rewind();
+  } catch (...) {
+    m_queue.reset();
+    AsyncIoQueue::CloseFile(m_fd);
+    throw;
+  }
+}
+
+AsyncFileReader::~AsyncFileReader() {
+  // Очередь дожидается операций над файлом, закрываем его после нее
+  m_queue.reset();
+  AsyncIoQueue::CloseFile(m_fd);
+}
+
+bool AsyncFileReader::Read(void* data, size_t size) noexcept(false) {
+  if (size > m_size - m_position)
+    return false;
+
+  auto bytes = static_cast<char*>(data);
+  while (size != 0) {
+    if (m_blockUsed == m_blockBytes) {
+      if (m_blockBytes != 0)
+        SubmitBlock(m_block);
+
+      auto [index, count] = m_queue->WaitOldest();
+      m_block = index;
+      m_blockUsed = 0;
+      m_blockBytes = count;
+      if (count == 0)
+        throw std::runtime_error("File " + m_path + " was truncated");
+    }
+
+    auto count = std::min(size, m_blockBytes - m_blockUsed);
+    std::memcpy(bytes, m_queue->GetBlock(m_block) + m_blockUsed, count);
+    m_blockUsed += count;
+    m_position += count;
+    bytes += count;
+    size -= count;
+  }
+  return true;
+}
+
+void AsyncFileReader::Rewind() noexcept(false) {
+  // Прочитанные заранее блоки больше не нужны
+  while (m_queue->GetPendingCount() != 0)
+    m_queue->WaitOldest();
+
+  m_block = 0;
+  m_blockUsed = 0;
+  m_blockBytes = 0;
+  m_position = 0;
+  m_nextOffset = 0;
+  for (size_t i = 0; i < m_queue->GetDepth(); ++i)
+    SubmitBlock(i);
+}
+
+uint64_t AsyncFileReader::GetSize() const {
+  return m_size;
+}
+
+bool AsyncFileReader::IsDirect() const {
+  return m_direct;
+}
+
+bool AsyncFileReader::UsesIoUring() const {
+  return m_queue->UsesIoUring();
+}
+
+void AsyncFileReader::SubmitBlock(size_t index) {
+  if (m_nextOffset >= m_size)
+    return;
+
+  m_queue->SubmitRead(index, m_nextOffset, m_queue->GetBlockSize());
+  m_nextOffset += m_queue->GetBlockSize();
+}
@@ -0,0 +1,106 @@
+#include "AsyncFileWriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+AsyncFileWriter::AsyncFileWriter(const std::string& path,
+                                 const AsyncFileOptions& options)
+    : m_path(path), m_direct(options.direct) {
+  m_fd = AsyncIoQueue::OpenFile(path, true, m_direct);
+  try {
+    m_queue = std::make_unique<AsyncIoQueue>(m_fd, options.blockSize,
+                                             options.queueDepth);
+    m_submittedSizes.resize(options.queueDepth);
+  } catch (...) {
+    AsyncIoQueue::CloseFile(m_fd);
+    throw;
+  }
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+  try {
+    Close();
+  } catch (...) {
+  }
+}
+
+void AsyncFileWriter::Write(const void* data, size_t size) noexcept(false) {
+  if (!m_queue)
+    throw std::logic_error("File " + m_path + " is closed");
+
+  auto bytes = static_cast<const char*>(data);
+  auto blockSize = m_queue->GetBlockSize();
+  while (size != 0) {
+    auto count = std::min(size, blockSize - m_used);
+    std::memcpy(m_queue->GetBlock(m_block) + m_used, bytes, count);
+    m_used += count;
+    bytes += count;
+    size -= count;
+
+    if (m_used == blockSize)
+      SubmitBlock(blockSize);
+  }
+}
+
+void AsyncFileWriter::Close() noexcept(false) {
+  if (!m_queue)
+    return;
+
+  auto size = m_offset + m_used;
+  try {
+    if (m_used != 0) {
+      // O_DIRECT требует выровненного размера записи
+      auto alignment = m_direct ? AsyncIoQueue::alignment : 1;
+      auto padded = (m_used + alignment - 1) / alignment * alignment;
+      std::memset(m_queue->GetBlock(m_block) + m_used, 0, padded - m_used);
+      SubmitBlock(padded);
+    }
+    while (m_queue->GetPendingCount() != 0)
+      WaitWritten();
+
+    if (m_offset != size)
+      AsyncIoQueue::TruncateFile(m_fd, size);
+  } catch (...) {
+    Release();
+    throw;
+  }
+  Release();
+}
+
+bool AsyncFileWriter::IsDirect() const {
+  return m_direct;
+}
+
+bool AsyncFileWriter::UsesIoUring() const {
+  return m_queue && m_queue->UsesIoUring();
+}
+
+void AsyncFileWriter::SubmitBlock(size_t size) {
+  m_queue->SubmitWrite(m_block, m_offset, size);
+  m_submittedSizes[m_block] = size;
+  m_offset += size;
+  m_used = 0;
+
+  // Блоки используются по кругу, самый старый в работе - следующий
+  m_block = (m_block + 1) % m_queue->GetDepth();
+  if (m_queue->GetPendingCount() == m_queue->GetDepth())
+    WaitWritten();
+}
+
+void AsyncFileWriter::WaitWritten() noexcept(false) {
+  auto [index, count] = m_queue->WaitOldest();
+  if (count != m_submittedSizes[index])
+    throw std::runtime_error("Short write to file " + m_path + ": " +
+                             std::to_string(count) + " of " +
+                             std::to_string(m_submittedSizes[index]) +
+                             " bytes");
+}
+
+void AsyncFileWriter::Release() {
+  // Очередь дожидается операций над файлом, закрываем его после нее
+  m_queue.reset();
+  AsyncIoQueue::CloseFile(m_fd);
+  m_fd = -1;
+}
@@ -0,0 +1,373 @@
+#include "AsyncIoQueue.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef ECSMS_HAVE_LIBURING
+#include <liburing.h>
+#include <sys/uio.h>
+#endif
+
+namespace {
+/// Потоков пула больше этого числа не нужно даже для NVMe
+constexpr size_t maxWorkersCount = 4;
+
+void FreeBlocks(char* memory) {
+  ::operator delete(memory, std::align_val_t{AsyncIoQueue::alignment});
+}
+
+/// Позиционное чтение или запись всего блока. Возвращает число переданных
+/// байт (меньше size только при чтении конца файла) или -errno.
+int64_t TransferBlock(int fd,
+                      bool write,
+                      char* data,
+                      size_t size,
+                      uint64_t offset) {
+  size_t done = 0;
+  while (done < size) {
+#ifdef _WIN32
+    auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    OVERLAPPED overlapped{};
+    overlapped.Offset = DWORD(offset + done);
+    overlapped.OffsetHigh = DWORD((offset + done) >> 32);
+    DWORD transferred = 0;
+    auto ok = write ? WriteFile(handle, data + done, DWORD(size - done),
+                                &transferred, &overlapped)
+                    : ReadFile(handle, data + done, DWORD(size - done),
+                               &transferred, &overlapped);
+    if (!ok && !(!write && GetLastError() == ERROR_HANDLE_EOF))
+      return -EIO;
+    auto result = int64_t(transferred);
+#else
+    auto result = write ? pwrite(fd, data + done, size - done, offset + done)
+                        : pread(fd, data + done, size - done, offset + done);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result < 0)
+      return -errno;
+#endif
+    if (result == 0)
+      break;
+    done += size_t(result);
+  }
+
+  if (write && done < size)
+    return -EIO;
+  return int64_t(done);
+}
+
+#ifdef ECSMS_HAVE_LIBURING
+/// Поставить в очередь io_uring передачу size байт зарегистрированного
+/// буфера index, начиная с его байта done
+void QueueTransfer(io_uring& ring,
+                   int fd,
+                   bool write,
+                   char* block,
+                   size_t index,
+                   size_t size,
+                   uint64_t offset,
+                   size_t done) {
+  auto sqe = io_uring_get_sqe(&ring);
+  if (sqe == nullptr)
+    throw std::runtime_error("io_uring submission queue is full");
+
+  if (write)
+    io_uring_prep_write_fixed(sqe, fd, block + done, unsigned(size - done),
+                              offset + done, int(index));
+  else
+    io_uring_prep_read_fixed(sqe, fd, block + done, unsigned(size - done),
+                             offset + done, int(index));
+  io_uring_sqe_set_data64(sqe, index);
+
+  auto submitted = io_uring_submit(&ring);
+  if (submitted < 0)
+    throw std::runtime_error(std::string("io_uring submit failed: ") +
+                             std::strerror(-submitted));
+}
+#endif
+}  // namespace
+
+#ifdef ECSMS_HAVE_LIBURING
+struct AsyncIoQueue::Ring {
+  io_uring ring;
+};
+#else
+struct AsyncIoQueue::Ring {};
+#endif
+
+AsyncIoQueue::AsyncIoQueue(int fd, size_t blockSize, size_t depth)
+    : m_fd(fd),
+      m_blockSize(blockSize),
+      m_depth(depth),
+      m_memory(nullptr, FreeBlocks),
+      m_inFlight(depth),
+      m_results(depth) {
+  if (blockSize == 0 || blockSize % alignment != 0)
+    throw std::invalid_argument("Block size must be a positive multiple of " +
+                                std::to_string(alignment));
+  if (depth == 0)
+    throw std::invalid_argument("Queue depth must be positive");
+
+  m_memory.reset(static_cast<char*>(
+      ::operator new(blockSize * depth, std::align_val_t{alignment})));
+
+#ifdef ECSMS_HAVE_LIBURING
+  // Ядро может не поддерживать io_uring или запрещать его, тогда работаем
+  // через пул потоков
+  auto ring = std::make_unique<Ring>();
+  if (io_uring_queue_init(unsigned(depth), &ring->ring, 0) == 0) {
+    std::vector<iovec> buffers(depth);
+    for (size_t i = 0; i < depth; ++i)
+      buffers[i] = {GetBlock(i), blockSize};
+    if (io_uring_register_buffers(&ring->ring, buffers.data(),
+                                  unsigned(depth)) == 0)
+      m_ring = std::move(ring);
+    else
+      io_uring_queue_exit(&ring->ring);
+  }
+#endif
+
+  if (!m_ring) {
+    for (size_t i = 0; i < std::min(depth, maxWorkersCount); ++i)
+      m_workers.emplace_back([this] { Work(); });
+  }
+}
+
+AsyncIoQueue::~AsyncIoQueue() {
+  while (!m_submitted.empty()) {
+    try {
+      WaitOldest();
+    } catch (...) {
+    }
+  }
+
+  {
+    std::lock_guard lock(m_mutex);
+    m_stopping = true;
+  }
+  m_requestCv.notify_all();
+  for (auto& worker : m_workers)
+    worker.join();
+
+#ifdef ECSMS_HAVE_LIBURING
+  if (m_ring) {
+    io_uring_unregister_buffers(&m_ring->ring);
+    io_uring_queue_exit(&m_ring->ring);
+  }
+#endif
+}
+
+char* AsyncIoQueue::GetBlock(size_t index) const {
+  return m_memory.get() + index * m_blockSize;
+}
+
+size_t AsyncIoQueue::GetBlockSize() const {
+  return m_blockSize;
+}
+
+size_t AsyncIoQueue::GetDepth() const {
+  return m_depth;
+}
+
+void AsyncIoQueue::SubmitWrite(size_t index, uint64_t offset, size_t size) {
+  Submit({true, index, offset, size});
+}
+
+void AsyncIoQueue::SubmitRead(size_t index, uint64_t offset, size_t size) {
+  Submit({false, index, offset, size});
+}
+
+std::pair<size_t, size_t> AsyncIoQueue::WaitOldest() noexcept(false) {
+  if (m_submitted.empty())
+    throw std::logic_error("No submitted operations");
+
+  auto index = m_submitted.front();
+  auto& result = m_results[index];
+
+#ifdef ECSMS_HAVE_LIBURING
+  // Операции io_uring завершаются в любом порядке
+  while (m_ring && !result.done) {
+    io_uring_cqe* cqe = nullptr;
+    auto error = io_uring_wait_cqe(&m_ring->ring, &cqe);
+    if (error == -EINTR)
+      continue;
+    if (error < 0)
+      throw std::runtime_error(std::string("io_uring wait failed: ") +
+                               std::strerror(-error));
+    auto completedIndex = size_t(io_uring_cqe_get_data64(cqe));
+    auto bytes = cqe->res;
+    io_uring_cqe_seen(&m_ring->ring, cqe);
+
+    auto& completed = m_results[completedIndex];
+    const auto& request = m_inFlight[completedIndex];
+    if (bytes < 0) {
+      completed = {true, bytes};
+      continue;
+    }
+
+    // Операция могла передать только часть блока, как и pwrite/pread
+    completed.bytes += bytes;
+    auto done = size_t(completed.bytes);
+    if (bytes > 0 && done < request.size) {
+      QueueTransfer(m_ring->ring, m_fd, request.write,
+                    GetBlock(completedIndex), completedIndex, request.size,
+                    request.offset, done);
+      continue;
+    }
+
+    // Файл не принял остаток записи, а чтение дошло до конца файла
+    if (request.write && done < request.size)
+      completed.bytes = -EIO;
+    completed.done = true;
+  }
+#endif
+
+  if (!m_ring) {
+    std::unique_lock lock(m_mutex);
+    m_doneCv.wait(lock, [&result] { return result.done; });
+  }
+
+  m_submitted.pop_front();
+  result.done = false;
+  if (result.bytes < 0)
+    throw std::runtime_error(std::string("File operation failed: ") +
+                             std::strerror(int(-result.bytes)));
+  return {index, size_t(result.bytes)};
+}
+
+size_t AsyncIoQueue::GetPendingCount() const {
+  return m_submitted.size();
+}
+
+bool AsyncIoQueue::UsesIoUring() const {
+  return m_ring != nullptr;
+}
+
+void AsyncIoQueue::Submit(const Request& request) {
+  if (request.index >= m_depth || request.size > m_blockSize)
+    throw std::invalid_argument("Request is out of the queue blocks");
+  if (std::find(m_submitted.begin(), m_submitted.end(), request.index) !=
+      m_submitted.end())
+    throw std::logic_error("Block is already submitted");
+
+  // Блок не в работе, его результат никто не читает
+  m_inFlight[request.index] = request;
+  m_results[request.index] = {};
+
+#ifdef ECSMS_HAVE_LIBURING
+  if (m_ring) {
+    QueueTransfer(m_ring->ring, m_fd, request.write, GetBlock(request.index),
+                  request.index, request.size, request.offset, 0);
+    m_submitted.push_back(request.index);
+    return;
+  }
+#endif
+
+  {
+    std::lock_guard lock(m_mutex);
+    m_requests.push_back(request);
+  }
+  m_submitted.push_back(request.index);
+  m_requestCv.notify_one();
+}
+
+void AsyncIoQueue::Work() {
+  std::unique_lock lock(m_mutex);
+  while (true) {
+    m_requestCv.wait(lock,
+                     [this] { return m_stopping || !m_requests.empty(); });
+    if (m_requests.empty())
+      return;
+
+    auto request = m_requests.front();
+    m_requests.pop_front();
+
+    lock.unlock();
+    auto bytes = TransferBlock(m_fd, request.write, GetBlock(request.index),
+                               request.size, request.offset);
+    lock.lock();
+
+    m_results[request.index] = {true, bytes};
+    m_doneCv.notify_all();
+  }
+}
+
+int AsyncIoQueue::OpenFile(const std::string& path,
+                           bool write,
+                           bool& direct) noexcept(false) {
+  if (path.empty())
+    throw std::invalid_argument("File name is not set");
+
+#ifdef _WIN32
+  // Позиционные операции Windows работают и без отключения кэша
+  direct = false;
+  auto flags =
+      _O_BINARY | (write ? _O_WRONLY | _O_CREAT | _O_TRUNC : _O_RDONLY);
+  auto fd = _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+  auto flags = write ? O_WRONLY | O_CREAT | O_TRUNC : O_RDONLY;
+  auto fd = -1;
+#ifdef O_DIRECT
+  if (direct)
+    fd = open(path.c_str(), flags | O_DIRECT, 0644);
+  // EINVAL - файловая система (например, tmpfs) не поддерживает O_DIRECT
+  if (fd < 0 && direct && errno != EINVAL)
+    throw std::runtime_error("Can't open file " + path + ": " +
+                             std::strerror(errno));
+#endif
+  direct = fd >= 0;
+  if (fd < 0)
+    fd = open(path.c_str(), flags, 0644);
+#endif
+  if (fd < 0)
+    throw std::runtime_error("Can't open file " + path + ": " +
+                             std::strerror(errno));
+  return fd;
+}
+
+void AsyncIoQueue::CloseFile(int fd) {
+#ifdef _WIN32
+  _close(fd);
+#else
+  close(fd);
+#endif
+}
+
+uint64_t AsyncIoQueue::GetFileSize(int fd) noexcept(false) {
+#ifdef _WIN32
+  struct _stat64 status;
+  if (_fstat64(fd, &status) != 0)
+#else
+  struct stat status;
+  if (fstat(fd, &status) != 0)
+#endif
+    throw std::runtime_error(std::string("Can't get file size: ") +
+                             std::strerror(errno));
+  return uint64_t(status.st_size);
+}
+
+void AsyncIoQueue::TruncateFile(int fd, uint64_t size) noexcept(false) {
+#ifdef _WIN32
+  if (_chsize_s(fd, int64_t(size)) != 0)
+#else
+  if (ftruncate(fd, off_t(size)) != 0)
+#endif
+    throw std::runtime_error(std::string("Can't truncate file: ") +
+                             std::strerror(errno));
+}
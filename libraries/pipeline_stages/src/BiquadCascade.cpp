@@ -0,0 +1,46 @@
+#include "BiquadCascade.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+BiquadCascade::BiquadCascade(std::vector<BiquadCoefficients> sections) noexcept(
+    false)
+    : m_sections(std::move(sections)), m_states(m_sections.size()) {
+  if (m_sections.empty())
+    throw std::invalid_argument("IIR filter must have sections");
+
+  for (const auto& section : m_sections) {
+    if (!std::isfinite(section.b0) || !std::isfinite(section.b1) ||
+        !std::isfinite(section.b2) || !std::isfinite(section.a1) ||
+        !std::isfinite(section.a2))
+      throw std::invalid_argument("IIR filter coefficients must be finite");
+    // Треугольник устойчивости для знаменателя второго порядка
+    if (!(std::abs(section.a2) < 1 && std::abs(section.a1) < 1 + section.a2))
+      throw std::invalid_argument("IIR filter section is unstable");
+  }
+}
+
+void BiquadCascade::Process(const double* in, double* out, size_t count) {
+  if (in != out)
+    std::copy(in, in + count, out);
+
+  for (size_t i = 0; i < m_sections.size(); ++i) {
+    const auto section = m_sections[i];
+    auto s1 = m_states[i].s1;
+    auto s2 = m_states[i].s2;
+    for (size_t n = 0; n < count; ++n) {
+      auto x = out[n];
+      auto y = section.b0 * x + s1;
+      s1 = section.b1 * x - section.a1 * y + s2;
+      s2 = section.b2 * x - section.a2 * y;
+      out[n] = y;
+    }
+    m_states[i] = {s1, s2};
+  }
+}
+
+void BiquadCascade::Reset() {
+  std::fill(m_states.begin(), m_states.end(), State{});
+}
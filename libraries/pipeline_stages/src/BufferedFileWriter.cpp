@@ -0,0 +1,154 @@
+#include "BufferedFileWriter.h"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+/// Сбросить файл на диск средствами ОС
+bool SyncToDisk(std::FILE* file) {
+#ifdef _WIN32
+  return _commit(_fileno(file)) == 0;
+#else
+  return fsync(fileno(file)) == 0;
+#endif
+}
+}  // namespace
+
+BufferedFileWriter::BufferedFileWriter(const std::string& path,
+                                       const Options& options)
+    : m_path(path), m_options(options) {
+  if (path.empty())
+    throw std::invalid_argument("File name is not set");
+  if (options.bufferSize == 0)
+    throw std::invalid_argument("bufferSize must be positive");
+
+  m_buffer.resize(options.bufferSize);
+  Open();
+}
+
+BufferedFileWriter::~BufferedFileWriter() {
+  try {
+    Close();
+  } catch (...) {
+  }
+}
+
+void BufferedFileWriter::Write(const void* data, size_t size) noexcept(false) {
+  if (m_options.rotateSize != 0 && m_fileSize != 0 &&
+      m_fileSize + size > m_options.rotateSize) {
+    Close();
+    ++m_fileIndex;
+    Open();
+  }
+
+  if (size > m_buffer.size() - m_used) {
+    FlushBuffer();
+    // Время проверяется только при передаче буфера в файл, а не на каждый
+    // блок
+    CheckTime(std::chrono::steady_clock::now());
+  }
+
+  if (size >= m_buffer.size()) {
+    // Большой блок пишется напрямую
+    if (std::fwrite(data, 1, size, m_file) != size)
+      throw std::runtime_error("Can't write file " + GetCurrentPath() + ": " +
+                               std::strerror(errno));
+  } else {
+    std::memcpy(m_buffer.data() + m_used, data, size);
+    m_used += size;
+  }
+  m_fileSize += size;
+}
+
+void BufferedFileWriter::Tick() noexcept(false) {
+  CheckTime(std::chrono::steady_clock::now());
+}
+
+void BufferedFileWriter::Sync() noexcept(false) {
+  FlushBuffer();
+  if (std::fflush(m_file) != 0 || !SyncToDisk(m_file))
+    throw std::runtime_error("Can't sync file " + GetCurrentPath() + ": " +
+                             std::strerror(errno));
+  m_lastSync = std::chrono::steady_clock::now();
+}
+
+std::string BufferedFileWriter::GetCurrentPath() const {
+  return IsRotating() ? MakePath(m_fileIndex) : m_path;
+}
+
+void BufferedFileWriter::Open() {
+  auto path = GetCurrentPath();
+  m_file = std::fopen(path.c_str(), "ab");
+  if (m_file == nullptr)
+    throw std::runtime_error("Can't open file " + path + ": " +
+                             std::strerror(errno));
+
+  // Буферизация выполняется в m_buffer
+  std::setvbuf(m_file, nullptr, _IONBF, 0);
+
+  std::fseek(m_file, 0, SEEK_END);
+  auto size = std::ftell(m_file);
+  m_fileSize = size > 0 ? size_t(size) : 0;
+  m_used = 0;
+  m_fileOpened = m_lastSync = std::chrono::steady_clock::now();
+}
+
+void BufferedFileWriter::Close() {
+  if (m_file == nullptr)
+    return;
+
+  auto file = m_file;
+  try {
+    Sync();
+  } catch (...) {
+    m_file = nullptr;
+    std::fclose(file);
+    throw;
+  }
+  m_file = nullptr;
+  std::fclose(file);
+}
+
+void BufferedFileWriter::FlushBuffer() {
+  if (m_used == 0)
+    return;
+
+  auto used = m_used;
+  m_used = 0;
+  if (std::fwrite(m_buffer.data(), 1, used, m_file) != used)
+    throw std::runtime_error("Can't write file " + GetCurrentPath() + ": " +
+                             std::strerror(errno));
+}
+
+void BufferedFileWriter::CheckTime(std::chrono::steady_clock::time_point now) {
+  if (m_options.rotateInterval.count() != 0 && m_fileSize != 0 &&
+      now - m_fileOpened >= m_options.rotateInterval) {
+    Close();
+    ++m_fileIndex;
+    Open();
+    return;
+  }
+
+  if (m_options.syncInterval.count() != 0 &&
+      now - m_lastSync >= m_options.syncInterval)
+    Sync();
+}
+
+std::string BufferedFileWriter::MakePath(size_t index) const {
+  std::filesystem::path path(m_path);
+  auto name = path.stem().string() + "." + std::to_string(index) +
+              path.extension().string();
+  return path.replace_filename(name).string();
+}
+
+bool BufferedFileWriter::IsRotating() const {
+  return m_options.rotateSize != 0 || m_options.rotateInterval.count() != 0;
+}
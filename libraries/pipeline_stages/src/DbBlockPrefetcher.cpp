@@ -0,0 +1,78 @@
+#include "DbBlockPrefetcher.h"
+
+#include <utility>
+
+DbBlockPrefetcher::DbBlockPrefetcher(ReadFunction read)
+    : m_read(std::move(read)) {}
+
+DbBlockPrefetcher::~DbBlockPrefetcher() {
+  {
+    std::lock_guard lock{m_mutex};
+    m_stopped = true;
+  }
+  m_blockRequested.notify_all();
+
+  if (m_reader.joinable())
+    m_reader.join();
+}
+
+void DbBlockPrefetcher::Request() {
+  {
+    std::lock_guard lock{m_mutex};
+    if (m_requested)
+      return;
+
+    m_requested = true;
+    m_reading = true;
+    if (!m_reader.joinable())
+      m_reader = std::thread(&DbBlockPrefetcher::ReadBlocks, this);
+  }
+  m_blockRequested.notify_all();
+}
+
+bool DbBlockPrefetcher::IsRequested() const {
+  std::lock_guard lock{m_mutex};
+  return m_requested;
+}
+
+std::vector<char> DbBlockPrefetcher::Take() noexcept(false) {
+  std::unique_lock lock{m_mutex};
+  m_blockRead.wait(lock, [this] { return !m_reading; });
+  m_requested = false;
+
+  if (auto error = std::exchange(m_error, nullptr))
+    std::rethrow_exception(error);
+  return std::exchange(m_block, {});
+}
+
+void DbBlockPrefetcher::Cancel() {
+  std::unique_lock lock{m_mutex};
+  m_blockRead.wait(lock, [this] { return !m_reading; });
+  m_requested = false;
+  m_block.clear();
+  m_error = nullptr;
+}
+
+void DbBlockPrefetcher::ReadBlocks() {
+  std::unique_lock lock{m_mutex};
+  while (true) {
+    m_blockRequested.wait(lock, [this] { return m_stopped || m_reading; });
+    if (m_stopped)
+      break;
+
+    lock.unlock();
+    std::vector<char> block;
+    std::exception_ptr error;
+    try {
+      block = m_read();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+
+    m_block = std::move(block);
+    m_error = error;
+    m_reading = false;
+    m_blockRead.notify_all();
+  }
+}
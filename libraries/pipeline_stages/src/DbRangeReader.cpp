@@ -0,0 +1,145 @@
+#include "DbRangeReader.h"
+
+#include <IExecuteResultStatus.h>
+#include <IFile.h>
+
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+namespace {
+/// Открыть объект на чтение в новой транзакции соединения
+IFilePtr OpenForReading(const IConnectionPtr& connection,
+                        const std::string& fileName) {
+  if (auto status = connection->BeginTransaction(); status->HasError())
+    throw std::runtime_error(status->GetErrorMessage());
+
+  auto file = connection->GetRemoteFile(fileName);
+  if (!file || !file->Open(FileOpenMode::Read))
+    throw std::runtime_error("Can't open binary large object " + fileName);
+  return file;
+}
+}  // namespace
+
+DbRangeReader::DbRangeReader(ConnectionFactory factory,
+                             const std::string& fileName,
+                             size_t chunkSize,
+                             size_t readersCount)
+    : m_factory(std::move(factory)), m_fileName(fileName),
+      m_chunkSize(chunkSize) {
+  if (chunkSize == 0 || readersCount == 0)
+    throw std::invalid_argument("chunkSize and readersCount must be positive");
+
+  // Размер читается сразу, чтобы ошибки подключения получил вызывающий
+  {
+    auto connection = m_factory();
+    auto file = OpenForReading(connection, fileName);
+    auto size = file->GetSize();
+    file->Close();
+    connection->RollbackTransaction();
+    if (!size)
+      throw std::runtime_error("Can't get size of binary large object " +
+                               fileName);
+    m_fileSize = *size;
+  }
+
+  m_chunksCount = (m_fileSize + m_chunkSize - 1) / m_chunkSize;
+  m_readAheadLimit = 2 * readersCount;
+
+  for (size_t i = 0; i < readersCount; ++i)
+    m_readers.emplace_back(&DbRangeReader::ReadRanges, this);
+}
+
+DbRangeReader::~DbRangeReader() {
+  {
+    std::lock_guard lock{m_mutex};
+    m_stopped = true;
+  }
+  m_chunkTaken.notify_all();
+
+  for (auto& reader : m_readers)
+    reader.join();
+}
+
+size_t DbRangeReader::GetFileSize() const {
+  return m_fileSize;
+}
+
+std::vector<char> DbRangeReader::NextChunk() noexcept(false) {
+  std::unique_lock lock{m_mutex};
+  if (m_nextToReturn == m_chunksCount)
+    return {};
+
+  auto failed = [this] { return m_error && m_failedChunk <= m_nextToReturn; };
+  m_chunkReady.wait(lock, [&] {
+    return failed() || m_readyChunks.count(m_nextToReturn) != 0;
+  });
+  if (m_readyChunks.count(m_nextToReturn) == 0) {
+    // Диапазон не будет прочитан, продолжать выдачу нечем
+    m_nextToReturn = m_chunksCount;
+    m_stopped = true;
+    m_readyChunks.clear();
+    lock.unlock();
+
+    m_chunkTaken.notify_all();
+    std::rethrow_exception(m_error);
+  }
+
+  auto chunk = std::move(m_readyChunks[m_nextToReturn]);
+  m_readyChunks.erase(m_nextToReturn++);
+  lock.unlock();
+
+  m_chunkTaken.notify_all();
+  return chunk;
+}
+
+void DbRangeReader::ReadRanges() {
+  // Диапазон, который читает поток (до первого - ближайший к выдаче)
+  size_t index = 0;
+  try {
+    while (true) {
+      {
+        std::unique_lock lock{m_mutex};
+        // Не уходим вперед дальше m_readAheadLimit диапазонов
+        m_chunkTaken.wait(lock, [this] {
+          return m_stopped || m_nextToRead == m_chunksCount ||
+                 m_nextToRead < m_nextToReturn + m_readAheadLimit;
+        });
+        if (m_stopped || m_nextToRead == m_chunksCount)
+          break;
+        index = m_nextToRead++;
+      }
+
+      auto offset = index * m_chunkSize;
+      std::vector<char> chunk(std::min(m_chunkSize, m_fileSize - offset));
+      size_t numberOfBytesRead = 0;
+      {
+        // Соединение возвращается, пока поток ждет следующего диапазона
+        auto connection = m_factory();
+        auto file = OpenForReading(connection, m_fileName);
+        if (!file->Seek(offset) ||
+            !file->ReadBytes(chunk.data(), chunk.size(), &numberOfBytesRead) ||
+            numberOfBytesRead != chunk.size())
+          throw std::runtime_error("Can't read binary large object " +
+                                   m_fileName);
+        file->Close();
+        connection->RollbackTransaction();
+      }
+
+      {
+        std::lock_guard lock{m_mutex};
+        m_readyChunks[index] = std::move(chunk);
+      }
+      m_chunkReady.notify_all();
+    }
+  } catch (...) {
+    {
+      std::lock_guard lock{m_mutex};
+      if (!m_error || index < m_failedChunk) {
+        m_error = std::current_exception();
+        m_failedChunk = index;
+      }
+    }
+    m_chunkReady.notify_all();
+  }
+}
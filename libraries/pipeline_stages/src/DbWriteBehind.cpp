@@ -0,0 +1,121 @@
+#include "DbWriteBehind.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+DbWriteBehind::DbWriteBehind(WriteFunction write,
+                             size_t bufferSize,
+                             size_t buffersCount,
+                             size_t highWaterMark)
+    : m_write(std::move(write)),
+      m_bufferSize(bufferSize),
+      m_highWaterMark(highWaterMark) {
+  if (bufferSize == 0)
+    throw std::invalid_argument("bufferSize must be positive");
+  if (buffersCount < 2)
+    throw std::invalid_argument("at least 2 buffers are required");
+  if (highWaterMark == 0 || highWaterMark >= buffersCount)
+    throw std::invalid_argument(
+        "highWaterMark must be between 1 and buffersCount - 1");
+
+  // Вся память выделяется сразу и дальше только переиспользуется
+  m_current.reserve(bufferSize);
+  m_free.resize(buffersCount - 1);
+  for (auto& buffer : m_free)
+    buffer.reserve(bufferSize);
+
+  m_writer = std::thread(&DbWriteBehind::WriteBuffers, this);
+}
+
+DbWriteBehind::~DbWriteBehind() {
+  Flush();
+  {
+    std::lock_guard lock{m_mutex};
+    m_stopped = true;
+  }
+  m_bufferFull.notify_all();
+  m_writer.join();
+}
+
+void DbWriteBehind::Append(const void* data, size_t size) noexcept(false) {
+  std::unique_lock lock{m_mutex};
+  if (m_failed) {
+    m_failed = false;
+    throw std::runtime_error("Can't write buffered data to database");
+  }
+
+  if (!m_current.empty() && m_current.size() + size > m_bufferSize)
+    SubmitLocked();
+
+  if (m_current.capacity() == 0) {
+    // Текущий буфер отдан на запись, ждем свободный
+    m_bufferFree.wait(lock, [this] {
+      auto waiting = m_full.size() + (m_writing ? 1 : 0);
+      return !m_free.empty() && waiting <= m_highWaterMark;
+    });
+    m_current = std::move(m_free.back());
+    m_free.pop_back();
+  }
+
+  auto offset = m_current.size();
+  m_current.resize(offset + size);
+  std::memcpy(m_current.data() + offset, data, size);
+}
+
+void DbWriteBehind::Submit() {
+  std::lock_guard lock{m_mutex};
+  SubmitLocked();
+}
+
+bool DbWriteBehind::Flush() {
+  std::unique_lock lock{m_mutex};
+  SubmitLocked();
+  m_bufferFree.wait(lock, [this] { return m_full.empty() && !m_writing; });
+
+  return !std::exchange(m_failed, false);
+}
+
+bool DbWriteBehind::HasBufferedData() const {
+  std::lock_guard lock{m_mutex};
+  return !m_current.empty();
+}
+
+void DbWriteBehind::WriteBuffers() {
+  while (true) {
+    std::vector<char> buffer;
+    {
+      std::unique_lock lock{m_mutex};
+      m_bufferFull.wait(lock, [this] { return m_stopped || !m_full.empty(); });
+      if (m_full.empty())
+        break;
+      buffer = std::move(m_full.front());
+      m_full.pop_front();
+      m_writing = true;
+    }
+
+    bool written = false;
+    try {
+      written = m_write(buffer);
+    } catch (...) {
+    }
+
+    {
+      std::lock_guard lock{m_mutex};
+      m_writing = false;
+      m_failed = m_failed || !written;
+      buffer.clear();
+      m_free.push_back(std::move(buffer));
+    }
+    m_bufferFree.notify_all();
+  }
+}
+
+void DbWriteBehind::SubmitLocked() {
+  if (m_current.empty())
+    return;
+
+  m_full.push_back(std::move(m_current));
+  m_current = std::vector<char>();
+  m_bufferFull.notify_one();
+}
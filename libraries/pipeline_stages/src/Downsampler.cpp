@@ -0,0 +1,92 @@
+#include "Downsampler.h"
+
+#include "MinMaxKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+Downsampler::Downsampler(Method method, size_t bucketSize) noexcept(false)
+    : m_method(method), m_bucketSize(bucketSize) {
+  if (bucketSize == 0)
+    throw std::invalid_argument("bucket size must be positive");
+  // Корзина minMax дает до двух точек, иначе очередь будет расти
+  if (method == Method::minMax && bucketSize < 2)
+    throw std::invalid_argument("min/max bucket must hold at least 2 values");
+  m_bucket.reserve(bucketSize);
+  m_pending.reserve(bucketSize);
+}
+
+void Downsampler::Add(double value) {
+  auto index = m_count++;
+  if (m_method == Method::lttb && index == 0) {
+    m_selected = {0, value};
+    m_points.push_back(m_selected);
+    m_bucketStart = 1;
+    return;
+  }
+
+  m_bucket.push_back(value);
+  if (m_bucket.size() < m_bucketSize)
+    return;
+
+  if (m_method == Method::minMax)
+    CloseMinMaxBucket();
+  else
+    CloseLttbBucket();
+  m_bucketStart = m_count;
+}
+
+std::optional<DisplayPoint> Downsampler::Next() {
+  if (m_points.empty())
+    return std::nullopt;
+
+  auto point = m_points.front();
+  m_points.pop_front();
+  return point;
+}
+
+void Downsampler::CloseMinMaxBucket() {
+  auto [minIndex, maxIndex] = FindMinMax(m_bucket.data(), m_bucket.size());
+  auto first = std::min(minIndex, maxIndex);
+  auto second = std::max(minIndex, maxIndex);
+
+  m_points.push_back({m_bucketStart + first, m_bucket[first]});
+  if (second != first)
+    m_points.push_back({m_bucketStart + second, m_bucket[second]});
+  m_bucket.clear();
+}
+
+void Downsampler::CloseLttbBucket() {
+  if (!m_pending.empty()) {
+    // Третья вершина треугольника - среднее только что заполненной корзины
+    auto size = double(m_bucket.size());
+    auto nextIndex = double(m_bucketStart) + (size - 1) / 2;
+    auto nextValue = std::accumulate(m_bucket.begin(), m_bucket.end(), 0.0) /
+                     size;
+
+    auto previousIndex = double(m_selected.index);
+    auto previousValue = m_selected.value;
+    size_t best = 0;
+    double bestArea = -1;
+    for (size_t i = 0; i < m_pending.size(); ++i) {
+      // Удвоенная площадь, ее достаточно для сравнения
+      auto area = std::abs(
+          (previousIndex - nextIndex) * (m_pending[i] - previousValue) -
+          (previousIndex - double(m_pendingStart + i)) *
+              (nextValue - previousValue));
+      if (area > bestArea) {
+        bestArea = area;
+        best = i;
+      }
+    }
+
+    m_selected = {m_pendingStart + best, m_pending[best]};
+    m_points.push_back(m_selected);
+  }
+
+  m_pending.swap(m_bucket);
+  m_pendingStart = m_bucketStart;
+  m_bucket.clear();
+}
@@ -0,0 +1,26 @@
+#include "FileParameterizedStage.h"
+
+#include <stdexcept>
+
+FileParameterizedStage::FileParameterizedStage() {
+  AddParameter("filename", L"Имя файла", "");
+}
+
+void FileParameterizedStage::ApplyParameterValues() noexcept(false) {
+  m_isApliedParams = false;
+
+  if (GetFileName().empty())
+    throw std::invalid_argument("File name is not set");
+
+  ResetFile();
+
+  m_isApliedParams = true;
+}
+
+bool FileParameterizedStage::IsFullyParameterized() const {
+  return m_isApliedParams;
+}
+
+std::string FileParameterizedStage::GetFileName() const {
+  return GetParameter("filename");
+}
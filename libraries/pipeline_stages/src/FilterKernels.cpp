@@ -0,0 +1,82 @@
+#include "FilterKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FILTER_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+// Вариант AVX2 собирается отдельной функцией и выбирается при запуске
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define FILTER_KERNELS_AVX2
+#define FILTER_KERNELS_AVX2_TARGET __attribute__((target("avx2,fma")))
+#include <immintrin.h>
+#endif
+
+namespace {
+double DotProductScalar(const double* a, const double* b, size_t count) {
+  double sum = 0;
+  for (size_t i = 0; i < count; ++i)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+#ifdef FILTER_KERNELS_SSE2
+double DotProductSse2(const double* a, const double* b, size_t count) {
+  __m128d sum0 = _mm_setzero_pd();
+  __m128d sum1 = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    sum0 = _mm_add_pd(sum0,
+                      _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    sum1 = _mm_add_pd(
+        sum1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+  }
+
+  double sums[2];
+  _mm_storeu_pd(sums, _mm_add_pd(sum0, sum1));
+  return sums[0] + sums[1] + DotProductScalar(a + i, b + i, count - i);
+}
+#endif
+
+#ifdef FILTER_KERNELS_AVX2
+FILTER_KERNELS_AVX2_TARGET double DotProductAvx2(const double* a,
+                                                 const double* b,
+                                                 size_t count) {
+  __m256d sum0 = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i),
+                           sum0);
+    sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4),
+                           _mm256_loadu_pd(b + i + 4), sum1);
+  }
+
+  double sums[4];
+  _mm256_storeu_pd(sums, _mm256_add_pd(sum0, sum1));
+  return sums[0] + sums[1] + sums[2] + sums[3] +
+         DotProductScalar(a + i, b + i, count - i);
+}
+#endif
+
+using DotProductFunction = double (*)(const double*, const double*, size_t);
+
+DotProductFunction SelectDotProduct() {
+#ifdef FILTER_KERNELS_AVX2
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return DotProductAvx2;
+#endif
+#ifdef FILTER_KERNELS_SSE2
+  return DotProductSse2;
+#else
+  return DotProductScalar;
+#endif
+}
+}  // namespace
+
+double DotProduct(const double* a, const double* b, size_t count) {
+  static const DotProductFunction function = SelectDotProduct();
+  return function(a, b, count);
+}
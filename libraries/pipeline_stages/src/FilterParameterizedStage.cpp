@@ -0,0 +1,75 @@
+#include "FilterParameterizedStage.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+/// Разобрать список чисел, разделенных пробелами, запятыми или точками с
+/// запятой
+std::vector<double> ParseCoefficients(std::string text) noexcept(false) {
+  std::replace(text.begin(), text.end(), ',', ' ');
+  std::replace(text.begin(), text.end(), ';', ' ');
+
+  std::vector<double> coefficients;
+  std::istringstream stream(text);
+  std::string word;
+  while (stream >> word) {
+    char* end = nullptr;
+    auto value = std::strtod(word.c_str(), &end);
+    if (end != word.c_str() + word.size() || !std::isfinite(value))
+      throw std::invalid_argument(
+          "Filter coefficient must be a number, got \"" + word + "\"");
+    coefficients.push_back(value);
+  }
+  return coefficients;
+}
+}  // namespace
+
+FilterParameterizedStage::FilterParameterizedStage(
+    const std::string& defaultCoefficients,
+    const std::wstring& coefficientsHelp)
+    : m_coefficientsHelp(coefficientsHelp) {
+  AddParameter("coefficients", L"Коэффициенты фильтра", defaultCoefficients);
+  AddParameter("coefficientsFile", L"Файл с коэффициентами фильтра", "");
+  m_coefficients = ReadCoefficients();
+}
+
+void FilterParameterizedStage::ApplyParameterValues() noexcept(false) {
+  auto coefficients = ReadCoefficients();
+  ResetFilter(coefficients);
+  m_coefficients = std::move(coefficients);
+}
+
+bool FilterParameterizedStage::IsFullyParameterized() const {
+  return true;
+}
+
+std::wstring FilterParameterizedStage::GetHelpString() const {
+  return L"Цифровой фильтр. " + m_coefficientsHelp +
+         L"\nКоэффициенты задаются числами через пробел, запятую или точку с "
+         L"запятой в параметре coefficients или в текстовом файле "
+         L"coefficientsFile (он важнее, если задан). Фильтр считается в "
+         L"double, целые результаты округляются.";
+}
+
+const std::vector<double>& FilterParameterizedStage::GetCoefficients() const {
+  return m_coefficients;
+}
+
+std::vector<double> FilterParameterizedStage::ReadCoefficients() const
+    noexcept(false) {
+  auto fileName = GetParameter("coefficientsFile");
+  if (fileName.empty())
+    return ParseCoefficients(GetParameter("coefficients"));
+
+  std::ifstream file(fileName);
+  if (!file.is_open())
+    throw std::runtime_error("Cannot open coefficients file " + fileName);
+
+  std::ostringstream text;
+  text << file.rdbuf();
+  return ParseCoefficients(text.str());
+}
@@ -0,0 +1,34 @@
+#include "FirFilter.h"
+
+#include "FilterKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+FirFilter::FirFilter(const std::vector<double>& taps) noexcept(false)
+    : m_reversedTaps(taps.rbegin(), taps.rend()),
+      m_history(2 * taps.size(), 0.0) {
+  if (taps.empty())
+    throw std::invalid_argument("FIR filter must have taps");
+  if (!std::all_of(taps.begin(), taps.end(),
+                   [](double tap) { return std::isfinite(tap); }))
+    throw std::invalid_argument("FIR filter taps must be finite");
+}
+
+void FirFilter::Process(const double* in, double* out, size_t count) {
+  const auto size = m_reversedTaps.size();
+  for (size_t i = 0; i < count; ++i) {
+    m_history[m_position] = m_history[m_position + size] = in[i];
+    // Окно от самого старого значения до только что записанного
+    out[i] = DotProduct(m_reversedTaps.data(),
+                        m_history.data() + m_position + 1, size);
+    if (++m_position == size)
+      m_position = 0;
+  }
+}
+
+void FirFilter::Reset() {
+  std::fill(m_history.begin(), m_history.end(), 0.0);
+  m_position = 0;
+}
@@ -0,0 +1,80 @@
+#include "GeneratorParameterizedStage.h"
+
+#include <map>
+#include <stdexcept>
+
+namespace {
+const std::map<std::string, SignalType> signalTypes = {
+    {"uniform", SignalType::uniform},
+    {"gaussian", SignalType::gaussian},
+    {"sine", SignalType::sine},
+    {"chirp", SignalType::chirp},
+    {"counter", SignalType::counter}};
+}  // namespace
+
+GeneratorParameterizedStage::GeneratorParameterizedStage() {
+  AddParameter("signal", L"Сигнал (uniform, gaussian, sine, chirp, counter)",
+               "uniform");
+  AddParameter("rate", L"Отсчетов в секунду", "1000");
+  AddParameter("throttle", L"Ограничивать частоту выдачи отсчетов (0/1)",
+               "1");
+  AddParameter("seed", L"Начальное значение генератора случайных чисел", "0");
+  AddParameter("amplitude", L"Амплитуда (для gaussian - СКО)", "100");
+  AddParameter("offset", L"Смещение (для gaussian - среднее)", "0");
+  AddParameter("frequency", L"Частота, Гц", "1");
+  AddParameter("endFrequency", L"Конечная частота chirp, Гц", "100");
+  AddParameter("sweepTime", L"Время изменения частоты chirp, с", "1");
+  m_settings = ParseSettings();
+}
+
+void GeneratorParameterizedStage::ApplyParameterValues() noexcept(false) {
+  m_settings = ParseSettings();
+  ResetGenerator();
+}
+
+bool GeneratorParameterizedStage::IsFullyParameterized() const {
+  return true;
+}
+
+std::wstring GeneratorParameterizedStage::GetHelpString() const {
+  return L"Генератор отсчетов сигнала для проверки и нагрузочного "
+         L"тестирования конвейера.\n"
+         L"uniform - равномерное распределение в offset +- amplitude, "
+         L"gaussian - нормальное со средним offset и СКО amplitude, "
+         L"sine - синус частоты frequency, chirp - синус, частота которого "
+         L"за sweepTime меняется от frequency до endFrequency, "
+         L"counter - offset, offset + 1, ...\n"
+         L"Время сигнала отсчитывается с частотой rate. При throttle = 0 "
+         L"отсчеты выдаются без пауз (для измерения предельной "
+         L"производительности).";
+}
+
+const SignalSettings& GeneratorParameterizedStage::GetSettings() const {
+  return m_settings;
+}
+
+SignalSettings GeneratorParameterizedStage::ParseSettings() const
+    noexcept(false) {
+  SignalSettings settings;
+
+  auto signal = GetParameter("signal");
+  auto type = signalTypes.find(signal);
+  if (type == signalTypes.end())
+    throw std::invalid_argument("Unknown signal " + signal);
+  settings.type = type->second;
+
+  settings.rate = GetRealParameter("rate");
+  settings.throttle = GetFlagParameter("throttle");
+  settings.seed = GetSizeParameter("seed");
+  settings.amplitude = GetRealParameter("amplitude");
+  settings.offset = GetRealParameter("offset");
+  settings.frequency = GetRealParameter("frequency");
+  settings.endFrequency = GetRealParameter("endFrequency");
+  settings.sweepTime = GetRealParameter("sweepTime");
+
+  if (!(settings.rate > 0))
+    throw std::invalid_argument("rate must be positive");
+  if (!(settings.sweepTime > 0))
+    throw std::invalid_argument("sweepTime must be positive");
+  return settings;
+}
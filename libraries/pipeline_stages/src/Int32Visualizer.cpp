@@ -1,6 +1,5 @@
 #include "Int32Visualizer.h"
 
-#include <fstream>
 #include <iostream>
 
 using namespace std;
@@ -11,9 +10,10 @@ Int32Visualizer::Int32Visualizer(
     : ConsumerStage(stageName, strategy, connection) {}
 
 void Int32Visualizer::consume(std::shared_ptr<int32_t> inData) {
-  std::ofstream file(m_filename, std::ios::app);
-  file << *inData << ' ' << endl;
-  cout << "Int32Visualizer: " << *inData << endl;
+  //  endl:        
+  if (m_file.is_open())
+    m_file << *inData << ' ' << '\n';
+  cout << "Int32Visualizer: " << *inData << '\n';
   dataConsumed(inData);
 }
 
@@ -25,8 +25,13 @@ Int32Visualizer::GetPatameterValues() const {
 bool Int32Visualizer::SetParameterValue(const std::string& paramName,
                                         const std::string& paramValue) {
   bool res = paramName == "filename";
-  if (res)
+  if (res && paramValue != m_filename) {
+    //          
     m_filename = paramValue;
+    m_file.close();
+    m_file.clear();
+    m_file.open(m_filename, std::ios::app);
+  }
   return res;
 }
 
@@ -44,6 +49,5 @@ std::optional<std::wstring> Int32Visualizer::GetObviousParamName(
 }
 
 bool Int32Visualizer::IsFullyParameterized() const {
-  std::ofstream file(m_filename, std::ios::app);
-  return file.is_open();
+  return m_file.is_open();
 }
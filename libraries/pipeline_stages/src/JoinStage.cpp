@@ -0,0 +1,107 @@
+#include "JoinStage.h"
+
+#include <limits>
+#include <stdexcept>
+
+JoinStage::JoinStage(
+    ConsumptionStrategy strategy,
+    const std::vector<std::shared_ptr<InStageConnection<TimedSample>>>&
+        inConnections,
+    std::shared_ptr<OutStageConnection<TimedSample>> outConnection)
+    : MultiInputStage<TimedSample, TimedSample>(stageName,
+                                                strategy,
+                                                inConnections,
+                                                outConnection),
+      m_buffers(inConnections.size()),
+      m_values(inConnections.size()) {
+  AddParameter("tolerance", L"Наибольшая разница меток сводимых отсчетов, мкс",
+               "1000");
+  AddParameter("buffer", L"Отсчетов в буфере каждого входа", "64");
+  AddParameter("operation",
+               L"Операция: sum, difference, product, ratio, mean, min, max",
+               "sum");
+  ApplyParameterValues();
+}
+
+uint64_t JoinStage::GetDroppedCount() const {
+  return m_dropped;
+}
+
+void JoinStage::consumeAndProduce(size_t input,
+                                  std::shared_ptr<TimedSample> inData,
+                                  std::shared_ptr<TimedSample> outData) {
+  auto& buffer = m_buffers[input];
+  if (buffer.count == buffer.samples.size()) {
+    Pop(buffer);
+    ++m_dropped;
+  }
+  buffer.samples[(buffer.head + buffer.count) % buffer.samples.size()] =
+      *inData;
+  ++buffer.count;
+  dataConsumed(input, inData);
+
+  dataProduced(outData, Match(*outData));
+}
+
+bool JoinStage::Match(TimedSample& result) {
+  for (;;) {
+    size_t oldest = 0;
+    int64_t first = 0;
+    int64_t last = 0;
+    for (size_t i = 0; i < m_buffers.size(); ++i) {
+      const auto& buffer = m_buffers[i];
+      if (buffer.count == 0)
+        return false;
+
+      auto timestamp = buffer.samples[buffer.head].timestampUs;
+      if (i == 0 || timestamp < first) {
+        first = timestamp;
+        oldest = i;
+      }
+      if (i == 0 || timestamp > last)
+        last = timestamp;
+    }
+
+    if (last - first <= m_toleranceUs)
+      break;
+
+    // Следующие отсчеты остальных входов еще новее
+    Pop(m_buffers[oldest]);
+    ++m_dropped;
+  }
+
+  for (size_t i = 0; i < m_buffers.size(); ++i) {
+    auto& buffer = m_buffers[i];
+    m_values[i] = buffer.samples[buffer.head].value;
+    if (i == 0)
+      result.timestampUs = buffer.samples[buffer.head].timestampUs;
+    Pop(buffer);
+  }
+  result.value = Combine(m_operation, m_values.data(), m_values.size());
+  return true;
+}
+
+void JoinStage::Pop(Buffer& buffer) {
+  buffer.head = (buffer.head + 1) % buffer.samples.size();
+  --buffer.count;
+}
+
+void JoinStage::ApplyParameterValues() noexcept(false) {
+  auto tolerance = GetSizeParameter("tolerance");
+  auto bufferSize = GetSizeParameter("buffer", 1);
+  auto operation = CombineOperationFromString(GetParameter("operation"));
+  if (tolerance > size_t(std::numeric_limits<int64_t>::max()))
+    throw std::invalid_argument("tolerance is too large");
+
+  m_toleranceUs = int64_t(tolerance);
+  m_operation = operation;
+  for (auto& buffer : m_buffers) {
+    buffer.samples.assign(bufferSize, TimedSample{});
+    buffer.head = 0;
+    buffer.count = 0;
+  }
+}
+
+bool JoinStage::IsFullyParameterized() const {
+  return true;
+}
@@ -0,0 +1,126 @@
+#include "KeyValueParameterized.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+/// Сообщение о некорректном значении параметра
+std::invalid_argument BadParameter(const std::string& key,
+                                   const std::string& requirement,
+                                   const std::string& value) {
+  return std::invalid_argument("Parameter " + key + " must be " +
+                               requirement + ", got \"" + value + "\"");
+}
+
+std::string ToString(double value) {
+  std::ostringstream stream;
+  stream << value;
+  return stream.str();
+}
+}  // namespace
+
+std::vector<IParameterized::PatameterValue>
+KeyValueParameterized::GetPatameterValues() const {
+  std::vector<PatameterValue> res;
+  for (auto&& key : m_keys) {
+    res.push_back({key, m_keyValues.at(key)});
+  }
+  return res;
+}
+
+bool KeyValueParameterized::SetParameterValue(const std::string& paramName,
+                                              const std::string& paramValue) {
+  auto iter = m_keyValues.find(paramName);
+  if (iter == m_keyValues.end())
+    // Такого ключа нет
+    return false;
+
+  iter->second = paramValue;
+  return true;
+}
+
+std::optional<std::wstring> KeyValueParameterized::GetObviousParamName(
+    const std::string& paramName) const {
+  if (auto iter = m_keysToObviousParamName.find(paramName);
+      iter != m_keysToObviousParamName.end())
+    return iter->second;
+  return std::nullopt;
+}
+
+void KeyValueParameterized::AddParameter(const std::string& key,
+                                         const std::wstring& obviousName,
+                                         const std::string& defaultValue) {
+  if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end())
+    m_keys.push_back(key);
+  m_keysToObviousParamName[key] = obviousName;
+  m_keyValues[key] = defaultValue;
+}
+
+std::string KeyValueParameterized::GetParameter(const std::string& key) const {
+  return m_keyValues.at(key);
+}
+
+size_t KeyValueParameterized::GetSizeParameter(const std::string& key,
+                                               size_t minValue) const {
+  const auto& value = m_keyValues.at(key);
+  size_t parsed = 0;
+  unsigned long long result = 0;
+  // stoull пропускает пробелы и принимает знак ("-1" дает наибольшее число),
+  // поэтому значение должно начинаться с цифры
+  if (!value.empty() && std::isdigit(static_cast<unsigned char>(value[0]))) {
+    try {
+      result = std::stoull(value, &parsed);
+    } catch (const std::exception&) {
+      parsed = 0;
+    }
+  }
+
+  if (parsed == 0 || parsed != value.size() || result < minValue ||
+      result > std::numeric_limits<size_t>::max())
+    throw BadParameter(key,
+                       "an integer not less than " + std::to_string(minValue),
+                       value);
+  return size_t(result);
+}
+
+double KeyValueParameterized::GetRealParameter(const std::string& key,
+                                               double minValue,
+                                               double maxValue) const {
+  const auto& value = m_keyValues.at(key);
+  size_t parsed = 0;
+  double result = 0;
+  if (!value.empty() && !std::isspace(static_cast<unsigned char>(value[0]))) {
+    try {
+      result = std::stod(value, &parsed);
+    } catch (const std::exception&) {
+      parsed = 0;
+    }
+  }
+
+  // Сравнения ложны и для NaN
+  if (parsed == 0 || parsed != value.size() ||
+      !(result >= minValue && result <= maxValue)) {
+    auto hasMin = minValue != std::numeric_limits<double>::lowest();
+    auto hasMax = maxValue != std::numeric_limits<double>::max();
+    std::string requirement = "a number";
+    if (hasMin && hasMax)
+      requirement +=
+          " from " + ToString(minValue) + " to " + ToString(maxValue);
+    else if (hasMin)
+      requirement += " not less than " + ToString(minValue);
+    else if (hasMax)
+      requirement += " not greater than " + ToString(maxValue);
+    throw BadParameter(key, requirement, value);
+  }
+  return result;
+}
+
+bool KeyValueParameterized::GetFlagParameter(const std::string& key) const {
+  const auto& value = m_keyValues.at(key);
+  if (value != "0" && value != "1")
+    throw BadParameter(key, "0 or 1", value);
+  return value == "1";
+}
@@ -0,0 +1,121 @@
+#include "LogHistogram.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+/// Вес, меньше которого корзина после уменьшения весов считается пустой
+constexpr double negligibleWeight = 1e-6;
+}  // namespace
+
+LogHistogram::LogHistogram(unsigned precisionBits) noexcept(false)
+    : m_precisionBits(precisionBits),
+      m_lowestKey(uint64_t(1023 - exponentRange) << precisionBits),
+      m_halfSize(size_t(2 * exponentRange) << precisionBits) {
+  if (precisionBits < 1 || precisionBits > 10)
+    throw std::invalid_argument("histogram precision must be 1..10 bits");
+  m_weights.assign(2 * m_halfSize + 1, 0.0);
+}
+
+void LogHistogram::Decay(double factor) {
+  if (!(factor >= 0 && factor <= 1))
+    throw std::invalid_argument("decay factor must be in 0..1");
+
+  double total = 0;
+  size_t first = m_weights.size();
+  size_t last = 0;
+  for (size_t i = 0; i < m_weights.size(); ++i) {
+    auto& weight = m_weights[i];
+    weight *= factor;
+    if (weight < negligibleWeight)
+      weight = 0;
+    if (weight == 0)
+      continue;
+
+    total += weight;
+    first = std::min(first, i);
+    last = i;
+  }
+
+  if (total == 0) {
+    Clear();
+    return;
+  }
+
+  // Значения, вес которых стал пренебрежимым, больше не экстремумы
+  m_min = std::max(m_min, GetBucketBounds(first).first);
+  m_max = std::min(m_max, GetBucketBounds(last).second);
+  m_sum *= total / m_totalWeight;
+  m_totalWeight = total;
+}
+
+void LogHistogram::Clear() {
+  std::fill(m_weights.begin(), m_weights.end(), 0.0);
+  m_totalWeight = 0;
+  m_sum = 0;
+  m_min = 0;
+  m_max = 0;
+}
+
+double LogHistogram::GetTotalWeight() const {
+  return m_totalWeight;
+}
+
+double LogHistogram::GetQuantile(double quantile) const {
+  if (m_totalWeight == 0)
+    return 0;
+  if (quantile <= 0)
+    return m_min;
+  if (quantile >= 1)
+    return m_max;
+
+  auto rank = quantile * m_totalWeight;
+  double cumulative = 0;
+  for (size_t i = 0; i < m_weights.size(); ++i) {
+    if (m_weights[i] == 0)
+      continue;
+
+    cumulative += m_weights[i];
+    if (cumulative >= rank) {
+      auto [low, high] = GetBucketBounds(i);
+      return std::clamp((low + high) / 2, m_min, m_max);
+    }
+  }
+  return m_max;
+}
+
+double LogHistogram::GetMin() const {
+  return m_min;
+}
+
+double LogHistogram::GetMax() const {
+  return m_max;
+}
+
+double LogHistogram::GetMean() const {
+  return m_totalWeight == 0 ? 0 : m_sum / m_totalWeight;
+}
+
+std::pair<double, double> LogHistogram::GetBucketBounds(size_t index) const {
+  if (index == m_halfSize) {
+    auto smallest = FromKey(m_lowestKey);
+    return {-smallest, smallest};
+  }
+
+  bool negative = index < m_halfSize;
+  auto offset = negative ? m_halfSize - index : index - m_halfSize;
+  auto key = m_lowestKey + offset - 1;
+  auto low = FromKey(key);
+  auto high = FromKey(key + 1);
+  if (negative)
+    return {-high, -low};
+  return {low, high};
+}
+
+double LogHistogram::FromKey(uint64_t key) const {
+  auto bits = key << (52 - m_precisionBits);
+  double value = 0;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
@@ -0,0 +1,150 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+#ifdef _WIN32
+string lastError() {
+  return "error " + to_string(GetLastError());
+}
+#else
+string lastError() {
+  return strerror(errno);
+}
+#endif
+}  // namespace
+
+MappedFile::MappedFile(const string& path, bool populate) {
+#ifdef _WIN32
+  // Windows загружает страницы по мере обращения, populate не используется
+  (void)populate;
+
+  auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                          OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    throw runtime_error("cannot open " + path + ": " + lastError());
+
+  LARGE_INTEGER size{};
+  if (!GetFileSizeEx(file, &size)) {
+    auto error = lastError();
+    CloseHandle(file);
+    throw runtime_error("cannot get size of " + path + ": " + error);
+  }
+  m_size = size_t(size.QuadPart);
+
+  if (m_size != 0) {
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping != nullptr)
+      m_data = static_cast<const char*>(
+          MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+      auto error = lastError();
+      if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+      CloseHandle(file);
+      throw runtime_error("cannot map " + path + ": " + error);
+    }
+  }
+  CloseHandle(file);
+#else
+  auto file = ::open(path.c_str(), O_RDONLY);
+  if (file < 0)
+    throw runtime_error("cannot open " + path + ": " + lastError());
+
+  struct stat status {};
+  if (fstat(file, &status) != 0) {
+    auto error = lastError();
+    ::close(file);
+    throw runtime_error("cannot get size of " + path + ": " + error);
+  }
+  m_size = size_t(status.st_size);
+
+  if (m_size != 0) {
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (populate)
+      flags |= MAP_POPULATE;
+#else
+    (void)populate;
+#endif
+    auto data = mmap(nullptr, m_size, PROT_READ, flags, file, 0);
+    if (data == MAP_FAILED) {
+      auto error = lastError();
+      ::close(file);
+      throw runtime_error("cannot map " + path + ": " + error);
+    }
+
+    // Разрешаем системе агрессивное упреждающее чтение
+    madvise(data, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const char*>(data);
+  }
+  // Отображение остается действительным после закрытия дескриптора
+  ::close(file);
+#endif
+
+  m_open = true;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+  *this = move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    m_data = exchange(other.m_data, nullptr);
+    m_size = exchange(other.m_size, 0);
+    m_open = exchange(other.m_open, false);
+#ifdef _WIN32
+    m_mapping = exchange(other.m_mapping, nullptr);
+#endif
+  }
+
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+const char* MappedFile::data() const {
+  return m_data;
+}
+
+size_t MappedFile::size() const {
+  return m_size;
+}
+
+bool MappedFile::isOpen() const {
+  return m_open;
+}
+
+void MappedFile::close() {
+  if (m_data != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+#else
+    munmap(const_cast<char*>(m_data), m_size);
+#endif
+  }
+
+  m_data = nullptr;
+  m_size = 0;
+  m_open = false;
+}
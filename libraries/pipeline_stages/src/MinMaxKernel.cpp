@@ -0,0 +1,65 @@
+#include "MinMaxKernel.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIN_MAX_KERNEL_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+/// Минимальное и максимальное значения
+std::pair<double, double> MinMaxValues(const double* values, size_t count) {
+  size_t i = 0;
+  double low = values[0];
+  double high = values[0];
+
+#ifdef MIN_MAX_KERNEL_SSE2
+  if (count >= 4) {
+    // Две пары регистров, чтобы соседние итерации не ждали друг друга
+    __m128d min0 = _mm_loadu_pd(values);
+    __m128d min1 = _mm_loadu_pd(values + 2);
+    __m128d max0 = min0;
+    __m128d max1 = min1;
+    for (i = 4; i + 4 <= count; i += 4) {
+      __m128d a = _mm_loadu_pd(values + i);
+      __m128d b = _mm_loadu_pd(values + i + 2);
+      min0 = _mm_min_pd(min0, a);
+      min1 = _mm_min_pd(min1, b);
+      max0 = _mm_max_pd(max0, a);
+      max1 = _mm_max_pd(max1, b);
+    }
+
+    double mins[2];
+    double maxs[2];
+    _mm_storeu_pd(mins, _mm_min_pd(min0, min1));
+    _mm_storeu_pd(maxs, _mm_max_pd(max0, max1));
+    low = std::min(mins[0], mins[1]);
+    high = std::max(maxs[0], maxs[1]);
+  }
+#endif
+
+  for (; i < count; ++i) {
+    low = std::min(low, values[i]);
+    high = std::max(high, values[i]);
+  }
+  return {low, high};
+}
+
+/// Первая позиция значения (0, если его нет)
+size_t IndexOf(const double* values, size_t count, double value) {
+  auto found = std::find(values, values + count, value) - values;
+  return size_t(found) < count ? size_t(found) : 0;
+}
+}  // namespace
+
+MinMaxIndices FindMinMax(const double* values, size_t count) noexcept(false) {
+  if (count == 0)
+    throw std::invalid_argument("no values to search");
+
+  auto [low, high] = MinMaxValues(values, count);
+  return {IndexOf(values, count, low), IndexOf(values, count, high)};
+}
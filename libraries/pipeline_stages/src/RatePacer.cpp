@@ -0,0 +1,52 @@
+#include "RatePacer.h"
+
+#include <SteadyClock.h>
+
+#include <stdexcept>
+
+using namespace std;
+
+RatePacer::RatePacer(double rate) {
+  Reset(rate);
+}
+
+void RatePacer::Reset(double rate) {
+  if (!(rate >= 0))
+    throw invalid_argument("rate must not be negative");
+
+  m_rate = rate;
+  m_count = 0;
+}
+
+bool RatePacer::WaitForNext(chrono::nanoseconds maxWait) {
+  if (m_rate == 0)
+    return true;
+
+  auto now = SteadyClock::nowNs();
+  if (m_count == 0)
+    m_started = now;
+
+  auto due = m_started + chrono::duration_cast<chrono::nanoseconds>(
+                             chrono::duration<double>(m_count / m_rate));
+  if (now - due > maxLag) {
+    // Конвейер долго не принимал элементы, не выдаем их пачкой
+    m_started = now;
+    m_count = 0;
+    due = now;
+  }
+
+  if (due > now) {
+    if (due - now > maxWait) {
+      SteadyClock::waitUntilNs(now + maxWait);
+      return false;
+    }
+    SteadyClock::waitUntilNs(due);
+  }
+
+  ++m_count;
+  return true;
+}
+
+double RatePacer::GetRate() const {
+  return m_rate;
+}
@@ -0,0 +1,553 @@
+#include "SampleCodec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SAMPLE_CODEC_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+const char blockMagic[4] = {'E', 'C', 'Z', '1'};
+
+struct BlockHeader {
+  char magic[4];
+  uint8_t compression;
+  uint8_t sampleSize;
+  uint16_t reserved;
+  uint32_t count;        ///< Число отсчетов
+  uint32_t payloadSize;  ///< Размер сжатых данных после заголовка
+};
+static_assert(sizeof(BlockHeader) == SampleCodec::headerSize,
+              "unexpected block header layout");
+
+/// Отсчетов в группе bitPacked: по 32 в каждой из 4 полос по 32 бита
+constexpr size_t packedGroupSize = 128;
+constexpr size_t packedLanes = 4;
+
+const std::map<std::string, SampleCompression> compressionNames = {
+    {"none", SampleCompression::none},
+    {"delta", SampleCompression::delta},
+    {"deltaOfDelta", SampleCompression::deltaOfDelta},
+    {"bitPacked", SampleCompression::bitPacked},
+    {"gorilla", SampleCompression::gorilla}};
+
+size_t SampleSize(SampleCompression compression) {
+  return compression == SampleCompression::gorilla ? sizeof(uint64_t)
+                                                   : sizeof(uint32_t);
+}
+
+uint32_t ZigZag(uint32_t value) {
+  return (value << 1) ^ (0u - (value >> 31));
+}
+
+uint32_t UnZigZag(uint32_t value) {
+  return (value >> 1) ^ (0u - (value & 1));
+}
+
+unsigned BitWidth(uint32_t value) {
+  unsigned width = 0;
+  for (; value != 0; value >>= 1)
+    ++width;
+  return width;
+}
+
+unsigned LeadingZeros(uint64_t value) {
+#ifdef _MSC_VER
+  unsigned long index = 0;
+  _BitScanReverse64(&index, value);
+  return 63 - unsigned(index);
+#else
+  return unsigned(__builtin_clzll(value));
+#endif
+}
+
+unsigned TrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+  unsigned long index = 0;
+  _BitScanForward64(&index, value);
+  return unsigned(index);
+#else
+  return unsigned(__builtin_ctzll(value));
+#endif
+}
+
+template <typename Value>
+std::vector<Value> ReadValues(const char* data, size_t size) {
+  std::vector<Value> values(size / sizeof(Value));
+  if (!values.empty())
+    std::memcpy(values.data(), data, values.size() * sizeof(Value));
+  return values;
+}
+
+template <typename Value>
+void AppendValues(const std::vector<Value>& values, std::vector<char>& out) {
+  if (values.empty())
+    return;
+  auto offset = out.size();
+  out.resize(offset + values.size() * sizeof(Value));
+  std::memcpy(out.data() + offset, values.data(),
+              values.size() * sizeof(Value));
+}
+
+[[noreturn]] void ThrowTruncated() {
+  throw std::runtime_error("Compressed block is truncated");
+}
+
+/// Запись битов, начиная со старших
+class BitWriter {
+ public:
+  explicit BitWriter(std::vector<char>& out) : m_out(out) {}
+
+  void Write(uint64_t value, unsigned count) {
+    if (count > 32) {
+      Write(value >> 32, count - 32);
+      value &= 0xFFFFFFFFu;
+      count = 32;
+    }
+    if (count == 0)
+      return;
+
+    value &= (uint64_t(1) << count) - 1;
+    m_buffer = (m_buffer << count) | value;
+    m_bits += count;
+    while (m_bits >= 8) {
+      m_bits -= 8;
+      m_out.push_back(char(uint8_t(m_buffer >> m_bits)));
+    }
+    m_buffer &= (uint64_t(1) << m_bits) - 1;
+  }
+
+  /// Дописать неполный байт
+  void Finish() {
+    if (m_bits != 0)
+      m_out.push_back(char(uint8_t(m_buffer << (8 - m_bits))));
+    m_buffer = 0;
+    m_bits = 0;
+  }
+
+ private:
+  std::vector<char>& m_out;
+  uint64_t m_buffer = 0;  ///< Еще не записанные биты (меньше 8)
+  unsigned m_bits = 0;
+};
+
+/// Чтение битов, записанных BitWriter
+class BitReader {
+ public:
+  BitReader(const char* data, size_t size)
+      : m_data(reinterpret_cast<const uint8_t*>(data)), m_bitsCount(size * 8) {}
+
+  uint64_t Read(unsigned count) {
+    if (count > 32) {
+      auto high = Read(count - 32);
+      return (high << 32) | Read(32);
+    }
+    if (m_position + count > m_bitsCount)
+      ThrowTruncated();
+
+    uint64_t result = 0;
+    while (count > 0) {
+      auto available = 8 - unsigned(m_position % 8);
+      auto taken = std::min(available, count);
+      auto bits = (m_data[m_position / 8] >> (available - taken)) &
+                  ((1u << taken) - 1);
+      result = (result << taken) | bits;
+      count -= taken;
+      m_position += taken;
+    }
+    return result;
+  }
+
+ private:
+  const uint8_t* m_data;
+  size_t m_bitsCount;
+  size_t m_position = 0;
+};
+
+void WriteVarint(uint32_t value, std::vector<char>& out) {
+  while (value >= 0x80) {
+    out.push_back(char(uint8_t(value | 0x80)));
+    value >>= 7;
+  }
+  out.push_back(char(uint8_t(value)));
+}
+
+uint32_t ReadVarint(const char*& data, const char* end) {
+  uint32_t value = 0;
+  for (unsigned shift = 0; shift < 35; shift += 7) {
+    if (data == end)
+      ThrowTruncated();
+    auto byte = uint8_t(*data++);
+    value |= uint32_t(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return value;
+  }
+  throw std::runtime_error("Compressed block has invalid varint");
+}
+
+// Разности считаются по модулю 2^32, поэтому переполнения не страшны
+
+void EncodeDeltas(const std::vector<uint32_t>& values,
+                  bool secondOrder,
+                  std::vector<char>& out) {
+  uint32_t previous = 0;
+  uint32_t previousDelta = 0;
+  for (auto value : values) {
+    uint32_t delta = value - previous;
+    previous = value;
+    WriteVarint(ZigZag(secondOrder ? delta - previousDelta : delta), out);
+    previousDelta = delta;
+  }
+}
+
+std::vector<uint32_t> DecodeDeltas(const char* data,
+                                   size_t size,
+                                   size_t count,
+                                   bool secondOrder) {
+  std::vector<uint32_t> values(count);
+  auto end = data + size;
+  uint32_t previous = 0;
+  uint32_t previousDelta = 0;
+  for (auto& value : values) {
+    auto delta = UnZigZag(ReadVarint(data, end));
+    if (secondOrder)
+      delta += previousDelta;
+    previousDelta = delta;
+    value = previous += delta;
+  }
+  return values;
+}
+
+// bitPacked: группа из 128 разностей - байт с разрядностью b и b слов по 128
+// бит. Разность i лежит в полосе i % 4 (32-битной части слов) под номером
+// i / 4, так что 4 полосы распаковываются одновременно.
+
+void EncodeBitPacked(const std::vector<uint32_t>& values,
+                     std::vector<char>& out) {
+  uint32_t previous = 0;
+  for (size_t start = 0; start < values.size(); start += packedGroupSize) {
+    uint32_t deltas[packedGroupSize] = {};
+    uint32_t all = 0;
+    auto count = std::min(packedGroupSize, values.size() - start);
+    for (size_t i = 0; i < count; ++i) {
+      deltas[i] = ZigZag(values[start + i] - previous);
+      previous = values[start + i];
+      all |= deltas[i];
+    }
+
+    auto width = BitWidth(all);
+    out.push_back(char(uint8_t(width)));
+    uint32_t words[32 * packedLanes] = {};
+    for (size_t lane = 0; lane < packedLanes; ++lane) {
+      for (size_t j = 0, bit = 0; j < packedGroupSize / packedLanes;
+           ++j, bit += width) {
+        auto value = deltas[j * packedLanes + lane];
+        auto word = bit / 32;
+        auto offset = bit % 32;
+        words[word * packedLanes + lane] |= value << offset;
+        if (offset + width > 32)
+          words[(word + 1) * packedLanes + lane] |= value >> (32 - offset);
+      }
+    }
+
+    auto offset = out.size();
+    auto size = width * packedLanes * sizeof(uint32_t);
+    out.resize(offset + size);
+    std::memcpy(out.data() + offset, words, size);
+  }
+}
+
+/// Распаковать группу из 128 zigzag-разностей разрядности width
+void UnpackGroup(const char* words, unsigned width, uint32_t* deltas) {
+  if (width == 0) {
+    std::fill(deltas, deltas + packedGroupSize, 0u);
+    return;
+  }
+
+#ifdef SAMPLE_CODEC_SSE2
+  const auto mask = _mm_set1_epi32(
+      int(width == 32 ? 0xFFFFFFFFu : (1u << width) - 1));
+  const auto one = _mm_set1_epi32(1);
+  const auto zero = _mm_setzero_si128();
+  auto input = reinterpret_cast<const __m128i*>(words);
+  auto current = _mm_loadu_si128(input);
+  unsigned shift = 0;
+  for (size_t j = 0; j < packedGroupSize / packedLanes; ++j) {
+    auto value = _mm_srl_epi32(current, _mm_cvtsi32_si128(int(shift)));
+    shift += width;
+    if (shift >= 32 && j + 1 < packedGroupSize / packedLanes) {
+      // Значение продолжается в следующем слове
+      current = _mm_loadu_si128(++input);
+      shift -= 32;
+      if (shift != 0)
+        value = _mm_or_si128(
+            value,
+            _mm_sll_epi32(current, _mm_cvtsi32_si128(int(width - shift))));
+    }
+    value = _mm_and_si128(value, mask);
+    // zigzag: (v >> 1) ^ -(v & 1)
+    value = _mm_xor_si128(_mm_srli_epi32(value, 1),
+                          _mm_sub_epi32(zero, _mm_and_si128(value, one)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(deltas + j * packedLanes),
+                     value);
+  }
+#else
+  uint32_t lanes[32 * packedLanes];
+  std::memcpy(lanes, words, width * packedLanes * sizeof(uint32_t));
+  const uint32_t mask = width == 32 ? 0xFFFFFFFFu : (1u << width) - 1;
+  for (size_t lane = 0; lane < packedLanes; ++lane) {
+    for (size_t j = 0, bit = 0; j < packedGroupSize / packedLanes;
+         ++j, bit += width) {
+      auto word = bit / 32;
+      auto offset = bit % 32;
+      uint32_t value = lanes[word * packedLanes + lane] >> offset;
+      if (offset + width > 32)
+        value |= lanes[(word + 1) * packedLanes + lane] << (32 - offset);
+      deltas[j * packedLanes + lane] = UnZigZag(value & mask);
+    }
+  }
+#endif
+}
+
+std::vector<uint32_t> DecodeBitPacked(const char* data,
+                                      size_t size,
+                                      size_t count) {
+  std::vector<uint32_t> values(count);
+  auto end = data + size;
+  uint32_t previous = 0;
+  for (size_t start = 0; start < count; start += packedGroupSize) {
+    if (data == end)
+      ThrowTruncated();
+    unsigned width = uint8_t(*data++);
+    if (width > 32)
+      throw std::runtime_error("Compressed block has invalid bit width");
+    auto groupSize = width * packedLanes * sizeof(uint32_t);
+    if (size_t(end - data) < groupSize)
+      ThrowTruncated();
+
+    uint32_t deltas[packedGroupSize];
+    UnpackGroup(data, width, deltas);
+    data += groupSize;
+
+    auto groupCount = std::min(packedGroupSize, count - start);
+    for (size_t i = 0; i < groupCount; ++i)
+      values[start + i] = previous += deltas[i];
+  }
+  return values;
+}
+
+// gorilla: первое значение целиком, далее XOR с предыдущим: 0 - совпадает,
+// 10 - значащие биты внутри прежнего окна, 11 - 5 бит числа старших нулей,
+// 6 бит длины (0 означает 64) и значащие биты.
+
+void EncodeGorilla(const std::vector<uint64_t>& values,
+                   std::vector<char>& out) {
+  BitWriter writer(out);
+  uint64_t previous = 0;
+  unsigned windowLeading = 0;
+  unsigned windowTrailing = 0;
+  bool hasWindow = false;
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto value = values[i];
+    if (i == 0) {
+      writer.Write(value, 64);
+      previous = value;
+      continue;
+    }
+
+    auto difference = value ^ previous;
+    previous = value;
+    if (difference == 0) {
+      writer.Write(0, 1);
+      continue;
+    }
+
+    auto leading = std::min(LeadingZeros(difference), 31u);
+    auto trailing = TrailingZeros(difference);
+    if (hasWindow && leading >= windowLeading && trailing >= windowTrailing) {
+      writer.Write(0b10, 2);
+      writer.Write(difference >> windowTrailing,
+                   64 - windowLeading - windowTrailing);
+      continue;
+    }
+
+    auto length = 64 - leading - trailing;
+    writer.Write(0b11, 2);
+    writer.Write(leading, 5);
+    writer.Write(length == 64 ? 0 : length, 6);
+    writer.Write(difference >> trailing, length);
+    windowLeading = leading;
+    windowTrailing = trailing;
+    hasWindow = true;
+  }
+  writer.Finish();
+}
+
+std::vector<uint64_t> DecodeGorilla(const char* data,
+                                    size_t size,
+                                    size_t count) {
+  std::vector<uint64_t> values(count);
+  BitReader reader(data, size);
+  uint64_t previous = 0;
+  unsigned windowLeading = 0;
+  unsigned windowTrailing = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (i == 0) {
+      values[i] = previous = reader.Read(64);
+      continue;
+    }
+
+    if (reader.Read(1) != 0) {
+      if (reader.Read(1) != 0) {
+        windowLeading = unsigned(reader.Read(5));
+        auto length = unsigned(reader.Read(6));
+        if (length == 0)
+          length = 64;
+        if (windowLeading + length > 64)
+          throw std::runtime_error("Compressed block has invalid window");
+        windowTrailing = 64 - windowLeading - length;
+      }
+      previous ^= reader.Read(64 - windowLeading - windowTrailing)
+                  << windowTrailing;
+    }
+    values[i] = previous;
+  }
+  return values;
+}
+}  // namespace
+
+SampleCompression SampleCodec::ParseCompression(
+    const std::string& name) noexcept(false) {
+  auto compression = compressionNames.find(name);
+  if (compression == compressionNames.end())
+    throw std::invalid_argument("Unknown compression " + name);
+  return compression->second;
+}
+
+std::string SampleCodec::GetCompressionName(SampleCompression compression) {
+  for (auto&& [name, value] : compressionNames) {
+    if (value == compression)
+      return name;
+  }
+  throw std::invalid_argument("Unknown compression " +
+                              std::to_string(int(compression)));
+}
+
+void SampleCodec::Encode(SampleCompression compression,
+                         const char* data,
+                         size_t size,
+                         std::vector<char>& out) noexcept(false) {
+  if (compression == SampleCompression::none) {
+    out.insert(out.end(), data, data + size);
+    return;
+  }
+
+  auto sampleSize = SampleSize(compression);
+  if (size % sampleSize != 0)
+    throw std::invalid_argument("Data size is not a multiple of sample size");
+  if (size / sampleSize > UINT32_MAX)
+    throw std::invalid_argument("Too many samples for one block");
+
+  auto headerOffset = out.size();
+  out.resize(headerOffset + headerSize);
+
+  switch (compression) {
+    case SampleCompression::delta:
+    case SampleCompression::deltaOfDelta:
+      EncodeDeltas(ReadValues<uint32_t>(data, size),
+                   compression == SampleCompression::deltaOfDelta, out);
+      break;
+    case SampleCompression::bitPacked:
+      EncodeBitPacked(ReadValues<uint32_t>(data, size), out);
+      break;
+    case SampleCompression::gorilla:
+      EncodeGorilla(ReadValues<uint64_t>(data, size), out);
+      break;
+    case SampleCompression::none:
+      break;
+  }
+
+  BlockHeader header{};
+  std::memcpy(header.magic, blockMagic, sizeof(blockMagic));
+  header.compression = uint8_t(compression);
+  header.sampleSize = uint8_t(sampleSize);
+  header.count = uint32_t(size / sampleSize);
+  header.payloadSize = uint32_t(out.size() - headerOffset - headerSize);
+  std::memcpy(out.data() + headerOffset, &header, sizeof(header));
+}
+
+bool SampleCodec::IsEncoded(const char* data, size_t size) {
+  return size >= sizeof(blockMagic) &&
+         std::memcmp(data, blockMagic, sizeof(blockMagic)) == 0;
+}
+
+void SampleStreamDecoder::Decode(const char* data,
+                                 size_t size,
+                                 std::vector<char>& out) noexcept(false) {
+  m_pending.insert(m_pending.end(), data, data + size);
+
+  size_t offset = 0;
+  try {
+    while (m_pending.size() - offset >= SampleCodec::headerSize) {
+      BlockHeader header;
+      std::memcpy(&header, m_pending.data() + offset, sizeof(header));
+      auto compression = SampleCompression(header.compression);
+      if (!SampleCodec::IsEncoded(header.magic, sizeof(header.magic)) ||
+          compression == SampleCompression::none ||
+          compression > SampleCompression::gorilla ||
+          header.sampleSize != SampleSize(compression))
+        throw std::runtime_error("Invalid compressed block header");
+      // Любой способ тратит не меньше бита на отсчет (bitPacked - на группу)
+      if (header.count > uint64_t(header.payloadSize) * packedGroupSize + 1)
+        throw std::runtime_error("Invalid compressed block size");
+
+      if (m_pending.size() - offset - SampleCodec::headerSize <
+          header.payloadSize)
+        break;
+
+      auto payload = m_pending.data() + offset + SampleCodec::headerSize;
+      switch (compression) {
+        case SampleCompression::delta:
+        case SampleCompression::deltaOfDelta:
+          AppendValues(
+              DecodeDeltas(payload, header.payloadSize, header.count,
+                           compression == SampleCompression::deltaOfDelta),
+              out);
+          break;
+        case SampleCompression::bitPacked:
+          AppendValues(
+              DecodeBitPacked(payload, header.payloadSize, header.count), out);
+          break;
+        case SampleCompression::gorilla:
+          AppendValues(DecodeGorilla(payload, header.payloadSize, header.count),
+                       out);
+          break;
+        case SampleCompression::none:
+          break;
+      }
+      offset += SampleCodec::headerSize + header.payloadSize;
+    }
+  } catch (...) {
+    m_pending.clear();
+    throw;
+  }
+
+  m_pending.erase(m_pending.begin(), m_pending.begin() + offset);
+}
+
+bool SampleStreamDecoder::HasIncompleteBlock() const {
+  return !m_pending.empty();
+}
+
+void SampleStreamDecoder::Reset() {
+  m_pending.clear();
+}
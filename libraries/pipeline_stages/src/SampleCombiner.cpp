@@ -0,0 +1,56 @@
+#include "SampleCombiner.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+CombineOperation CombineOperationFromString(
+    const std::string& name) noexcept(false) {
+  if (name == "sum")
+    return CombineOperation::sum;
+  if (name == "difference")
+    return CombineOperation::difference;
+  if (name == "product")
+    return CombineOperation::product;
+  if (name == "ratio")
+    return CombineOperation::ratio;
+  if (name == "mean")
+    return CombineOperation::mean;
+  if (name == "min")
+    return CombineOperation::min;
+  if (name == "max")
+    return CombineOperation::max;
+  throw std::invalid_argument("Unknown combine operation " + name);
+}
+
+double Combine(CombineOperation operation,
+               const double* values,
+               size_t count) {
+  double result = values[0];
+  for (size_t i = 1; i < count; ++i) {
+    switch (operation) {
+      case CombineOperation::sum:
+      case CombineOperation::mean:
+        result += values[i];
+        break;
+      case CombineOperation::difference:
+        result -= values[i];
+        break;
+      case CombineOperation::product:
+        result *= values[i];
+        break;
+      case CombineOperation::ratio:
+        result /= values[i];
+        break;
+      case CombineOperation::min:
+        result = std::min(result, values[i]);
+        break;
+      case CombineOperation::max:
+        result = std::max(result, values[i]);
+        break;
+    }
+  }
+
+  if (operation == CombineOperation::mean)
+    result /= double(count);
+  return result;
+}
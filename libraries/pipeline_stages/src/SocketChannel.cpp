@@ -0,0 +1,426 @@
+#include "SocketChannel.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+#else
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr auto unixPrefix = "unix:";
+constexpr auto tcpPrefix = "tcp:";
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+using NativeBuffer = WSABUF;
+constexpr size_t maxBuffersPerCall = 64;
+
+struct WinsockInitializer {
+  WinsockInitializer() {
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+  }
+  ~WinsockInitializer() { WSACleanup(); }
+};
+
+void initializeSockets() {
+  static WinsockInitializer initializer;
+}
+
+string lastError() {
+  return "error " + to_string(WSAGetLastError());
+}
+
+bool interrupted() {
+  return WSAGetLastError() == WSAEINTR;
+}
+
+void closeSocket(NativeSocket socket) {
+  closesocket(socket);
+}
+
+int pollSocket(pollfd* fd, int timeout) {
+  return WSAPoll(fd, 1, timeout);
+}
+
+NativeBuffer makeBuffer(const SocketChannel::Buffer& buffer) {
+  return {ULONG(buffer.size),
+          static_cast<char*>(const_cast<void*>(buffer.data))};
+}
+#else
+using NativeSocket = int;
+using NativeBuffer = iovec;
+constexpr size_t maxBuffersPerCall = IOV_MAX;
+
+void initializeSockets() {}
+
+string lastError() {
+  return strerror(errno);
+}
+
+bool interrupted() {
+  return errno == EINTR;
+}
+
+void closeSocket(NativeSocket socket) {
+  ::close(socket);
+}
+
+int pollSocket(pollfd* fd, int timeout) {
+  return ::poll(fd, 1, timeout);
+}
+
+NativeBuffer makeBuffer(const SocketChannel::Buffer& buffer) {
+  return {const_cast<void*>(buffer.data), buffer.size};
+}
+#endif
+
+NativeSocket native(intptr_t socket) {
+  return static_cast<NativeSocket>(socket);
+}
+
+size_t length(const NativeBuffer& buffer) {
+#ifdef _WIN32
+  return buffer.len;
+#else
+  return buffer.iov_len;
+#endif
+}
+
+void skip(NativeBuffer& buffer, size_t bytes) {
+#ifdef _WIN32
+  buffer.buf += bytes;
+  buffer.len -= ULONG(bytes);
+#else
+  buffer.iov_base = static_cast<char*>(buffer.iov_base) + bytes;
+  buffer.iov_len -= bytes;
+#endif
+}
+
+struct ResolvedAddress {
+  sockaddr_storage storage{};
+  socklen_t length = 0;
+  bool isUnix = false;
+};
+
+ResolvedAddress resolve(const string& address, bool passive) {
+  ResolvedAddress result;
+
+  if (address.rfind(unixPrefix, 0) == 0) {
+    auto path = address.substr(strlen(unixPrefix));
+    sockaddr_un unixAddress{};
+    if (path.empty() || path.size() >= sizeof(unixAddress.sun_path))
+      throw invalid_argument("invalid unix socket path in " + address);
+
+    unixAddress.sun_family = AF_UNIX;
+    memcpy(unixAddress.sun_path, path.c_str(), path.size() + 1);
+    memcpy(&result.storage, &unixAddress, sizeof(unixAddress));
+    result.length = socklen_t(sizeof(unixAddress));
+    result.isUnix = true;
+    return result;
+  }
+
+  if (address.rfind(tcpPrefix, 0) == 0) {
+    auto hostAndPort = address.substr(strlen(tcpPrefix));
+    auto separator = hostAndPort.rfind(':');
+    if (separator == string::npos || separator + 1 == hostAndPort.size())
+      throw invalid_argument("port is not specified in " + address);
+
+    auto host = hostAndPort.substr(0, separator);
+    auto port = hostAndPort.substr(separator + 1);
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+    addrinfo* info = nullptr;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(),
+                    &hints, &info) != 0 ||
+        info == nullptr)
+      throw SocketChannelException("cannot resolve " + address);
+
+    memcpy(&result.storage, info->ai_addr, info->ai_addrlen);
+    result.length = socklen_t(info->ai_addrlen);
+    freeaddrinfo(info);
+    return result;
+  }
+
+  throw invalid_argument("unknown socket address " + address +
+                         ", expected unix:<path> or tcp:<host>:<port>");
+}
+
+NativeSocket openSocket(const ResolvedAddress& address) {
+  initializeSockets();
+
+  auto socket = ::socket(address.storage.ss_family, SOCK_STREAM, 0);
+  if (socket == native(-1))
+    throw SocketChannelException("cannot create socket: " + lastError());
+
+  return socket;
+}
+
+void setNoDelay(NativeSocket socket, const string& address) {
+  if (address.rfind(tcpPrefix, 0) != 0)
+    return;
+
+  // frames are already batched, do not delay them further
+  int enable = 1;
+  setsockopt(socket, IPPROTO_TCP, TCP_NODELAY,
+             reinterpret_cast<const char*>(&enable), sizeof(enable));
+}
+
+}  // namespace
+
+SocketChannel::SocketChannel(intptr_t socket, string address)
+    : m_socket(socket), m_address(move(address)) {}
+
+SocketChannel::SocketChannel(SocketChannel&& other) noexcept {
+  *this = move(other);
+}
+
+SocketChannel& SocketChannel::operator=(SocketChannel&& other) noexcept {
+  if (this != &other) {
+    close();
+    m_socket = exchange(other.m_socket, -1);
+    m_address = move(other.m_address);
+    m_listening = exchange(other.m_listening, false);
+  }
+
+  return *this;
+}
+
+SocketChannel::~SocketChannel() {
+  close();
+}
+
+SocketChannel SocketChannel::listen(const string& address) {
+  auto resolved = resolve(address, true);
+  auto socket = openSocket(resolved);
+
+  if (resolved.isUnix)
+    remove(address.substr(strlen(unixPrefix)).c_str());
+  else {
+    int enable = 1;
+    setsockopt(socket, SOL_SOCKET, SO_REUSEADDR,
+               reinterpret_cast<const char*>(&enable), sizeof(enable));
+  }
+
+  if (::bind(socket, reinterpret_cast<const sockaddr*>(&resolved.storage),
+             resolved.length) != 0 ||
+      ::listen(socket, SOMAXCONN) != 0) {
+    auto error = lastError();
+    closeSocket(socket);
+    throw SocketChannelException("cannot listen on " + address + ": " +
+                                 error);
+  }
+
+  SocketChannel channel(intptr_t(socket), address);
+  channel.m_listening = true;
+  return channel;
+}
+
+SocketChannel SocketChannel::connect(const string& address) {
+  auto resolved = resolve(address, false);
+  auto socket = openSocket(resolved);
+
+  if (::connect(socket, reinterpret_cast<const sockaddr*>(&resolved.storage),
+                resolved.length) != 0) {
+    auto error = lastError();
+    closeSocket(socket);
+    throw SocketChannelException("cannot connect to " + address + ": " +
+                                 error);
+  }
+
+  setNoDelay(socket, address);
+#ifdef SO_NOSIGPIPE
+  int enable = 1;
+  setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+
+  return SocketChannel(intptr_t(socket), address);
+}
+
+SocketChannel SocketChannel::accept(chrono::milliseconds timeout) {
+  if (!m_listening)
+    throw SocketChannelException("socket is not listening");
+
+  if (!waitReadable(timeout))
+    return SocketChannel();
+
+  auto socket = ::accept(native(m_socket), nullptr, nullptr);
+  if (socket == native(-1)) {
+    if (interrupted())
+      return SocketChannel();
+    throw SocketChannelException("cannot accept connection on " + m_address +
+                                 ": " + lastError());
+  }
+
+  setNoDelay(socket, m_address);
+#ifdef SO_NOSIGPIPE
+  int enable = 1;
+  setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+
+  return SocketChannel(intptr_t(socket), m_address);
+}
+
+string SocketChannel::localAddress() const {
+  if (!isOpen() || m_address.rfind(tcpPrefix, 0) != 0)
+    return m_address;
+
+  sockaddr_storage storage{};
+  socklen_t length = sizeof(storage);
+  if (getsockname(native(m_socket), reinterpret_cast<sockaddr*>(&storage),
+                  &length) != 0)
+    return m_address;
+
+  char host[NI_MAXHOST];
+  char port[NI_MAXSERV];
+  if (getnameinfo(reinterpret_cast<const sockaddr*>(&storage), length, host,
+                  sizeof(host), port, sizeof(port),
+                  NI_NUMERICHOST | NI_NUMERICSERV) != 0)
+    return m_address;
+
+  return string(tcpPrefix) + host + ":" + port;
+}
+
+bool SocketChannel::waitReadable(chrono::milliseconds timeout) const {
+  if (!isOpen())
+    throw SocketChannelException("socket is closed");
+
+  pollfd fd{};
+  fd.fd = native(m_socket);
+  fd.events = POLLIN;
+
+  int result = pollSocket(&fd, int(max<int64_t>(0, timeout.count())));
+  if (result < 0 && !interrupted())
+    throw SocketChannelException("poll failed on " + m_address + ": " +
+                                 lastError());
+
+  // hang up and errors are reported by the following read
+  return result > 0;
+}
+
+void SocketChannel::send(const Buffer* buffers, size_t count) {
+  if (!isOpen())
+    throw SocketChannelException("socket is closed");
+
+  vector<NativeBuffer> pending;
+  pending.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (buffers[i].size > 0)
+      pending.push_back(makeBuffer(buffers[i]));
+  }
+
+  size_t first = 0;
+  while (first < pending.size()) {
+    auto chunk = min(pending.size() - first, maxBuffersPerCall);
+    size_t written = 0;
+
+#ifdef _WIN32
+    DWORD sent = 0;
+    if (WSASend(native(m_socket), &pending[first], DWORD(chunk), &sent, 0,
+                nullptr, nullptr) != 0) {
+      if (interrupted())
+        continue;
+      throw SocketChannelException("send failed on " + m_address + ": " +
+                                   lastError());
+    }
+    written = sent;
+#else
+    msghdr message{};
+    message.msg_iov = &pending[first];
+    message.msg_iovlen = chunk;
+#ifdef MSG_NOSIGNAL
+    constexpr int flags = MSG_NOSIGNAL;
+#else
+    constexpr int flags = 0;
+#endif
+    auto sent = ::sendmsg(native(m_socket), &message, flags);
+    if (sent < 0) {
+      if (interrupted())
+        continue;
+      throw SocketChannelException("send failed on " + m_address + ": " +
+                                   lastError());
+    }
+    written = size_t(sent);
+#endif
+
+    // drop fully written buffers and shift the partially written one
+    while (first < pending.size() && written >= length(pending[first]))
+      written -= length(pending[first++]);
+    if (written > 0)
+      skip(pending[first], written);
+  }
+}
+
+bool SocketChannel::receive(void* data,
+                            size_t size,
+                            chrono::milliseconds timeout) {
+  if (!waitReadable(timeout))
+    return false;
+
+  auto bytes = static_cast<char*>(data);
+  size_t received = 0;
+  while (received < size) {
+    if (received > 0 && !waitReadable(messageTimeout))
+      throw SocketChannelException("incomplete message on " + m_address);
+
+#ifdef _WIN32
+    auto result = ::recv(native(m_socket), bytes + received,
+                         int(min<size_t>(size - received, INT_MAX)), 0);
+#else
+    auto result = ::recv(native(m_socket), bytes + received, size - received,
+                         0);
+#endif
+    if (result == 0)
+      throw SocketChannelException("connection closed on " + m_address);
+    if (result < 0) {
+      if (interrupted())
+        continue;
+      throw SocketChannelException("receive failed on " + m_address + ": " +
+                                   lastError());
+    }
+
+    received += size_t(result);
+  }
+
+  return true;
+}
+
+bool SocketChannel::isOpen() const {
+  return m_socket != -1;
+}
+
+void SocketChannel::close() {
+  if (!isOpen())
+    return;
+
+  closeSocket(native(m_socket));
+  m_socket = -1;
+
+  if (m_listening && m_address.rfind(unixPrefix, 0) == 0)
+    remove(m_address.substr(strlen(unixPrefix)).c_str());
+  m_listening = false;
+}
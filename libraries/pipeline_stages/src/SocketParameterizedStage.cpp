@@ -0,0 +1,38 @@
+#include "SocketParameterizedStage.h"
+
+#include <stdexcept>
+
+SocketParameterizedStage::SocketParameterizedStage() {
+  AddParameter("address",
+               L"Адрес сокета (unix:<путь> или tcp:<хост>:<порт>)", "");
+}
+
+void SocketParameterizedStage::ApplyParameterValues() noexcept(false) {
+  m_isApliedParams = false;
+
+  if (GetAddress().empty())
+    throw std::invalid_argument("Socket address is not set");
+
+  ResetChannel();
+
+  m_isApliedParams = true;
+}
+
+bool SocketParameterizedStage::IsFullyParameterized() const {
+  return m_isApliedParams;
+}
+
+std::wstring SocketParameterizedStage::GetHelpString() const {
+  return L"Стадии передачи задач через сокет соединяют конвейеры, "
+         L"запущенные в разных процессах.\n"
+         L"Стадия чтения ожидает подключения по заданному адресу, стадия "
+         L"записи подключается к нему.\n"
+         L"Адрес задается в виде unix:<путь к файлу сокета> или "
+         L"tcp:<хост>:<порт>.\n"
+         L"Стадия записи отправляет задачи пакетами и не передает больше "
+         L"задач, чем разрешила стадия чтения.";
+}
+
+std::string SocketParameterizedStage::GetAddress() const {
+  return GetParameter("address");
+}
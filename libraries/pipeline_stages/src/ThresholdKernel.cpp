@@ -0,0 +1,42 @@
+#include "ThresholdKernel.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define THRESHOLD_KERNEL_SSE2
+#include <emmintrin.h>
+#endif
+
+size_t FindFirstOutside(const double* values,
+                        size_t count,
+                        double low,
+                        double high) {
+  size_t i = 0;
+
+#ifdef THRESHOLD_KERNEL_SSE2
+  const __m128d lows = _mm_set1_pd(low);
+  const __m128d highs = _mm_set1_pd(high);
+  for (; i + 4 <= count; i += 4) {
+    __m128d a = _mm_loadu_pd(values + i);
+    __m128d b = _mm_loadu_pd(values + i + 2);
+    __m128d outsideA =
+        _mm_or_pd(_mm_cmple_pd(a, lows), _mm_cmpge_pd(a, highs));
+    __m128d outsideB =
+        _mm_or_pd(_mm_cmple_pd(b, lows), _mm_cmpge_pd(b, highs));
+    int mask = _mm_movemask_pd(outsideA) | (_mm_movemask_pd(outsideB) << 2);
+    if (mask == 0)
+      continue;
+
+    // Бит j маски - значение i + j
+    for (size_t j = 0;; ++j) {
+      if ((mask >> j) & 1)
+        return i + j;
+    }
+  }
+#endif
+
+  for (; i < count; ++i) {
+    if (values[i] <= low || values[i] >= high)
+      return i;
+  }
+  return count;
+}
@@ -0,0 +1,153 @@
+#include "TriggerDetector.h"
+
+#include "ThresholdKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+constexpr double disabled = std::numeric_limits<double>::quiet_NaN();
+}  // namespace
+
+TriggerDetector::TriggerDetector(const Settings& settings) noexcept(false)
+    : m_settings(settings) {
+  if (!std::isfinite(settings.level) || !std::isfinite(settings.hysteresis) ||
+      settings.hysteresis < 0)
+    throw std::invalid_argument(
+        "trigger level must be finite and hysteresis non-negative");
+  if (settings.postSamples == 0)
+    throw std::invalid_argument("event must include the trigger sample");
+  if (settings.preSamples + settings.postSamples > TriggerEvent::maxSamples)
+    throw std::invalid_argument("event must not exceed " +
+                                std::to_string(TriggerEvent::maxSamples) +
+                                " samples");
+
+  bool rising = settings.edge != Edge::falling;
+  bool falling = settings.edge != Edge::rising;
+  m_armRise = rising ? settings.level - settings.hysteresis : disabled;
+  m_armFall = falling ? settings.level + settings.hysteresis : disabled;
+
+  // История вмещает окна события, сработавшего в начале прохода
+  size_t historySize = 1;
+  while (historySize < settings.preSamples + settings.postSamples + chunkSize)
+    historySize *= 2;
+  m_history.assign(historySize, 0.0);
+  m_historyMask = historySize - 1;
+  m_events.resize(maxEvents);
+}
+
+void TriggerDetector::Process(const double* values,
+                              size_t count,
+                              int64_t nowUs) {
+  while (count > 0) {
+    auto chunk = std::min(count, chunkSize);
+
+    auto position = size_t(m_total & m_historyMask);
+    auto first = std::min(chunk, m_history.size() - position);
+    std::memcpy(m_history.data() + position, values, first * sizeof(double));
+    std::memcpy(m_history.data(), values + first,
+                (chunk - first) * sizeof(double));
+    m_total += chunk;
+
+    Scan(values, chunk, nowUs);
+    CompleteEvents();
+
+    values += chunk;
+    count -= chunk;
+  }
+}
+
+const TriggerEvent* TriggerDetector::Front() const {
+  return m_eventsCount == 0 ? nullptr : &m_events[m_eventsHead];
+}
+
+void TriggerDetector::Pop() {
+  if (m_eventsCount == 0)
+    return;
+  m_eventsHead = (m_eventsHead + 1) % maxEvents;
+  --m_eventsCount;
+}
+
+uint64_t TriggerDetector::GetDroppedCount() const {
+  return m_dropped;
+}
+
+void TriggerDetector::Scan(const double* values,
+                           size_t count,
+                           int64_t nowUs) {
+  // values - последние count полученных отсчетов
+  const uint64_t base = m_total - count;
+  if (m_nextScan >= m_total)
+    return;
+
+  auto i = size_t(m_nextScan - base);
+  while (i < count) {
+    double low = m_armRise;
+    double high = m_armFall;
+    if (m_state == State::armedRise) {
+      low = disabled;
+      high = m_settings.level;
+    } else if (m_state == State::armedFall) {
+      low = m_settings.level;
+      high = disabled;
+    }
+
+    i += FindFirstOutside(values + i, count - i, low, high);
+    if (i == count)
+      break;
+
+    if (m_state == State::idle) {
+      m_state = values[i] <= low ? State::armedRise : State::armedFall;
+      ++i;
+      continue;
+    }
+
+    Fire(base + i, m_state == State::armedRise, nowUs);
+    m_state = State::idle;
+    i += std::max<size_t>(m_settings.holdoff, 1);
+  }
+  m_nextScan = base + i;
+}
+
+void TriggerDetector::Fire(uint64_t index, bool rising, int64_t nowUs) {
+  if (m_triggersCount == maxEvents) {
+    ++m_dropped;
+    return;
+  }
+  m_triggers[(m_triggersHead + m_triggersCount) % maxEvents] = {index, nowUs,
+                                                                rising};
+  ++m_triggersCount;
+}
+
+void TriggerDetector::CompleteEvents() {
+  while (m_triggersCount > 0) {
+    const auto& trigger = m_triggers[m_triggersHead];
+    if (trigger.index + m_settings.postSamples > m_total)
+      break;
+
+    if (m_eventsCount == maxEvents) {
+      ++m_dropped;
+    } else {
+      auto& event = m_events[(m_eventsHead + m_eventsCount) % maxEvents];
+      auto pre = std::min<uint64_t>(m_settings.preSamples, trigger.index);
+      auto start = trigger.index - pre;
+      auto sampleCount = size_t(pre) + m_settings.postSamples;
+
+      event.index = trigger.index;
+      event.timestampUs = trigger.timestampUs;
+      event.preSamples = uint32_t(pre);
+      event.sampleCount = uint32_t(sampleCount);
+      event.rising = trigger.rising ? 1 : 0;
+      for (size_t i = 0; i < sampleCount; ++i)
+        event.values[i] = m_history[(start + i) & m_historyMask];
+      ++m_eventsCount;
+    }
+
+    m_triggersHead = (m_triggersHead + 1) % maxEvents;
+    --m_triggersCount;
+  }
+}
@@ -0,0 +1,173 @@
+#include "WindowAggregator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+WindowAccumulator::WindowAccumulator(bool keepValues)
+    : m_keepValues(keepValues) {}
+
+void WindowAccumulator::Push(double value, int64_t time) {
+  ++m_count;
+  auto delta = value - m_mean;
+  m_mean += delta / double(m_count);
+  m_m2 += delta * (value - m_mean);
+
+  if (!m_keepValues) {
+    m_min = m_count == 1 ? value : std::min(m_min, value);
+    m_max = m_count == 1 ? value : std::max(m_max, value);
+    return;
+  }
+
+  // Значения, которые уже не станут минимумом (максимумом), пока в окне
+  // есть новое, больше не нужны
+  while (!m_minimums.empty() && m_minimums.back().value >= value)
+    m_minimums.pop_back();
+  m_minimums.push_back({m_pushed, value});
+  while (!m_maximums.empty() && m_maximums.back().value <= value)
+    m_maximums.pop_back();
+  m_maximums.push_back({m_pushed, value});
+
+  m_values.push_back({value, time});
+  ++m_pushed;
+}
+
+void WindowAccumulator::PopFront() {
+  if (!m_keepValues)
+    throw std::logic_error("values are not kept");
+  if (m_values.empty())
+    return;
+
+  auto value = m_values.front().value;
+  m_values.pop_front();
+
+  if (--m_count == 0) {
+    m_mean = m_m2 = 0;
+  } else {
+    auto delta = value - m_mean;
+    m_mean -= delta / double(m_count);
+    m_m2 -= delta * (value - m_mean);
+    // Погрешность округления не должна делать дисперсию отрицательной
+    m_m2 = std::max(m_m2, 0.0);
+  }
+
+  if (m_minimums.front().index == m_popped)
+    m_minimums.pop_front();
+  if (m_maximums.front().index == m_popped)
+    m_maximums.pop_front();
+  ++m_popped;
+}
+
+void WindowAccumulator::Clear() {
+  m_values.clear();
+  m_minimums.clear();
+  m_maximums.clear();
+  m_popped = m_pushed;
+  m_count = 0;
+  m_mean = m_m2 = 0;
+}
+
+size_t WindowAccumulator::Size() const {
+  return m_count;
+}
+
+int64_t WindowAccumulator::FrontTime() const {
+  return m_values.front().time;
+}
+
+WindowStatistics WindowAccumulator::GetStatistics() const {
+  WindowStatistics statistics{};
+  statistics.count = m_count;
+  if (m_count == 0)
+    return statistics;
+
+  statistics.min = m_keepValues ? m_minimums.front().value : m_min;
+  statistics.max = m_keepValues ? m_maximums.front().value : m_max;
+  statistics.mean = m_mean;
+  statistics.variance = m_m2 / double(m_count);
+  statistics.rms = std::sqrt(m_mean * m_mean + statistics.variance);
+  return statistics;
+}
+
+WindowAggregator::WindowAggregator(Mode mode, uint64_t length, uint64_t hop)
+    : m_mode(mode),
+      m_length(length),
+      m_hop(hop == 0 ? length : hop),
+      m_window(m_hop < m_length),
+      // Первое заполненное окно выдается сразу
+      m_sinceEmit(m_hop - 1) {
+  if (length == 0)
+    throw std::invalid_argument("window length must be positive");
+  if (m_hop > m_length)
+    throw std::invalid_argument("window hop must not exceed its length");
+}
+
+std::optional<WindowStatistics> WindowAggregator::Add(double value,
+                                                      int64_t timeUs) {
+  return m_mode == Mode::count ? AddByCount(value) : AddByTime(value, timeUs);
+}
+
+bool WindowAggregator::IsTimeBased() const {
+  return m_mode == Mode::time;
+}
+
+std::optional<WindowStatistics> WindowAggregator::AddByCount(double value) {
+  m_window.Push(value, 0);
+
+  if (m_hop == m_length) {
+    if (m_window.Size() < m_length)
+      return std::nullopt;
+
+    auto statistics = m_window.GetStatistics();
+    m_window.Clear();
+    return statistics;
+  }
+
+  if (m_window.Size() > m_length)
+    m_window.PopFront();
+
+  if (m_window.Size() < m_length || ++m_sinceEmit < m_hop)
+    return std::nullopt;
+
+  m_sinceEmit = 0;
+  return m_window.GetStatistics();
+}
+
+std::optional<WindowStatistics> WindowAggregator::AddByTime(double value,
+                                                            int64_t timeUs) {
+  std::optional<WindowStatistics> statistics;
+  if (!m_nextEmit)
+    m_nextEmit = timeUs + int64_t(m_length);
+
+  if (m_hop == m_length) {
+    // Значение уже относится к следующему окну
+    if (timeUs >= *m_nextEmit) {
+      statistics = m_window.GetStatistics();
+      m_window.Clear();
+      // Пустые окна пропускаются
+      while (*m_nextEmit <= timeUs)
+        *m_nextEmit += int64_t(m_hop);
+    }
+    m_window.Push(value, timeUs);
+    return statistics;
+  }
+
+  if (timeUs >= *m_nextEmit) {
+    // Окно [nextEmit - length, nextEmit) закрыто, значение в него не входит
+    auto start = *m_nextEmit - int64_t(m_length);
+    while (m_window.Size() != 0 && m_window.FrontTime() < start)
+      m_window.PopFront();
+    // Пустые окна пропускаются
+    if (m_window.Size() != 0)
+      statistics = m_window.GetStatistics();
+    while (*m_nextEmit <= timeUs)
+      *m_nextEmit += int64_t(m_hop);
+  }
+
+  // Значения не новее timeUs - length не войдут ни в одно следующее окно
+  while (m_window.Size() != 0 &&
+         m_window.FrontTime() <= timeUs - int64_t(m_length))
+    m_window.PopFront();
+  m_window.Push(value, timeUs);
+  return statistics;
+}
@@ -20,3 +20,12 @@ TEST(SteadyClock_tests, waitForUsDoesntThrow) {
 TEST(SteadyClock_tests, waitForMsDoesntThrow) {
   ASSERT_NO_THROW(SteadyClock::waitForMs(1));
 }
+
+TEST(SteadyClock_tests, waitUntilNsReachesDeadline) {
+  auto deadline = SteadyClock::nowNs() + milliseconds(2);
+  SteadyClock::waitUntilNs(deadline);
+  ASSERT_GE(SteadyClock::nowNs(), deadline);
+
+  // deadline in the past returns immediately
+  ASSERT_NO_THROW(SteadyClock::waitUntilNs(deadline - seconds(1)));
+}
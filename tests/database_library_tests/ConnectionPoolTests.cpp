@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+/**
+  Тесты для ConnectionPool
+*/
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <ConnectionPool.h>
+
+#include "TestStatus.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+/// Соединение, не обращающееся к базе данных
+class FakeConnection : public IConnection {
+public:
+  bool IsValid() const override { return true; }
+  ConnectionStatus GetStatus() const override { return ConnectionStatus::Ok; }
+  IExecuteResultPtr Execute(const std::string &) override { return nullptr; }
+  IExecuteResultStatusPtr BeginTransaction() override {
+    return std::make_shared<OkStatus>();
+  }
+  IExecuteResultStatusPtr CommitTransaction() override {
+    return std::make_shared<OkStatus>();
+  }
+  IExecuteResultStatusPtr RollbackTransaction() override {
+    ++rollbacksCount;
+    return std::make_shared<OkStatus>();
+  }
+  IFilePtr CreateRemoteFile() override { return nullptr; }
+  bool DeleteRemoteFile(const std::string &) override { return false; }
+  IFilePtr GetRemoteFile(const std::string &) override { return nullptr; }
+
+  std::atomic<int> rollbacksCount = 0; ///< Число отмен транзакции
+
+protected:
+  IExecuteResultPtr Execute(const std::string &,
+                            const std::vector<ExecuteArgType> &,
+                            const ResultFormat,
+                            const std::vector<SQLDataType> &) override {
+    return nullptr;
+  }
+};
+
+/// Создать пул, считающий созданные соединения
+ConnectionPoolPtr CreateCountingPool(size_t maxConnections,
+                                     std::atomic<int> &createdCount) {
+  return ConnectionPool::Create(maxConnections, [&createdCount](auto &&) {
+    ++createdCount;
+    return std::make_shared<FakeConnection>();
+  });
+}
+} // namespace
+
+/// Возвращенное в пул соединение выдается повторно, а транзакция отменяется
+TEST(ConnectionPool, ReleasedConnectionIsReused) {
+  std::atomic<int> createdCount = 0;
+  auto pool = CreateCountingPool(2, createdCount);
+
+  IConnection *first = nullptr;
+  {
+    auto connection = pool->Acquire("db");
+    ASSERT_NE(connection, nullptr);
+    first = connection.get();
+    ASSERT_EQ(pool->GetAcquiredConnectionsCount(), 1);
+  }
+  ASSERT_EQ(pool->GetAcquiredConnectionsCount(), 0);
+  ASSERT_EQ(static_cast<FakeConnection *>(first)->rollbacksCount, 1);
+
+  auto connection = pool->Acquire("db");
+  ASSERT_EQ(connection.get(), first);
+  ASSERT_EQ(createdCount, 1);
+  ASSERT_EQ(pool->GetOpenedConnectionsCount(), 1);
+}
+
+/// Пул не открывает больше соединений, чем разрешено
+TEST(ConnectionPool, AcquireFailsWhenPoolIsExhausted) {
+  std::atomic<int> createdCount = 0;
+  auto pool = CreateCountingPool(2, createdCount);
+
+  auto first = pool->Acquire("db");
+  auto second = pool->Acquire("other db");
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+
+  ASSERT_EQ(pool->Acquire("db", std::chrono::milliseconds(10)), nullptr);
+  ASSERT_EQ(createdCount, 2);
+}
+
+/// Ожидающий получает соединение, как только его вернут в пул
+TEST(ConnectionPool, AcquireWaitsForRelease) {
+  std::atomic<int> createdCount = 0;
+  auto pool = CreateCountingPool(1, createdCount);
+
+  auto connection = pool->Acquire("db");
+  std::thread releaser([&connection] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    connection.reset();
+  });
+
+  auto waited = pool->Acquire("other db", std::chrono::seconds(5));
+  releaser.join();
+
+  ASSERT_NE(waited, nullptr);
+  ASSERT_EQ(createdCount, 2);
+  ASSERT_EQ(pool->GetOpenedConnectionsCount(), 1);
+}
+
+/// Вложенный пул ограничивает число своих соединений, не занимая чужие
+TEST(ConnectionPool, QuotaLimitsConnections) {
+  std::atomic<int> createdCount = 0;
+  auto pool = CreateCountingPool(4, createdCount);
+  auto quota = pool->CreateQuota(1);
+
+  auto connection = quota->Acquire("db");
+  ASSERT_NE(connection, nullptr);
+  ASSERT_EQ(quota->Acquire("db", std::chrono::milliseconds(10)), nullptr);
+  ASSERT_NE(pool->Acquire("db"), nullptr);
+
+  connection.reset();
+  ASSERT_EQ(quota->GetAcquiredConnectionsCount(), 0);
+  ASSERT_NE(quota->Acquire("db"), nullptr);
+}
@@ -13,6 +13,7 @@
 #include <IDatabaseManager.h>
 #include <Utils/StringUtils.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
 
@@ -326,6 +327,40 @@ TEST_F(TestWithValidRemoteFile, CanReadAfterWriting) {
   ASSERT_FALSE(connection->CommitTransaction()->HasError());
 }
 
+/// Можно прочесть данные с произвольной позиции, размер файла не зависит от
+/// позиции
+TEST_F(TestWithValidRemoteFile, CanSeekAndGetSize) {
+  constexpr size_t size = 1000;
+  constexpr size_t position = 600;
+
+  ASSERT_FALSE(connection->BeginTransaction()->HasError());
+  ASSERT_TRUE(remoteFilePtr->Open(FileOpenMode::Write));
+  auto bytes = GenerateBytes(size);
+  ASSERT_TRUE(remoteFilePtr->WriteBytes(bytes));
+  ASSERT_TRUE(remoteFilePtr->Close());
+  ASSERT_FALSE(connection->CommitTransaction()->HasError());
+
+  ASSERT_FALSE(connection->BeginTransaction()->HasError());
+  ASSERT_TRUE(remoteFilePtr->Open(FileOpenMode::Read));
+  ASSERT_TRUE(remoteFilePtr->Seek(position));
+  ASSERT_EQ(remoteFilePtr->GetSize(), size);
+
+  std::vector<char> buffer;
+  ASSERT_TRUE(remoteFilePtr->ReadBytes(size - position, buffer));
+  ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(),
+                         bytes.begin() + position));
+  ASSERT_TRUE(remoteFilePtr->Close());
+  ASSERT_FALSE(connection->CommitTransaction()->HasError());
+}
+
+/// Нельзя перемещать позицию и узнавать размер закрытого файла
+TEST_F(TestWithValidRemoteFile, CantSeekAndGetSizeWhenFileIsClosed) {
+  ASSERT_FALSE(connection->BeginTransaction()->HasError());
+  ASSERT_FALSE(remoteFilePtr->Seek(0));
+  ASSERT_FALSE(remoteFilePtr->GetSize().has_value());
+  ASSERT_FALSE(connection->CommitTransaction()->HasError());
+}
+
 /// Можно дописать данные в файл в рамках одного сеанса работы с файлом в рамках
 /// одной транзакции в режиме открытия на запись
 TEST_F(TestWithValidRemoteFile,
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <IExecuteResultStatus.h>
+
+#include <string>
+
+/// Статус успешно выполненной команды
+class OkStatus : public IExecuteResultStatus {
+public:
+  ResultStatus GetStatus() const override {
+    return ResultStatus::OkWithoutData;
+  }
+  std::string GetErrorMessage() const override { return {}; }
+};
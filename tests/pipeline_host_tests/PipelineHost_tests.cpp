@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "PipelineHost.h"
+#include "SteadyClock.h"
+
+using namespace std;
+using namespace testing;
+
+namespace {
+constexpr auto PipelineStr =
+    "Int32RandomGenerator:\n"
+    "  id: generator\n"
+    "  type: producer\n"
+    "\n"
+    "Int32ToDoubleConverter:\n"
+    "  id: converter\n"
+    "  type: producerConsumer\n"
+    "  strategy: fifo\n"
+    "  parentId: generator\n";
+
+PipelineHostSettings hostSettings(size_t threadsCount) {
+  PipelineHostSettings settings;
+  settings.executor.threadsCount = threadsCount;
+  settings.dbConnectionsCount = 2;
+  return settings;
+}
+}  // namespace
+
+TEST(PipelineHost_tests, pipelinesRunOnSharedExecutor) {
+  PipelineHost host(hostSettings(2));
+  for (int i = 0; i < 8; ++i)
+    host.loadPipelineFromString("channel " + to_string(i), PipelineStr,
+                                PipelineQuota{1, 1});
+
+  host.run();
+  SteadyClock::waitForMs(100);
+  ASSERT_EQ(host.getExecutor()->getScheduledCount(), 16);
+  host.shutdown();
+
+  ASSERT_EQ(host.getExecutor()->getThreadsCount(), 2);
+  ASSERT_EQ(host.getExecutor()->getScheduledCount(), 0);
+  for (const auto& name : host.getPipelineNames()) {
+    auto converter = host.getPipeline(name)->getStageById("converter");
+    ASSERT_GT(converter->getStatistics().processedCount, 0);
+  }
+}
+
+TEST(PipelineHost_tests, pipelineAddedToRunningHostIsStarted) {
+  PipelineHost host(hostSettings(1));
+  host.run();
+
+  auto pipeline = host.loadPipelineFromString("channel", PipelineStr);
+  SteadyClock::waitForMs(100);
+  host.removePipeline("channel");
+
+  ASSERT_TRUE(host.getPipelineNames().empty());
+  ASSERT_EQ(host.getExecutor()->getScheduledCount(), 0);
+  ASSERT_GT(pipeline->getStageById("generator")->getStatistics().processedCount,
+            0);
+}
+
+TEST(PipelineHost_tests, pipelineNamesAreUnique) {
+  PipelineHost host(hostSettings(1));
+  host.loadPipelineFromString("channel", PipelineStr);
+
+  ASSERT_THROW(host.loadPipelineFromString("channel", PipelineStr),
+               invalid_argument);
+  ASSERT_THROW(host.getPipeline("unknown"), invalid_argument);
+}
@@ -2,8 +2,10 @@
 
 #include <fstream>
 
+#include "IParameterized.h"
 #include "PipelineToYaml.h"
 #include "PipelineRegistry.h"
+#include "YamlConversionException.h"
 
 using namespace std;
 namespace fs = filesystem;
@@ -15,7 +17,8 @@ class PipelineToYaml_test : public Test {
     auto registry = PipelineRegistry::Instance();
     
     auto int32Connection =
-        registry.constructProducerConnection("Int32RandomGenerator", 128);
+        registry.constructProducerConnection(
+            "Int32RandomGenerator", YamlPipelineStage::defaultConnectionSize);
 
     auto int32Generator =
         registry.constructProducer("Int32RandomGenerator", int32Connection);
@@ -27,7 +30,8 @@ class PipelineToYaml_test : public Test {
     int32Visualizer->setParentId("Int 32 generator");
 
     auto doubleConnection =
-        registry.constructProducerConnection("Int32ToDoubleConverter", 128);
+        registry.constructProducerConnection(
+            "Int32ToDoubleConverter", YamlPipelineStage::defaultConnectionSize);
 
     auto int32ToDouble = registry.constructConsumerAndProducer(
         "Int32ToDoubleConverter", ConsumptionStrategy::fifo, int32Connection,
@@ -102,3 +106,135 @@ TEST_F(PipelineToYaml_test, PipelineToYaml_toStringWorks) {
   auto pipelineStr = PipelineToYaml::serializeToString(pipeline);
   ASSERT_EQ(pipelineStr, ExpectedPipelineStr);
 }
+
+TEST_F(PipelineToYaml_test, PipelineToYaml_parametersAreSerialized) {
+  static constexpr auto visualizerFile = "int32_visualizer.txt";
+  auto registry = PipelineRegistry::Instance();
+
+  auto connection =
+      registry.constructProducerConnection("Int32RandomGenerator", 128);
+  auto visualizer = registry.constructConsumer(
+      "Int32Visualizer", ConsumptionStrategy::fifo, connection);
+  visualizer->setId("Int 32 visualizer");
+  visualizer->setParentId("Int 32 generator");
+  dynamic_pointer_cast<IParameterized>(visualizer)
+      ->SetParameterValue("filename", visualizerFile);
+
+  auto parameterizedPipeline = make_shared<Pipeline>();
+  parameterizedPipeline->addConnection(connection);
+  parameterizedPipeline->addStage(visualizer);
+
+  auto pipelineStr = PipelineToYaml::serializeToString(parameterizedPipeline);
+  fs::remove(visualizerFile);
+
+  ASSERT_EQ(pipelineStr,
+            "Int32Visualizer:\n"
+            "  id: Int 32 visualizer\n"
+            "  type: consumer\n"
+            "  strategy: fifo\n"
+            "  parentId: Int 32 generator\n"
+            "  parameters:\n"
+            "    filename: int32_visualizer.txt\n"
+            "\n");
+}
+
+TEST_F(PipelineToYaml_test, PipelineToYaml_severalParentsAreSerialized) {
+  auto registry = PipelineRegistry::Instance();
+
+  auto a = registry.constructProducerConnection("int32Generator", 16);
+  auto b = registry.constructProducerConnection("int32Generator", 16);
+  auto out = registry.constructProducerConnection("int32Merge", 16);
+  auto merge = registry.constructMultiInput(
+      "int32Merge", ConsumptionStrategy::fifo, {a, b}, out);
+  merge->setId("merged");
+  merge->setParentIds({"a", "b"});
+
+  auto mergePipeline = make_shared<Pipeline>();
+  mergePipeline->addConnection(out);
+  mergePipeline->addStage(merge);
+
+  ASSERT_EQ(PipelineToYaml::serializeToString(mergePipeline),
+            "int32Merge:\n"
+            "  id: merged\n"
+            "  type: producerConsumer\n"
+            "  strategy: fifo\n"
+            "  parentId: [a, b]\n"
+            "  connectionSize: 16\n"
+            "\n");
+}
+
+TEST_F(PipelineToYaml_test, PipelineToYaml_outputsAreSerialized) {
+  auto registry = PipelineRegistry::Instance();
+
+  auto in = registry.constructProducerConnection("int32Generator", 16);
+  auto first = registry.constructProducerConnection("int32HashRouter", 16);
+  auto second = registry.constructProducerConnection("int32HashRouter", 16);
+  auto router = registry.constructMultiOutput(
+      "int32HashRouter", ConsumptionStrategy::fifo, in, {first, second});
+  router->setId("router");
+  router->setParentIds({"source"});
+  router->setOutputNames({"first", "second"});
+
+  auto quantiles = registry.constructConsumer(
+      "int32Quantiles", ConsumptionStrategy::fifo, second);
+  quantiles->setId("quantiles");
+  quantiles->setParentId("router.second");
+
+  auto routerPipeline = make_shared<Pipeline>();
+  routerPipeline->addConnection(first);
+  routerPipeline->addConnection(second);
+  routerPipeline->addStage(quantiles);
+  routerPipeline->addStage(router);
+
+  // Потребитель выхода идет после маршрутизатора
+  auto yaml = PipelineToYaml::serializeToString(routerPipeline);
+  ASSERT_EQ(yaml.find("int32HashRouter:\n"
+                      "  id: router\n"
+                      "  type: producerConsumer\n"
+                      "  strategy: fifo\n"
+                      "  parentId: source\n"
+                      "  outputs: [first, second]\n"
+                      "  connectionSize: 16\n"),
+            0);
+  ASSERT_NE(yaml.find("  parentId: router.second\n"), string::npos);
+
+  // Идентификатор с '.' нельзя отличить от выхода маршрутизатора
+  router->setId("router.main");
+  ASSERT_THROW(PipelineToYaml::serializeToString(routerPipeline),
+               YamlConversionException);
+}
+
+TEST_F(PipelineToYaml_test, PipelineToYaml_capacityTuningIsSerialized) {
+  auto registry = PipelineRegistry::Instance();
+
+  auto connection =
+      registry.constructProducerConnection("Int32RandomGenerator", 64);
+  auto generator =
+      registry.constructProducer("Int32RandomGenerator", connection);
+  generator->setId("generator");
+
+  auto tunedPipeline = make_shared<Pipeline>();
+  tunedPipeline->addConnection(connection);
+  tunedPipeline->addStage(generator);
+
+  CapacityTuningSettings settings;
+  settings.minCapacity = 32;
+  settings.maxCapacity = 4096;
+  settings.memoryBudget = 1 << 20;
+  settings.period = chrono::milliseconds(100);
+  tunedPipeline->setCapacityTuning(settings);
+
+  ASSERT_EQ(PipelineToYaml::serializeToString(tunedPipeline),
+            "capacityTuning:\n"
+            "  minCapacity: 32\n"
+            "  maxCapacity: 4096\n"
+            "  memoryBudget: 1048576\n"
+            "  period: 100\n"
+            "\n"
+            "\n"
+            "Int32RandomGenerator:\n"
+            "  id: generator\n"
+            "  type: producer\n"
+            "  connectionSize: 64\n"
+            "\n");
+}
@@ -3,7 +3,12 @@
 #include <filesystem>
 #include <fstream>
 
+#include "IParameterized.h"
+#include "QuantileStage.h"
+#include "SocketReadStage.h"
+#include "SocketWriteStage.h"
 #include "SteadyClock.h"
+#include "YamlConversionException.h"
 #include "YamlToPipeline.h"
 
     using namespace std;
@@ -111,3 +116,351 @@ TEST_F(YamlToPipeline_test, YamlToPipeline_fromFileRunnable) {
   SteadyClock::waitForMs(100);
   pipeline->shutdown();
 }
+
+TEST_F(YamlToPipeline_test, YamlToPipeline_connectionSizeIsApplied) {
+  auto pipeline = YamlToPipeline::parseFromString(
+      "Int32RandomGenerator:\n"
+      "  id: \"Int 32 generator\"\n"
+      "  type: producer\n"
+      "  connectionSize: 64\n");
+
+  auto connection = pipeline->getConnectionForStage("Int32RandomGenerator");
+  ASSERT_NE(connection, nullptr);
+  ASSERT_EQ(connection->getCapacity(), 64);
+}
+
+TEST_F(YamlToPipeline_test, YamlToPipeline_capacityTuningIsApplied) {
+  auto pipeline = YamlToPipeline::parseFromString(
+      "capacityTuning:\n"
+      "  minCapacity: 32\n"
+      "  maxCapacity: 1024\n"
+      "  period: 10\n"
+      "\n"
+      "int16Generator:\n"
+      "  id: sensor\n"
+      "  type: producer\n"
+      "  connectionSize: 128\n"
+      "  parameters:\n"
+      "    rate: 100\n"
+      "\n"
+      "int16Quantiles:\n"
+      "  id: stats\n"
+      "  type: consumer\n"
+      "  strategy: fifo\n"
+      "  parentId: sensor\n"
+      "  parameters:\n"
+      "    publishInterval: 0\n");
+
+  auto tuning = pipeline->getCapacityTuning();
+  ASSERT_TRUE(tuning.has_value());
+  ASSERT_EQ(tuning->minCapacity, 32);
+  ASSERT_EQ(tuning->maxCapacity, 1024);
+  ASSERT_EQ(tuning->period, chrono::milliseconds(10));
+
+  // Потребитель успевает за медленным генератором, поэтому емкость
+  // соединения уменьшается до нижней границы
+  auto connection = pipeline->getStageById("sensor")->getOutConnection();
+  pipeline->run();
+  for (size_t i = 0; i < 300 && connection->getCapacity() > 32; ++i)
+    SteadyClock::waitForMs(10);
+  pipeline->shutdown();
+  ASSERT_EQ(connection->getCapacity(), 32);
+
+  ASSERT_FALSE(YamlToPipeline::parseFromString(
+                   "int16Generator:\n"
+                   "  id: sensor\n"
+                   "  type: producer\n")
+                   ->getCapacityTuning()
+                   .has_value());
+  ASSERT_THROW(YamlToPipeline::parseFromString(
+                   "capacityTuning:\n"
+                   "  minCapacity: 64\n"
+                   "  maxCapacity: 32\n"),
+               YamlConversionException);
+  ASSERT_THROW(YamlToPipeline::parseFromString(
+                   "capacityTuning:\n"
+                   "  growThreshold: 1\n"),
+               YamlConversionException);
+}
+
+TEST_F(YamlToPipeline_test, YamlToPipeline_parametersAreApplied) {
+  static constexpr auto visualizerFile = "int32_visualizer.txt";
+  auto pipeline = YamlToPipeline::parseFromString(
+      "Int32RandomGenerator:\n"
+      "  id: \"Int 32 generator\"\n"
+      "  type: producer\n"
+      "\n"
+      "Int32Visualizer:\n"
+      "  id: \"Int 32 visualizer\"\n"
+      "  type: consumer\n"
+      "  strategy: fifo\n"
+      "  parentId: \"Int 32 generator\"\n"
+      "  parameters:\n"
+      "    filename: int32_visualizer.txt\n");
+
+  auto parameterized = dynamic_pointer_cast<IParameterized>(
+      pipeline->getStageById("Int 32 visualizer"));
+  fs::remove(visualizerFile);
+
+  ASSERT_NE(parameterized, nullptr);
+  auto values = parameterized->GetPatameterValues();
+  ASSERT_EQ(values.size(), 1);
+  EXPECT_EQ(values[0].paramName, "filename");
+  EXPECT_EQ(values[0].paramValue, visualizerFile);
+}
+
+TEST_F(YamlToPipeline_test, YamlToPipeline_parametersOfNotParameterizedStageThrow) {
+  ASSERT_THROW(YamlToPipeline::parseFromString(
+                   "Int32RandomGenerator:\n"
+                   "  id: \"Int 32 generator\"\n"
+                   "  type: producer\n"
+                   "  parameters:\n"
+                   "    seed: 1\n"),
+               YamlConversionException);
+}
+
+TEST_F(YamlToPipeline_test, YamlToPipeline_socketStagesArePluggable) {
+  auto receiving = YamlToPipeline::parseFromString(
+      SocketReadStage<int>::stageName +
+      ":\n"
+      "  id: receiver\n"
+      "  type: producer\n"
+      "  parameters:\n"
+      "    address: unix:yaml_socket_test.sock\n"
+      "    window: 16\n"
+      "\n"
+      "Int32Visualizer:\n"
+      "  id: visualizer\n"
+      "  type: consumer\n"
+      "  strategy: fifo\n"
+      "  parentId: receiver\n");
+
+  auto sending = YamlToPipeline::parseFromString(
+      "Int32RandomGenerator:\n"
+      "  id: generator\n"
+      "  type: producer\n"
+      "\n" +
+      SocketWriteStage<int>::stageName +
+      ":\n"
+      "  id: sender\n"
+      "  type: consumer\n"
+      "  strategy: fifo\n"
+      "  parentId: generator\n"
+      "  parameters:\n"
+      "    address: unix:yaml_socket_test.sock\n"
+      "    batchSize: 4\n");
+
+  receiving->run();
+  sending->run();
+  SteadyClock::waitForMs(200);
+  sending->shutdown();
+  receiving->shutdown();
+
+  auto receiver = dynamic_pointer_cast<SocketReadStage<int>>(
+      receiving->getStageById("receiver"));
+  auto sender = dynamic_pointer_cast<SocketWriteStage<int>>(
+      sending->getStageById("sender"));
+  ASSERT_NE(receiver, nullptr);
+  ASSERT_NE(sender, nullptr);
+  ASSERT_TRUE(receiver->IsFullyParameterized());
+  ASSERT_TRUE(sender->IsFullyParameterized());
+  ASSERT_GT(receiving->getStageById("visualizer")
+                ->getStatistics()
+                .processedCount,
+            0);
+}
+
+TEST_F(YamlToPipeline_test, YamlToPipeline_stageNamesAreStableForAllTypes) {
+  ASSERT_EQ(QuantileStage<int16_t>::stageName, "int16Quantiles");
+  ASSERT_EQ(SocketReadStage<std::complex<float>>::stageName,
+            "complex64FromSocket");
+
+  auto pipeline = YamlToPipeline::parseFromString(
+      "int16Generator:\n"
+      "  id: adc\n"
+      "  type: producer\n"
+      "  parameters:\n"
+      "    signal: sine\n"
+      "    amplitude: 1000\n"
+      "\n"
+      "int16Quantiles:\n"
+      "  id: quantiles\n"
+      "  type: consumer\n"
+      "  strategy: fifo\n"
+      "  parentId: adc\n"
+      "  parameters:\n"
+      "    publishInterval: 0\n");
+
+  pipeline->run();
+  SteadyClock::waitForMs(200);
+  pipeline->shutdown();
+
+  auto quantiles = dynamic_pointer_cast<QuantileStage<int16_t>>(
+      pipeline->getStageById("quantiles"));
+  ASSERT_NE(quantiles, nullptr);
+  auto snapshot = quantiles->GetSnapshot();
+  ASSERT_GT(snapshot.count, 0);
+  ASSERT_GE(snapshot.min, -1000);
+  ASSERT_LE(snapshot.max, 1000);
+}
+
+TEST_F(YamlToPipeline_test, YamlToPipeline_stageWithSeveralParents) {
+  auto pipeline = YamlToPipeline::parseFromString(
+      "int16Generator:\n"
+      "  id: current\n"
+      "  type: producer\n"
+      "  parameters:\n"
+      "    signal: sine\n"
+      "    amplitude: 0\n"
+      "    offset: 3\n"
+      "\n"
+      "int16Generator:\n"
+      "  id: voltage\n"
+      "  type: producer\n"
+      "  parameters:\n"
+      "    signal: sine\n"
+      "    amplitude: 0\n"
+      "    offset: 4\n"
+      "\n"
+      "int16Zip:\n"
+      "  id: power\n"
+      "  type: producerConsumer\n"
+      "  strategy: fifo\n"
+      "  parentId: [current, voltage]\n"
+      "  parameters:\n"
+      "    operation: product\n"
+      "\n"
+      "doubleQuantiles:\n"
+      "  id: quantiles\n"
+      "  type: consumer\n"
+      "  strategy: fifo\n"
+      "  parentId: power\n"
+      "  parameters:\n"
+      "    publishInterval: 0\n");
+
+  auto power = pipeline->getStageById("power");
+  ASSERT_EQ(power->getParentIds(), vector<string>({"current", "voltage"}));
+  ASSERT_EQ(power->getInConnections().size(), 2);
+
+  pipeline->run();
+  SteadyClock::waitForMs(200);
+  pipeline->shutdown();
+
+  auto quantiles = dynamic_pointer_cast<QuantileStage<double>>(
+      pipeline->getStageById("quantiles"));
+  ASSERT_NE(quantiles, nullptr);
+  auto snapshot = quantiles->GetSnapshot();
+  ASSERT_GT(snapshot.count, 0);
+  ASSERT_EQ(snapshot.min, 12);
+  ASSERT_EQ(snapshot.max, 12);
+
+  // Стадия с одним входом не принимает список родителей
+  ASSERT_THROW(YamlToPipeline::parseFromString(
+                   "Int32RandomGenerator:\n"
+                   "  id: a\n"
+                   "  type: producer\n"
+                   "\n"
+                   "Int32RandomGenerator:\n"
+                   "  id: b\n"
+                   "  type: producer\n"
+                   "\n"
+                   "Int32ToDoubleConverter:\n"
+                   "  id: c\n"
+                   "  type: producerConsumer\n"
+                   "  strategy: fifo\n"
+                   "  parentId: [a, b]\n"),
+               YamlConversionException);
+}
+
+TEST_F(YamlToPipeline_test, YamlToPipeline_outputsOfRouterAreParents) {
+  auto pipeline = YamlToPipeline::parseFromString(
+      "int16Generator:\n"
+      "  id: sensor\n"
+      "  type: producer\n"
+      "  parameters:\n"
+      "    signal: uniform\n"
+      "    amplitude: 10\n"
+      "\n"
+      "int16RangeRouter:\n"
+      "  id: router\n"
+      "  type: producerConsumer\n"
+      "  strategy: fifo\n"
+      "  parentId: sensor\n"
+      "  outputs: [normal, alarm]\n"
+      "  parameters:\n"
+      "    low: -5\n"
+      "    high: 5\n"
+      "\n"
+      "int16Quantiles:\n"
+      "  id: alarmStats\n"
+      "  type: consumer\n"
+      "  strategy: fifo\n"
+      "  parentId: router.alarm\n"
+      "  parameters:\n"
+      "    publishInterval: 0\n"
+      "\n"
+      "int16Quantiles:\n"
+      "  id: normalStats\n"
+      "  type: consumer\n"
+      "  strategy: fifo\n"
+      "  parentId: router.normal\n"
+      "  parameters:\n"
+      "    publishInterval: 0\n");
+
+  auto router = pipeline->getStageById("router");
+  ASSERT_EQ(router->getOutputNames(), vector<string>({"normal", "alarm"}));
+  ASSERT_EQ(router->getOutConnections().size(), 2);
+
+  pipeline->run();
+  SteadyClock::waitForMs(200);
+  pipeline->shutdown();
+
+  auto normal = dynamic_pointer_cast<QuantileStage<int16_t>>(
+      pipeline->getStageById("normalStats"))->GetSnapshot();
+  auto alarm = dynamic_pointer_cast<QuantileStage<int16_t>>(
+      pipeline->getStageById("alarmStats"))->GetSnapshot();
+  ASSERT_GT(normal.count, 0);
+  ASSERT_GE(normal.min, -5);
+  ASSERT_LE(normal.max, 5);
+  ASSERT_GT(alarm.count, 0);
+  ASSERT_LT(alarm.min, -5);
+  ASSERT_GT(alarm.max, 5);
+
+  // Маршрутизатору нужен список выходов, остальным стадиям он не нужен
+  ASSERT_THROW(YamlToPipeline::parseFromString(
+                   "int16Generator:\n"
+                   "  id: sensor\n"
+                   "  type: producer\n"
+                   "\n"
+                   "int16RangeRouter:\n"
+                   "  id: router\n"
+                   "  type: producerConsumer\n"
+                   "  strategy: fifo\n"
+                   "  parentId: sensor\n"),
+               YamlConversionException);
+  ASSERT_THROW(YamlToPipeline::parseFromString(
+                   "int16Generator:\n"
+                   "  id: sensor\n"
+                   "  type: producer\n"
+                   "  outputs: [a, b]\n"),
+               YamlConversionException);
+
+  // Точка отделяет выход от идентификатора стадии и в них запрещена
+  ASSERT_THROW(YamlToPipeline::parseFromString(
+                   "int16Generator:\n"
+                   "  id: sensor.1\n"
+                   "  type: producer\n"),
+               YamlConversionException);
+  ASSERT_THROW(YamlToPipeline::parseFromString(
+                   "int16Generator:\n"
+                   "  id: sensor\n"
+                   "  type: producer\n"
+                   "\n"
+                   "int16RangeRouter:\n"
+                   "  id: router\n"
+                   "  type: producerConsumer\n"
+                   "  strategy: fifo\n"
+                   "  parentId: sensor\n"
+                   "  outputs: [normal, alarm.high]\n"),
+               YamlConversionException);
+}
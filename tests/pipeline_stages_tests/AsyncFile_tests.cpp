@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include "AsyncFileReader.h"
+#include "AsyncFileRecorderStage.h"
+#include "AsyncFileReplayStage.h"
+#include "AsyncFileWriter.h"
+#include "SPMCStageConnection.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+class AsyncFile_test : public Test {
+ protected:
+  void SetUp() override {
+    filesystem::remove_all(Directory);
+    filesystem::create_directory(Directory);
+  }
+
+  void TearDown() override { filesystem::remove_all(Directory); }
+
+  static string readFile(const filesystem::path& path) {
+    ifstream file(path, ios::binary);
+    return string(istreambuf_iterator<char>(file), {});
+  }
+
+  // several blocks, the last one is incomplete
+  static string makeData() {
+    string data(3 * 4096 + 100, '\0');
+    for (size_t i = 0; i < data.size(); ++i)
+      data[i] = char(i * 7 % 251);
+    return data;
+  }
+
+  static inline const filesystem::path Directory = "async_file_test";
+  static inline const AsyncFileOptions Options{4096, 2, true};
+};
+}  // namespace
+
+TEST_F(AsyncFile_test, writerWritesBlocksAndTail) {
+  auto path = (Directory / "data.bin").string();
+  auto data = makeData();
+  for (bool direct : {true, false}) {
+    auto options = Options;
+    options.direct = direct;
+    AsyncFileWriter writer(path, options);
+    // куски не совпадают с границами блоков
+    for (size_t offset = 0; offset < data.size(); offset += 1000)
+      writer.Write(data.data() + offset,
+                   min<size_t>(1000, data.size() - offset));
+    writer.Close();
+
+    ASSERT_EQ(readFile(path), data) << direct;
+  }
+
+  ASSERT_THROW(AsyncFileWriter(path, {1000, 2, false}), invalid_argument);
+}
+
+TEST_F(AsyncFile_test, readerReadsAheadAndRewinds) {
+  auto path = (Directory / "data.bin").string();
+  auto data = makeData();
+  ofstream(path, ios::binary) << data;
+
+  AsyncFileReader reader(path, Options);
+  ASSERT_EQ(reader.GetSize(), data.size());
+  for (int pass = 0; pass < 2; ++pass) {
+    string read(data.size(), '\0');
+    for (size_t offset = 0; offset < data.size(); offset += 1000)
+      ASSERT_TRUE(reader.Read(read.data() + offset,
+                              min<size_t>(1000, data.size() - offset)));
+    ASSERT_EQ(read, data);
+
+    char extra;
+    ASSERT_FALSE(reader.Read(&extra, 1));
+    reader.Rewind();
+  }
+}
+
+TEST_F(AsyncFile_test, stagesRecordAndReplay) {
+  auto path = (Directory / "data.bin").string();
+  vector<int> values(3000);
+  iota(values.begin(), values.end(), 0);
+
+  auto in = make_shared<SPMCStageConnection<int>>(32);
+  in->setWaitPeriod(chrono::milliseconds{0});
+  auto recorder =
+      make_shared<AsyncFileRecorderStage<int>>(ConsumptionStrategy::fifo, in);
+  recorder->SetParameterValue("filename", path);
+  recorder->SetParameterValue("blockSize", "4096");
+  recorder->ApplyParameterValues();
+
+  size_t lastProducedId = 0;
+  for (int value : values) {
+    auto task = in->getProducerTask();
+    *task->data = value;
+    in->taskProduced(task->data, ++lastProducedId, true);
+    ASSERT_TRUE(recorder->step());
+  }
+  recorder->shutdown();
+  ASSERT_EQ(filesystem::file_size(path), values.size() * sizeof(int));
+
+  auto out = make_shared<SPMCStageConnection<int>>(32);
+  out->setWaitPeriod(chrono::milliseconds{0});
+  auto consumerId = out->connectConsumer();
+  auto replay = make_shared<AsyncFileReplayStage<int>>(out);
+  replay->SetParameterValue("filename", path);
+  replay->SetParameterValue("blockSize", "8192");
+  replay->ApplyParameterValues();
+
+  vector<int> replayed;
+  size_t lastConsumedId = 0;
+  while (!replay->isFinished()) {
+    replay->step();
+    auto task = out->getConsumerTask(consumerId, ConsumptionStrategy::fifo,
+                                     lastConsumedId);
+    if (!task)
+      continue;
+
+    lastConsumedId = task->taskId;
+    replayed.push_back(*task->data);
+    out->taskConsumed(task->data, consumerId, true);
+  }
+  ASSERT_EQ(replayed, values);
+}
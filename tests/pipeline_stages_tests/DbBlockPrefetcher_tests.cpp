@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include "DbBlockPrefetcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+TEST(DbBlockPrefetcher_tests, blocksAreReadByOneThread) {
+  set<thread::id> readers;
+  char next = 0;
+  DbBlockPrefetcher prefetcher([&] {
+    readers.insert(this_thread::get_id());
+    return vector<char>(3, next++);
+  });
+
+  for (char i = 0; i < 10; ++i) {
+    prefetcher.Request();
+    // повторный запрос не читает блок заново
+    prefetcher.Request();
+    ASSERT_TRUE(prefetcher.IsRequested());
+    ASSERT_EQ(prefetcher.Take(), vector<char>(3, i));
+    ASSERT_FALSE(prefetcher.IsRequested());
+  }
+
+  ASSERT_EQ(readers.size(), 1);
+  ASSERT_EQ(readers.count(this_thread::get_id()), 0);
+}
+
+TEST(DbBlockPrefetcher_tests, readErrorIsReportedOnce) {
+  bool fail = true;
+  DbBlockPrefetcher prefetcher([&]() -> vector<char> {
+    if (fail)
+      throw runtime_error("read failed");
+    return {1, 2};
+  });
+
+  prefetcher.Request();
+  ASSERT_THROW(prefetcher.Take(), runtime_error);
+
+  fail = false;
+  prefetcher.Request();
+  ASSERT_EQ(prefetcher.Take(), vector<char>({1, 2}));
+}
+
+TEST(DbBlockPrefetcher_tests, cancelWaitsForRead) {
+  atomic_bool reading{false};
+  atomic_bool read{false};
+  DbBlockPrefetcher prefetcher([&] {
+    reading = true;
+    this_thread::sleep_for(chrono::milliseconds(20));
+    read = true;
+    return vector<char>(1);
+  });
+
+  prefetcher.Request();
+  while (!reading)
+    this_thread::yield();
+  prefetcher.Cancel();
+
+  ASSERT_TRUE(read);
+  ASSERT_FALSE(prefetcher.IsRequested());
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include "DbRangeReader.h"
+#include "TestStatus.h"
+
+#include <IExecuteResultStatus.h>
+#include <IFile.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+
+namespace {
+// large object kept in memory, reads of chunks with odd offsets are delayed
+// so that readers complete out of order
+class MemoryFile : public IFile {
+ public:
+  MemoryFile(const vector<char>& data, optional<size_t> failingOffset)
+      : m_data(data), m_failingOffset(failingOffset) {}
+
+  std::string GetFileName() const override { return "memory"; }
+  bool Open(FileOpenMode) override { return true; }
+  bool Close() override { return true; }
+
+  bool Seek(size_t position) override {
+    m_position = position;
+    return position <= m_data.size();
+  }
+
+  std::optional<size_t> GetSize() override { return m_data.size(); }
+
+  bool ReadBytes(char* buffer,
+                 size_t bytesCount,
+                 size_t* numberOfBytesReadPtr) override {
+    if (m_failingOffset == m_position)
+      return false;
+    if ((m_position / 100) % 2 == 1)
+      this_thread::sleep_for(chrono::milliseconds(1));
+
+    auto count = min(bytesCount, m_data.size() - m_position);
+    copy_n(m_data.begin() + m_position, count, buffer);
+    m_position += count;
+    if (numberOfBytesReadPtr)
+      *numberOfBytesReadPtr = count;
+    return true;
+  }
+
+  bool WriteBytes(const char*, size_t, size_t*) override { return false; }
+
+ private:
+  const vector<char>& m_data;
+  optional<size_t> m_failingOffset;
+  size_t m_position = 0;
+};
+
+class MemoryConnection : public IConnection {
+ public:
+  MemoryConnection(const vector<char>& data, optional<size_t> failingOffset)
+      : m_data(data), m_failingOffset(failingOffset) {}
+
+  bool IsValid() const override { return true; }
+  ConnectionStatus GetStatus() const override { return ConnectionStatus::Ok; }
+  IExecuteResultPtr Execute(const std::string&) override { return nullptr; }
+  IExecuteResultStatusPtr BeginTransaction() override {
+    return make_shared<OkStatus>();
+  }
+  IExecuteResultStatusPtr CommitTransaction() override {
+    return make_shared<OkStatus>();
+  }
+  IExecuteResultStatusPtr RollbackTransaction() override {
+    return make_shared<OkStatus>();
+  }
+  IFilePtr CreateRemoteFile() override { return nullptr; }
+  bool DeleteRemoteFile(const std::string&) override { return false; }
+  IFilePtr GetRemoteFile(const std::string&) override {
+    return make_shared<MemoryFile>(m_data, m_failingOffset);
+  }
+
+ protected:
+  IExecuteResultPtr Execute(const std::string&,
+                            const std::vector<ExecuteArgType>&,
+                            const ResultFormat,
+                            const std::vector<SQLDataType>&) override {
+    return nullptr;
+  }
+
+ private:
+  const vector<char>& m_data;
+  optional<size_t> m_failingOffset;
+};
+
+vector<char> generateData(size_t size) {
+  vector<char> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = char(i * 31 + 7);
+  return data;
+}
+}  // namespace
+
+TEST(DbRangeReader_tests, chunksAreReassembledInOrder) {
+  auto data = generateData(10'050);
+  atomic_int connectionsCount{0};
+  DbRangeReader reader(
+      [&] {
+        ++connectionsCount;
+        return make_shared<MemoryConnection>(data, nullopt);
+      },
+      "memory", 100, 4);
+  ASSERT_EQ(reader.GetFileSize(), data.size());
+
+  vector<char> received;
+  for (auto chunk = reader.NextChunk(); !chunk.empty();
+       chunk = reader.NextChunk())
+    received.insert(received.end(), chunk.begin(), chunk.end());
+
+  ASSERT_EQ(received, data);
+  ASSERT_TRUE(reader.NextChunk().empty());
+  // одно соединение для размера и по одному на каждый диапазон
+  ASSERT_EQ(connectionsCount, 1 + 101);
+}
+
+TEST(DbRangeReader_tests, readErrorIsReportedOnce) {
+  auto data = generateData(1'000);
+  DbRangeReader reader(
+      [&] { return make_shared<MemoryConnection>(data, 300); }, "memory", 100,
+      2);
+
+  // диапазоны до ошибочного выдаются, несмотря на упреждающее чтение
+  for (int i = 0; i < 3; ++i)
+    ASSERT_EQ(reader.NextChunk().size(), 100);
+  ASSERT_THROW(reader.NextChunk(), runtime_error);
+  // после ошибки чтение остановлено, а не повторяет ее при каждом вызове
+  ASSERT_TRUE(reader.NextChunk().empty());
+  ASSERT_TRUE(reader.NextChunk().empty());
+}
+
+TEST(DbRangeReader_tests, stopsWithUnreadChunks) {
+  auto data = generateData(100'000);
+  DbRangeReader reader(
+      [&] { return make_shared<MemoryConnection>(data, nullopt); }, "memory",
+      10, 3);
+  ASSERT_EQ(reader.NextChunk().size(), 10);
+}
+
+TEST(DbRangeReader_tests, connectionsAreNotHeldBetweenChunks) {
+  auto data = generateData(2'000);
+  atomic_int leased{0};
+  atomic_int maxLeased{0};
+  DbRangeReader reader(
+      [&] {
+        auto count = ++leased;
+        for (auto max = maxLeased.load(); count > max;)
+          maxLeased.compare_exchange_weak(max, count);
+        return shared_ptr<IConnection>(
+            new MemoryConnection(data, nullopt), [&](IConnection* connection) {
+              --leased;
+              delete connection;
+            });
+      },
+      "memory", 100, 2);
+
+  while (!reader.NextChunk().empty())
+    ;
+
+  ASSERT_LE(maxLeased, 2);
+  // потоки чтения ждут следующего диапазона без соединения
+  ASSERT_EQ(leased, 0);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "DbWriteBehind.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <thread>
+
+using namespace std;
+
+TEST(DbWriteBehind_tests, buffersAreWrittenInOrder) {
+  vector<int> written;
+  size_t largestWrite = 0;
+  {
+    DbWriteBehind writer(
+        [&](const vector<char>& data) {
+          this_thread::sleep_for(chrono::microseconds(100));
+          largestWrite = max(largestWrite, data.size());
+          auto offset = written.size();
+          written.resize(offset + data.size() / sizeof(int));
+          memcpy(written.data() + offset, data.data(), data.size());
+          return true;
+        },
+        10 * sizeof(int), 3, 2);
+
+    for (int i = 0; i < 1'000; ++i) {
+      writer.Append(&i, sizeof(i));
+      if (i % 7 == 0)
+        writer.Submit();
+    }
+    ASSERT_TRUE(writer.Flush());
+    ASSERT_EQ(written.size(), 1'000);
+
+    // остаток записывается при разрушении
+    int last = 1'000;
+    writer.Append(&last, sizeof(last));
+  }
+
+  ASSERT_EQ(written.size(), 1'001);
+  for (int i = 0; i < 1'001; ++i)
+    ASSERT_EQ(written[i], i);
+  ASSERT_LE(largestWrite, 10 * sizeof(int));
+}
+
+TEST(DbWriteBehind_tests, appendBlocksAboveHighWaterMark) {
+  atomic_bool released = false;
+  DbWriteBehind writer(
+      [&](const vector<char>&) {
+        while (!released)
+          this_thread::sleep_for(chrono::milliseconds(1));
+        return true;
+      },
+      sizeof(int), 3, 1);
+
+  int value = 0;
+  writer.Append(&value, sizeof(value));
+  // первый буфер уходит на запись, второй заполняется
+  writer.Append(&value, sizeof(value));
+
+  // второй буфер тоже ждет записи, это больше highWaterMark
+  auto blocked = async(launch::async,
+                       [&] { writer.Append(&value, sizeof(value)); });
+  ASSERT_EQ(blocked.wait_for(chrono::milliseconds(50)), future_status::timeout);
+
+  released = true;
+  ASSERT_EQ(blocked.wait_for(chrono::seconds(5)), future_status::ready);
+  ASSERT_TRUE(writer.Flush());
+}
+
+TEST(DbWriteBehind_tests, writeErrorIsReportedOnce) {
+  atomic_bool fail = true;
+  atomic_int writes = 0;
+  DbWriteBehind writer(
+      [&](const vector<char>&) {
+        ++writes;
+        return !fail;
+      },
+      sizeof(int), 2, 1);
+
+  int value = 0;
+  writer.Append(&value, sizeof(value));
+  ASSERT_FALSE(writer.Flush());
+  ASSERT_TRUE(writer.Flush());
+
+  writer.Append(&value, sizeof(value));
+  writer.Submit();
+  // ждем окончания записи, не сбрасывая признак ошибки
+  while (writes < 2)
+    this_thread::sleep_for(chrono::milliseconds(1));
+  this_thread::sleep_for(chrono::milliseconds(10));
+
+  fail = false;
+  ASSERT_THROW(writer.Append(&value, sizeof(value)), runtime_error);
+  writer.Append(&value, sizeof(value));
+  ASSERT_TRUE(writer.Flush());
+}
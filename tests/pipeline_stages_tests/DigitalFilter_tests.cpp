@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include "BiquadCascade.h"
+#include "FilterKernels.h"
+#include "FirFilter.h"
+#include "FirFilterStage.h"
+#include "IirFilterStage.h"
+#include "SPMCStageConnection.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+vector<double> randomValues(size_t count, unsigned seed) {
+  mt19937 random(seed);
+  uniform_real_distribution<double> distribution(-1, 1);
+  vector<double> values(count);
+  for (auto& value : values)
+    value = distribution(random);
+  return values;
+}
+
+/// Обработать значения блоками разного размера
+template <typename Filter>
+vector<double> processInBlocks(Filter& filter, const vector<double>& values) {
+  vector<double> result(values.size());
+  size_t block = 1;
+  for (size_t start = 0; start < values.size(); start += block++) {
+    auto count = min(block, values.size() - start);
+    filter.Process(values.data() + start, result.data() + start, count);
+  }
+  return result;
+}
+}  // namespace
+
+TEST(DigitalFilter_tests, dotProductMatchesScalarSum) {
+  for (size_t count = 0; count < 40; ++count) {
+    auto a = randomValues(count, 1);
+    auto b = randomValues(count, 2);
+    double expected = 0;
+    for (size_t i = 0; i < count; ++i)
+      expected += a[i] * b[i];
+    ASSERT_NEAR(DotProduct(a.data(), b.data(), count), expected, 1e-12)
+        << count;
+  }
+}
+
+TEST(DigitalFilter_tests, firMatchesDirectConvolution) {
+  auto values = randomValues(1000, 3);
+  for (size_t tapsCount : {1, 7, 33}) {
+    auto taps = randomValues(tapsCount, 4);
+    FirFilter filter(taps);
+    auto result = processInBlocks(filter, values);
+
+    for (size_t n = 0; n < values.size(); ++n) {
+      double expected = 0;
+      for (size_t k = 0; k < taps.size() && k <= n; ++k)
+        expected += taps[k] * values[n - k];
+      ASSERT_NEAR(result[n], expected, 1e-12) << tapsCount << " " << n;
+    }
+  }
+}
+
+TEST(DigitalFilter_tests, biquadCascadeMatchesDirectForm) {
+  // два звена ФНЧ Баттерворта 4-го порядка, срез 0.1 от частоты отсчетов
+  vector<BiquadCoefficients> sections = {
+      {0.0048243, 0.0096487, 0.0048243, -1.0485995, 0.2961869},
+      {1, 2, 1, -1.3209134, 0.6327387}};
+  auto values = randomValues(1000, 5);
+  BiquadCascade filter(sections);
+  auto result = processInBlocks(filter, values);
+
+  auto expected = values;
+  for (const auto& s : sections) {
+    double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+    for (auto& value : expected) {
+      auto y = s.b0 * value + s.b1 * x1 + s.b2 * x2 - s.a1 * y1 - s.a2 * y2;
+      x2 = x1;
+      x1 = value;
+      y2 = y1;
+      y1 = y;
+      value = y;
+    }
+  }
+
+  for (size_t n = 0; n < values.size(); ++n)
+    ASSERT_NEAR(result[n], expected[n], 1e-9) << n;
+}
+
+TEST(DigitalFilter_tests, invalidFiltersAreRejected) {
+  ASSERT_THROW(FirFilter({}), invalid_argument);
+  ASSERT_THROW(BiquadCascade({}), invalid_argument);
+  // полюс на единичной окружности
+  ASSERT_THROW(BiquadCascade({{1, 0, 0, 0, 1}}), invalid_argument);
+}
+
+TEST(DigitalFilter_tests, stagesFilterAndRoundSamples) {
+  auto in = make_shared<SPMCStageConnection<int>>(32);
+  auto out = make_shared<SPMCStageConnection<int>>(32);
+  in->setWaitPeriod(chrono::milliseconds{0});
+  out->setWaitPeriod(chrono::milliseconds{0});
+  auto consumerId = out->connectConsumer();
+
+  auto stage = make_shared<FirFilterStage<int>>(ConsumptionStrategy::fifo, in,
+                                                out);
+  ASSERT_TRUE(stage->SetParameterValue("coefficients", "0.5, 0.5"));
+  stage->ApplyParameterValues();
+
+  size_t lastProducedId = 0;
+  size_t lastConsumedId = 0;
+  vector<int> results;
+  for (int value : {1, 2, 4, -4}) {
+    auto task = in->getProducerTask();
+    *task->data = value;
+    in->taskProduced(task->data, ++lastProducedId, true);
+    ASSERT_TRUE(stage->step());
+
+    auto result = out->getConsumerTask(consumerId, ConsumptionStrategy::fifo,
+                                       lastConsumedId);
+    ASSERT_TRUE(result);
+    lastConsumedId = result->taskId;
+    results.push_back(*result->data);
+    out->taskConsumed(result->data, consumerId, true);
+  }
+  ASSERT_EQ(results, vector<int>({1, 2, 3, 0}));
+
+  ASSERT_TRUE(stage->SetParameterValue("coefficients", "0.5 x"));
+  ASSERT_THROW(stage->ApplyParameterValues(), invalid_argument);
+  ASSERT_EQ(stage->GetCoefficients(), vector<double>({0.5, 0.5}));
+
+  auto iir = make_shared<IirFilterStage<int>>(ConsumptionStrategy::fifo, in,
+                                              out);
+  auto path = filesystem::temp_directory_path() / "iir_coefficients.txt";
+  ofstream(path) << "1 0 0 -0.5 0\n1 1 0 0 0\n";
+  ASSERT_TRUE(iir->SetParameterValue("coefficientsFile", path.string()));
+  iir->ApplyParameterValues();
+  ASSERT_EQ(iir->GetCoefficients().size(), 10);
+
+  ofstream(path) << "1 0 0 -0.5\n";
+  ASSERT_THROW(iir->ApplyParameterValues(), invalid_argument);
+  filesystem::remove(path);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include "Downsampler.h"
+#include "MinMaxKernel.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+vector<DisplayPoint> downsample(Downsampler& downsampler,
+                                const vector<double>& values) {
+  vector<DisplayPoint> points;
+  for (auto value : values) {
+    downsampler.Add(value);
+    while (auto point = downsampler.Next())
+      points.push_back(*point);
+  }
+  return points;
+}
+}  // namespace
+
+TEST(Downsampler_tests, findMinMaxMatchesScalarSearch) {
+  mt19937 random(7);
+  // небольшой диапазон, чтобы были равные значения
+  uniform_int_distribution<int> distribution(-20, 20);
+
+  for (size_t count = 1; count < 70; ++count) {
+    vector<double> values(count);
+    for (auto& value : values)
+      value = distribution(random);
+
+    auto [minIndex, maxIndex] = FindMinMax(values.data(), values.size());
+    ASSERT_EQ(minIndex, min_element(values.begin(), values.end()) -
+                            values.begin())
+        << count;
+    ASSERT_EQ(maxIndex, max_element(values.begin(), values.end()) -
+                            values.begin())
+        << count;
+  }
+
+  ASSERT_THROW(FindMinMax(nullptr, 0), invalid_argument);
+}
+
+TEST(Downsampler_tests, minMaxKeepsBucketExtremesInOrder) {
+  const size_t bucket = 10;
+  mt19937 random(11);
+  normal_distribution<double> distribution;
+  vector<double> values(1005);
+  for (auto& value : values)
+    value = distribution(random);
+
+  Downsampler downsampler(Downsampler::Method::minMax, bucket);
+  auto points = downsample(downsampler, values);
+
+  vector<size_t> expected;
+  for (size_t start = 0; start + bucket <= values.size(); start += bucket) {
+    auto begin = values.begin() + start;
+    size_t low = min_element(begin, begin + bucket) - values.begin();
+    size_t high = max_element(begin, begin + bucket) - values.begin();
+    expected.push_back(min(low, high));
+    expected.push_back(max(low, high));
+  }
+
+  ASSERT_EQ(points.size(), expected.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    ASSERT_EQ(points[i].index, expected[i]);
+    ASSERT_EQ(points[i].value, values[expected[i]]);
+  }
+}
+
+TEST(Downsampler_tests, lttbKeepsSpikes) {
+  const size_t bucket = 10;
+  vector<double> values(201, 0.0);
+  values[15] = 5;
+  values[123] = -3;
+
+  Downsampler downsampler(Downsampler::Method::lttb, bucket);
+  auto points = downsample(downsampler, values);
+
+  // первое значение и по точке на корзину, кроме последней (ждет следующую)
+  ASSERT_EQ(points.size(), 1 + (values.size() - 1) / bucket - 1);
+  ASSERT_EQ(points.front().index, 0);
+  for (size_t i = 1; i < points.size(); ++i) {
+    ASSERT_GE(points[i].index, 1 + (i - 1) * bucket);
+    ASSERT_LT(points[i].index, 1 + i * bucket);
+  }
+
+  auto hasPoint = [&](uint64_t index) {
+    return any_of(points.begin(), points.end(), [&](const DisplayPoint& p) {
+      return p.index == index && p.value == values[index];
+    });
+  };
+  ASSERT_TRUE(hasPoint(15));
+  ASSERT_TRUE(hasPoint(123));
+}
+
+TEST(Downsampler_tests, invalidBucketIsRejected) {
+  ASSERT_THROW(Downsampler(Downsampler::Method::lttb, 0), invalid_argument);
+  ASSERT_THROW(Downsampler(Downsampler::Method::minMax, 1), invalid_argument);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "BufferedFileWriter.h"
+#include "FileRecorderStage.h"
+#include "SPMCStageConnection.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+class FileRecorder_test : public Test {
+ protected:
+  void SetUp() override {
+    filesystem::remove_all(Directory);
+    filesystem::create_directory(Directory);
+  }
+
+  void TearDown() override { filesystem::remove_all(Directory); }
+
+  static string readFile(const filesystem::path& path) {
+    ifstream file(path, ios::binary);
+    return string(istreambuf_iterator<char>(file), {});
+  }
+
+  static inline const filesystem::path Directory = "file_recorder_test";
+};
+}  // namespace
+
+TEST_F(FileRecorder_test, writerKeepsDataUntilSync) {
+  BufferedFileWriter::Options options;
+  options.syncInterval = chrono::milliseconds{0};
+  BufferedFileWriter writer((Directory / "data.bin").string(), options);
+
+  writer.Write("abc", 3);
+  writer.Tick();
+  ASSERT_EQ(filesystem::file_size(Directory / "data.bin"), 0);
+
+  writer.Sync();
+  ASSERT_EQ(readFile(Directory / "data.bin"), "abc");
+}
+
+TEST_F(FileRecorder_test, writerRotatesBySizeWithoutSplittingBlocks) {
+  BufferedFileWriter::Options options;
+  options.bufferSize = 16;
+  options.rotateSize = 10;
+  {
+    BufferedFileWriter writer((Directory / "data.bin").string(), options);
+    for (int i = 0; i < 10; ++i)
+      writer.Write("1234", 4);
+  }
+
+  // по два блока в части, последняя часть заполнена наполовину
+  for (int i = 0; i < 5; ++i) {
+    auto part = Directory / ("data." + to_string(i) + ".bin");
+    ASSERT_EQ(readFile(part), "12341234") << part;
+  }
+  ASSERT_FALSE(filesystem::exists(Directory / "data.5.bin"));
+}
+
+TEST_F(FileRecorder_test, stageRecordsBinaryAndText) {
+  auto connection = make_shared<SPMCStageConnection<int>>(32);
+  connection->setWaitPeriod(chrono::milliseconds{0});
+  size_t lastProducedId = 0;
+
+  auto binary = make_shared<FileRecorderStage<int>>(ConsumptionStrategy::fifo,
+                                                    connection);
+  binary->SetParameterValue("filename", (Directory / "data.bin").string());
+  binary->ApplyParameterValues();
+
+  auto text = make_shared<FileRecorderStage<int>>(ConsumptionStrategy::fifo,
+                                                  connection);
+  text->SetParameterValue("filename", (Directory / "data.txt").string());
+  text->SetParameterValue("format", "text");
+  text->ApplyParameterValues();
+
+  for (int value : {1, -20, 300}) {
+    auto task = connection->getProducerTask();
+    *task->data = value;
+    connection->taskProduced(task->data, ++lastProducedId, true);
+    ASSERT_TRUE(binary->step());
+    ASSERT_TRUE(text->step());
+  }
+  binary->shutdown();
+  text->shutdown();
+
+  vector<int> values(3);
+  auto recorded = readFile(Directory / "data.bin");
+  ASSERT_EQ(recorded.size(), values.size() * sizeof(int));
+  memcpy(values.data(), recorded.data(), recorded.size());
+  ASSERT_EQ(values, vector<int>({1, -20, 300}));
+  ASSERT_EQ(readFile(Directory / "data.txt"), "1\n-20\n300\n");
+
+  text->SetParameterValue("format", "csv");
+  ASSERT_THROW(text->ApplyParameterValues(), invalid_argument);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "FileReplayStage.h"
+#include "SPMCStageConnection.h"
+
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+class FileReplay_test : public Test {
+ protected:
+  void SetUp() override {
+    vector<int> values(100);
+    iota(values.begin(), values.end(), 0);
+    ofstream file(FileName, ios::binary);
+    file.write(reinterpret_cast<const char*>(values.data()),
+               values.size() * sizeof(int));
+
+    m_out->setWaitPeriod(chrono::milliseconds{0});
+    m_consumerId = m_out->connectConsumer();
+  }
+
+  void TearDown() override {
+    m_replay.reset();
+    filesystem::remove(FileName);
+  }
+
+  void setUpStage(const map<string, string>& parameters) {
+    m_replay = make_shared<FileReplayStage<int>>(m_out);
+    m_replay->SetParameterValue("filename", FileName);
+    for (auto& [key, value] : parameters)
+      ASSERT_TRUE(m_replay->SetParameterValue(key, value));
+    m_replay->ApplyParameterValues();
+  }
+
+  // steps the stage until it produces count values or finishes
+  vector<int> replay(size_t count) {
+    vector<int> values;
+    while (values.size() < count && !m_replay->isFinished()) {
+      m_replay->step();
+      auto task = m_out->getConsumerTask(
+          m_consumerId, ConsumptionStrategy::fifo, m_lastConsumedId);
+      if (!task)
+        continue;
+
+      m_lastConsumedId = task->taskId;
+      values.push_back(*task->data);
+      m_out->taskConsumed(task->data, m_consumerId, true);
+    }
+
+    return values;
+  }
+
+  static constexpr auto FileName = "file_replay_test.bin";
+
+  shared_ptr<SPMCStageConnection<int>> m_out =
+      make_shared<SPMCStageConnection<int>>(32);
+  shared_ptr<FileReplayStage<int>> m_replay;
+  size_t m_consumerId = 0;
+  size_t m_lastConsumedId = 0;
+};
+}  // namespace
+
+TEST_F(FileReplay_test, replaysRangeAndFinishes) {
+  setUpStage({{"startOffset", "10"}, {"endOffset", "20"}});
+
+  auto values = replay(100);
+  vector<int> expected(10);
+  iota(expected.begin(), expected.end(), 10);
+  ASSERT_EQ(values, expected);
+  ASSERT_TRUE(m_replay->isFinished());
+}
+
+TEST_F(FileReplay_test, loopsOverRange) {
+  setUpStage({{"startOffset", "98"}, {"loop", "1"}, {"populate", "1"}});
+
+  ASSERT_EQ(replay(5), vector<int>({98, 99, 98, 99, 98}));
+  ASSERT_FALSE(m_replay->isFinished());
+}
+
+TEST_F(FileReplay_test, isPacedToRate) {
+  setUpStage({{"rate", "1000"}});
+
+  auto started = chrono::steady_clock::now();
+  ASSERT_EQ(replay(51).size(), 51);
+  ASSERT_GE(chrono::steady_clock::now() - started, chrono::milliseconds(50));
+}
+
+TEST_F(FileReplay_test, rejectsOffsetsOutOfFile) {
+  ASSERT_THROW(setUpStage({{"endOffset", "101"}}), invalid_argument);
+  ASSERT_FALSE(m_replay->IsFullyParameterized());
+  ASSERT_THROW(setUpStage({{"startOffset", "11"}, {"endOffset", "10"}}),
+               invalid_argument);
+}
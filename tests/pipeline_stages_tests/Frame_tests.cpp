@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include "FileRecorderStage.h"
+#include "Frame.h"
+#include "FrameMergeStage.h"
+#include "FramePackStage.h"
+#include "FrameSelectStage.h"
+#include "SPMCStageConnection.h"
+#include "SampleCodec.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+using SmallFrame = Frame<int16_t, 4, 3>;
+using PairFrame = Frame<int16_t, 2, 3>;
+
+/// Отсчет канала channel с номером sample
+int16_t sampleValue(size_t channel, size_t sample) {
+  return int16_t(100 * channel + sample);
+}
+
+/// Собрать кадр из чередующихся по каналам отсчетов стадией FramePackStage
+shared_ptr<SmallFrame> packFrame() {
+  auto in = make_shared<SPMCStageConnection<int16_t>>(32);
+  auto out = make_shared<SPMCStageConnection<SmallFrame>>(4);
+  in->setWaitPeriod(chrono::milliseconds{0});
+  out->setWaitPeriod(chrono::milliseconds{0});
+  auto consumerId = out->connectConsumer();
+  FramePackStage<SmallFrame> stage(ConsumptionStrategy::fifo, in, out);
+
+  size_t lastProducedId = 0;
+  size_t lastConsumedId = 0;
+  for (size_t sample = 0; sample < SmallFrame::samples; ++sample) {
+    for (size_t channel = 0; channel < SmallFrame::channels; ++channel) {
+      EXPECT_FALSE(out->getConsumerTask(consumerId, ConsumptionStrategy::fifo,
+                                        lastConsumedId));
+      auto task = in->getProducerTask();
+      *task->data = sampleValue(channel, sample);
+      in->taskProduced(task->data, ++lastProducedId, true);
+      EXPECT_TRUE(stage.step());
+    }
+  }
+
+  auto result = out->getConsumerTask(consumerId, ConsumptionStrategy::fifo,
+                                     lastConsumedId);
+  EXPECT_TRUE(result);
+  auto frame = make_shared<SmallFrame>(*result->data);
+  out->taskConsumed(result->data, consumerId, true);
+  return frame;
+}
+}  // namespace
+
+TEST(Frame_tests, layoutAndNames) {
+  using AdcFrame = Frame<int16_t, 64, frameSamples>;
+  static_assert(alignof(AdcFrame) == 64);
+  static_assert(sizeof(AdcFrame) == 64 * frameSamples * sizeof(int16_t));
+  static_assert(is_trivially_copyable_v<AdcFrame>);
+  static_assert(isFrame<AdcFrame> && !isFrame<int16_t>);
+
+  ASSERT_EQ(string(SampleType<AdcFrame>::name), "int16Frame64x256");
+  ASSERT_EQ(FramePackStage<AdcFrame>::stageName, "int16Frame64x256FromSamples");
+  ASSERT_EQ((FrameSelectStage<AdcFrame, Frame<int16_t, 8, 256>>::stageName),
+            "int16Frame64x256Select8");
+
+  // Кадр сжимается как последовательность своих значений
+  ASSERT_TRUE((SampleCodec::Supports<Frame<int32_t, 8, 256>>(
+      SampleCompression::bitPacked)));
+  ASSERT_FALSE(SampleCodec::Supports<AdcFrame>(SampleCompression::delta));
+}
+
+TEST(Frame_tests, packDeinterleavesChannels) {
+  auto frame = packFrame();
+  for (size_t channel = 0; channel < SmallFrame::channels; ++channel)
+    for (size_t sample = 0; sample < SmallFrame::samples; ++sample)
+      ASSERT_EQ(frame->Channel(channel)[sample], sampleValue(channel, sample));
+}
+
+TEST(Frame_tests, selectCopiesChosenChannels) {
+  auto in = make_shared<SPMCStageConnection<SmallFrame>>(4);
+  auto out = make_shared<SPMCStageConnection<PairFrame>>(4);
+  in->setWaitPeriod(chrono::milliseconds{0});
+  out->setWaitPeriod(chrono::milliseconds{0});
+  auto consumerId = out->connectConsumer();
+
+  FrameSelectStage<SmallFrame, PairFrame> stage(ConsumptionStrategy::fifo, in,
+                                                out);
+  ASSERT_TRUE(stage.SetParameterValue("channels", "3, 1"));
+  stage.ApplyParameterValues();
+
+  auto task = in->getProducerTask();
+  *task->data = *packFrame();
+  in->taskProduced(task->data, 1, true);
+  ASSERT_TRUE(stage.step());
+
+  auto result =
+      out->getConsumerTask(consumerId, ConsumptionStrategy::fifo, 0);
+  ASSERT_TRUE(result);
+  for (size_t sample = 0; sample < PairFrame::samples; ++sample) {
+    ASSERT_EQ(result->data->Channel(0)[sample], sampleValue(3, sample));
+    ASSERT_EQ(result->data->Channel(1)[sample], sampleValue(1, sample));
+  }
+
+  for (auto channels : {"1", "0 4", "0 x"}) {
+    ASSERT_TRUE(stage.SetParameterValue("channels", channels));
+    ASSERT_THROW(stage.ApplyParameterValues(), invalid_argument) << channels;
+  }
+}
+
+TEST(Frame_tests, mergeJoinsChannelsOfAllInputs) {
+  vector<shared_ptr<SPMCStageConnection<PairFrame>>> inputs;
+  for (size_t i = 0; i < 2; ++i) {
+    inputs.push_back(make_shared<SPMCStageConnection<PairFrame>>(4));
+    inputs.back()->setWaitPeriod(chrono::milliseconds{0});
+  }
+  auto out = make_shared<SPMCStageConnection<SmallFrame>>(4);
+  out->setWaitPeriod(chrono::milliseconds{0});
+  auto consumerId = out->connectConsumer();
+
+  FrameMergeStage<PairFrame, SmallFrame> stage(ConsumptionStrategy::fifo,
+                                               {inputs[0], inputs[1]}, out);
+  ASSERT_EQ((FrameMergeStage<PairFrame, SmallFrame>::stageName),
+            "int16Frame2x3Merge4");
+
+  // на вход i приходят каналы 2i и 2i+1 собранного кадра
+  auto frame = packFrame();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto task = inputs[1 - i]->getProducerTask();
+    memcpy(task->data->data, frame->Channel(2 * (1 - i)),
+           sizeof(task->data->data));
+    inputs[1 - i]->taskProduced(task->data, 1, true);
+    ASSERT_TRUE(stage.step());
+  }
+
+  auto result =
+      out->getConsumerTask(consumerId, ConsumptionStrategy::fifo, 0);
+  ASSERT_TRUE(result);
+  for (size_t channel = 0; channel < SmallFrame::channels; ++channel)
+    for (size_t sample = 0; sample < SmallFrame::samples; ++sample)
+      ASSERT_EQ(result->data->Channel(channel)[sample],
+                sampleValue(channel, sample));
+
+  ASSERT_THROW((FrameMergeStage<PairFrame, SmallFrame>(
+                   ConsumptionStrategy::fifo, {inputs[0]}, out)),
+               invalid_argument);
+}
+
+TEST(Frame_tests, textRecordingHasLinePerSample) {
+  auto path = filesystem::temp_directory_path() / "frame_recording.txt";
+  auto connection = make_shared<SPMCStageConnection<SmallFrame>>(4);
+  connection->setWaitPeriod(chrono::milliseconds{0});
+
+  auto recorder = make_shared<FileRecorderStage<SmallFrame>>(
+      ConsumptionStrategy::fifo, connection);
+  recorder->SetParameterValue("filename", path.string());
+  recorder->SetParameterValue("format", "text");
+  recorder->ApplyParameterValues();
+
+  auto task = connection->getProducerTask();
+  *task->data = *packFrame();
+  connection->taskProduced(task->data, 1, true);
+  ASSERT_TRUE(recorder->step());
+  recorder->shutdown();
+
+  ifstream file(path, ios::binary);
+  string text(istreambuf_iterator<char>(file), {});
+  file.close();
+  filesystem::remove(path);
+  ASSERT_EQ(text,
+            "0\t100\t200\t300\n"
+            "1\t101\t201\t301\n"
+            "2\t102\t202\t302\n");
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include "KeyValueParameterized.h"
+#include "SPMCStageConnection.h"
+#include "WindowAggregationStage.h"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+/// Параметризуемый объект, открывающий разбор значений для проверки
+class TestParameterized : public KeyValueParameterized {
+ public:
+  TestParameterized() {
+    AddParameter("size", L"Размер", "1");
+    AddParameter("real", L"Число", "0.5");
+    AddParameter("flag", L"Флаг", "0");
+  }
+
+  void ApplyParameterValues() noexcept(false) override {}
+  bool IsFullyParameterized() const override { return true; }
+
+  using KeyValueParameterized::GetFlagParameter;
+  using KeyValueParameterized::GetRealParameter;
+  using KeyValueParameterized::GetSizeParameter;
+};
+}  // namespace
+
+TEST(KeyValueParameterized_tests, parametersKeepOrderAndDefaults) {
+  TestParameterized parameterized;
+
+  auto values = parameterized.GetPatameterValues();
+  ASSERT_EQ(values.size(), 3);
+  EXPECT_EQ(values[0].paramName, "size");
+  EXPECT_EQ(values[0].paramValue, "1");
+  EXPECT_EQ(values[2].paramName, "flag");
+  EXPECT_EQ(parameterized.GetObviousParamName("real"), wstring(L"Число"));
+
+  EXPECT_FALSE(parameterized.SetParameterValue("unknown", "1"));
+  EXPECT_FALSE(parameterized.GetObviousParamName("unknown"));
+  EXPECT_TRUE(parameterized.SetParameterValue("size", "42"));
+  EXPECT_EQ(parameterized.GetSizeParameter("size"), 42);
+}
+
+TEST(KeyValueParameterized_tests, sizeRejectsSignsAndTrailingCharacters) {
+  TestParameterized parameterized;
+
+  for (auto value : {"-1", "10x", " 5", "+5", "", "1.5",
+                     "99999999999999999999999"}) {
+    parameterized.SetParameterValue("size", value);
+    EXPECT_THROW(parameterized.GetSizeParameter("size"), invalid_argument)
+        << value;
+  }
+
+  parameterized.SetParameterValue("size", "0");
+  EXPECT_EQ(parameterized.GetSizeParameter("size"), 0);
+  EXPECT_THROW(parameterized.GetSizeParameter("size", 1), invalid_argument);
+}
+
+TEST(KeyValueParameterized_tests, realIsCheckedAgainstRange) {
+  TestParameterized parameterized;
+
+  for (auto value : {"nan", "inf", "1e999", "0.5s", " 1", ""}) {
+    parameterized.SetParameterValue("real", value);
+    EXPECT_THROW(parameterized.GetRealParameter("real"), invalid_argument)
+        << value;
+  }
+
+  parameterized.SetParameterValue("real", "-2.5");
+  EXPECT_EQ(parameterized.GetRealParameter("real"), -2.5);
+  EXPECT_THROW(parameterized.GetRealParameter("real", 0), invalid_argument);
+
+  // Бесконечность допустима, только если входит в диапазон
+  constexpr auto infinity = numeric_limits<double>::infinity();
+  parameterized.SetParameterValue("real", "-inf");
+  EXPECT_EQ(parameterized.GetRealParameter("real", -infinity, infinity),
+            -infinity);
+}
+
+TEST(KeyValueParameterized_tests, flagIsZeroOrOne) {
+  TestParameterized parameterized;
+
+  EXPECT_FALSE(parameterized.GetFlagParameter("flag"));
+  parameterized.SetParameterValue("flag", "1");
+  EXPECT_TRUE(parameterized.GetFlagParameter("flag"));
+  parameterized.SetParameterValue("flag", "yes");
+  EXPECT_THROW(parameterized.GetFlagParameter("flag"), invalid_argument);
+}
+
+TEST(KeyValueParameterized_tests, stageRejectsBadValues) {
+  auto in = make_shared<SPMCStageConnection<double>>(4);
+  auto out = make_shared<SPMCStageConnection<WindowStatistics>>(4);
+  WindowAggregationStage<double> stage(ConsumptionStrategy::fifo, in, out);
+
+  ASSERT_TRUE(stage.SetParameterValue("length", "-1"));
+  EXPECT_THROW(stage.ApplyParameterValues(), invalid_argument);
+  ASSERT_TRUE(stage.SetParameterValue("length", "10x"));
+  EXPECT_THROW(stage.ApplyParameterValues(), invalid_argument);
+
+  ASSERT_TRUE(stage.SetParameterValue("length", "10"));
+  ASSERT_TRUE(stage.SetParameterValue("hop", "5"));
+  EXPECT_NO_THROW(stage.ApplyParameterValues());
+}
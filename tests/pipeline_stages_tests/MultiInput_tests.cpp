@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include "JoinStage.h"
+#include "MergeStage.h"
+#include "Pipeline.h"
+#include "PipelineException.h"
+#include "SPMCStageConnection.h"
+#include "StageConnectionTest.h"
+#include "TimestampStage.h"
+#include "ZipStage.h"
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+
+class MultiInput_tests : public StageConnectionTest {};
+
+TEST_F(MultiInput_tests, mergeTakesInputsInTurn) {
+  auto a = makeConnection<int32_t>();
+  auto b = makeConnection<int32_t>();
+  auto out = makeConnection<int32_t>();
+  auto consumerId = out->connectConsumer();
+
+  auto merge = make_shared<MergeStage<int32_t>>(
+      ConsumptionStrategy::fifo,
+      vector<shared_ptr<InStageConnection<int32_t>>>{a, b}, out);
+  ASSERT_EQ(merge->getStageType(), PipelineStageType::producerConsumer);
+  ASSERT_EQ(merge->getInConnections(),
+            (vector<shared_ptr<StageConnection>>{a, b}));
+
+  produce(*a, {1, 2, 3});
+  produce(*b, {10});
+  for (size_t i = 0; i < 4; ++i)
+    ASSERT_TRUE(merge->step());
+  ASSERT_FALSE(merge->step());
+  ASSERT_EQ(consume(*out, consumerId), vector<int32_t>({1, 10, 2, 3}));
+
+  // Стадию источника нельзя удалить, пока из него берет данные слияние
+  Pipeline pipeline;
+  pipeline.addConnection(a);
+  pipeline.addConnection(b);
+  pipeline.addConnection(out);
+  pipeline.addStage(merge);
+  auto sourceIn = makeConnection<int32_t>();
+  auto source = make_shared<MergeStage<int32_t>>(
+      ConsumptionStrategy::fifo,
+      vector<shared_ptr<InStageConnection<int32_t>>>{sourceIn}, b);
+  pipeline.addStage(source);
+  ASSERT_THROW(pipeline.removeStage(source), PipelineException);
+  pipeline.removeStage(merge);
+  pipeline.removeStage(source);
+
+  ASSERT_THROW(MergeStage<int32_t>(ConsumptionStrategy::fifo, {a, a}, out),
+               invalid_argument);
+}
+
+TEST_F(MultiInput_tests, zipCombinesSamplesPairwise) {
+  auto current = makeConnection<int16_t>();
+  auto voltage = makeConnection<int16_t>();
+  auto out = makeConnection<double>();
+  auto consumerId = out->connectConsumer();
+
+  ZipStage<int16_t> power(ConsumptionStrategy::fifo, {current, voltage}, out);
+  ASSERT_TRUE(power.SetParameterValue("operation", "product"));
+  power.ApplyParameterValues();
+
+  // Опередивший вход ждет второй в своем соединении
+  produce(*current, {2, 3, 4});
+  produce(*voltage, {10});
+  while (power.step()) {
+  }
+  ASSERT_EQ(consume(*out, consumerId), vector<double>({20}));
+
+  produce(*voltage, {20, 30});
+  while (power.step()) {
+  }
+  ASSERT_EQ(consume(*out, consumerId), vector<double>({60, 120}));
+
+  ASSERT_TRUE(power.SetParameterValue("operation", "power"));
+  ASSERT_THROW(power.ApplyParameterValues(), invalid_argument);
+}
+
+TEST_F(MultiInput_tests, joinMatchesSamplesByTimestamp) {
+  auto a = makeConnection<TimedSample>();
+  auto b = makeConnection<TimedSample>();
+  auto out = makeConnection<TimedSample>();
+  auto consumerId = out->connectConsumer();
+
+  JoinStage join(ConsumptionStrategy::fifo, {a, b}, out);
+  ASSERT_TRUE(join.SetParameterValue("tolerance", "100"));
+  ASSERT_TRUE(join.SetParameterValue("operation", "difference"));
+  join.ApplyParameterValues();
+
+  produce(*a, {{0, 1}, {1000, 2}, {2000, 3}, {3000, 4}});
+  produce(*b, {{1010, 10}, {2050, 20}, {5000, 30}});
+  while (join.step()) {
+  }
+
+  auto joined = consume(*out, consumerId);
+  ASSERT_EQ(joined.size(), 2);
+  ASSERT_EQ(joined[0].timestampUs, 1000);
+  ASSERT_EQ(joined[0].value, -8);
+  ASSERT_EQ(joined[1].timestampUs, 2000);
+  ASSERT_EQ(joined[1].value, -17);
+  // Отсчеты 0 и 3000 входа a не нашли пары
+  ASSERT_EQ(join.GetDroppedCount(), 2);
+
+  // Из полного буфера вытесняются старые отсчеты
+  ASSERT_TRUE(join.SetParameterValue("buffer", "2"));
+  join.ApplyParameterValues();
+  produce(*a, {{6000, 1}, {7000, 2}, {8000, 3}});
+  while (join.step()) {
+  }
+  ASSERT_EQ(join.GetDroppedCount(), 3);
+
+  produce(*b, {{9000, 1}});
+  while (join.step()) {
+  }
+  ASSERT_TRUE(consume(*out, consumerId).empty());
+  ASSERT_EQ(join.GetDroppedCount(), 5);
+}
+
+TEST_F(MultiInput_tests, timestampsOfUniformSamplesAreSpaced) {
+  auto in = makeConnection<int32_t>();
+  auto out = makeConnection<TimedSample>();
+  auto consumerId = out->connectConsumer();
+
+  TimestampStage<int32_t> stage(ConsumptionStrategy::fifo, in, out);
+  ASSERT_TRUE(stage.SetParameterValue("period", "2.5"));
+  stage.ApplyParameterValues();
+
+  produce(*in, {7, 8, 9});
+  while (stage.step()) {
+  }
+
+  auto samples = consume(*out, consumerId);
+  ASSERT_EQ(samples.size(), 3);
+  ASSERT_EQ(samples[1].timestampUs - samples[0].timestampUs, 3);
+  ASSERT_EQ(samples[2].timestampUs - samples[0].timestampUs, 5);
+  ASSERT_EQ(samples[2].value, 9);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include "LogHistogram.h"
+#include "QuantileStage.h"
+#include "SPMCStageConnection.h"
+#include "SeqLockCell.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+
+TEST(QuantileStage_tests, quantilesMatchSortedData) {
+  const unsigned precision = 6;
+  LogHistogram histogram(precision);
+
+  mt19937_64 random(42);
+  lognormal_distribution<double> magnitude(0, 4);
+  vector<double> values;
+  for (int i = 0; i < 100000; ++i) {
+    double value = magnitude(random);
+    if (i % 3 == 0)
+      value = -value;
+    if (i % 101 == 0)
+      value = 0;
+    values.push_back(value);
+    histogram.Add(value);
+  }
+  histogram.Add(NAN);
+  sort(values.begin(), values.end());
+
+  ASSERT_EQ(histogram.GetTotalWeight(), values.size());
+  ASSERT_EQ(histogram.GetMin(), values.front());
+  ASSERT_EQ(histogram.GetMax(), values.back());
+  for (double quantile : {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999}) {
+    auto rank = size_t(ceil(quantile * double(values.size()))) - 1;
+    auto expected = values[rank];
+    EXPECT_NEAR(histogram.GetQuantile(quantile), expected,
+                abs(expected) * ldexp(1.0, -int(precision)))
+        << quantile;
+  }
+}
+
+TEST(QuantileStage_tests, decayForgetsOldValues) {
+  LogHistogram histogram(4);
+  for (int i = 0; i < 1000; ++i)
+    histogram.Add(1000);
+  histogram.Decay(0.5);
+  ASSERT_DOUBLE_EQ(histogram.GetTotalWeight(), 500);
+  ASSERT_DOUBLE_EQ(histogram.GetMean(), 1000);
+
+  for (int i = 0; i < 1500; ++i)
+    histogram.Add(1);
+  // Новые значения перевешивают старые втрое
+  ASSERT_NEAR(histogram.GetQuantile(0.5), 1, 1.0 / 16);
+  ASSERT_NEAR(histogram.GetQuantile(0.9), 1000, 1000.0 / 16);
+
+  // Вес 1000 опускается ниже пренебрежимого раньше, чем вес 1500
+  for (int i = 0; i < 29; ++i)
+    histogram.Decay(0.5);
+  ASSERT_EQ(histogram.GetMin(), 1);
+  ASSERT_NEAR(histogram.GetMax(), 1, 1.0 / 16);
+  ASSERT_NEAR(histogram.GetQuantile(0.99), 1, 1.0 / 16);
+
+  histogram.Clear();
+  ASSERT_EQ(histogram.GetTotalWeight(), 0);
+  ASSERT_EQ(histogram.GetQuantile(0.5), 0);
+  ASSERT_THROW(histogram.Decay(2), invalid_argument);
+  ASSERT_THROW(LogHistogram(0), invalid_argument);
+}
+
+TEST(QuantileStage_tests, seqLockReadersNeverSeeTornValues) {
+  struct Value {
+    uint64_t words[5];
+  };
+  SeqLockCell<Value> cell;
+  atomic<bool> done = false;
+
+  thread writer([&] {
+    for (uint64_t i = 1; i <= 200000; ++i) {
+      Value value;
+      fill(begin(value.words), end(value.words), i);
+      cell.Store(value);
+    }
+    done = true;
+  });
+
+  uint64_t last = 0;
+  while (!done) {
+    auto value = cell.Load();
+    for (auto word : value.words)
+      ASSERT_EQ(word, value.words[0]);
+    ASSERT_GE(value.words[0], last);
+    last = value.words[0];
+  }
+  writer.join();
+  ASSERT_EQ(cell.Load().words[4], 200000);
+}
+
+TEST(QuantileStage_tests, stagePublishesSnapshots) {
+  auto in = make_shared<SPMCStageConnection<int>>(32);
+  in->setWaitPeriod(chrono::milliseconds{0});
+
+  auto stage =
+      make_shared<QuantileStage<int>>(ConsumptionStrategy::fifo, in);
+  ASSERT_TRUE(stage->SetParameterValue("publishInterval", "0"));
+  ASSERT_TRUE(stage->SetParameterValue("window", "reset"));
+  ASSERT_TRUE(stage->SetParameterValue("windowInterval", "100000"));
+  stage->ApplyParameterValues();
+  ASSERT_EQ(stage->GetSnapshot().count, 0);
+
+  size_t lastProducedId = 0;
+  for (int value = 1; value <= 1000; ++value) {
+    auto task = in->getProducerTask();
+    *task->data = value;
+    in->taskProduced(task->data, ++lastProducedId, true);
+    ASSERT_TRUE(stage->step());
+  }
+  // Нет данных - публикация по onIdle
+  stage->step();
+
+  auto snapshot = stage->GetSnapshot();
+  ASSERT_EQ(snapshot.count, 1000);
+  ASSERT_EQ(snapshot.min, 1);
+  ASSERT_EQ(snapshot.max, 1000);
+  ASSERT_DOUBLE_EQ(snapshot.mean, 500.5);
+  ASSERT_NEAR(snapshot.p50, 500, 500.0 / 64);
+  ASSERT_NEAR(snapshot.p99, 990, 990.0 / 64);
+
+  ASSERT_TRUE(stage->SetParameterValue("window", "sliding"));
+  ASSERT_THROW(stage->ApplyParameterValues(), invalid_argument);
+  ASSERT_EQ(stage->GetSnapshot().count, 1000);
+}
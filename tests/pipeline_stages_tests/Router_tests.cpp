@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include "HashRouter.h"
+#include "Pipeline.h"
+#include "PipelineException.h"
+#include "RangeRouter.h"
+#include "SPMCStageConnection.h"
+#include "StageConnectionTest.h"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+
+class Router_tests : public StageConnectionTest {};
+
+TEST_F(Router_tests, rangeRouterSplitsOutOfRangeSamples) {
+  auto in = makeConnection<double>();
+  auto normal = makeConnection<double>();
+  auto alarm = makeConnection<double>();
+  auto normalId = normal->connectConsumer();
+  auto alarmId = alarm->connectConsumer();
+
+  auto router = make_shared<RangeRouter<double>>(
+      ConsumptionStrategy::fifo, in,
+      vector<shared_ptr<OutStageConnection<double>>>{normal, alarm});
+  ASSERT_EQ(router->getOutConnections(),
+            (vector<shared_ptr<StageConnection>>{normal, alarm}));
+  ASSERT_TRUE(router->SetParameterValue("low", "-1"));
+  ASSERT_TRUE(router->SetParameterValue("high", "1"));
+  router->ApplyParameterValues();
+
+  produce(*in, {0, 0.5, 2, -1, -3, numeric_limits<double>::quiet_NaN(), 1});
+  while (router->step()) {
+  }
+
+  // Каждая ветка получает только свою часть потока
+  ASSERT_EQ(consume(*normal, normalId), vector<double>({0, 0.5, -1, 1}));
+  auto alarms = consume(*alarm, alarmId);
+  ASSERT_EQ(alarms.size(), 3);
+  ASSERT_EQ(alarms[0], 2);
+  ASSERT_EQ(alarms[1], -3);
+  ASSERT_TRUE(std::isnan(alarms[2]));
+  ASSERT_EQ(router->getDroppedCount(), 0);
+
+  // Маршрутизатор нельзя удалить, пока из его выхода берет данные ветка
+  Pipeline pipeline;
+  pipeline.addConnection(in);
+  pipeline.addConnection(normal);
+  pipeline.addConnection(alarm);
+  pipeline.addStage(router);
+  auto branch = make_shared<RangeRouter<double>>(
+      ConsumptionStrategy::fifo, alarm,
+      vector<shared_ptr<OutStageConnection<double>>>{
+          makeConnection<double>(), makeConnection<double>()});
+  pipeline.addStage(branch);
+  ASSERT_THROW(pipeline.removeStage(router), PipelineException);
+  pipeline.removeStage(branch);
+  pipeline.removeStage(router);
+
+  ASSERT_TRUE(router->SetParameterValue("low", "2"));
+  ASSERT_THROW(router->ApplyParameterValues(), invalid_argument);
+  ASSERT_THROW(RangeRouter<double>(ConsumptionStrategy::fifo, in, {normal}),
+               invalid_argument);
+}
+
+TEST_F(Router_tests, busyOutputStallsRouter) {
+  auto in = makeConnection<int32_t>();
+  auto normal = makeConnection<int32_t>(1);
+  auto alarm = makeConnection<int32_t>();
+  auto normalId = normal->connectConsumer();
+  auto alarmId = alarm->connectConsumer();
+
+  RangeRouter<int32_t> router(ConsumptionStrategy::fifo, in, {normal, alarm});
+  ASSERT_TRUE(router.SetParameterValue("high", "10"));
+  router.ApplyParameterValues();
+
+  produce(*in, {1, 2, 20});
+  ASSERT_TRUE(router.step());
+  // Ветка еще обрабатывает единственную задачу своего соединения
+  auto busy = normal->getConsumerTask(normalId, ConsumptionStrategy::fifo, 0);
+  ASSERT_NE(busy, nullptr);
+  ASSERT_EQ(*busy->data, 1);
+
+  // Второй отсчет ждет места, следующие за ним тоже
+  ASSERT_FALSE(router.step());
+  ASSERT_FALSE(router.step());
+  ASSERT_TRUE(consume(*alarm, alarmId).empty());
+
+  normal->taskConsumed(busy->data, normalId, true);
+  while (router.step()) {
+  }
+  ASSERT_EQ(consume(*normal, normalId), vector<int32_t>({2}));
+  ASSERT_EQ(consume(*alarm, alarmId), vector<int32_t>({20}));
+}
+
+TEST_F(Router_tests, hashRouterKeepsEqualSamplesTogether) {
+  auto in = makeConnection<int64_t>(1024);
+  vector<shared_ptr<OutStageConnection<int64_t>>> outputs;
+  vector<shared_ptr<SPMCStageConnection<int64_t>>> connections;
+  vector<size_t> consumerIds;
+  for (size_t i = 0; i < 4; ++i) {
+    connections.push_back(makeConnection<int64_t>(1024));
+    consumerIds.push_back(connections.back()->connectConsumer());
+    outputs.push_back(connections.back());
+  }
+
+  HashRouter<int64_t> router(ConsumptionStrategy::fifo, in, outputs);
+
+  vector<int64_t> values;
+  for (int64_t i = 0; i < 400; ++i)
+    values.push_back(i % 200);
+  produce(*in, values);
+  while (router.step()) {
+  }
+
+  // Равные отсчеты в одном выходе, соседние значения распределены по всем
+  size_t total = 0;
+  vector<int> outputOf(200, -1);
+  for (size_t i = 0; i < connections.size(); ++i) {
+    auto routed = consume(*connections[i], consumerIds[i]);
+    ASSERT_GT(routed.size(), 40);
+    total += routed.size();
+    for (auto value : routed) {
+      ASSERT_TRUE(outputOf[value] == -1 || outputOf[value] == int(i));
+      outputOf[value] = int(i);
+    }
+  }
+  ASSERT_EQ(total, values.size());
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include "SampleCodec.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+template <typename T>
+vector<char> encode(SampleCompression compression, const vector<T>& values) {
+  vector<char> encoded;
+  SampleCodec::Encode(compression,
+                      reinterpret_cast<const char*>(values.data()),
+                      values.size() * sizeof(T), encoded);
+  return encoded;
+}
+
+template <typename T>
+vector<T> decode(const vector<char>& encoded, size_t chunkSize) {
+  SampleStreamDecoder decoder;
+  vector<char> decoded;
+  for (size_t offset = 0; offset < encoded.size(); offset += chunkSize)
+    decoder.Decode(encoded.data() + offset,
+                   min(chunkSize, encoded.size() - offset), decoded);
+  EXPECT_FALSE(decoder.HasIncompleteBlock());
+
+  vector<T> values(decoded.size() / sizeof(T));
+  memcpy(values.data(), decoded.data(), decoded.size());
+  return values;
+}
+
+vector<int> randomWalk(size_t count, int step) {
+  mt19937 random(17);
+  uniform_int_distribution<int> distribution(-step, step);
+  vector<int> values(count);
+  int value = 1000;
+  for (auto& sample : values)
+    sample = value += distribution(random);
+  return values;
+}
+}  // namespace
+
+TEST(SampleCodec_tests, integerCodecsRoundTrip) {
+  vector<vector<int>> inputs = {
+      {},
+      {42},
+      randomWalk(1000, 100),
+      randomWalk(300, 1 << 20),
+      vector<int>(200, -7),
+      {numeric_limits<int>::min(), numeric_limits<int>::max(), 0,
+       numeric_limits<int>::min(), -1, numeric_limits<int>::max()}};
+  // линейный рост - вторые разности нулевые
+  inputs.emplace_back();
+  for (int i = 0; i < 500; ++i)
+    inputs.back().push_back(3 * i - 700);
+
+  for (auto compression :
+       {SampleCompression::delta, SampleCompression::deltaOfDelta,
+        SampleCompression::bitPacked}) {
+    for (auto& values : inputs) {
+      auto encoded = encode(compression, values);
+      ASSERT_TRUE(SampleCodec::IsEncoded(encoded.data(), encoded.size()));
+      for (size_t chunkSize : {size_t(1), size_t(7), encoded.size()})
+        ASSERT_EQ(decode<int>(encoded, chunkSize), values)
+            << int(compression) << " " << values.size();
+    }
+  }
+}
+
+TEST(SampleCodec_tests, smoothSignalsCompress) {
+  auto walk = randomWalk(10'000, 100);
+  auto rawSize = walk.size() * sizeof(int);
+  // разности до 100 укладываются в 8 бит
+  ASSERT_LT(encode(SampleCompression::delta, walk).size(), rawSize / 2);
+  ASSERT_LT(encode(SampleCompression::bitPacked, walk).size(), rawSize / 3);
+
+  vector<int> ramp;
+  for (int i = 0; i < 10'000; ++i)
+    ramp.push_back(5 * i);
+  ASSERT_LT(encode(SampleCompression::deltaOfDelta, ramp).size(),
+            rawSize / 3);
+
+  vector<double> slow(10'000, 1.5);
+  for (size_t i = 0; i < slow.size(); i += 100)
+    slow[i] = 2.25;
+  ASSERT_LT(encode(SampleCompression::gorilla, slow).size(),
+            slow.size() * sizeof(double) / 16);
+}
+
+TEST(SampleCodec_tests, gorillaKeepsExactBits) {
+  mt19937 random(5);
+  normal_distribution<double> distribution(0, 1e3);
+  vector<double> values = {0.0, -0.0, 1.0, 1.0,
+                           numeric_limits<double>::infinity(),
+                           numeric_limits<double>::quiet_NaN(),
+                           numeric_limits<double>::denorm_min(), -1e300};
+  for (int i = 0; i < 1000; ++i)
+    values.push_back(distribution(random));
+
+  auto encoded = encode(SampleCompression::gorilla, values);
+  auto decoded = decode<double>(encoded, 13);
+  ASSERT_EQ(decoded.size(), values.size());
+  ASSERT_EQ(memcmp(decoded.data(), values.data(),
+                   values.size() * sizeof(double)),
+            0);
+}
+
+TEST(SampleCodec_tests, invalidInputIsRejected) {
+  ASSERT_THROW(SampleCodec::ParseCompression("zip"), invalid_argument);
+  ASSERT_EQ(SampleCodec::GetCompressionName(SampleCompression::deltaOfDelta),
+            "deltaOfDelta");
+  ASSERT_EQ(SampleCodec::ParseCompression(
+                SampleCodec::GetCompressionName(SampleCompression::gorilla)),
+            SampleCompression::gorilla);
+  ASSERT_TRUE(SampleCodec::Supports<int>(SampleCompression::bitPacked));
+  ASSERT_FALSE(SampleCodec::Supports<double>(SampleCompression::delta));
+  ASSERT_FALSE(SampleCodec::Supports<int>(SampleCompression::gorilla));
+
+  auto encoded = encode(SampleCompression::delta, randomWalk(100, 10));
+  SampleStreamDecoder decoder;
+  vector<char> decoded;
+
+  // блок без конца
+  decoder.Decode(encoded.data(), encoded.size() - 1, decoded);
+  ASSERT_TRUE(decoded.empty());
+  ASSERT_TRUE(decoder.HasIncompleteBlock());
+  decoder.Reset();
+
+  encoded[4] = 42;  // неизвестный способ сжатия
+  ASSERT_THROW(decoder.Decode(encoded.data(), encoded.size(), decoded),
+               runtime_error);
+  ASSERT_FALSE(decoder.HasIncompleteBlock());
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include "SPMCStageConnection.h"
+#include "SignalGenerator.h"
+
+#include <cmath>
+#include <numeric>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+template <typename T>
+class Generator {
+ public:
+  explicit Generator(const map<string, string>& parameters) {
+    m_out->setWaitPeriod(chrono::milliseconds{0});
+    m_consumerId = m_out->connectConsumer();
+
+    m_stage = make_shared<SignalGenerator<T>>(m_out);
+    for (auto& [key, value] : parameters)
+      EXPECT_TRUE(m_stage->SetParameterValue(key, value));
+    m_stage->ApplyParameterValues();
+  }
+
+  vector<T> generate(size_t count) {
+    vector<T> values;
+    while (values.size() < count) {
+      m_stage->step();
+      auto task = m_out->getConsumerTask(
+          m_consumerId, ConsumptionStrategy::fifo, m_lastConsumedId);
+      if (!task)
+        continue;
+
+      m_lastConsumedId = task->taskId;
+      values.push_back(*task->data);
+      m_out->taskConsumed(task->data, m_consumerId, true);
+    }
+
+    return values;
+  }
+
+ private:
+  shared_ptr<SPMCStageConnection<T>> m_out =
+      make_shared<SPMCStageConnection<T>>(32);
+  shared_ptr<SignalGenerator<T>> m_stage;
+  size_t m_consumerId = 0;
+  size_t m_lastConsumedId = 0;
+};
+}  // namespace
+
+TEST(SignalGenerator_tests, counterCountsFromOffset) {
+  Generator<int> generator(
+      {{"signal", "counter"}, {"offset", "-2"}, {"throttle", "0"}});
+  ASSERT_EQ(generator.generate(5), vector<int>({-2, -1, 0, 1, 2}));
+}
+
+TEST(SignalGenerator_tests, uniformIsReproducibleAndBounded) {
+  map<string, string> parameters = {
+      {"amplitude", "3"}, {"offset", "10"}, {"seed", "42"}, {"throttle", "0"}};
+  auto values = Generator<int>(parameters).generate(10'000);
+  ASSERT_EQ(Generator<int>(parameters).generate(10'000), values);
+
+  // все значения 7..13 встречаются
+  vector<size_t> histogram(7);
+  for (auto value : values) {
+    ASSERT_GE(value, 7);
+    ASSERT_LE(value, 13);
+    ++histogram[value - 7];
+  }
+  for (auto count : histogram)
+    ASSERT_GT(count, 1'000);
+}
+
+TEST(SignalGenerator_tests, gaussianHasConfiguredMoments) {
+  auto values = Generator<double>({{"signal", "gaussian"},
+                                   {"amplitude", "2"},
+                                   {"offset", "5"},
+                                   {"throttle", "0"}})
+                    .generate(100'000);
+
+  auto mean = accumulate(values.begin(), values.end(), 0.0) / values.size();
+  double variance = 0;
+  for (auto value : values)
+    variance += (value - mean) * (value - mean);
+  variance /= values.size();
+
+  ASSERT_NEAR(mean, 5, 0.05);
+  ASSERT_NEAR(variance, 4, 0.1);
+}
+
+TEST(SignalGenerator_tests, sineFollowsSampleTime) {
+  auto values = Generator<double>({{"signal", "sine"},
+                                   {"rate", "8"},
+                                   {"frequency", "2"},
+                                   {"throttle", "0"}})
+                    .generate(5);
+
+  // четверть периода на отсчет
+  vector<double> expected = {0, 100, 0, -100, 0};
+  for (size_t i = 0; i < values.size(); ++i)
+    ASSERT_NEAR(values[i], expected[i], 1e-9);
+}
+
+TEST(SignalGenerator_tests, throttledGeneratorKeepsRate) {
+  Generator<int> generator(map<string, string>{{"rate", "2000"}});
+
+  auto started = chrono::steady_clock::now();
+  generator.generate(201);
+  auto elapsed = chrono::steady_clock::now() - started;
+
+  ASSERT_GE(elapsed, chrono::milliseconds(100));
+  ASSERT_LT(elapsed, chrono::milliseconds(500));
+}
@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+
+#include "SPMCStageConnection.h"
+#include "SocketReadStage.h"
+#include "SocketWriteStage.h"
+
+#include <filesystem>
+#include <numeric>
+#include <thread>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+struct Sample {
+  int32_t channel;
+  double value;
+};
+
+class SocketStages_test : public Test {
+ protected:
+  void SetUp() override {
+    m_in->setWaitPeriod(chrono::milliseconds{0});
+    m_out->setWaitPeriod(chrono::milliseconds{0});
+    m_outConsumerId = m_out->connectConsumer();
+  }
+
+  void TearDown() override {
+    m_writer.reset();
+    m_reader.reset();
+    filesystem::remove(SocketPath);
+  }
+
+  void setUpStages(const string& window,
+                   const string& batchSize,
+                   const string& flushInterval = "10000000") {
+    m_reader = make_shared<SocketReadStage<int>>(m_out);
+    m_reader->SetParameterValue("address", Address);
+    m_reader->SetParameterValue("window", window);
+    m_reader->ApplyParameterValues();
+
+    m_writer = make_shared<SocketWriteStage<int>>(ConsumptionStrategy::fifo,
+                                                  m_in);
+    m_writer->SetParameterValue("address", Address);
+    m_writer->SetParameterValue("batchSize", batchSize);
+    m_writer->SetParameterValue("flushInterval", flushInterval);
+    m_writer->ApplyParameterValues();
+  }
+
+  // writes the value to the writer input and lets the writer consume it
+  void write(int value) {
+    auto task = m_in->getProducerTask();
+    *task->data = value;
+    m_in->taskProduced(task->data, ++m_lastProducedId, true);
+    ASSERT_TRUE(m_writer->step());
+  }
+
+  vector<int> read(size_t count) {
+    vector<int> values;
+    for (size_t i = 0; i < count; ++i) {
+      m_reader->step();
+      auto task = m_out->getConsumerTask(m_outConsumerId,
+                                         ConsumptionStrategy::fifo,
+                                         m_lastConsumedId);
+      if (!task)
+        break;
+
+      m_lastConsumedId = task->taskId;
+      values.push_back(*task->data);
+      m_out->taskConsumed(task->data, m_outConsumerId, true);
+    }
+
+    return values;
+  }
+
+  static constexpr auto SocketPath = "socket_stages_test.sock";
+  static inline const string Address = string("unix:") + SocketPath;
+
+  shared_ptr<SPMCStageConnection<int>> m_in =
+      make_shared<SPMCStageConnection<int>>(32);
+  shared_ptr<SPMCStageConnection<int>> m_out =
+      make_shared<SPMCStageConnection<int>>(32);
+  shared_ptr<SocketReadStage<int>> m_reader;
+  shared_ptr<SocketWriteStage<int>> m_writer;
+  size_t m_outConsumerId = 0;
+  size_t m_lastProducedId = 0;
+  size_t m_lastConsumedId = 0;
+};
+}  // namespace
+
+TEST(SocketChannel_tests, vectoredSendIsReceivedWhole) {
+  auto listener = SocketChannel::listen("tcp:127.0.0.1:0");
+  auto address = listener.localAddress();
+  ASSERT_NE(address, "tcp:127.0.0.1:0");
+
+  auto sender = SocketChannel::connect(address);
+  auto receiver = listener.accept(chrono::milliseconds{1000});
+  ASSERT_TRUE(receiver.isOpen());
+
+  SocketFrameHeader header{sizeof(Sample), 2};
+  Sample samples[] = {{1, 0.5}, {2, 1.5}};
+  SocketChannel::Buffer buffers[] = {{&header, sizeof(header)},
+                                     {&samples[0], sizeof(Sample)},
+                                     {&samples[1], sizeof(Sample)}};
+  sender.send(buffers, size(buffers));
+
+  SocketFrameHeader receivedHeader{};
+  Sample received[2]{};
+  ASSERT_TRUE(receiver.receive(&receivedHeader, sizeof(receivedHeader),
+                               chrono::milliseconds{1000}));
+  ASSERT_TRUE(receiver.receive(received, sizeof(received),
+                               chrono::milliseconds{1000}));
+  EXPECT_EQ(receivedHeader.taskSize, sizeof(Sample));
+  EXPECT_EQ(receivedHeader.taskCount, 2);
+  EXPECT_EQ(received[1].channel, 2);
+  EXPECT_EQ(received[1].value, 1.5);
+
+  int value = 0;
+  EXPECT_FALSE(receiver.receive(&value, sizeof(value),
+                                chrono::milliseconds{10}));
+
+  sender.close();
+  EXPECT_THROW(receiver.receive(&value, sizeof(value),
+                                chrono::milliseconds{1000}),
+               SocketChannelException);
+}
+
+TEST(SocketChannel_tests, unknownAddressThrows) {
+  EXPECT_THROW(SocketChannel::listen("udp:127.0.0.1:1"), invalid_argument);
+  EXPECT_THROW(SocketChannel::connect("tcp:127.0.0.1"), invalid_argument);
+}
+
+TEST_F(SocketStages_test, tasksAreDeliveredInOrder) {
+  setUpStages("8", "4");
+
+  // the writer connects on the first task, the reader grants credits
+  // when accepts the connection
+  write(0);
+  ASSERT_TRUE(read(1).empty());
+
+  // more tasks than the credit window, credits are returned by the reader
+  vector<int> received;
+  for (int value = 1; value < 20; ++value) {
+    write(value);
+    if (value % 4 == 3) {
+      auto values = read(4);
+      received.insert(received.end(), values.begin(), values.end());
+    }
+  }
+
+  vector<int> expected(20);
+  iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(received, expected);
+  ASSERT_EQ(m_writer->getStatistics().failedCount, 0);
+}
+
+TEST_F(SocketStages_test, partialBatchIsFlushedWhenIdle) {
+  setUpStages("8", "4", "200000");
+  write(7);
+  read(1);
+  write(8);
+
+  // no input, but the batch is kept until the flush interval has passed
+  ASSERT_FALSE(m_writer->step());
+  ASSERT_TRUE(read(1).empty());
+
+  this_thread::sleep_for(chrono::milliseconds{250});
+  ASSERT_FALSE(m_writer->step());
+  ASSERT_EQ(read(2), (vector<int>{7, 8}));
+}
+
+TEST_F(SocketStages_test, tasksWithoutCreditsAreDropped) {
+  setUpStages("2", "4", "200000");
+  write(0);
+  read(1);
+  for (int value = 1; value < 4; ++value)
+    write(value);
+
+  // only two tasks fit into the window, the rest is dropped after the wait
+  this_thread::sleep_for(chrono::milliseconds{250});
+  m_writer->step();
+  ASSERT_EQ(m_writer->getStatistics().failedCount, 1);
+  ASSERT_EQ(read(4), (vector<int>{0, 1}));
+}
+
+TEST_F(SocketStages_test, unexpectedFrameIsRejected) {
+  setUpStages("8", "4");
+  auto sender = SocketChannel::connect(Address);
+
+  SocketFrameHeader header{sizeof(double), 1};
+  double value = 1;
+  SocketChannel::Buffer buffers[] = {{&header, sizeof(header)},
+                                     {&value, sizeof(value)}};
+  sender.send(buffers, size(buffers));
+
+  ASSERT_TRUE(read(1).empty());
+  ASSERT_TRUE(read(1).empty());
+  ASSERT_EQ(m_reader->getStatistics().failedCount, 1);
+}
+
+TEST_F(SocketStages_test, invalidParametersThrow) {
+  SocketWriteStage<int> writer(ConsumptionStrategy::fifo, m_in);
+  ASSERT_THROW(writer.ApplyParameterValues(), invalid_argument);
+
+  writer.SetParameterValue("address", Address);
+  writer.SetParameterValue("batchSize", "0");
+  ASSERT_THROW(writer.ApplyParameterValues(), invalid_argument);
+  ASSERT_FALSE(writer.IsFullyParameterized());
+
+  writer.SetParameterValue("batchSize", "16");
+  writer.ApplyParameterValues();
+  ASSERT_TRUE(writer.IsFullyParameterized());
+}
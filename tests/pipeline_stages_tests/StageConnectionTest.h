@@ -0,0 +1,51 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "SPMCStageConnection.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+/// Основа тестов стадий, задачи которым тест передает через соединения
+class StageConnectionTest : public testing::Test {
+ protected:
+  /// Соединение, не ожидающее задач
+  template <typename T>
+  static std::shared_ptr<SPMCStageConnection<T>> makeConnection(
+      size_t size = 16) {
+    auto connection = std::make_shared<SPMCStageConnection<T>>(size);
+    connection->setWaitPeriod(std::chrono::milliseconds{0});
+    return connection;
+  }
+
+  /// Задачи получают возрастающие номера, как у стадии-производителя
+  template <typename T>
+  void produce(SPMCStageConnection<T>& connection,
+               const std::vector<T>& values) {
+    for (const auto& value : values) {
+      auto task = connection.getProducerTask();
+      *task->data = value;
+      connection.taskProduced(task->data, ++m_lastProducedTaskId, true);
+    }
+  }
+
+  /// Все задачи соединения, еще не полученные потребителем consumerId
+  template <typename T>
+  static std::vector<T> consume(SPMCStageConnection<T>& connection,
+                                size_t consumerId) {
+    std::vector<T> values;
+    size_t lastTaskId = 0;
+    while (auto task = connection.getConsumerTask(
+               consumerId, ConsumptionStrategy::fifo, lastTaskId)) {
+      values.push_back(*task->data);
+      lastTaskId = task->taskId;
+      connection.taskConsumed(task->data, consumerId, true);
+    }
+    return values;
+  }
+
+ private:
+  size_t m_lastProducedTaskId = 0;  ///< Номер последней переданной задачи
+};
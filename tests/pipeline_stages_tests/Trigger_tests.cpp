@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#include "SPMCStageConnection.h"
+#include "ThresholdKernel.h"
+#include "TriggerDetector.h"
+#include "TriggerStage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+/// Все готовые события детектора
+vector<TriggerEvent> takeEvents(TriggerDetector& detector) {
+  vector<TriggerEvent> events;
+  while (auto event = detector.Front()) {
+    events.push_back(*event);
+    detector.Pop();
+  }
+  return events;
+}
+
+/// Обработать data пачками по batch, забирая события после каждой
+vector<TriggerEvent> detect(const TriggerDetector::Settings& settings,
+                            const vector<double>& data,
+                            size_t batch) {
+  TriggerDetector detector(settings);
+  vector<TriggerEvent> events;
+  for (size_t i = 0; i < data.size(); i += batch) {
+    detector.Process(data.data() + i, min(batch, data.size() - i), 0);
+    auto taken = takeEvents(detector);
+    events.insert(events.end(), taken.begin(), taken.end());
+  }
+  EXPECT_EQ(detector.GetDroppedCount(), 0);
+  return events;
+}
+
+/// Номера отсчетов срабатывания
+vector<uint64_t> indices(const vector<TriggerEvent>& events) {
+  vector<uint64_t> result;
+  for (auto& event : events)
+    result.push_back(event.index);
+  return result;
+}
+}  // namespace
+
+TEST(Trigger_tests, kernelFindsFirstValueOutside) {
+  const double nan = numeric_limits<double>::quiet_NaN();
+  mt19937 random(1);
+  uniform_real_distribution<double> values(-1, 1);
+  vector<double> data(1000);
+  for (auto& value : data)
+    value = values(random);
+
+  for (auto [low, high] : {pair{-0.99, 0.99}, pair{nan, 0.999},
+                           pair{-0.999, nan}, pair{-2.0, 2.0}}) {
+    for (size_t start : {0, 1, 3, 500}) {
+      size_t expected = start;
+      while (expected < data.size() && !(data[expected] <= low) &&
+             !(data[expected] >= high))
+        ++expected;
+      ASSERT_EQ(start + FindFirstOutside(data.data() + start,
+                                         data.size() - start, low, high),
+                expected);
+    }
+  }
+}
+
+TEST(Trigger_tests, hysteresisSuppressesNoiseAndWindowsAreCaptured) {
+  TriggerDetector::Settings settings;
+  settings.level = 1;
+  settings.hysteresis = 0.5;
+  settings.preSamples = 2;
+  settings.postSamples = 3;
+  TriggerDetector detector(settings);
+
+  // Шум около уровня (0.9 .. 1.1) не взводит триггер повторно
+  vector<double> data = {0, 0.2, 1.1, 0.9, 1.1, 0.9, 1.2, 0.4, 0.6, 2, 3};
+  detector.Process(data.data(), data.size(), 42);
+
+  auto events = takeEvents(detector);
+  ASSERT_EQ(indices(events), vector<uint64_t>({2}));
+  ASSERT_EQ(events[0].preSamples, 2);
+  ASSERT_EQ(events[0].sampleCount, 5);
+  ASSERT_EQ(vector<double>(events[0].values, events[0].values + 5),
+            vector<double>({0, 0.2, 1.1, 0.9, 1.1}));
+  ASSERT_EQ(events[0].timestampUs, 42);
+  ASSERT_EQ(events[0].rising, 1);
+
+  // Второе событие ждет последнего отсчета окна после срабатывания
+  ASSERT_EQ(detector.Front(), nullptr);
+  double last = 5;
+  detector.Process(&last, 1, 43);
+  events = takeEvents(detector);
+  ASSERT_EQ(indices(events), vector<uint64_t>({9}));
+  ASSERT_EQ(vector<double>(events[0].values, events[0].values + 5),
+            vector<double>({0.4, 0.6, 2, 3, 5}));
+  ASSERT_EQ(events[0].timestampUs, 42);
+}
+
+TEST(Trigger_tests, edgesHoldoffAndBatchingAgree) {
+  // Синус с периодом 100: спад через 0 у отсчета 50, фронт - у 100
+  constexpr double twoPi = 6.283185307179586;
+  vector<double> data(5000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = sin((double(i) + 0.5) * twoPi / 100);
+
+  TriggerDetector::Settings settings;
+  settings.hysteresis = 0.1;
+  settings.preSamples = 10;
+  settings.postSamples = 20;
+
+  settings.edge = TriggerDetector::Edge::rising;
+  auto events = detect(settings, data, 1000);
+  ASSERT_EQ(events.size(), 49);
+  for (auto& event : events) {
+    ASSERT_EQ(event.index % 100, 0);
+    ASSERT_EQ(event.rising, 1);
+    ASSERT_GE(event.values[event.preSamples], 0);
+    ASSERT_LT(event.values[event.preSamples - 1], 0);
+  }
+
+  settings.edge = TriggerDetector::Edge::falling;
+  events = detect(settings, data, 1000);
+  ASSERT_EQ(events.size(), 50);
+  ASSERT_EQ(events[0].index, 50);
+  ASSERT_EQ(events[0].rising, 0);
+
+  // holdoff 60 пропускает фронт после каждого спада
+  settings.edge = TriggerDetector::Edge::both;
+  settings.holdoff = 60;
+  ASSERT_EQ(detect(settings, data, 1000).size(), 50);
+
+  settings.holdoff = 30;
+  events = detect(settings, data, 1);
+  ASSERT_EQ(events.size(), 99);
+  for (size_t i = 0; i < events.size(); ++i) {
+    ASSERT_EQ(events[i].index, 50 * (i + 1));
+    ASSERT_EQ(events[i].rising, i % 2);
+  }
+  for (size_t batch : {7, 100, 500})
+    ASSERT_EQ(indices(detect(settings, data, batch)), indices(events))
+        << batch;
+}
+
+TEST(Trigger_tests, eventsOverQueueAreDropped) {
+  vector<double> data(2000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = i % 10 < 5 ? -1 : 1;
+
+  TriggerDetector::Settings settings;
+  settings.postSamples = 3;
+  TriggerDetector detector(settings);
+  detector.Process(data.data(), data.size(), 0);
+  ASSERT_EQ(takeEvents(detector).size(), TriggerDetector::maxEvents);
+  ASSERT_EQ(detector.GetDroppedCount(), 200 - TriggerDetector::maxEvents);
+
+  settings.preSamples = TriggerEvent::maxSamples;
+  ASSERT_THROW(TriggerDetector{settings}, invalid_argument);
+  settings.preSamples = 0;
+  settings.postSamples = 0;
+  ASSERT_THROW(TriggerDetector{settings}, invalid_argument);
+}
+
+TEST(Trigger_tests, stageEmitsEvents) {
+  auto in = make_shared<SPMCStageConnection<int16_t>>(32);
+  auto out = make_shared<SPMCStageConnection<TriggerEvent>>(4);
+  in->setWaitPeriod(chrono::milliseconds{0});
+  out->setWaitPeriod(chrono::milliseconds{0});
+  auto consumerId = out->connectConsumer();
+
+  TriggerStage<int16_t> stage(ConsumptionStrategy::fifo, in, out);
+  ASSERT_TRUE(stage.SetParameterValue("level", "100"));
+  ASSERT_TRUE(stage.SetParameterValue("pre", "1"));
+  ASSERT_TRUE(stage.SetParameterValue("post", "2"));
+  ASSERT_TRUE(stage.SetParameterValue("batch", "4"));
+  stage.ApplyParameterValues();
+
+  size_t lastProducedId = 0;
+  for (int16_t value : {0, 50, 150, 200, 0, 0, 0, 0}) {
+    auto task = in->getProducerTask();
+    *task->data = value;
+    in->taskProduced(task->data, ++lastProducedId, true);
+    ASSERT_TRUE(stage.step());
+  }
+
+  auto result = out->getConsumerTask(consumerId, ConsumptionStrategy::fifo, 0);
+  ASSERT_TRUE(result);
+  ASSERT_EQ(result->data->index, 2);
+  ASSERT_EQ(result->data->sampleCount, 3);
+  ASSERT_EQ(vector<double>(result->data->values, result->data->values + 3),
+            vector<double>({50, 150, 200}));
+  out->taskConsumed(result->data, consumerId, true);
+  ASSERT_FALSE(out->getConsumerTask(consumerId, ConsumptionStrategy::fifo,
+                                    result->taskId));
+
+  ASSERT_TRUE(stage.SetParameterValue("edge", "sideways"));
+  ASSERT_THROW(stage.ApplyParameterValues(), invalid_argument);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include "WindowAggregator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+WindowStatistics bruteForce(vector<double>::const_iterator begin,
+                            vector<double>::const_iterator end) {
+  WindowStatistics statistics{};
+  statistics.count = uint64_t(end - begin);
+  statistics.min = *min_element(begin, end);
+  statistics.max = *max_element(begin, end);
+  statistics.mean = accumulate(begin, end, 0.0) / double(statistics.count);
+  double squares = 0;
+  for (auto it = begin; it != end; ++it) {
+    statistics.variance += (*it - statistics.mean) * (*it - statistics.mean);
+    squares += *it * *it;
+  }
+  statistics.variance /= double(statistics.count);
+  statistics.rms = sqrt(squares / double(statistics.count));
+  return statistics;
+}
+
+void expectNear(const WindowStatistics& actual,
+                const WindowStatistics& expected) {
+  EXPECT_EQ(actual.count, expected.count);
+  EXPECT_EQ(actual.min, expected.min);
+  EXPECT_EQ(actual.max, expected.max);
+  EXPECT_NEAR(actual.mean, expected.mean, 1e-6);
+  EXPECT_NEAR(actual.variance, expected.variance, 1e-6);
+  EXPECT_NEAR(actual.rms, expected.rms, 1e-6);
+}
+}  // namespace
+
+TEST(WindowAggregator_tests, tumblingCountWindows) {
+  WindowAggregator aggregator(WindowAggregator::Mode::count, 4, 0);
+
+  vector<WindowStatistics> windows;
+  for (int i = 1; i <= 10; ++i) {
+    if (auto statistics = aggregator.Add(i, 0))
+      windows.push_back(*statistics);
+  }
+
+  ASSERT_EQ(windows.size(), 2);
+  vector<double> values = {1, 2, 3, 4, 5, 6, 7, 8};
+  expectNear(windows[0], bruteForce(values.begin(), values.begin() + 4));
+  expectNear(windows[1], bruteForce(values.begin() + 4, values.end()));
+}
+
+TEST(WindowAggregator_tests, slidingCountWindowsMatchBruteForce) {
+  const size_t length = 50;
+  const size_t hop = 7;
+  WindowAggregator aggregator(WindowAggregator::Mode::count, length, hop);
+
+  vector<double> values;
+  size_t emitted = 0;
+  for (size_t i = 0; i < 1000; ++i) {
+    // пилообразный сигнал с шумом, чтобы минимум и максимум менялись
+    values.push_back(double(i % 37) - 0.5 * double(i % 11) + 1e6);
+    auto statistics = aggregator.Add(values.back(), 0);
+    bool expected =
+        values.size() >= length && (values.size() - length) % hop == 0;
+    ASSERT_EQ(bool(statistics), expected) << i;
+    if (!statistics)
+      continue;
+
+    ++emitted;
+    expectNear(*statistics, bruteForce(values.end() - length, values.end()));
+  }
+  ASSERT_EQ(emitted, (1000 - length) / hop + 1);
+}
+
+TEST(WindowAggregator_tests, tumblingTimeWindowsSkipEmptyOnes) {
+  WindowAggregator aggregator(WindowAggregator::Mode::time, 100, 0);
+
+  ASSERT_FALSE(aggregator.Add(1, 0));
+  ASSERT_FALSE(aggregator.Add(3, 99));
+  // окно [0, 100) закрывается первым значением после границы
+  auto first = aggregator.Add(10, 150);
+  ASSERT_TRUE(first);
+  EXPECT_EQ(first->count, 2);
+  EXPECT_EQ(first->mean, 2);
+
+  // окна [200, 400) пустые и не выдаются
+  auto second = aggregator.Add(20, 420);
+  ASSERT_TRUE(second);
+  EXPECT_EQ(second->count, 1);
+  EXPECT_EQ(second->max, 10);
+
+  ASSERT_FALSE(aggregator.Add(30, 450));
+  auto third = aggregator.Add(0, 500);
+  ASSERT_TRUE(third);
+  EXPECT_EQ(third->count, 2);
+  EXPECT_EQ(third->min, 20);
+}
+
+TEST(WindowAggregator_tests, boundaryValueStartsNextTimeWindow) {
+  WindowAggregator tumbling(WindowAggregator::Mode::time, 100, 0);
+  WindowAggregator sliding(WindowAggregator::Mode::time, 100, 50);
+
+  for (auto* aggregator : {&tumbling, &sliding}) {
+    ASSERT_FALSE(aggregator->Add(1, 0));
+    ASSERT_FALSE(aggregator->Add(2, 50));
+    // окно [0, 100) не включает значение на границе
+    auto statistics = aggregator->Add(3, 100);
+    ASSERT_TRUE(statistics);
+    EXPECT_EQ(statistics->count, 2);
+    EXPECT_EQ(statistics->max, 2);
+  }
+
+  // окно [50, 150) включает значение, пришедшее на границе 100
+  auto statistics = sliding.Add(4, 150);
+  ASSERT_TRUE(statistics);
+  EXPECT_EQ(statistics->count, 2);
+  EXPECT_EQ(statistics->min, 2);
+  EXPECT_EQ(statistics->max, 3);
+}
+
+TEST(WindowAggregator_tests, invalidWindowIsRejected) {
+  ASSERT_THROW(WindowAggregator(WindowAggregator::Mode::count, 0, 0),
+               invalid_argument);
+  ASSERT_THROW(WindowAggregator(WindowAggregator::Mode::time, 10, 11),
+               invalid_argument);
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include "ConnectionCapacityTuner.h"
+#include "MultiOutputStage.h"
+#include "ProducerStage.h"
+#include "SPMCStageConnection.h"
+
+#include <chrono>
+
+using namespace std;
+
+namespace {
+class IdleProducer : public ProducerStage<int> {
+ public:
+  IdleProducer(weak_ptr<OutStageConnection<int>> outConnection)
+      : ProducerStage("IdleProducer", outConnection) {}
+
+  void produce(shared_ptr<int> outData) override {
+    dataProduced(outData, false);
+  }
+};
+
+class IdleRouter : public MultiOutputStage<int> {
+ public:
+  IdleRouter(shared_ptr<InStageConnection<int>> inConnection,
+             const vector<shared_ptr<OutStageConnection<int>>>& outConnections)
+      : MultiOutputStage("IdleRouter",
+                         ConsumptionStrategy::fifo,
+                         inConnection,
+                         outConnections) {
+    setOutputNames({"low", "high"});
+  }
+
+ protected:
+  size_t route(const int&) override { return 0; }
+};
+}  // namespace
+
+TEST(ConnectionCapacityTuner_tests, setCapacityGrowsConnection) {
+  SPMCStageConnection<int> connection(4);
+
+  connection.setCapacity(16);
+
+  ASSERT_EQ(connection.getCapacity(), 16);
+}
+
+TEST(ConnectionCapacityTuner_tests, setCapacityKeepsPendingTasks) {
+  SPMCStageConnection<int> connection(4);
+  auto consumerId = connection.connectConsumer();
+
+  for (int i = 0; i < 4; ++i) {
+    auto task = connection.getProducerTask();
+    *task->data = i;
+    connection.taskProduced(task->data, i + 1, true);
+  }
+
+  auto task =
+      connection.getConsumerTask(consumerId, ConsumptionStrategy::fifo, 0);
+  connection.taskConsumed(task->data, consumerId, true);
+
+  connection.setCapacity(1);
+
+  ASSERT_EQ(connection.getCapacity(), 3);
+  for (int i = 1; i < 4; ++i) {
+    auto task = connection.getConsumerTask(consumerId,
+                                           ConsumptionStrategy::fifo, i);
+    ASSERT_NE(task, nullptr);
+    ASSERT_EQ(*task->data, i);
+    connection.taskConsumed(task->data, consumerId, true);
+  }
+}
+
+TEST(ConnectionCapacityTuner_tests, tuneGrowsOverwrittenConnection) {
+  auto connection = make_shared<SPMCStageConnection<int>>(16);
+  connection->connectConsumer();
+
+  CapacityTuningSettings settings;
+  settings.maxCapacity = 64;
+  ConnectionCapacityTuner tuner(settings);
+  tuner.addConnection("producer", connection);
+
+  for (int i = 0; i < 64; ++i) {
+    auto task = connection->getProducerTask();
+    connection->taskProduced(task->data, i + 1, true);
+  }
+  tuner.tune();
+
+  ASSERT_EQ(tuner.getCapacities().at("producer"), 32);
+}
+
+TEST(ConnectionCapacityTuner_tests, tuneRespectsMemoryBudget) {
+  auto connection = make_shared<SPMCStageConnection<int>>(16);
+  connection->connectConsumer();
+
+  CapacityTuningSettings settings;
+  settings.memoryBudget = 20 * connection->getTaskSize();
+  ConnectionCapacityTuner tuner(settings);
+  tuner.addConnection("producer", connection);
+
+  for (int i = 0; i < 64; ++i) {
+    auto task = connection->getProducerTask();
+    connection->taskProduced(task->data, i + 1, true);
+  }
+  tuner.tune();
+
+  ASSERT_EQ(connection->getCapacity(), 20);
+}
+
+TEST(ConnectionCapacityTuner_tests, tuneShrinksStarvingConnection) {
+  auto connection = make_shared<SPMCStageConnection<int>>(64);
+  auto consumerId = connection->connectConsumer();
+
+  CapacityTuningSettings settings;
+  settings.shrinkPeriodsCount = 1;
+  ConnectionCapacityTuner tuner(settings);
+  tuner.addConnection("producer", connection);
+
+  ASSERT_EQ(
+      connection->getConsumerTask(consumerId, ConsumptionStrategy::fifo, 0),
+      nullptr);
+  tuner.tune();
+
+  ASSERT_EQ(connection->getCapacity(), 32);
+}
+
+TEST(ConnectionCapacityTuner_tests, stagesWithoutIdsAreTunedByName) {
+  auto first = make_shared<SPMCStageConnection<int>>(16);
+  auto second = make_shared<SPMCStageConnection<int>>(32);
+  auto identified = make_shared<SPMCStageConnection<int>>(64);
+
+  Pipeline pipeline;
+  pipeline.addStage(make_shared<IdleProducer>(first));
+  pipeline.addStage(make_shared<IdleProducer>(second));
+  auto stage = make_shared<IdleProducer>(identified);
+  stage->setId("producer");
+  pipeline.addStage(stage);
+
+  ConnectionCapacityTuner tuner;
+  tuner.addPipeline(pipeline);
+  // the pipeline is added again when it is run
+  tuner.addPipeline(pipeline);
+
+  ASSERT_EQ(tuner.getCapacities(),
+            (map<string, size_t>{{"IdleProducer", 16},
+                                 {"IdleProducer #2", 32},
+                                 {"producer", 64}}));
+}
+
+TEST(ConnectionCapacityTuner_tests, outputsOfStagesWithoutIdsAreNumbered) {
+  auto in = make_shared<SPMCStageConnection<int>>(4);
+  vector<shared_ptr<SPMCStageConnection<int>>> outs;
+  for (size_t capacity : {8, 16, 32, 64})
+    outs.push_back(make_shared<SPMCStageConnection<int>>(capacity));
+
+  IdleRouter first(in, {outs[0], outs[1]});
+  IdleRouter second(in, {outs[2], outs[3]});
+
+  ConnectionCapacityTuner tuner;
+  tuner.addStage(first);
+  tuner.addStage(second);
+
+  ASSERT_EQ(tuner.getCapacities(),
+            (map<string, size_t>{{"IdleRouter.low", 8},
+                                 {"IdleRouter.high", 16},
+                                 {"IdleRouter #2.low", 32},
+                                 {"IdleRouter #2.high", 64}}));
+}
+
+TEST(ConnectionCapacityTuner_tests, shutdownDoesNotWaitForPeriod) {
+  auto connection = make_shared<SPMCStageConnection<int>>(16);
+  connection->connectConsumer();
+
+  CapacityTuningSettings settings;
+  settings.period = chrono::seconds{10};
+  ConnectionCapacityTuner tuner(settings);
+  tuner.addConnection("producer", connection);
+
+  for (int i = 0; i < 64; ++i) {
+    auto task = connection->getProducerTask();
+    connection->taskProduced(task->data, i + 1, true);
+  }
+
+  auto started = chrono::steady_clock::now();
+  tuner.run();
+  tuner.shutdown();
+
+  ASSERT_LT(chrono::steady_clock::now() - started, chrono::seconds{1});
+  // the overwritten connection is not tuned once more after shutdown
+  ASSERT_EQ(connection->getCapacity(), 16);
+}
@@ -3,6 +3,7 @@
 
 #include "Pipeline.h"
 #include "ConsumerStage.h"
+#include "ProducerAndConsumerStage.h"
 #include "ProducerStage.h"
 #include "SPMCStageConnection.h"
 
@@ -39,8 +40,72 @@ class TestProducerStage : public ProducerStage<int> {
     *outData = outValue;
     dataProduced(outData);
   }
+
+  void finishImpl() { finish(); }
 };
 
+class TestCopyStage : public ConsumerAndProducerStage<int, int> {
+ public:
+  static constexpr auto stageName = "TestCopyStage";
+
+  TestCopyStage(std::shared_ptr<InStageConnection<int>> inConnection,
+                std::shared_ptr<OutStageConnection<int>> outConnection)
+      : ConsumerAndProducerStage(stageName,
+                                 ConsumptionStrategy::fifo,
+                                 inConnection,
+                                 outConnection) {}
+
+ protected:
+  void consumeAndProduce(shared_ptr<int> inData,
+                         shared_ptr<int> outData) override {
+    *outData = *inData;
+    dataConsumed(inData);
+    dataProduced(outData);
+  }
+};
+
+namespace {
+// connections of a copy stage which took task 2 while the only output task
+// is held by the downstream consumer
+struct BlockedCopyStage {
+  shared_ptr<SPMCStageConnection<int>> in =
+      make_shared<SPMCStageConnection<int>>(4);
+  shared_ptr<SPMCStageConnection<int>> out =
+      make_shared<SPMCStageConnection<int>>(1);
+  shared_ptr<TestCopyStage> stage = make_shared<TestCopyStage>(in, out);
+  size_t downstreamId = out->connectConsumer();
+  shared_ptr<StageTask<int>> heldTask;
+
+  BlockedCopyStage() {
+    in->setWaitPeriod(chrono::milliseconds{0});
+    out->setWaitPeriod(chrono::milliseconds{0});
+    for (int value = 1; value <= 3; ++value) {
+      auto task = in->getProducerTask();
+      *task->data = value;
+      in->taskProduced(task->data, value, true);
+    }
+
+    stage->step();
+    heldTask = out->getConsumerTask(downstreamId, ConsumptionStrategy::fifo, 0);
+    stage->step();
+  }
+
+  // steps the stage and collects what it produces
+  vector<int> drain(IPipelineStage& copy, size_t lastTaskId) {
+    out->taskConsumed(heldTask->data, downstreamId, true);
+    vector<int> values;
+    while (copy.step()) {
+      auto task = out->getConsumerTask(downstreamId, ConsumptionStrategy::fifo,
+                                       lastTaskId);
+      lastTaskId = task->taskId;
+      values.push_back(*task->data);
+      out->taskConsumed(task->data, downstreamId, true);
+    }
+    return values;
+  }
+};
+}  // namespace
+
 TEST(Pipeline_tests, getStagesWorksOnEmpty) {
   Pipeline p;
   vector<shared_ptr<IPipelineStage>> stages;
@@ -197,3 +262,217 @@ TEST(Pipeline_tests, multipleConsumersConsume) {
   for (size_t i = 0; i < consumedValues_4.size(); ++i)
     ASSERT_EQ(consumedValues_4[i], producedValues[i]);
 }
+
+TEST(Pipeline_tests, replaceStageKeepsConsumerPosition) {
+  Pipeline p;
+
+  auto connection = make_shared<
+      SPMCStageConnection<typename TestConsumerStage::consumptionT>>(32);
+  auto producer = make_shared<TestProducerStage>(connection);
+  auto consumer =
+      make_shared<TestConsumerStage>(ConsumptionStrategy::fifo, connection);
+  auto newConsumer =
+      make_shared<TestConsumerStage>(ConsumptionStrategy::fifo, connection);
+
+  p.addConnection(connection);
+  p.addStage(producer);
+  p.addStage(consumer);
+
+  atomic<int> productionValue = 0;
+
+  vector<int> consumedValues;
+  vector<int> newConsumedValues;
+  EXPECT_CALL(*producer, produce(_)).WillRepeatedly([&](shared_ptr<int> out) {
+    SteadyClock::waitForMs(1);
+    producer->produceImpl(out, productionValue++);
+  });
+  EXPECT_CALL(*consumer, consume(_)).WillRepeatedly([&](shared_ptr<int> in) {
+    consumedValues.push_back(*in);
+    consumer->consumeImpl(in);
+  });
+  EXPECT_CALL(*newConsumer, consume(_)).WillRepeatedly([&](shared_ptr<int> in) {
+    newConsumedValues.push_back(*in);
+    newConsumer->consumeImpl(in);
+  });
+
+  p.run();
+  SteadyClock::waitForMs(50);
+  p.replaceStage(consumer, newConsumer);
+  SteadyClock::waitForMs(50);
+  p.shutdown();
+
+  ASSERT_EQ(p.getStages().size(), 2);
+  ASSERT_EQ(p.getStages().back(), newConsumer);
+  ASSERT_FALSE(consumedValues.empty());
+  ASSERT_FALSE(newConsumedValues.empty());
+  ASSERT_GT(newConsumedValues.front(), consumedValues.back());
+  for (size_t i = 1; i < newConsumedValues.size(); ++i)
+    ASSERT_GT(newConsumedValues[i], newConsumedValues[i - 1]);
+}
+
+TEST(Pipeline_tests, replaceStageThrowsOnDifferentOutConnection) {
+  Pipeline p;
+
+  auto connection = make_shared<
+      SPMCStageConnection<typename TestProducerStage::productionT>>(32);
+  auto otherConnection = make_shared<
+      SPMCStageConnection<typename TestProducerStage::productionT>>(32);
+  auto producer = make_shared<TestProducerStage>(connection);
+  auto newProducer = make_shared<TestProducerStage>(otherConnection);
+
+  p.addConnection(connection);
+  p.addStage(producer);
+
+  ASSERT_THROW(p.replaceStage(producer, newProducer), PipelineException);
+}
+
+TEST(Pipeline_tests, removeStageWorksWhileRunning) {
+  Pipeline p;
+
+  auto connection = make_shared<
+      SPMCStageConnection<typename TestConsumerStage::consumptionT>>(32);
+  auto producer = make_shared<TestProducerStage>(connection);
+  auto consumer =
+      make_shared<TestConsumerStage>(ConsumptionStrategy::fifo, connection);
+
+  p.addConnection(connection);
+  p.addStage(producer);
+  p.addStage(consumer);
+
+  EXPECT_CALL(*producer, produce(_)).WillRepeatedly([&](shared_ptr<int> out) {
+    SteadyClock::waitForMs(1);
+    producer->produceImpl(out, 0);
+  });
+  EXPECT_CALL(*consumer, consume(_)).WillRepeatedly([&](shared_ptr<int> in) {
+    consumer->consumeImpl(in);
+  });
+
+  p.run();
+  SteadyClock::waitForMs(20);
+  ASSERT_THROW(p.removeStage(producer), PipelineException);
+  ASSERT_NO_THROW(p.removeStage(consumer));
+  SteadyClock::waitForMs(20);
+  p.shutdown();
+
+  ASSERT_EQ(p.getStages().size(), 1);
+  ASSERT_EQ(p.getStages().front(), producer);
+}
+
+TEST(Pipeline_tests, addStageRunsStageWhilePipelineIsRunning) {
+  Pipeline p;
+
+  auto connection = make_shared<
+      SPMCStageConnection<typename TestConsumerStage::consumptionT>>(32);
+  auto producer = make_shared<TestProducerStage>(connection);
+
+  p.addConnection(connection);
+  p.addStage(producer);
+
+  atomic<int> consumedCount = 0;
+  EXPECT_CALL(*producer, produce(_)).WillRepeatedly([&](shared_ptr<int> out) {
+    SteadyClock::waitForMs(1);
+    producer->produceImpl(out, 0);
+  });
+
+  p.run();
+
+  auto consumer =
+      make_shared<TestConsumerStage>(ConsumptionStrategy::fifo, connection);
+  EXPECT_CALL(*consumer, consume(_)).WillRepeatedly([&](shared_ptr<int> in) {
+    consumer->consumeImpl(in);
+    consumedCount++;
+  });
+  p.addStage(consumer);
+
+  SteadyClock::waitForMs(50);
+  p.shutdown();
+
+  ASSERT_GT(consumedCount, 0);
+}
+
+TEST(Pipeline_tests, finishedProducerStopsAndReportsStatistics) {
+  Pipeline p;
+
+  auto connection = make_shared<
+      SPMCStageConnection<typename TestConsumerStage::consumptionT>>(32);
+  auto producer = make_shared<TestProducerStage>(connection);
+
+  p.addConnection(connection);
+  p.addStage(producer);
+
+  int producedCount = 0;
+  EXPECT_CALL(*producer, produce(_)).WillRepeatedly([&](shared_ptr<int> out) {
+    producer->produceImpl(out, producedCount);
+    if (++producedCount == 10)
+      producer->finishImpl();
+  });
+
+  ASSERT_FALSE(p.producersFinished());
+  p.run();
+  for (int i = 0; i < 100 && !p.producersFinished(); ++i)
+    SteadyClock::waitForMs(10);
+  p.shutdown();
+
+  ASSERT_TRUE(p.producersFinished());
+  auto statistics = producer->getStatistics();
+  ASSERT_EQ(statistics.processedCount, 10);
+  ASSERT_EQ(statistics.failedCount, 0);
+  ASSERT_LE(statistics.averageLatency(), statistics.maxLatency);
+  ASSERT_LE(statistics.latencyPercentile(0.5),
+            statistics.latencyPercentile(0.99));
+}
+
+TEST(Pipeline_tests, shutdownHandsBackPendingTask) {
+  BlockedCopyStage blocked;
+  ASSERT_EQ(*blocked.heldTask->data, 1);
+
+  blocked.stage->shutdown();
+
+  auto cursor = blocked.stage->getConsumerCursor();
+  ASSERT_TRUE(cursor.has_value());
+  auto task = blocked.in->getConsumerTask(
+      cursor->consumerId, ConsumptionStrategy::fifo,
+      cursor->lastConsumedTaskId);
+  ASSERT_NE(task, nullptr);
+  ASSERT_EQ(*task->data, 2);
+}
+
+TEST(Pipeline_tests, replaceStageDeliversHeldTaskOnce) {
+  BlockedCopyStage blocked;
+  Pipeline p;
+  p.addConnection(blocked.in);
+  p.addConnection(blocked.out);
+  p.addStage(blocked.stage);
+
+  auto newStage = make_shared<TestCopyStage>(blocked.in, blocked.out);
+  p.replaceStage(blocked.stage, newStage);
+
+  ASSERT_EQ(blocked.drain(*newStage, blocked.heldTask->taskId),
+            vector<int>({2, 3}));
+}
+
+TEST(Pipeline_tests, transferConsumerHandsOverTakenTasks) {
+  SPMCStageConnection<int> connection(4);
+  connection.setWaitPeriod(chrono::milliseconds{0});
+  auto from = connection.connectConsumer();
+  auto to = connection.connectConsumer();
+  for (int value = 1; value <= 2; ++value) {
+    auto task = connection.getProducerTask();
+    *task->data = value;
+    connection.taskProduced(task->data, value, true);
+  }
+
+  auto taken = connection.getConsumerTask(from, ConsumptionStrategy::fifo, 0);
+  ASSERT_EQ(*taken->data, 1);
+  connection.transferConsumer(from, to);
+
+  vector<int> values;
+  size_t lastTaskId = 0;
+  while (auto task = connection.getConsumerTask(
+             to, ConsumptionStrategy::fifo, lastTaskId)) {
+    lastTaskId = task->taskId;
+    values.push_back(*task->data);
+    connection.taskConsumed(task->data, to, true);
+  }
+  ASSERT_EQ(values, vector<int>({1, 2}));
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "StaticPipeline.h"
+#include "SteadyClock.h"
+
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+struct Counter : StaticNode<void, int> {
+  bool produce(int& out) {
+    out = m_next++;
+    return true;
+  }
+
+  int m_next = 0;
+};
+
+struct Halving : StaticNode<int, double> {
+  static constexpr string_view name = "Halving";
+
+  // odd values are dropped, zero fails
+  bool consumeAndProduce(const int& in, double& out) {
+    if (in == 0)
+      throw runtime_error("zero");
+    out = in / 2.0;
+    return in % 2 == 0;
+  }
+};
+
+struct Collector : StaticNode<double, void> {
+  void consume(const double& in) { values.push_back(in); }
+
+  vector<double> values;
+};
+
+template <typename Chain>
+constexpr size_t chainLength(const Chain& chain) {
+  return tuple_size_v<decay_t<decltype(chain.getNodes())>>;
+}
+}  // namespace
+
+TEST(StaticPipeline_tests, chainIsBuiltAtCompileTime) {
+  constexpr auto chain = StaticNode<void, int>{} | StaticNode<int, double>{} |
+                         StaticNode<double, void>{};
+  static_assert(chainLength(chain) == 3);
+  static_assert(
+      is_same_v<decay_t<decltype(chain)>::lastT, StaticNode<double, void>>);
+}
+
+TEST(StaticPipeline_tests, stagesPassTasksAlongChain) {
+  auto pipeline = makeStaticPipeline(Counter{} | Halving{} | Collector{}, 16);
+  ASSERT_EQ(pipeline->getStages().size(), 3);
+  ASSERT_EQ(pipeline->getConnections().size(), 2);
+
+  auto source = pipeline->getStaticStage<0>();
+  auto halving = pipeline->getStaticStage<1>();
+  auto sink = pipeline->getStaticStage<2>();
+  ASSERT_EQ(source->getStageType(), PipelineStageType::producer);
+  ASSERT_EQ(halving->getStageType(), PipelineStageType::producerConsumer);
+  ASSERT_EQ(sink->getStageType(), PipelineStageType::consumer);
+  ASSERT_EQ(halving->getInConnection(), source->getOutConnection());
+  ASSERT_EQ(pipeline->getStageById("2")->getParentId(), "1");
+  ASSERT_EQ(source->getName(), "StaticStage0");
+  ASSERT_EQ(halving->getName(), "Halving");
+  ASSERT_EQ(sink->getName(), "StaticStage2");
+
+  for (size_t i = 0; i < 5; ++i)
+    ASSERT_TRUE(source->step());
+  // 0 fails, 1 and 3 are dropped
+  while (halving->step()) {
+  }
+  while (sink->step()) {
+  }
+
+  ASSERT_EQ(sink->getNode().values, vector<double>({1, 2}));
+  ASSERT_EQ(halving->getStatistics().failedCount, 1);
+  ASSERT_EQ(halving->getStatistics().processedCount, 4);
+  ASSERT_EQ(sink->getStatistics().processedCount, 2);
+}
+
+TEST(StaticPipeline_tests, pipelineRuns) {
+  auto pipeline = makeStaticPipeline(Counter{} | Halving{} | Collector{});
+  auto sink = pipeline->getStaticStage<2>();
+
+  pipeline->run();
+  for (size_t i = 0;
+       i < 100 && sink->getStatistics().processedCount < 1000; ++i)
+    SteadyClock::waitForMs(10);
+  pipeline->shutdown();
+
+  ASSERT_GE(sink->getStatistics().processedCount, 1000);
+  ASSERT_EQ(sink->getNode().values.size(),
+            sink->getStatistics().processedCount);
+}
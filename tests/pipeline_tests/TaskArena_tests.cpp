@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include "HugePageBuffer.h"
+#include "SPMCStageConnection.h"
+#include "TaskArena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+using namespace std;
+using namespace testing;
+
+TEST(TaskArena_tests, bufferIsRoundedToHugePages) {
+  HugePageBuffer buffer(100);
+  ASSERT_EQ(buffer.size() % HugePageBuffer::hugePageSize, 0);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(buffer.data()) % 4096, 0);
+
+  // the kind depends on the system, memory is usable with any of them
+  memset(buffer.data(), 1, buffer.size());
+  ASSERT_EQ(static_cast<char*>(buffer.data())[buffer.size() - 1], 1);
+}
+
+TEST(TaskArena_tests, arenaAllocatesAlignedUntilFull) {
+  TaskArena arena(1);
+  auto a = arena.allocate(3, 1);
+  auto b = arena.allocate(8, 8);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % 8, 0);
+  ASSERT_TRUE(arena.contains(b));
+
+  ASSERT_EQ(arena.allocate(HugePageBuffer::hugePageSize, 1), nullptr);
+
+  // full arena falls back to the heap
+  auto shared = make_shared<TaskArena>(1);
+  ASSERT_NE(shared->allocate(HugePageBuffer::hugePageSize - 8, 1), nullptr);
+  auto value = allocate_shared<int64_t>(TaskArenaAllocator<int64_t>(shared), 7);
+  ASSERT_FALSE(shared->contains(value.get()));
+  ASSERT_EQ(*value, 7);
+}
+
+TEST(TaskArena_tests, largeConnectionKeepsWorking) {
+  ASSERT_EQ(SPMCStageConnection<int64_t>(16).getPageKind(), PageKind::regular);
+
+  shared_ptr<int64_t> data;
+  {
+    SPMCStageConnection<int64_t> connection(100000);
+    ASSERT_EQ(connection.getCapacity(), 100000);
+    connection.setWaitPeriod(chrono::milliseconds{0});
+    auto consumerId = connection.connectConsumer();
+
+    auto task = connection.getProducerTask();
+    *task->data = 42;
+    connection.taskProduced(task->data, 1, true);
+
+    auto consumed =
+        connection.getConsumerTask(consumerId, ConsumptionStrategy::fifo, 0);
+    ASSERT_NE(consumed, nullptr);
+    ASSERT_EQ(*consumed->data, 42);
+    data = consumed->data;
+    connection.taskConsumed(consumed->data, consumerId, true);
+
+    connection.setCapacity(100010);
+    ASSERT_EQ(connection.getCapacity(), 100010);
+  }
+
+  // the arena lives as long as its tasks
+  ASSERT_EQ(*data, 42);
+}
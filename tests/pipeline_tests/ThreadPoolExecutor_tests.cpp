@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include "ConsumerStage.h"
+#include "Pipeline.h"
+#include "ProducerStage.h"
+#include "SPMCStageConnection.h"
+#include "SteadyClock.h"
+#include "ThreadPoolExecutor.h"
+
+#include <atomic>
+
+using namespace std;
+using namespace testing;
+
+namespace {
+class CountingProducer : public ProducerStage<int> {
+ public:
+  CountingProducer(weak_ptr<OutStageConnection<int>> outConnection)
+      : ProducerStage("CountingProducer", outConnection) {}
+
+  void produce(shared_ptr<int> outData) override {
+    *outData = m_value++;
+    dataProduced(outData);
+  }
+
+ private:
+  int m_value = 0;
+};
+
+class CountingConsumer : public ConsumerStage<int> {
+ public:
+  CountingConsumer(weak_ptr<InStageConnection<int>> inConnection,
+                   atomic<int>* running = nullptr,
+                   atomic<int>* maxRunning = nullptr)
+      : ConsumerStage("CountingConsumer",
+                      ConsumptionStrategy::fifo,
+                      inConnection),
+        m_running(running),
+        m_maxRunning(maxRunning) {}
+
+  void consume(shared_ptr<int> inData) override {
+    if (m_running != nullptr) {
+      auto running = ++*m_running;
+      for (auto max = m_maxRunning->load(); running > max;)
+        m_maxRunning->compare_exchange_weak(max, running);
+      SteadyClock::waitForMs(1);
+      --*m_running;
+    }
+
+    consumedCount++;
+    dataConsumed(inData);
+  }
+
+  atomic<int> consumedCount = 0;
+
+ private:
+  atomic<int>* m_running;
+  atomic<int>* m_maxRunning;
+};
+
+struct TestPipeline {
+  shared_ptr<Pipeline> pipeline;
+  shared_ptr<CountingConsumer> consumer;
+  shared_ptr<SPMCStageConnection<int>> connection;
+};
+
+TestPipeline makePipeline(atomic<int>* running = nullptr,
+                          atomic<int>* maxRunning = nullptr) {
+  auto connection = make_shared<SPMCStageConnection<int>>(32);
+  auto producer = make_shared<CountingProducer>(connection);
+  auto consumer =
+      make_shared<CountingConsumer>(connection, running, maxRunning);
+
+  auto pipeline = make_shared<Pipeline>();
+  pipeline->addConnection(connection);
+  pipeline->addStage(producer);
+  pipeline->addStage(consumer);
+
+  return {pipeline, consumer, connection};
+}
+}  // namespace
+
+TEST(ThreadPoolExecutor_tests, pipelinesShareThreads) {
+  auto executor = make_shared<ThreadPoolExecutor>(ThreadPoolSettings{2});
+
+  vector<TestPipeline> pipelines;
+  for (int i = 0; i < 10; ++i) {
+    pipelines.push_back(makePipeline());
+    pipelines.back().pipeline->setExecutor(executor);
+  }
+
+  for (auto& p : pipelines)
+    p.pipeline->run();
+  SteadyClock::waitForMs(100);
+  ASSERT_EQ(executor->getScheduledCount(), 20);
+
+  for (auto& p : pipelines)
+    p.pipeline->shutdown();
+
+  ASSERT_EQ(executor->getThreadsCount(), 2);
+  ASSERT_EQ(executor->getScheduledCount(), 0);
+  for (auto& p : pipelines)
+    ASSERT_GT(p.consumer->consumedCount, 0);
+}
+
+TEST(ThreadPoolExecutor_tests, quotaLimitsConcurrency) {
+  auto executor = make_shared<ThreadPoolExecutor>(ThreadPoolSettings{4});
+  auto quota = make_shared<ExecutorQuota>(ExecutorQuota{1});
+
+  atomic<int> running = 0;
+  atomic<int> maxRunning = 0;
+  vector<TestPipeline> pipelines;
+  for (int i = 0; i < 4; ++i) {
+    pipelines.push_back(makePipeline(&running, &maxRunning));
+    pipelines.back().pipeline->setExecutor(executor, quota);
+  }
+
+  for (auto& p : pipelines)
+    p.pipeline->run();
+  SteadyClock::waitForMs(100);
+  for (auto& p : pipelines)
+    p.pipeline->shutdown();
+
+  ASSERT_EQ(maxRunning, 1);
+  for (auto& p : pipelines)
+    ASSERT_GT(p.consumer->consumedCount, 0);
+}
+
+TEST(ThreadPoolExecutor_tests, waitPeriodIsRestoredAfterShutdown) {
+  ThreadPoolSettings settings{2};
+  settings.connectionWaitPeriod = chrono::milliseconds(1);
+  auto executor = make_shared<ThreadPoolExecutor>(settings);
+
+  auto p = makePipeline();
+  p.connection->setWaitPeriod(chrono::milliseconds(250));
+  p.pipeline->setExecutor(executor);
+
+  p.pipeline->run();
+  SteadyClock::waitForMs(50);
+  ASSERT_EQ(p.connection->getWaitPeriod(), chrono::milliseconds(1));
+
+  p.pipeline->shutdown();
+  ASSERT_EQ(p.connection->getWaitPeriod(), chrono::milliseconds(250));
+}